@@ -0,0 +1,94 @@
+// Reports the memory footprint of idle actors: the `sizeof` of the actor
+// class hierarchy and the resident set size per actor after spawning a large
+// number of function-based actors that do nothing but wait for messages.
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "caf/all.hpp"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+class config : public actor_system_config {
+public:
+  size_t actors = 1000000;
+
+  config() {
+    opt_group{custom_options_, "global"}
+    .add(actors, "actors,a", "set number of spawned idle actors");
+  }
+};
+
+// returns the resident set size of this process in bytes
+size_t resident_set_size() {
+  std::ifstream in{"/proc/self/statm"};
+  size_t total = 0;
+  size_t resident = 0;
+  if (!(in >> total >> resident))
+    return 0;
+  return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+behavior idle(event_based_actor*, std::atomic<size_t>* initialized) {
+  ++*initialized;
+  return {
+    [](int x) {
+      return x;
+    }
+  };
+}
+
+#define PRINT_SIZEOF(type)                                                     \
+  cout << std::left << std::setw(48) << "sizeof(" #type "):" << sizeof(type)   \
+       << endl
+
+void caf_main(actor_system& sys, const config& cfg) {
+  PRINT_SIZEOF(actor_control_block);
+  PRINT_SIZEOF(abstract_actor);
+  PRINT_SIZEOF(monitorable_actor);
+  PRINT_SIZEOF(local_actor);
+  PRINT_SIZEOF(scheduled_actor);
+  PRINT_SIZEOF(event_based_actor);
+  PRINT_SIZEOF(blocking_actor);
+  PRINT_SIZEOF(actor_storage<event_based_actor>);
+  PRINT_SIZEOF(local_actor::mailbox_type);
+  PRINT_SIZEOF(detail::behavior_stack);
+  std::atomic<size_t> initialized{0};
+  std::vector<actor> handles;
+  handles.reserve(cfg.actors);
+  auto rss0 = resident_set_size();
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < cfg.actors; ++i)
+    handles.emplace_back(sys.spawn(idle, &initialized));
+  while (initialized < cfg.actors)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  auto t1 = std::chrono::steady_clock::now();
+  auto rss1 = resident_set_size();
+  std::chrono::duration<double> secs = t1 - t0;
+  // the handle vector is part of the measurement, but only adds one pointer
+  auto per_actor = static_cast<double>(rss1 - rss0) / cfg.actors;
+  cout << std::setw(48) << "idle actors:" << cfg.actors << endl
+       << std::setw(48) << "spawn time (s):" << secs.count() << endl
+       << std::setw(48) << "RSS increase (MB):" << (rss1 - rss0) / 1e6 << endl
+       << std::setw(48) << "RSS per idle actor (bytes):" << per_actor << endl;
+  for (auto& hdl : handles)
+    anon_send_exit(hdl, exit_reason::user_shutdown);
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
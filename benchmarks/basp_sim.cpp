@@ -0,0 +1,484 @@
+// Deterministic network simulation for BASP. Runs any number of nodes in a
+// single process on top of the test multiplexer, i.e., without kernel sockets,
+// and connects each pair of nodes with a simulated link that has a fixed
+// latency and bandwidth. A discrete-event loop advances a virtual clock, so
+// end-to-end latencies in virtual time are identical across runs, while the
+// CPU cost per message of the BASP broker, `basp::instance::handle`, and
+// (de)serialization is measured with a real clock.
+//
+// Traffic is either generated from a pattern (uniform, ring, fan-in, fan-out)
+// or replayed from a file with one event per line:
+//
+//     <virtual time in ns> <source node> <destination node> <payload bytes>
+//
+// Lines starting with '#' are ignored. Use --record to write the generated
+// traffic to a file for replaying it later, e.g., after changing BASP.
+
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+#include "caf/io/network/test_multiplexer.hpp"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::string;
+using std::vector;
+
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+using hello_atom = atom_constant<atom("hello")>;
+
+using clock_type = std::chrono::steady_clock;
+
+uint64_t ns_since(clock_type::time_point t0) {
+  return static_cast<uint64_t>(std::chrono::duration_cast<
+    std::chrono::nanoseconds>(clock_type::now() - t0).count());
+}
+
+// -- traffic patterns ---------------------------------------------------------
+
+struct traffic_event {
+  uint64_t time;
+  uint32_t source;
+  uint32_t destination;
+  uint32_t payload;
+};
+
+vector<traffic_event> generate_traffic(const string& pattern, uint32_t nodes,
+                                       size_t messages, uint64_t interval,
+                                       uint32_t payload, uint64_t seed) {
+  vector<traffic_event> result;
+  result.reserve(messages);
+  std::mt19937_64 engine{seed};
+  std::uniform_int_distribution<uint32_t> any_node{0, nodes - 1};
+  std::uniform_int_distribution<uint32_t> other_node{1, nodes - 1};
+  for (size_t i = 0; i < messages; ++i) {
+    uint32_t src;
+    uint32_t dst;
+    if (pattern == "ring") {
+      src = static_cast<uint32_t>(i % nodes);
+      dst = (src + 1) % nodes;
+    } else if (pattern == "fan-in") {
+      src = static_cast<uint32_t>(i % (nodes - 1)) + 1;
+      dst = 0;
+    } else if (pattern == "fan-out") {
+      src = 0;
+      dst = static_cast<uint32_t>(i % (nodes - 1)) + 1;
+    } else {
+      src = any_node(engine);
+      dst = (src + other_node(engine)) % nodes;
+    }
+    result.push_back(traffic_event{i * interval, src, dst, payload});
+  }
+  return result;
+}
+
+bool read_traffic(const string& path, uint32_t nodes,
+                  vector<traffic_event>& out) {
+  std::ifstream in{path};
+  if (!in) {
+    cerr << "cannot open " << path << endl;
+    return false;
+  }
+  string line;
+  size_t line_num = 0;
+  while (std::getline(in, line)) {
+    ++line_num;
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream iss{line};
+    traffic_event x;
+    if (!(iss >> x.time >> x.source >> x.destination >> x.payload)
+        || x.source >= nodes || x.destination >= nodes
+        || x.source == x.destination) {
+      cerr << path << ":" << line_num << ": invalid traffic event" << endl;
+      return false;
+    }
+    out.push_back(x);
+  }
+  auto cmp = [](const traffic_event& x, const traffic_event& y) {
+    return x.time < y.time;
+  };
+  std::stable_sort(out.begin(), out.end(), cmp);
+  return true;
+}
+
+bool write_traffic(const string& path, const vector<traffic_event>& xs) {
+  std::ofstream out{path};
+  out << "# <time in ns> <source> <destination> <payload bytes>\n";
+  for (auto& x : xs)
+    out << x.time << ' ' << x.source << ' ' << x.destination << ' '
+        << x.payload << '\n';
+  return static_cast<bool>(out);
+}
+
+// -- configuration ------------------------------------------------------------
+
+class config : public actor_system_config {
+public:
+  size_t nodes = 4;
+  size_t messages = 10000;
+  size_t payload = 64;
+  size_t interval = 1000;
+  size_t latency = 50;
+  size_t bandwidth = 1000;
+  size_t seed = 0;
+  string pattern = "uniform";
+  string replay;
+  string record;
+
+  config() {
+    opt_group{custom_options_, "global"}
+    .add(nodes, "nodes,n", "set number of simulated nodes")
+    .add(messages, "messages,m", "set number of generated messages")
+    .add(payload, "payload,p", "set payload size of generated messages")
+    .add(interval, "interval,i", "set virtual ns between generated messages")
+    .add(pattern, "pattern", "uniform, ring, fan-in, or fan-out")
+    .add(latency, "latency,l", "set link latency in virtual microseconds")
+    .add(bandwidth, "bandwidth,b", "set link bandwidth in Mbit/s (0 = inf)")
+    .add(seed, "seed", "set seed for generating uniform traffic")
+    .add(replay, "replay,r", "replay traffic from file instead of generating")
+    .add(record, "record", "write the simulated traffic to file");
+  }
+};
+
+// -- simulation ---------------------------------------------------------------
+
+class simulation;
+
+// receives the payload messages of the simulation on each node
+behavior sink(event_based_actor*, simulation* sim, uint32_t id);
+
+// a single actor system with its own test multiplexer and BASP broker
+struct sim_node {
+  actor_system_config cfg;
+  std::unique_ptr<actor_system> sys;
+  network::test_multiplexer* mpx;
+  scheduler::test_coordinator* sched;
+  basp_broker* broker;
+  actor sink;
+  // proxies to the sinks of all other nodes
+  vector<actor> peers;
+};
+
+// a frame in flight on a simulated link
+struct frame {
+  uint64_t arrival;
+  uint64_t seq;
+  uint32_t destination;
+  connection_handle hdl;
+  vector<char> bytes;
+};
+
+struct later_arrival {
+  bool operator()(const frame& x, const frame& y) const {
+    return x.arrival != y.arrival ? x.arrival > y.arrival : x.seq > y.seq;
+  }
+};
+
+class simulation {
+public:
+  static constexpr uint16_t port = 4242;
+
+  simulation(const config& cfg)
+      : num_nodes_(static_cast<uint32_t>(cfg.nodes)),
+        latency_ns_(cfg.latency * 1000),
+        bandwidth_(cfg.bandwidth),
+        now_(0),
+        frame_seq_(0),
+        broker_ns_(0),
+        received_(0),
+        link_free_(cfg.nodes * cfg.nodes, 0) {
+    // nop
+  }
+
+  ~simulation() {
+    for (auto& n : nodes_) {
+      anon_send_exit(n->sink, exit_reason::user_shutdown);
+      n->peers.clear();
+      n->sink = nullptr;
+      n->sys->await_actors_before_shutdown(false);
+    }
+    for (uint32_t i = 0; i < nodes_.size(); ++i)
+      pump(i);
+  }
+
+  // spawns all nodes and connects each pair of nodes
+  bool init() {
+    for (uint32_t i = 0; i < num_nodes_; ++i) {
+      std::unique_ptr<sim_node> n{new sim_node};
+      n->cfg.load<middleman, network::test_multiplexer>()
+        .set("scheduler.policy", atom("testing"))
+        .set("middleman.detach-utility-actors", false);
+      n->sys.reset(new actor_system(n->cfg));
+      auto& mm = n->sys->middleman();
+      n->mpx = static_cast<network::test_multiplexer*>(&mm.backend());
+      n->sched = &dynamic_cast<scheduler::test_coordinator&>(
+                   n->sys->scheduler());
+      auto hdl = mm.named_broker<basp_broker>(atom("BASP"));
+      n->broker = static_cast<basp_broker*>(actor_cast<abstract_actor*>(hdl));
+      n->sink = n->sys->spawn(sink, this, i);
+      n->peers.resize(num_nodes_);
+      // publish the sink at the simulated port, making it part of the
+      // server handshake of this node
+      auto sink_ptr = actor_cast<strong_actor_ptr>(n->sink);
+      n->sys->registry().put(n->sink.id(), sink_ptr);
+      n->broker->add_doorman(n->mpx->new_doorman(acceptor(), port));
+      n->broker->state.instance.add_published_actor(port, sink_ptr, {});
+      nodes_.emplace_back(std::move(n));
+      pump(i);
+    }
+    // node j connects to all nodes i < j
+    for (uint32_t j = 1; j < num_nodes_; ++j)
+      for (uint32_t i = 0; i < j; ++i)
+        connect(j, i);
+    run();
+    for (uint32_t i = 0; i < num_nodes_; ++i)
+      for (uint32_t j = 0; j < num_nodes_; ++j)
+        if (i != j && !nodes_[i]->peers[j]) {
+          cerr << "node " << i << " failed to connect to node " << j << endl;
+          return false;
+        }
+    return true;
+  }
+
+  // replays `traffic` and returns once all messages have been delivered
+  void replay(const vector<traffic_event>& traffic) {
+    for (auto& n : nodes_) {
+      auto& prof = n->broker->state.instance.profile();
+      prof = basp::instance::cpu_profile{};
+      prof.enabled = true;
+    }
+    broker_ns_ = 0;
+    received_ = 0;
+    auto t0 = now_;
+    sent_at_.clear();
+    latencies_.clear();
+    sent_at_.reserve(traffic.size());
+    latencies_.reserve(traffic.size());
+    auto next = traffic.begin();
+    while (next != traffic.end() || !frames_.empty()) {
+      if (next != traffic.end()
+          && (frames_.empty() || t0 + next->time <= frames_.top().arrival)) {
+        now_ = std::max(now_, t0 + next->time);
+        auto seq = static_cast<uint64_t>(sent_at_.size());
+        sent_at_.push_back(now_);
+        anon_send(nodes_[next->source]->peers[next->destination], seq,
+                  string(next->payload, 'x'));
+        pump(next->source);
+        ++next;
+      } else {
+        deliver_next();
+      }
+    }
+    elapsed_ = now_ - t0;
+  }
+
+  // called by the sink actors
+  void received(uint64_t seq) {
+    ++received_;
+    if (seq < sent_at_.size())
+      latencies_.push_back(now_ - sent_at_[seq]);
+  }
+
+  void learned(uint32_t node, uint32_t peer, actor hdl) {
+    nodes_[node]->peers[peer] = std::move(hdl);
+  }
+
+  void print_report(std::ostream& out) {
+    basp::instance::cpu_profile total;
+    for (auto& n : nodes_) {
+      auto& prof = n->broker->state.instance.profile();
+      total.handle_calls += prof.handle_calls;
+      total.handle_ns += prof.handle_ns;
+      total.serialize_calls += prof.serialize_calls;
+      total.serialize_ns += prof.serialize_ns;
+      total.deserialize_calls += prof.deserialize_calls;
+      total.deserialize_ns += prof.deserialize_ns;
+    }
+    auto per_msg = [&](uint64_t ns) {
+      return received_ > 0 ? static_cast<double>(ns) / received_ : 0.;
+    };
+    std::sort(latencies_.begin(), latencies_.end());
+    auto pct = [&](double p) -> double {
+      if (latencies_.empty())
+        return 0.;
+      auto rank = static_cast<size_t>(p / 100. * latencies_.size());
+      return latencies_[std::min(rank, latencies_.size() - 1)] / 1000.;
+    };
+    out << "messages delivered:        " << received_ << endl
+        << "virtual duration (us):     " << elapsed_ / 1000. << endl
+        << "virtual latency p50 (us):  " << pct(50) << endl
+        << "virtual latency p99 (us):  " << pct(99) << endl
+        << "virtual latency max (us):  " << pct(100) << endl
+        << "broker ns/msg:             " << per_msg(broker_ns_) << endl
+        << "instance::handle ns/msg:   " << per_msg(total.handle_ns) << endl
+        << "serialization ns/msg:      " << per_msg(total.serialize_ns) << endl
+        << "deserialization ns/msg:    " << per_msg(total.deserialize_ns)
+        << endl
+        << "handle calls:              " << total.handle_calls << endl
+        << "serialize calls:           " << total.serialize_calls << endl
+        << "deserialize calls:         " << total.deserialize_calls << endl;
+  }
+
+private:
+  static accept_handle acceptor() {
+    return accept_handle::from_int(1);
+  }
+
+  // each node reaches node `peer` via the connection handle `peer + 1`
+  static connection_handle connection_to(uint32_t peer) {
+    return connection_handle::from_int(peer + 1);
+  }
+
+  // lets node `client` connect to the published sink of node `server`
+  void connect(uint32_t client, uint32_t server) {
+    auto& c = *nodes_[client];
+    auto& s = *nodes_[server];
+    auto sc = c.mpx->new_scribe(connection_to(server));
+    auto bhdl = actor_cast<actor>(c.broker);
+    auto sim = this;
+    c.sys->spawn([=](event_based_actor* self) {
+      self->request(bhdl, infinite, connect_atom::value, sc, port).then(
+        [=](const node_id&, strong_actor_ptr& ptr,
+            const std::set<std::string>&) {
+          auto hdl = actor_cast<actor>(ptr);
+          sim->learned(client, server, hdl);
+          // introduce our own sink to the server
+          self->send(hdl, hello_atom::value, client,
+                     sim->nodes_[client]->sink);
+        }
+      );
+    });
+    pump(client);
+    s.mpx->add_pending_connect(acceptor(), connection_to(client));
+    s.mpx->accept_connection(acceptor());
+    pump(server);
+  }
+
+  // runs brokers and actors of `n` until idle, then puts all pending output
+  // of the node onto the simulated links
+  void pump(uint32_t id) {
+    auto& n = *nodes_[id];
+    for (;;) {
+      auto t0 = clock_type::now();
+      auto broker_progress = false;
+      while (n.mpx->try_exec_runnable())
+        broker_progress = true;
+      broker_ns_ += ns_since(t0);
+      if (n.sched->run() == 0 && !broker_progress)
+        break;
+    }
+    for (uint32_t peer = 0; peer < nodes_.size(); ++peer) {
+      if (peer == id)
+        continue;
+      auto& buf = n.mpx->output_buffer(connection_to(peer));
+      if (buf.empty())
+        continue;
+      // serialize frames on the link and add the propagation delay
+      auto& free_at = link_free_[id * num_nodes_ + peer];
+      auto start = std::max(now_, free_at);
+      uint64_t tx = 0;
+      if (bandwidth_ > 0)
+        tx = buf.size() * 8 * 1000 / bandwidth_;
+      free_at = start + tx;
+      frame f{free_at + latency_ns_, frame_seq_++, peer, connection_to(id),
+              {}};
+      f.bytes.swap(buf);
+      frames_.push(std::move(f));
+    }
+  }
+
+  // delivers the next frame to its destination node
+  void deliver_next() {
+    auto& top = frames_.top();
+    now_ = std::max(now_, top.arrival);
+    auto id = top.destination;
+    auto& n = *nodes_[id];
+    auto hdl = top.hdl;
+    auto& vbuf = n.mpx->virtual_network_buffer(hdl);
+    vbuf.insert(vbuf.end(), top.bytes.begin(), top.bytes.end());
+    frames_.pop();
+    auto t0 = clock_type::now();
+    n.mpx->read_data(hdl);
+    broker_ns_ += ns_since(t0);
+    pump(id);
+  }
+
+  // runs the simulation until no frame is in flight
+  void run() {
+    while (!frames_.empty())
+      deliver_next();
+  }
+
+  uint32_t num_nodes_;
+  uint64_t latency_ns_;
+  uint64_t bandwidth_;
+  uint64_t now_;
+  uint64_t elapsed_;
+  uint64_t frame_seq_;
+  uint64_t broker_ns_;
+  uint64_t received_;
+  vector<uint64_t> link_free_;
+  vector<uint64_t> sent_at_;
+  vector<uint64_t> latencies_;
+  vector<std::unique_ptr<sim_node>> nodes_;
+  std::priority_queue<frame, vector<frame>, later_arrival> frames_;
+};
+
+constexpr uint16_t simulation::port;
+
+behavior sink(event_based_actor*, simulation* sim, uint32_t id) {
+  return {
+    [=](hello_atom, uint32_t peer, const actor& hdl) {
+      sim->learned(id, peer, hdl);
+    },
+    [=](uint64_t seq, const string&) {
+      sim->received(seq);
+    }
+  };
+}
+
+void caf_main(actor_system&, const config& cfg) {
+  if (cfg.nodes < 2) {
+    cerr << "need at least two nodes" << endl;
+    return;
+  }
+  auto nodes = static_cast<uint32_t>(cfg.nodes);
+  vector<traffic_event> traffic;
+  if (!cfg.replay.empty()) {
+    if (!read_traffic(cfg.replay, nodes, traffic))
+      return;
+  } else {
+    traffic = generate_traffic(cfg.pattern, nodes, cfg.messages, cfg.interval,
+                               static_cast<uint32_t>(cfg.payload), cfg.seed);
+  }
+  if (!cfg.record.empty() && !write_traffic(cfg.record, traffic)) {
+    cerr << "cannot write " << cfg.record << endl;
+    return;
+  }
+  simulation sim{cfg};
+  if (!sim.init())
+    return;
+  sim.replay(traffic);
+  sim.print_report(cout);
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
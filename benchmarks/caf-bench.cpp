@@ -0,0 +1,547 @@
+// Microbenchmarks for the core messaging paths of CAF. Each benchmark runs
+// a fixed number of warmup rounds followed by a fixed number of samples and
+// reports min, max, mean, and percentiles as JSON or CSV. Use --filter to
+// select benchmarks by substring and --scale to multiply the workload.
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::string;
+using std::vector;
+
+using namespace caf;
+
+namespace {
+
+// -- atoms for dispatch benchmarks --------------------------------------------
+
+using a01_atom = atom_constant<atom("a01")>;
+using a02_atom = atom_constant<atom("a02")>;
+using a03_atom = atom_constant<atom("a03")>;
+using a04_atom = atom_constant<atom("a04")>;
+using a05_atom = atom_constant<atom("a05")>;
+using a06_atom = atom_constant<atom("a06")>;
+using a07_atom = atom_constant<atom("a07")>;
+using a08_atom = atom_constant<atom("a08")>;
+using a09_atom = atom_constant<atom("a09")>;
+using a10_atom = atom_constant<atom("a10")>;
+using a11_atom = atom_constant<atom("a11")>;
+using a12_atom = atom_constant<atom("a12")>;
+using a13_atom = atom_constant<atom("a13")>;
+using a14_atom = atom_constant<atom("a14")>;
+using a15_atom = atom_constant<atom("a15")>;
+
+// -- measurement utilities ----------------------------------------------------
+
+using clock_type = std::chrono::steady_clock;
+
+double ns_since(clock_type::time_point t0) {
+  std::chrono::duration<double, std::nano> ns = clock_type::now() - t0;
+  return ns.count();
+}
+
+struct summary {
+  string name;
+  string unit;
+  size_t samples;
+  double min;
+  double p50;
+  double p90;
+  double p99;
+  double max;
+  double mean;
+};
+
+// nearest-rank percentile of a sorted, non-empty vector
+double percentile(const vector<double>& xs, double p) {
+  auto rank = static_cast<size_t>(p / 100. * static_cast<double>(xs.size()));
+  return xs[std::min(rank, xs.size() - 1)];
+}
+
+summary summarize(string name, string unit, vector<double> xs) {
+  std::sort(xs.begin(), xs.end());
+  auto sum = std::accumulate(xs.begin(), xs.end(), 0.);
+  return {std::move(name), std::move(unit), xs.size(), xs.front(),
+          percentile(xs, 50), percentile(xs, 90), percentile(xs, 99),
+          xs.back(), sum / static_cast<double>(xs.size())};
+}
+
+// -- configuration ------------------------------------------------------------
+
+class config : public actor_system_config {
+public:
+  string format = "json";
+  string output;
+  string filter;
+  size_t samples = 20;
+  size_t warmup = 2;
+  size_t scale = 1;
+
+  config() {
+    opt_group{custom_options_, "global"}
+    .add(format, "format", "set output format to 'json' or 'csv'")
+    .add(output, "output,o", "write results to file instead of STDOUT")
+    .add(filter, "filter,f", "only run benchmarks containing this string")
+    .add(samples, "samples,s", "set number of samples per benchmark")
+    .add(warmup, "warmup,w", "set number of discarded warmup samples")
+    .add(scale, "scale", "multiply the workload of each sample");
+  }
+};
+
+// -- benchmark driver ---------------------------------------------------------
+
+// writes `str` as JSON string literal
+void print_json_string(std::ostream& out, const string& str) {
+  out << '"';
+  for (auto c : str) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          static constexpr char hex[] = "0123456789abcdef";
+          out << "\\u00" << hex[(c >> 4) & 0x0F] << hex[c & 0x0F];
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+// writes `str` as quoted CSV field (RFC 4180), since benchmark names may
+// contain commas, e.g., "serialize.message(int,string,double).encode"
+void print_csv_field(std::ostream& out, const string& str) {
+  out << '"';
+  for (auto c : str) {
+    if (c == '"')
+      out << '"';
+    out << c;
+  }
+  out << '"';
+}
+
+class driver {
+public:
+  /// Appends measurements of a single sample to the vector.
+  using sample_fun = std::function<void (vector<double>&)>;
+
+  driver(const config& cfg) : cfg_(cfg) {
+    // nop
+  }
+
+  bool selected(const string& name) const {
+    return name.find(cfg_.filter) != string::npos;
+  }
+
+  void run(const string& name, const string& unit, sample_fun f) {
+    if (!selected(name))
+      return;
+    cerr << "run " << name << endl;
+    vector<double> xs;
+    for (size_t i = 0; i < cfg_.warmup; ++i)
+      f(xs);
+    xs.clear();
+    for (size_t i = 0; i < cfg_.samples; ++i)
+      f(xs);
+    if (!xs.empty())
+      results_.emplace_back(summarize(name, unit, std::move(xs)));
+  }
+
+  void print_json(std::ostream& out) const {
+    out << "{\n  \"samples\": " << cfg_.samples
+        << ",\n  \"scale\": " << cfg_.scale
+        << ",\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results_.size(); ++i) {
+      auto& x = results_[i];
+      out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+      print_json_string(out, x.name);
+      out << ", \"unit\": ";
+      print_json_string(out, x.unit);
+      out << ", \"samples\": " << x.samples << ", \"min\": " << x.min
+          << ", \"p50\": " << x.p50 << ", \"p90\": " << x.p90
+          << ", \"p99\": " << x.p99 << ", \"max\": " << x.max
+          << ", \"mean\": " << x.mean << "}";
+    }
+    out << "\n  ]\n}" << endl;
+  }
+
+  void print_csv(std::ostream& out) const {
+    out << "name,unit,samples,min,p50,p90,p99,max,mean" << endl;
+    for (auto& x : results_) {
+      print_csv_field(out, x.name);
+      out << ',';
+      print_csv_field(out, x.unit);
+      out << ',' << x.samples << ',' << x.min << ',' << x.p50 << ',' << x.p90
+          << ',' << x.p99 << ',' << x.max << ',' << x.mean << endl;
+    }
+  }
+
+  void print(std::ostream& out) const {
+    if (cfg_.format == "csv")
+      print_csv(out);
+    else
+      print_json(out);
+  }
+
+private:
+  const config& cfg_;
+  vector<summary> results_;
+};
+
+// -- actors -------------------------------------------------------------------
+
+struct counter_state {
+  size_t count = 0;
+};
+
+// counts integers and notifies `listener` after receiving `expected` of them
+behavior counter(stateful_actor<counter_state>* self, size_t expected,
+                 actor listener) {
+  return {
+    [=](int) {
+      if (++self->state.count == expected)
+        self->send(listener, ok_atom::value);
+    }
+  };
+}
+
+// counts integers and reports its count on request
+behavior remote_counter(stateful_actor<counter_state>* self) {
+  return {
+    [=](int) {
+      ++self->state.count;
+    },
+    [=](get_atom) {
+      auto result = self->state.count;
+      self->state.count = 0;
+      return result;
+    }
+  };
+}
+
+// sends `n` integers round-robin to the actors in the first message it receives
+behavior sender(event_based_actor* self, size_t n) {
+  return {
+    [=](const vector<actor>& dest) {
+      for (size_t i = 0; i < n; ++i)
+        self->send(dest[i % dest.size()], static_cast<int>(i));
+      self->quit();
+    }
+  };
+}
+
+behavior echo() {
+  return {
+    [](int x) {
+      return x;
+    }
+  };
+}
+
+// matches integers only with its last handler
+behavior dispatcher(stateful_actor<counter_state>* self, size_t expected,
+                    actor listener) {
+  return {
+    [](a01_atom) {}, [](a02_atom) {}, [](a03_atom) {}, [](a04_atom) {},
+    [](a05_atom) {}, [](a06_atom) {}, [](a07_atom) {}, [](a08_atom) {},
+    [](a09_atom) {}, [](a10_atom) {}, [](a11_atom) {}, [](a12_atom) {},
+    [](a13_atom) {}, [](a14_atom) {}, [](a15_atom) {},
+    [=](int) {
+      if (++self->state.count == expected)
+        self->send(listener, ok_atom::value);
+    }
+  };
+}
+
+behavior int_source(event_based_actor* self) {
+  return {
+    [=](size_t n) -> stream<int> {
+      return self->make_source(
+        std::make_tuple(),
+        [](size_t& pos) {
+          pos = 0;
+        },
+        [=](size_t& pos, downstream<int>& out, size_t hint) {
+          auto k = std::min(hint, n - pos);
+          for (size_t i = 0; i < k; ++i)
+            out.push(static_cast<int>(pos++));
+        },
+        [=](const size_t& pos) {
+          return pos == n;
+        }
+      );
+    }
+  };
+}
+
+behavior int_stage(event_based_actor* self) {
+  return {
+    [=](stream<int>& in) {
+      return self->make_stage(
+        in,
+        [](unit_t&) {
+          // nop
+        },
+        [](unit_t&, downstream<int>& out, int x) {
+          out.push(x * 2);
+        },
+        [](unit_t&) {
+          // nop
+        }
+      );
+    }
+  };
+}
+
+behavior int_sink(event_based_actor* self) {
+  return {
+    [=](stream<int>& in) {
+      return self->make_sink(
+        in,
+        [](size_t& num) {
+          num = 0;
+        },
+        [](size_t& num, int) {
+          ++num;
+        },
+        [](size_t& num) {
+          return num;
+        }
+      );
+    }
+  };
+}
+
+// -- benchmarks ---------------------------------------------------------------
+
+void await_ok(scoped_actor& self, size_t n) {
+  for (size_t i = 0; i < n; ++i)
+    self->receive([](ok_atom) {});
+}
+
+void spawn_benchmarks(driver& d, actor_system& sys, size_t scale) {
+  auto n = 1000 * scale;
+  d.run("spawn.terminate", "ns/op", [&, n](vector<double>& xs) {
+    scoped_actor self{sys};
+    auto t0 = clock_type::now();
+    for (size_t i = 0; i < n; ++i)
+      sys.spawn([](event_based_actor* ptr, actor listener) {
+        ptr->send(listener, ok_atom::value);
+      }, self);
+    await_ok(self, n);
+    xs.push_back(ns_since(t0) / n);
+  });
+}
+
+void send_benchmarks(driver& d, actor_system& sys, size_t scale) {
+  auto n = 100000 * scale;
+  d.run("send.1:1", "ns/msg", [&, n](vector<double>& xs) {
+    scoped_actor self{sys};
+    auto rcv = sys.spawn(counter, n, actor{self});
+    auto t0 = clock_type::now();
+    for (size_t i = 0; i < n; ++i)
+      self->send(rcv, static_cast<int>(i));
+    await_ok(self, 1);
+    xs.push_back(ns_since(t0) / n);
+    anon_send_exit(rcv, exit_reason::user_shutdown);
+  });
+  size_t num_peers = 8;
+  d.run("send.N:1", "ns/msg", [&, n, num_peers](vector<double>& xs) {
+    scoped_actor self{sys};
+    auto rcv = sys.spawn(counter, n, actor{self});
+    vector<actor> senders;
+    for (size_t i = 0; i < num_peers; ++i)
+      senders.emplace_back(sys.spawn(sender, n / num_peers));
+    auto t0 = clock_type::now();
+    for (auto& x : senders)
+      self->send(x, vector<actor>{rcv});
+    await_ok(self, 1);
+    xs.push_back(ns_since(t0) / n);
+    anon_send_exit(rcv, exit_reason::user_shutdown);
+  });
+  d.run("send.1:N", "ns/msg", [&, n, num_peers](vector<double>& xs) {
+    scoped_actor self{sys};
+    vector<actor> receivers;
+    for (size_t i = 0; i < num_peers; ++i)
+      receivers.emplace_back(sys.spawn(counter, n / num_peers, actor{self}));
+    auto snd = sys.spawn(sender, n);
+    auto t0 = clock_type::now();
+    self->send(snd, receivers);
+    await_ok(self, num_peers);
+    xs.push_back(ns_since(t0) / n);
+    for (auto& x : receivers)
+      anon_send_exit(x, exit_reason::user_shutdown);
+  });
+  d.run("dispatch.16_handlers", "ns/msg", [&, n](vector<double>& xs) {
+    scoped_actor self{sys};
+    auto rcv = sys.spawn(dispatcher, n, actor{self});
+    auto t0 = clock_type::now();
+    for (size_t i = 0; i < n; ++i)
+      self->send(rcv, static_cast<int>(i));
+    await_ok(self, 1);
+    xs.push_back(ns_since(t0) / n);
+    anon_send_exit(rcv, exit_reason::user_shutdown);
+  });
+}
+
+// measures the latency of each individual request
+void request_benchmark(driver& d, const string& name, actor_system& sys,
+                       const actor& dest, size_t n) {
+  d.run(name, "ns/roundtrip", [&, n](vector<double>& xs) {
+    scoped_actor self{sys};
+    for (size_t i = 0; i < n; ++i) {
+      auto t0 = clock_type::now();
+      self->request(dest, infinite, static_cast<int>(i)).receive(
+        [&](int) {
+          xs.push_back(ns_since(t0));
+        },
+        [&](error& err) {
+          cerr << "request failed: " << sys.render(err) << endl;
+        }
+      );
+    }
+  });
+}
+
+template <class T>
+void serialization_benchmark(driver& d, const string& name,
+                             actor_system& sys, T x, size_t n) {
+  vector<char> buf;
+  d.run("serialize." + name + ".encode", "ns/op", [&, n](vector<double>& xs) {
+    auto t0 = clock_type::now();
+    for (size_t i = 0; i < n; ++i) {
+      buf.clear();
+      binary_serializer sink{sys, buf};
+      sink(x);
+    }
+    xs.push_back(ns_since(t0) / n);
+  });
+  d.run("serialize." + name + ".decode", "ns/op", [&, n](vector<double>& xs) {
+    T y;
+    auto t0 = clock_type::now();
+    for (size_t i = 0; i < n; ++i) {
+      binary_deserializer source{sys, buf};
+      source(y);
+    }
+    xs.push_back(ns_since(t0) / n);
+  });
+}
+
+void serialization_benchmarks(driver& d, actor_system& sys, size_t scale) {
+  auto n = 10000 * scale;
+  vector<int64_t> ints(1000);
+  std::iota(ints.begin(), ints.end(), 0);
+  serialization_benchmark(d, "vector<int64_t>[1000]", sys, ints, n);
+  vector<double> doubles(1000);
+  std::iota(doubles.begin(), doubles.end(), 0.5);
+  serialization_benchmark(d, "vector<double>[1000]", sys, doubles, n);
+  serialization_benchmark(d, "string[1000]", sys, string(1000, 'x'), n);
+  serialization_benchmark(d, "message(int,string,double)", sys,
+                          make_message(42, string("hello world"), 4.2), n);
+}
+
+void basp_benchmarks(driver& d, actor_system& sys, size_t scale) {
+  if (!d.selected("basp.loopback.latency")
+      && !d.selected("basp.loopback.throughput"))
+    return;
+  // a second actor system in the same process acts as remote node
+  actor_system_config peer_cfg;
+  peer_cfg.load<io::middleman>();
+  actor_system peer{peer_cfg};
+  auto srv = peer.spawn(echo);
+  auto cnt = peer.spawn(remote_counter);
+  auto srv_port = peer.middleman().publish(srv, 0, "127.0.0.1");
+  auto cnt_port = peer.middleman().publish(cnt, 0, "127.0.0.1");
+  if (!srv_port || !cnt_port) {
+    cerr << "cannot publish BASP benchmark actors" << endl;
+    return;
+  }
+  auto srv_proxy = sys.middleman().remote_actor("127.0.0.1", *srv_port);
+  auto cnt_proxy = sys.middleman().remote_actor("127.0.0.1", *cnt_port);
+  if (!srv_proxy || !cnt_proxy) {
+    cerr << "cannot connect to BASP benchmark actors" << endl;
+    return;
+  }
+  request_benchmark(d, "basp.loopback.latency", sys,
+                    actor_cast<actor>(*srv_proxy), 1000 * scale);
+  auto n = 100000 * scale;
+  auto dest = actor_cast<actor>(*cnt_proxy);
+  d.run("basp.loopback.throughput", "ns/msg", [&, n](vector<double>& xs) {
+    scoped_actor self{sys};
+    auto t0 = clock_type::now();
+    for (size_t i = 0; i < n; ++i)
+      self->send(dest, static_cast<int>(i));
+    // BASP preserves the order of messages on a connection
+    self->request(dest, infinite, get_atom::value).receive(
+      [&](size_t count) {
+        if (count != n)
+          cerr << "lost messages: " << (n - count) << endl;
+        xs.push_back(ns_since(t0) / n);
+      },
+      [&](error& err) {
+        cerr << "request failed: " << sys.render(err) << endl;
+      }
+    );
+  });
+  anon_send_exit(srv, exit_reason::user_shutdown);
+  anon_send_exit(cnt, exit_reason::user_shutdown);
+}
+
+void stream_benchmarks(driver& d, actor_system& sys, size_t scale) {
+  auto n = 100000 * scale;
+  d.run("stream.pipeline", "ns/element", [&, n](vector<double>& xs) {
+    scoped_actor self{sys};
+    auto pipeline = sys.spawn(int_sink) * sys.spawn(int_stage)
+                    * sys.spawn(int_source);
+    auto t0 = clock_type::now();
+    self->request(pipeline, infinite, n).receive(
+      [&](size_t) {
+        xs.push_back(ns_since(t0) / n);
+      },
+      [&](error& err) {
+        cerr << "stream failed: " << sys.render(err) << endl;
+      }
+    );
+  });
+}
+
+void caf_main(actor_system& sys, const config& cfg) {
+  driver d{cfg};
+  auto scale = std::max(cfg.scale, size_t{1});
+  spawn_benchmarks(d, sys, scale);
+  send_benchmarks(d, sys, scale);
+  auto local_echo = sys.spawn(echo);
+  request_benchmark(d, "request.local.latency", sys, local_echo, 1000 * scale);
+  anon_send_exit(local_echo, exit_reason::user_shutdown);
+  serialization_benchmarks(d, sys, scale);
+  basp_benchmarks(d, sys, scale);
+  stream_benchmarks(d, sys, scale);
+  if (cfg.output.empty()) {
+    d.print(cout);
+  } else {
+    std::ofstream out{cfg.output};
+    d.print(out);
+  }
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN(io::middleman)
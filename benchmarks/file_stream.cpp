@@ -0,0 +1,107 @@
+// Measures the ingest rate of a memory-mapped file source that streams
+// fixed-size records into a counting sink.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+
+#include "caf/all.hpp"
+#include "caf/file_stream.hpp"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using format = fixed_size_records<uint64_t>;
+
+behavior reader(event_based_actor* self) {
+  return {
+    [=](const std::string& path) -> stream<uint64_t> {
+      return make_file_source<format>(self, path);
+    }
+  };
+}
+
+behavior counter(event_based_actor* self) {
+  return {
+    [=](stream<uint64_t>& in) {
+      return self->make_sink(
+        in,
+        [](uint64_t& num) {
+          num = 0;
+        },
+        [](uint64_t& num, uint64_t) {
+          ++num;
+        },
+        [](uint64_t& num) {
+          return num;
+        }
+      );
+    }
+  };
+}
+
+class config : public actor_system_config {
+public:
+  std::string file;
+  size_t megabytes = 256;
+
+  config() {
+    opt_group{custom_options_, "global"}
+    .add(file, "file,f", "read from given file instead of a generated one")
+    .add(megabytes, "megabytes,m", "set size of the generated file in MB");
+  }
+};
+
+bool generate(const std::string& path, size_t megabytes) {
+  std::ofstream out{path, std::ios::binary};
+  std::vector<uint64_t> chunk(1024 * 1024 / sizeof(uint64_t));
+  uint64_t x = 0;
+  for (size_t i = 0; i < megabytes && out; ++i) {
+    for (auto& y : chunk)
+      y = x++;
+    out.write(reinterpret_cast<const char*>(chunk.data()),
+              static_cast<std::streamsize>(chunk.size() * sizeof(uint64_t)));
+  }
+  return static_cast<bool>(out);
+}
+
+void caf_main(actor_system& sys, const config& cfg) {
+  auto path = cfg.file;
+  if (path.empty()) {
+    path = "caf-file-stream-benchmark.bin";
+    if (!generate(path, cfg.megabytes)) {
+      cerr << "cannot generate " << path << endl;
+      return;
+    }
+  }
+  auto pipeline = sys.spawn(counter) * sys.spawn(reader);
+  scoped_actor self{sys};
+  auto t0 = std::chrono::steady_clock::now();
+  self->request(pipeline, infinite, path).receive(
+    [&](uint64_t num) {
+      auto t1 = std::chrono::steady_clock::now();
+      std::chrono::duration<double> secs = t1 - t0;
+      auto bytes = static_cast<double>(num * sizeof(uint64_t));
+      cout << "records:      " << num << endl
+           << "seconds:      " << secs.count() << endl
+           << "GB/s:         " << (bytes / secs.count() / 1e9) << endl;
+    },
+    [&](error& err) {
+      cerr << "error: " << sys.render(err) << endl;
+    }
+  );
+  if (cfg.file.empty())
+    remove(path.c_str());
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
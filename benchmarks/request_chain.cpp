@@ -0,0 +1,155 @@
+// Compares request chains written with nested `request(...).then(...)`
+// continuations against the same chains written with `co_await`. Each chain
+// sends `depth` requests one after another to a worker before answering its
+// client, all chains run concurrently. Build with `-std=c++20` to include
+// the coroutine variant.
+
+#include <chrono>
+#include <memory>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using add_atom = atom_constant<atom("add")>;
+
+behavior adder() {
+  return {
+    [](add_atom, int x) {
+      return x + 1;
+    }
+  };
+}
+
+// continues the chain in the response handler of the previous step
+void then_step(event_based_actor* self, actor worker, int depth, int x,
+               response_promise rp) {
+  if (depth == 0) {
+    rp.deliver(x);
+    return;
+  }
+  self->request(worker, infinite, add_atom::value, x).then(
+    [=](int y) {
+      then_step(self, worker, depth - 1, y, rp);
+    },
+    [=](error& err) mutable {
+      rp.deliver(std::move(err));
+    }
+  );
+}
+
+behavior then_chain(event_based_actor* self, actor worker, int depth) {
+  return {
+    [=](int x) {
+      auto rp = self->make_response_promise();
+      then_step(self, worker, depth, x, rp);
+      return rp;
+    }
+  };
+}
+
+#ifdef CAF_HAS_COROUTINES
+
+behavior coroutine_chain(event_based_actor* self, actor worker, int depth) {
+  return {
+    [=](int x) -> actor_task {
+      auto rp = self->make_response_promise();
+      for (int i = 0; i < depth; ++i) {
+        auto y = co_await self->request(worker, infinite, add_atom::value, x);
+        if (!y) {
+          rp.deliver(y.error());
+          co_return;
+        }
+        x = y->get_as<int>(0);
+      }
+      rp.deliver(x);
+    }
+  };
+}
+
+#endif // CAF_HAS_COROUTINES
+
+class config : public actor_system_config {
+public:
+  int chains = 100000;
+  int depth = 5;
+
+  config() {
+    opt_group{custom_options_, "global"}
+    .add(chains, "chains,c", "set number of request chains")
+    .add(depth, "depth,d", "set number of requests per chain");
+  }
+};
+
+// starts all chains at once from an event-based actor to measure the cost
+// per chain rather than the latency of waking up a blocking client
+behavior driver(event_based_actor* self, actor chain, int chains, int depth) {
+  return {
+    [=](ok_atom) {
+      auto rp = self->make_response_promise();
+      auto pending = std::make_shared<int>(chains);
+      auto failed = std::make_shared<int>(0);
+      auto done = [=]() mutable {
+        if (--*pending == 0)
+          rp.deliver(*failed);
+      };
+      for (int i = 0; i < chains; ++i)
+        self->request(chain, infinite, i).then(
+          [=](int x) mutable {
+            if (x != i + depth)
+              ++*failed;
+            done();
+          },
+          [=](error&) mutable {
+            ++*failed;
+            done();
+          }
+        );
+      return rp;
+    }
+  };
+}
+
+// prints the average time per chain
+void run(actor_system& sys, const config& cfg, const char* name,
+         const actor& chain) {
+  scoped_actor self{sys};
+  auto drv = sys.spawn(driver, chain, cfg.chains, cfg.depth);
+  auto t0 = std::chrono::steady_clock::now();
+  self->request(drv, infinite, ok_atom::value).receive(
+    [&](int failed) {
+      auto t1 = std::chrono::steady_clock::now();
+      std::chrono::duration<double, std::nano> ns = t1 - t0;
+      cout << name << ": " << (ns.count() / cfg.chains) << " ns/chain";
+      if (failed > 0)
+        cout << " (" << failed << " failed)";
+      cout << endl;
+    },
+    [&](error& err) {
+      cout << name << ": " << sys.render(err) << endl;
+    }
+  );
+  anon_send_exit(drv, exit_reason::user_shutdown);
+  anon_send_exit(chain, exit_reason::user_shutdown);
+}
+
+void caf_main(actor_system& sys, const config& cfg) {
+  auto worker = sys.spawn(adder);
+  run(sys, cfg, "then     ", sys.spawn(then_chain, worker, cfg.depth));
+# ifdef CAF_HAS_COROUTINES
+  run(sys, cfg, "co_await ", sys.spawn(coroutine_chain, worker, cfg.depth));
+# else
+  cout << "co_await : not available, requires C++20 coroutines" << endl;
+# endif // CAF_HAS_COROUTINES
+  anon_send_exit(worker, exit_reason::user_shutdown);
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
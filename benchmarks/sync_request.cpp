@@ -0,0 +1,101 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+// Compares the cost of issuing requests from threads that are not actors,
+// i.e., per-call `scoped_actor`, `function_view`, and `sync_requester`.
+
+#include <chrono>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using calculator = typed_actor<replies_to<int, int>::with<int>>;
+
+calculator::behavior_type adder() {
+  return {
+    [](int x, int y) {
+      return x + y;
+    }
+  };
+}
+
+class config : public actor_system_config {
+public:
+  int requests = 100000;
+
+  config() {
+    opt_group{custom_options_, "global"}
+    .add(requests, "requests,r", "set number of requests per variant");
+  }
+};
+
+// prints the average time per request
+template <class F>
+void run(const config& cfg, const char* name, F f) {
+  int failed = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < cfg.requests; ++i)
+    if (f(i) != i + 1)
+      ++failed;
+  auto t1 = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::nano> ns = t1 - t0;
+  cout << name << ": " << (ns.count() / cfg.requests) << " ns/request";
+  if (failed > 0)
+    cout << " (" << failed << " failed)";
+  cout << endl;
+}
+
+void caf_main(actor_system& sys, const config& cfg) {
+  auto dest = sys.spawn(adder);
+  run(cfg, "scoped_actor  ", [&](int x) {
+    scoped_actor self{sys, true};
+    int result = 0;
+    self->request(dest, infinite, x, 1).receive(
+      [&](int y) {
+        result = y;
+      },
+      [&](error&) {
+        // nop
+      }
+    );
+    return result;
+  });
+  run(cfg, "function_view ", [&](int x) {
+    auto f = make_function_view(dest);
+    auto res = f(x, 1);
+    return res ? *res : 0;
+  });
+  sync_requester self{sys};
+  run(cfg, "sync_requester", [&](int x) {
+    auto res = self.request(dest, infinite, x, 1).get();
+    return res ? *res : 0;
+  });
+  anon_send_exit(dest, exit_reason::user_shutdown);
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
@@ -0,0 +1,141 @@
+// Measures the throughput of a windowing stage that aggregates elements
+// per key over tumbling windows. Each window sees `keys` distinct keys.
+
+#include <deque>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using std::chrono::microseconds;
+
+struct event {
+  uint64_t key;
+  int64_t time_us;
+};
+
+template <class Inspector>
+typename Inspector::result_type inspect(Inspector& f, event& x) {
+  return f(meta::type_name("event"), x.key, x.time_us);
+}
+
+struct counting_aggregator {
+  using input_type = event;
+  using accumulator_type = uint64_t;
+  using output_type = uint64_t;
+
+  void add(uint64_t& acc, const event&) {
+    ++acc;
+  }
+
+  void merge(uint64_t& acc, uint64_t x) {
+    acc += x;
+  }
+
+  uint64_t emit(uint64_t, uint64_t acc, timestamp) {
+    return acc;
+  }
+};
+
+behavior source(event_based_actor* self, uint64_t keys) {
+  return {
+    [=](uint64_t num) -> stream<event> {
+      return self->make_source(
+        std::make_tuple(),
+        [](uint64_t& pos) {
+          pos = 0;
+        },
+        [=](uint64_t& pos, downstream<event>& out, size_t hint) {
+          auto n = std::min(static_cast<uint64_t>(hint), num - pos);
+          for (uint64_t i = 0; i < n; ++i, ++pos)
+            out.push(event{pos % keys, static_cast<int64_t>(pos)});
+        },
+        [=](const uint64_t& pos) {
+          return pos == num;
+        }
+      );
+    }
+  };
+}
+
+behavior window(event_based_actor* self, uint64_t keys) {
+  return {
+    [=](stream<event>& in) {
+      return self->make_window_stage(
+        in,
+        tumbling_window(microseconds(keys)),
+        [](const event& x) {
+          return x.key;
+        },
+        [](const event& x) {
+          return timestamp{microseconds(x.time_us)};
+        },
+        counting_aggregator{}
+      );
+    }
+  };
+}
+
+behavior sink(event_based_actor* self) {
+  return {
+    [=](stream<uint64_t>& in) {
+      return self->make_sink(
+        in,
+        [](uint64_t& total) {
+          total = 0;
+        },
+        [](uint64_t& total, uint64_t x) {
+          total += x;
+        },
+        [](uint64_t& total) {
+          return total;
+        }
+      );
+    }
+  };
+}
+
+class config : public actor_system_config {
+public:
+  uint64_t items = 10000000;
+  uint64_t keys = 1000000;
+
+  config() {
+    opt_group{custom_options_, "global"}
+    .add(items, "items,i", "set number of stream elements")
+    .add(keys, "keys,k", "set number of distinct keys per window");
+  }
+};
+
+void caf_main(actor_system& sys, const config& cfg) {
+  auto pipeline = sys.spawn(sink) * sys.spawn(window, cfg.keys)
+                  * sys.spawn(source, cfg.keys);
+  scoped_actor self{sys};
+  auto t0 = std::chrono::steady_clock::now();
+  self->request(pipeline, infinite, cfg.items).receive(
+    [&](uint64_t total) {
+      auto t1 = std::chrono::steady_clock::now();
+      std::chrono::duration<double> secs = t1 - t0;
+      cout << "items:        " << cfg.items << endl
+           << "keys:         " << cfg.keys << endl
+           << "aggregated:   " << total << endl
+           << "seconds:      " << secs.count() << endl
+           << "items/sec:    " << (cfg.items / secs.count()) << endl;
+    },
+    [&](error& err) {
+      cout << "error: " << sys.render(err) << endl;
+    }
+  );
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
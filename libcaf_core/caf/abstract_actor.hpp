@@ -30,6 +30,7 @@
 #include <type_traits>
 
 #include "caf/fwd.hpp"
+#include "caf/locks.hpp"
 #include "caf/node_id.hpp"
 #include "caf/attachable.hpp"
 #include "caf/message_id.hpp"
@@ -40,6 +41,7 @@
 #include "caf/abstract_channel.hpp"
 
 #include "caf/detail/disposer.hpp"
+#include "caf/detail/shared_spinlock.hpp"
 #include "caf/detail/type_traits.hpp"
 #include "caf/detail/functor_attachable.hpp"
 
@@ -78,6 +80,12 @@ public:
   /// This `enqueue` variant allows to define forwarding chains.
   virtual void enqueue(mailbox_element_ptr what, execution_unit* host) = 0;
 
+  /// Enqueues all elements of `xs` in order. The default implementation
+  /// calls `enqueue` for each element, while local actors publish the
+  /// entire batch to their mailbox at once and get scheduled at most once.
+  virtual void enqueue_batch(std::vector<mailbox_element_ptr> xs,
+                             execution_unit* host);
+
   /// Attaches `ptr` to this actor. The actor will call `ptr->detach(...)` on
   /// exit, or immediately if it already finished execution.
   virtual void attach(attachable_ptr ptr) = 0;
@@ -174,14 +182,14 @@ public:
   /// Calls `fun` with exclusive access to an actor's state.
   template <class F>
   auto exclusive_critical_section(F fun) -> decltype(fun()) {
-    std::unique_lock<std::mutex> guard{mtx_};
+    std::unique_lock<detail::shared_spinlock> guard{mtx_};
     return fun();
   }
 
   /// Calls `fun` with readonly access to an actor's state.
   template <class F>
   auto shared_critical_section(F fun) -> decltype(fun()) {
-    std::unique_lock<std::mutex> guard{mtx_};
+    shared_lock<detail::shared_spinlock> guard{mtx_};
     return fun();
   }
 
@@ -197,12 +205,12 @@ public:
     // actor with the lowest address.
     CAF_ASSERT(p1 != p2 && p1 != nullptr && p2 != nullptr);
     if (p1 < p2) {
-      std::unique_lock<std::mutex> guard1{p1->mtx_};
-      std::unique_lock<std::mutex> guard2{p2->mtx_};
+      std::unique_lock<detail::shared_spinlock> guard1{p1->mtx_};
+      std::unique_lock<detail::shared_spinlock> guard2{p2->mtx_};
       return fun();
     }
-    std::unique_lock<std::mutex> guard1{p2->mtx_};
-    std::unique_lock<std::mutex> guard2{p1->mtx_};
+    std::unique_lock<detail::shared_spinlock> guard1{p2->mtx_};
+    std::unique_lock<detail::shared_spinlock> guard2{p1->mtx_};
     return fun();
   }
 
@@ -214,7 +222,9 @@ protected:
 
   // Guards potentially concurrent access to the state. For example,
   // `exit_state_`, `attachables_`, and `links_` in a `monitorable_actor`.
-  mutable std::mutex mtx_;
+  // All critical sections are short and never block, hence a spinlock
+  // suffices and keeps actors small compared to a `std::mutex`.
+  mutable detail::shared_spinlock mtx_;
 
 private:
   // prohibit copies, assigments, and heap allocations
@@ -82,6 +82,9 @@ public:
   void enqueue(strong_actor_ptr src, message_id mid, message content,
                execution_unit* eu) override;
 
+  void enqueue_batch(std::vector<mailbox_element_ptr> xs,
+                     execution_unit* eu) override;
+
   void launch(execution_unit* eu, bool lazy, bool hide) override;
 
   void on_exit() override;
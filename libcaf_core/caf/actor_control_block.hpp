@@ -21,6 +21,7 @@
 #define CAF_ACTOR_CONTROL_BLOCK_HPP
 
 #include <atomic>
+#include <vector>
 
 #include "caf/fwd.hpp"
 #include "caf/error.hpp"
@@ -139,6 +140,9 @@ public:
 
   void enqueue(mailbox_element_ptr what, execution_unit* host);
 
+  void enqueue_batch(std::vector<mailbox_element_ptr> xs,
+                     execution_unit* host);
+
   /// @endcond
 };
 
@@ -32,7 +32,7 @@
 #include "caf/abstract_actor.hpp"
 #include "caf/actor_control_block.hpp"
 
-#include "caf/detail/shared_spinlock.hpp"
+#include "caf/detail/concurrent_actor_map.hpp"
 
 namespace caf {
 
@@ -91,19 +91,19 @@ private:
   // Stops this component.
   void stop();
 
-  using entries = std::unordered_map<actor_id, strong_actor_ptr>;
-
   actor_registry(actor_system& sys);
 
   std::atomic<size_t> running_;
+
+  // number of threads in `await_running_count_equal`, allows `dec_running`
+  // to skip the mutex unless someone is waiting
+  mutable std::atomic<size_t> running_waiters_;
   mutable std::mutex running_mtx_;
   mutable std::condition_variable running_cv_;
 
-  mutable detail::shared_spinlock instances_mtx_;
-  entries entries_;
-
-  name_map named_entries_;
-  mutable detail::shared_spinlock named_entries_mtx_;
+  // lookups by ID or name never lock
+  detail::concurrent_actor_map entries_;
+  detail::concurrent_actor_map named_entries_;
 
   actor_system& system_;
 };
@@ -46,9 +46,13 @@
 #include "caf/composable_behavior_based_actor.hpp"
 #include "caf/prohibit_top_level_spawn_marker.hpp"
 
+#include "caf/detail/tracer.hpp"
+#include "caf/detail/private_thread_pool.hpp"
 #include "caf/detail/spawn_fwd.hpp"
 #include "caf/detail/init_fun_factory.hpp"
 
+#include "caf/metrics/registry.hpp"
+
 namespace caf {
 
 using rtti_pair = std::pair<uint16_t, const std::type_info*>;
@@ -255,6 +259,15 @@ public:
   /// Returns the system-wide actor registry.
   actor_registry& registry();
 
+  /// Returns the system-wide metrics registry.
+  metrics::registry& metrics();
+
+  /// Returns the system-wide tracer for sampled messages.
+  detail::tracer& tracer();
+
+  /// Returns the pool of threads for running detached actors.
+  detail::private_thread_pool& private_threads();
+
   /// Returns the system-wide factory for custom types and actors.
   const uniform_type_info_map& types() const;
 
@@ -491,6 +504,10 @@ public:
   /// Blocks the caller until all detached threads are done.
   void await_detached_threads();
 
+  /// Returns whether blocking actors run as fibers unless spawned with the
+  /// `detached` flag.
+  bool blocking_fibers() const;
+
   /// @endcond
 
 private:
@@ -515,7 +532,10 @@ private:
     cfg.flags = has_priority_aware_flag(Os)
                 ? abstract_actor::is_priority_aware_flag
                 : 0;
-    if (has_detach_flag(Os) || std::is_base_of<blocking_actor, C>::value)
+    // blocking actors need their own thread unless they run as fibers
+    if (has_detach_flag(Os)
+        || (std::is_base_of<blocking_actor, C>::value
+            && !blocking_fibers()))
       cfg.flags |= abstract_actor::is_detached_flag;
     if (has_hide_flag(Os))
       cfg.flags |= abstract_actor::is_hidden_flag;
@@ -544,6 +564,9 @@ private:
   node_id node_;
   intrusive_ptr<caf::logger> logger_;
   actor_registry registry_;
+  metrics::registry metrics_;
+  detail::tracer tracer_;
+  detail::private_thread_pool private_threads_;
   group_manager groups_;
   module_array modules_;
   scoped_execution_unit dummy_execution_unit_;
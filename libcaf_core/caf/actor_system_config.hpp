@@ -253,6 +253,16 @@ public:
   bool scheduler_enable_profiling;
   size_t scheduler_profiling_ms_resolution;
   std::string scheduler_profiling_output_file;
+  size_t scheduler_profiling_rusage_interval;
+  size_t scheduler_profiling_buffer_size;
+  size_t scheduler_lane_fairness;
+  size_t scheduler_resume_budget;
+  size_t scheduler_resume_budget_interval;
+  size_t scheduler_detached_min_threads;
+  size_t scheduler_detached_max_threads;
+  size_t scheduler_detached_idle_timeout;
+  bool scheduler_blocking_fibers;
+  size_t scheduler_fiber_stack_size;
 
   // -- config parameters for work-stealing ------------------------------------
 
@@ -273,12 +283,30 @@ public:
   std::string logger_component_filter;
   atom_value logger_verbosity;
   bool logger_inline_output;
+  bool logger_binary_output;
+  size_t logger_ring_size;
 
   // -- backward compatibility -------------------------------------------------
 
   std::string& logger_filename CAF_DEPRECATED;
   std::string& logger_filter CAF_DEPRECATED;
 
+  // -- config parameters for streaming ----------------------------------------
+
+  std::string stream_spill_directory;
+  size_t stream_spill_threshold;
+
+  // -- config parameters for metrics ------------------------------------------
+
+  bool metrics_enable_runtime;
+  std::string metrics_mailbox_latency_actors;
+
+  // -- config parameters for tracing ------------------------------------------
+
+  double tracing_sample_rate;
+  std::string tracing_output_file;
+  size_t tracing_buffer_size;
+
   // -- config parameters of the middleman -------------------------------------
 
   atom_value middleman_network_backend;
@@ -288,6 +316,8 @@ public:
   size_t middleman_heartbeat_interval;
   bool middleman_detach_utility_actors;
   bool middleman_detach_multiplexer;
+  size_t middleman_stream_buffer_limit;
+  uint16_t middleman_metrics_port;
 
   // -- config parameters of the OpenCL module ---------------------------------
 
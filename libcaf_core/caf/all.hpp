@@ -51,6 +51,7 @@
 #include "caf/attachable.hpp"
 #include "caf/message_id.hpp"
 #include "caf/replies_to.hpp"
+#include "caf/coroutine.hpp"
 #include "caf/serializer.hpp"
 #include "caf/actor_proxy.hpp"
 #include "caf/exit_reason.hpp"
@@ -62,6 +63,7 @@
 #include "caf/scoped_actor.hpp"
 #include "caf/actor_ostream.hpp"
 #include "caf/function_view.hpp"
+#include "caf/sync_requester.hpp"
 #include "caf/index_mapping.hpp"
 #include "caf/spawn_options.hpp"
 #include "caf/abstract_actor.hpp"
@@ -76,6 +78,7 @@
 #include "caf/behavior_policy.hpp"
 #include "caf/message_builder.hpp"
 #include "caf/message_handler.hpp"
+#include "caf/response_future.hpp"
 #include "caf/response_handle.hpp"
 #include "caf/fused_scatterer.hpp"
 #include "caf/random_gatherer.hpp"
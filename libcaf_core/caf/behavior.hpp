@@ -96,6 +96,12 @@ public:
     return impl_->timeout();
   }
 
+  /// Returns whether this behavior has a match case for messages with type
+  /// token `tt`, i.e., whether invoking it with such a message can succeed.
+  inline bool may_match(uint32_t tt) const {
+    return impl_ && impl_->may_match(tt);
+  }
+
   /// Runs this handler and returns its (optional) result.
   inline optional<message> operator()(message& xs) {
     return impl_ ? impl_->invoke(xs) : none;
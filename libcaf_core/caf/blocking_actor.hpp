@@ -21,6 +21,7 @@
 #define CAF_BLOCKING_ACTOR_HPP
 
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 
@@ -185,6 +186,9 @@ public:
 
   void enqueue(mailbox_element_ptr, execution_unit*) override;
 
+  void enqueue_batch(std::vector<mailbox_element_ptr>,
+                     execution_unit*) override;
+
   // -- overridden functions of local_actor ------------------------------------
 
   const char* name() const override;
@@ -349,9 +353,20 @@ public:
   void receive_impl(receive_cond& rcc, message_id mid,
                     detail::blocking_behavior& bhvr);
 
+  /// Initializes the actor, runs `act()` and `on_exit()`, and cleans up
+  /// afterwards. Called from the actor's thread or fiber.
+  void execute();
+
   /// @endcond
 
 private:
+  // enqueues the fiber of this actor to `eu` or to the scheduler
+  void schedule_fiber(execution_unit* eu);
+
+  // stores the next message in `fiber_pending_`, switching back to the worker
+  // while the mailbox is empty; returns `false` if `timeout` expires first
+  bool fiber_await_data(const timeout_type* timeout);
+
   size_t attach_functor(const actor&);
 
   size_t attach_functor(const actor_addr&);
@@ -370,6 +385,23 @@ private:
       res += attach_functor(x);
     return res;
   }
+
+  // guards the mailbox while the actor waits for new messages; only blocking
+  // actors need these, scheduled actors get away with the spinlock in
+  // `abstract_actor`
+  std::mutex mailbox_mtx_;
+  std::condition_variable mailbox_cv_;
+
+  // runs the actor on the workers of the scheduler if
+  // `scheduler.blocking-fibers` is set, `nullptr` otherwise
+  std::unique_ptr<detail::blocking_fiber> fiber_;
+
+  // next message of a fiber, taken from the mailbox while filtering out
+  // timeout messages that implement `await_data(timeout)` for fibers
+  mailbox_element_ptr fiber_pending_;
+
+  // ID of the last timeout requested by the fiber
+  uint32_t fiber_timeout_id_;
 };
 
 } // namespace caf
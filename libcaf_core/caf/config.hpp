@@ -31,6 +31,10 @@
 // CAF_ENABLE_RUNTIME_CHECKS:
 //   - check requirements at runtime
 //
+// CAF_ENABLE_MAILBOX_LATENCY:
+//   - stamp mailbox elements of scheduled actors with their enqueue time
+//     to measure the time messages spend waiting in a mailbox
+//
 // CAF_LOG_LEVEL:
 //   - denotes the amount of logging, ranging from error messages only (0)
 //     to complete traces (4)
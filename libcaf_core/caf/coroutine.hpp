@@ -0,0 +1,170 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_COROUTINE_HPP
+#define CAF_COROUTINE_HPP
+
+#include "caf/config.hpp"
+
+// coroutines require C++20, e.g., `-std=c++20` on GCC >= 10 or Clang >= 14
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#  if __has_include(<coroutine>)
+#    define CAF_HAS_COROUTINES
+#  endif
+#endif
+
+#ifdef CAF_HAS_COROUTINES
+
+#include <cstddef>
+#include <utility>
+#include <exception>
+#include <coroutine>
+
+#include "caf/message.hpp"
+#include "caf/expected.hpp"
+#include "caf/message_id.hpp"
+#include "caf/response_handle.hpp"
+#include "caf/scheduled_actor.hpp"
+
+#include "caf/detail/response_result.hpp"
+#include "caf/detail/coroutine_frame_pool.hpp"
+#include "caf/detail/coroutine_response_slot.hpp"
+
+namespace caf {
+
+/// Return type of message handlers that suspend on responses, e.g.:
+///
+/// ~~~
+/// [=](int x) -> actor_task {
+///   auto y = co_await self->request(worker, infinite, x);
+///   if (y)
+///     aout(self) << "result: " << to_string(*y) << endl;
+/// }
+/// ~~~
+///
+/// The coroutine starts right away inside the handler and resumes in the
+/// context of its actor once the response arrives, i.e., the coroutine never
+/// runs concurrently to other handlers of the actor. Frames come from the
+/// coroutine frame pool of the actor. Handlers returning an `actor_task`
+/// never respond implicitly, handlers for requests need to call
+/// `make_response_promise()` before the first `co_await` instead.
+/// Terminating the actor destroys all of its suspended coroutines.
+class actor_task {
+public:
+  class promise_type {
+  public:
+    actor_task get_return_object() noexcept {
+      return {};
+    }
+
+    std::suspend_never initial_suspend() const noexcept {
+      return {};
+    }
+
+    std::suspend_never final_suspend() const noexcept {
+      return {};
+    }
+
+    void return_void() noexcept {
+      // nop
+    }
+
+    void unhandled_exception() {
+#     ifndef CAF_NO_EXCEPTIONS
+      auto self = detail::current_coroutine_owner();
+      if (self == nullptr)
+        throw;
+      self->handle_coroutine_exception(std::current_exception());
+#     else
+      std::terminate();
+#     endif // CAF_NO_EXCEPTIONS
+    }
+
+    static void* operator new(size_t size) {
+      auto self = detail::current_coroutine_owner();
+      return detail::coroutine_frame_pool::allocate(
+        self != nullptr ? &self->frame_pool() : nullptr, size);
+    }
+
+    static void operator delete(void* ptr) noexcept {
+      detail::coroutine_frame_pool::deallocate(ptr);
+    }
+  };
+};
+
+/// Suspends a coroutine until the response for `request(...)` arrives.
+/// Lives in the coroutine frame and registers itself at the actor, i.e.,
+/// unlike `then`, suspending allocates no `behavior`.
+template <class Self, class Output>
+class response_awaiter final : public detail::coroutine_response_slot {
+public:
+  using result_trait = detail::response_result<Output>;
+
+  using value_type = expected<typename result_trait::type>;
+
+  response_awaiter(message_id mid, Self* self) : mid_(mid), self_(self) {
+    // nop
+  }
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+
+  void await_suspend(std::coroutine_handle<> hdl) {
+    hdl_ = hdl;
+    self_->add_coroutine_response_handler(mid_, this);
+  }
+
+  value_type await_resume() {
+    return result_trait::convert(msg_);
+  }
+
+  void resume(message& x) override {
+    msg_ = std::move(x);
+    // may destroy this object when the coroutine runs to completion
+    hdl_.resume();
+  }
+
+  void discard() override {
+    hdl_.destroy();
+  }
+
+private:
+  message_id mid_;
+  Self* self_;
+  std::coroutine_handle<> hdl_;
+  message msg_;
+};
+
+/// Enables `co_await self->request(...)` in coroutines of event-based actors.
+/// The result is an `expected<T>` for requests with a single result value, an
+/// `expected<std::tuple<Ts...>>` for multiple values, an `expected<void>` for
+/// empty responses, and an `expected<message>` for dynamically typed actors.
+/// @relates response_handle
+template <class Self, class Output>
+response_awaiter<Self, Output>
+operator co_await(const response_handle<Self, Output, false>& x) {
+  return {x.id(), x.self()};
+}
+
+} // namespace caf
+
+#endif // CAF_HAS_COROUTINES
+
+#endif // CAF_COROUTINE_HPP
@@ -313,7 +313,9 @@ public:
   // Applies this processor as Derived to `xs` in saving mode.
   template <class D, class T>
   static typename std::enable_if<
-    D::reads_state && !detail::is_byte_sequence<T>::value,
+    D::reads_state
+    && !detail::is_byte_sequence<T>::value
+    && !detail::is_arithmetic_sequence<T>::value,
     error
   >::type
   apply_sequence(D& self, T& xs) {
@@ -326,7 +328,9 @@ public:
   // Applies this processor as Derived to `xs` in loading mode.
   template <class D, class T>
   static typename std::enable_if<
-    !D::reads_state && !detail::is_byte_sequence<T>::value,
+    !D::reads_state
+    && !detail::is_byte_sequence<T>::value
+    && !detail::is_arithmetic_sequence<T>::value,
     error
   >::type
   apply_sequence(D& self, T& xs) {
@@ -365,6 +369,41 @@ public:
                        [&] { return self.end_sequence(); });
   }
 
+  // Optimized saving for contiguous sequences of arithmetic values.
+  template <class D, class T>
+  static typename std::enable_if<
+    D::reads_state && detail::is_arithmetic_sequence<T>::value,
+    error
+  >::type
+  apply_sequence(D& self, T& xs) {
+    using value_type = typename T::value_type;
+    auto s = xs.size();
+    return error::eval([&] { return self.begin_sequence(s); },
+                       [&] { return s > 0
+                                    ? self.apply_builtin_range(
+                                        builtin_of<value_type>(), s, &xs[0])
+                                    : none; },
+                       [&] { return self.end_sequence(); });
+  }
+
+  // Optimized loading for contiguous sequences of arithmetic values.
+  template <class D, class T>
+  static typename std::enable_if<
+    !D::reads_state && detail::is_arithmetic_sequence<T>::value,
+    error
+  >::type
+  apply_sequence(D& self, T& xs) {
+    using value_type = typename T::value_type;
+    size_t s;
+    return error::eval([&] { return self.begin_sequence(s); },
+                       [&] { xs.resize(s);
+                             return s > 0
+                                    ? self.apply_builtin_range(
+                                        builtin_of<value_type>(), s, &xs[0])
+                                    : none; },
+                       [&] { return self.end_sequence(); });
+  }
+
   /// Applies this processor to a sequence of values.
   template <class T>
   typename std::enable_if<
@@ -551,6 +590,63 @@ protected:
   /// Applies this processor to a single builtin value.
   virtual error apply_builtin(builtin in_out_type, void* in_out) = 0;
 
+  /// Applies this processor to `num` consecutive values of the arithmetic
+  /// builtin type `in_out_type`, starting at `first`. The default
+  /// implementation calls `apply_builtin` for each value individually.
+  virtual error apply_builtin_range(builtin in_out_type, size_t num,
+                                    void* first) {
+    auto ptr = reinterpret_cast<char*>(first);
+    auto step = builtin_size(in_out_type);
+    CAF_ASSERT(step > 0);
+    for (size_t i = 0; i < num; ++i) {
+      auto e = apply_builtin(in_out_type, ptr + i * step);
+      if (e)
+        return e;
+    }
+    return none;
+  }
+
+  /// Returns the size of a single value of the arithmetic builtin type `x`
+  /// or 0 if `x` is not an arithmetic type.
+  static size_t builtin_size(builtin x) {
+    switch (x) {
+      case i8_v:
+      case u8_v:
+        return 1;
+      case i16_v:
+      case u16_v:
+        return 2;
+      case i32_v:
+      case u32_v:
+        return 4;
+      case i64_v:
+      case u64_v:
+        return 8;
+      case float_v:
+        return sizeof(float);
+      case double_v:
+        return sizeof(double);
+      default:
+        return 0;
+    }
+  }
+
+  /// Returns the builtin tag for the arithmetic type `T`.
+  template <class T>
+  static constexpr builtin builtin_of() {
+    using type =
+      typename std::conditional<
+        std::is_floating_point<T>::value,
+        T,
+        typename detail::select_integer_type<
+          static_cast<int>(sizeof(T)) * (std::is_signed<T>::value ? -1 : 1)
+        >::type
+      >::type;
+    static_assert(detail::tl_index_of<builtin_t, type>::value >= 0,
+                  "T not recognized as builtin type");
+    return static_cast<builtin>(detail::tl_index_of<builtin_t, type>::value);
+  }
+
 private:
   template <class T>
   T& deconst(const T& x) {
@@ -73,6 +73,11 @@ public:
 
   optional<message> invoke(type_erased_tuple&);
 
+  /// Returns whether this behavior has at least one match case for
+  /// messages with type token `tt`. Note that the match case may still
+  /// decide to skip the message.
+  virtual bool may_match(uint32_t tt) const;
+
   virtual void handle_timeout();
 
   inline const duration& timeout() const {
@@ -0,0 +1,96 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_BLOCKING_FIBER_HPP
+#define CAF_DETAIL_BLOCKING_FIBER_HPP
+
+#include <memory>
+#include <cstddef>
+
+#include "caf/config.hpp"
+#include "caf/fwd.hpp"
+#include "caf/resumable.hpp"
+
+#if defined(CAF_LINUX) || defined(CAF_MACOS) || defined(CAF_BSD)
+#define CAF_HAS_BLOCKING_FIBERS
+#endif
+
+namespace caf {
+namespace detail {
+
+/// Runs a blocking actor as a stackful fiber on the workers of the
+/// scheduler. Instead of parking its thread, the actor switches back to the
+/// worker whenever its mailbox runs dry and the actor's `enqueue`
+/// reschedules the fiber once new messages arrive. Fiber stacks come from a
+/// process-wide pool and have a guard page below the lowest address to turn
+/// stack overflows into segmentation faults instead of memory corruption.
+/// The actor owns its fiber and scheduling the fiber adds a reference to the
+/// actor, i.e., the fiber never outlives its actor.
+/// @warning A fiber keeps its worker busy until its mailbox runs dry and any
+///          function that blocks the calling thread, e.g., `wait_for`, also
+///          blocks the worker.
+class blocking_fiber : public resumable {
+public:
+  /// Creates a fiber that runs `self` with a stack of `stack_size` bytes,
+  /// rounded up to whole pages.
+  blocking_fiber(blocking_actor* self, size_t stack_size);
+
+  ~blocking_fiber() override;
+
+  subtype_t subtype() const override;
+
+  resume_result resume(execution_unit* ctx, size_t max_throughput) override;
+
+  void intrusive_ptr_add_ref_impl() override;
+
+  void intrusive_ptr_release_impl() override;
+
+  /// Switches from the fiber back to the worker until the mailbox receives
+  /// new messages.
+  /// @pre called from within the fiber while the mailbox is empty
+  void await_messages();
+
+  /// Returns whether this platform supports running blocking actors as
+  /// fibers.
+  static bool available();
+
+  /// Returns the number of unused stacks in the process-wide pool.
+  static size_t pooled_stacks();
+
+private:
+  // entry point of the fiber
+  static void entry(int hi, int lo);
+
+  struct context;
+
+  enum class state {
+    running,
+    awaiting_messages,
+    done
+  };
+
+  blocking_actor* self_;
+  std::unique_ptr<context> ctx_;
+  state state_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_BLOCKING_FIBER_HPP
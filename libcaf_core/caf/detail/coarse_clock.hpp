@@ -0,0 +1,61 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_COARSE_CLOCK_HPP
+#define CAF_DETAIL_COARSE_CLOCK_HPP
+
+#include <chrono>
+
+#include "caf/config.hpp"
+
+#ifdef CAF_LINUX
+#include <time.h>
+#endif // CAF_LINUX
+
+namespace caf {
+namespace detail {
+
+/// A monotonic clock that is cheap to read but only advances once per
+/// kernel tick (usually 1-10ms) on Linux. Other platforms fall back to
+/// `std::chrono::steady_clock`.
+struct coarse_clock {
+  using duration = std::chrono::nanoseconds;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::time_point<coarse_clock, duration>;
+
+  static constexpr bool is_steady = true;
+
+  static time_point now() noexcept {
+#   ifdef CAF_LINUX
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return time_point{std::chrono::seconds{ts.tv_sec}
+                      + duration{ts.tv_nsec}};
+#   else
+    return time_point{std::chrono::duration_cast<duration>(
+      std::chrono::steady_clock::now().time_since_epoch())};
+#   endif
+  }
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_COARSE_CLOCK_HPP
@@ -0,0 +1,173 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_CONCURRENT_ACTOR_MAP_HPP
+#define CAF_DETAIL_CONCURRENT_ACTOR_MAP_HPP
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "caf/config.hpp"
+#include "caf/fwd.hpp"
+#include "caf/actor_control_block.hpp"
+
+namespace caf {
+namespace detail {
+
+/// A concurrent hash map from 64-bit keys to actors. The map consists of
+/// shards that each own an open-addressing table with atomic slots.
+/// Lookups never lock: readers register in one of two per-shard counters
+/// and writers, which serialize on a per-shard mutex, wait for readers of
+/// the previous epoch before releasing removed actors or freeing replaced
+/// tables. Erased slots become tombstones that only disappear when the
+/// shard rehashes, i.e., writers never reuse a slot readers may observe.
+class concurrent_actor_map {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using key_type = uint64_t;
+
+  using value_type = std::pair<key_type, strong_actor_ptr>;
+
+  // -- constants --------------------------------------------------------------
+
+  /// Number of independent shards, must be a power of two.
+  static constexpr size_t num_shards = 64;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  concurrent_actor_map();
+
+  concurrent_actor_map(const concurrent_actor_map&) = delete;
+
+  concurrent_actor_map& operator=(const concurrent_actor_map&) = delete;
+
+  ~concurrent_actor_map();
+
+  // -- lookup -----------------------------------------------------------------
+
+  /// Returns the actor associated to `key` or `nullptr`. Never blocks.
+  strong_actor_ptr get(key_type key) const;
+
+  /// Returns a copy of all entries.
+  std::vector<value_type> entries() const;
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Associates `key` with `val` unless `key` already exists.
+  /// @returns `true` if the map now contains `val`, `false` otherwise.
+  bool put(key_type key, strong_actor_ptr val);
+
+  /// Removes `key` from the map.
+  /// @returns `true` if the map contained `key`, `false` otherwise.
+  bool erase(key_type key);
+
+private:
+  // all keys are valid, hence slots carry their state explicitly
+  enum slot_state : uint32_t {
+    empty_slot,
+    used_slot,
+    erased_slot
+  };
+
+  struct slot {
+    slot() : state(empty_slot), key(0), val(nullptr) {
+      // nop
+    }
+
+    // readers may only access `key` after observing `used_slot`
+    std::atomic<uint32_t> state;
+    // written once before setting `state` to `used_slot`
+    key_type key;
+    std::atomic<actor_control_block*> val;
+  };
+
+  struct table {
+    explicit table(size_t n)
+        : capacity(n),
+          used(0),
+          size(0),
+          slots(new slot[n]) {
+      // nop
+    }
+
+    // number of slots, always a power of two
+    size_t capacity;
+    // number of slots with a key or a tombstone
+    size_t used;
+    // number of slots with a key
+    size_t size;
+    std::unique_ptr<slot[]> slots;
+  };
+
+  struct shard {
+    shard() : epoch(0), tbl(nullptr) {
+      readers[0] = 0;
+      readers[1] = 0;
+    }
+
+    // selects the reader counter for new readers
+    std::atomic<size_t> epoch;
+    // number of readers per epoch
+    std::atomic<size_t> readers[2];
+    // current table or `nullptr` before the first insertion
+    std::atomic<table*> tbl;
+    // serializes writers
+    std::mutex mtx;
+    // keeps shards on separate cache lines
+    char pad[CAF_CACHE_LINE_SIZE];
+  };
+
+  static uint64_t hash(key_type key) {
+    // Fibonacci hashing spreads consecutive IDs over shards and slots
+    return key * 0x9E3779B97F4A7C15ull;
+  }
+
+  shard& shard_for(uint64_t h) const {
+    return shards_[h >> 58];
+  }
+
+  // enters a read-side critical section and returns its epoch
+  static size_t enter(shard& s);
+
+  // leaves a read-side critical section
+  static void leave(shard& s, size_t epoch);
+
+  // waits for all readers that might still observe a previous state,
+  // requires `s.mtx`
+  static void synchronize(shard& s);
+
+  // moves all entries of `s` to a new table, requires `s.mtx`
+  static table* rehash(shard& s, table* old);
+
+  static_assert((size_t{1} << (64 - 58)) == num_shards,
+                "shard index must select exactly num_shards shards");
+
+  std::unique_ptr<shard[]> shards_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_CONCURRENT_ACTOR_MAP_HPP
@@ -0,0 +1,118 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_COROUTINE_FRAME_POOL_HPP
+#define CAF_DETAIL_COROUTINE_FRAME_POOL_HPP
+
+#include <cstddef>
+
+#include "caf/fwd.hpp"
+#include "caf/config.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Recycles the memory of coroutine frames for a single actor. Frames fall
+/// into a few power-of-two size classes and each class keeps a short free
+/// list, i.e., an actor that repeatedly suspends on requests reuses the same
+/// few blocks instead of going to the heap on every step. Larger frames and
+/// frames of coroutines started outside of an actor bypass the pool.
+/// @warning Not thread-safe, only the owning actor may allocate and release
+///          frames (coroutines of an actor always run in its context).
+class coroutine_frame_pool {
+public:
+  coroutine_frame_pool();
+
+  coroutine_frame_pool(const coroutine_frame_pool&) = delete;
+  coroutine_frame_pool& operator=(const coroutine_frame_pool&) = delete;
+
+  ~coroutine_frame_pool();
+
+  /// Allocates `size` bytes from `pool` or from the heap if `pool == nullptr`.
+  static void* allocate(coroutine_frame_pool* pool, size_t size);
+
+  /// Returns `ptr` to the pool it came from.
+  static void deallocate(void* ptr);
+
+  /// Returns the number of cached blocks.
+  size_t cached() const;
+
+  /// Smallest size class in bytes.
+  static constexpr size_t min_block_size = 128;
+
+  /// Number of size classes, each doubling the previous one.
+  static constexpr size_t num_size_classes = 4;
+
+  /// Maximum number of cached blocks per size class.
+  static constexpr size_t max_cached_blocks = 16;
+
+private:
+  struct block;
+
+  block* free_lists_[num_size_classes];
+  size_t free_list_sizes_[num_size_classes];
+};
+
+/// Returns the actor that currently runs in the calling thread or `nullptr`.
+/// Coroutines started by message handlers take their frames from this actor.
+#ifdef CAF_NO_THREAD_LOCAL
+scheduled_actor* current_coroutine_owner();
+#else // CAF_NO_THREAD_LOCAL
+inline scheduled_actor*& current_coroutine_owner_ref() {
+  static thread_local scheduled_actor* result = nullptr;
+  return result;
+}
+
+inline scheduled_actor* current_coroutine_owner() {
+  return current_coroutine_owner_ref();
+}
+#endif // CAF_NO_THREAD_LOCAL
+
+/// Sets the actor that currently runs in the calling thread.
+#ifdef CAF_NO_THREAD_LOCAL
+void current_coroutine_owner(scheduled_actor* x);
+#else // CAF_NO_THREAD_LOCAL
+inline void current_coroutine_owner(scheduled_actor* x) {
+  current_coroutine_owner_ref() = x;
+}
+#endif // CAF_NO_THREAD_LOCAL
+
+/// Installs a coroutine owner for the lifetime of this object.
+class coroutine_owner_scope {
+public:
+  explicit coroutine_owner_scope(scheduled_actor* x)
+      : prev_(current_coroutine_owner()) {
+    current_coroutine_owner(x);
+  }
+
+  coroutine_owner_scope(const coroutine_owner_scope&) = delete;
+  coroutine_owner_scope& operator=(const coroutine_owner_scope&) = delete;
+
+  ~coroutine_owner_scope() {
+    current_coroutine_owner(prev_);
+  }
+
+private:
+  scheduled_actor* prev_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_COROUTINE_FRAME_POOL_HPP
@@ -0,0 +1,44 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_COROUTINE_RESPONSE_SLOT_HPP
+#define CAF_DETAIL_COROUTINE_RESPONSE_SLOT_HPP
+
+#include "caf/fwd.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Receives the response to a request a coroutine suspended on. Implemented
+/// by the awaiter, which lives in the coroutine frame.
+class coroutine_response_slot {
+public:
+  virtual ~coroutine_response_slot();
+
+  /// Stores the response (or error) `x` and resumes the coroutine.
+  virtual void resume(message& x) = 0;
+
+  /// Destroys the suspended coroutine without resuming it.
+  virtual void discard() = 0;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_COROUTINE_RESPONSE_SLOT_HPP
@@ -0,0 +1,86 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_FILE_WRITER_HPP
+#define CAF_DETAIL_FILE_WRITER_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "caf/error.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Appends data to a file through a write-behind buffer, i.e., collects
+/// small writes in memory and hands them to the OS in large chunks.
+class file_writer {
+public:
+  file_writer();
+
+  ~file_writer();
+
+  file_writer(const file_writer&) = delete;
+  file_writer& operator=(const file_writer&) = delete;
+
+  /// Opens `path` for appending, creating the file if necessary.
+  /// @param buffer_size Number of bytes to collect before writing to disk.
+  error open(const std::string& path, size_t buffer_size);
+
+  /// Returns whether `open` succeeded previously.
+  inline bool is_open() const {
+    return file_ != nullptr;
+  }
+
+  /// Returns the write-behind buffer. Callers append to the buffer and call
+  /// `flush_if_full` afterwards.
+  inline std::vector<char>& buf() {
+    return buf_;
+  }
+
+  /// Writes the buffer to disk if it reached its configured size.
+  inline error flush_if_full() {
+    return buf_.size() >= buffer_size_ ? flush() : error{};
+  }
+
+  /// Writes the buffer to disk. Discards the buffer on error.
+  error flush();
+
+  /// Returns the number of bytes written to disk.
+  inline uint64_t written() const {
+    return written_;
+  }
+
+  /// Flushes the buffer and closes the file.
+  error close();
+
+private:
+  std::FILE* file_;
+  size_t buffer_size_;
+  uint64_t written_;
+  std::vector<char> buf_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_FILE_WRITER_HPP
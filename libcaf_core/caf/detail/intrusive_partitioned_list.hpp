@@ -22,6 +22,7 @@
 
 #include "caf/config.hpp"
 
+#include <array>
 #include <memory>
 #include <iterator>
 #include <algorithm>
@@ -35,8 +36,11 @@ namespace detail {
 /// Describes a partitioned list of elements. The first part
 /// of the list is described by the iterator pair `[begin, separator)`.
 /// The second part by `[continuation, end)`. Actors use the second half
-/// of the list to store previously skipped elements. Priority-aware actors
-/// also use the first half of the list to sort messages by priority.
+/// of the list to store previously skipped elements.
+/// Since most actors never skip a message, the list allocates its three
+/// sentinel elements on first access to an iterator. Member functions that
+/// only inspect the list, i.e., `empty`, `ranges`, and `count`, as well as
+/// `clear` never allocate.
 template <class T, class Delete = std::default_delete<T>>
 class intrusive_partitioned_list {
 public:
@@ -101,31 +105,26 @@ public:
     }
   };
 
-  intrusive_partitioned_list() {
-    head_.next = &separator_;
-    separator_.prev = &head_;
-    separator_.next = &tail_;
-    tail_.prev = &separator_;
-  }
+  intrusive_partitioned_list() = default;
 
   ~intrusive_partitioned_list() {
     clear();
   }
 
   iterator begin() {
-    return head_.next;
+    return sentinels().head.next;
   }
 
   iterator separator() {
-    return &separator_;
+    return &sentinels().separator;
   }
 
   iterator continuation() {
-    return separator_.next;
+    return sentinels().separator.next;
   }
 
   iterator end() {
-    return &tail_;
+    return &sentinels().tail;
   }
 
   using range = std::pair<iterator, iterator>;
@@ -133,6 +132,8 @@ public:
   /// Returns the two iterator pairs describing the first and second part
   /// of the partitioned list.
   std::array<range, 2> ranges() {
+    if (!s_)
+      return {{range{}, range{}}};
     return {{range{begin(), separator()}, range{continuation(), end()}}};
   }
 
@@ -148,14 +149,8 @@ public:
         delete_(ptr);
       }
     }
-    if (head_.next != &separator_) {
-      head_.next = &separator_;
-      separator_.prev = &head_;
-    }
-    if (separator_.next != &tail_) {
-      separator_.next = &tail_;
-      tail_.prev = &separator_;
-    }
+    if (s_)
+      s_->link();
   }
 
   void clear() {
@@ -173,7 +168,8 @@ public:
   }
 
   bool empty() const {
-    return head_.next == &separator_ && separator_.next == &tail_;
+    return !s_ || (s_->head.next == &s_->separator
+                   && s_->separator.next == &s_->tail);
   }
 
   pointer take(iterator pos) {
@@ -201,9 +197,30 @@ public:
   }
 
 private:
-  value_type head_;
-  value_type separator_;
-  value_type tail_;
+  struct sentinel_block {
+    value_type head;
+    value_type separator;
+    value_type tail;
+
+    sentinel_block() {
+      link();
+    }
+
+    void link() {
+      head.next = &separator;
+      separator.prev = &head;
+      separator.next = &tail;
+      tail.prev = &separator;
+    }
+  };
+
+  sentinel_block& sentinels() {
+    if (!s_)
+      s_.reset(new sentinel_block);
+    return *s_;
+  }
+
+  std::unique_ptr<sentinel_block> s_;
   deleter_type delete_;
 };
 
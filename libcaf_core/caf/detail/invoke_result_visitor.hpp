@@ -127,6 +127,11 @@ public:
     (*this)();
   }
 
+  // coroutines respond via response promises if at all
+  inline void operator()(actor_task&) {
+    (*this)();
+  }
+
   // visit API - returns true if T was visited, false if T was skipped
 
   template <class T>
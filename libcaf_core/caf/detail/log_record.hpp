@@ -0,0 +1,347 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_LOG_RECORD_HPP
+#define CAF_DETAIL_LOG_RECORD_HPP
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <functional>
+#include <type_traits>
+
+#include "caf/fwd.hpp"
+#include "caf/config.hpp"
+#include "caf/timestamp.hpp"
+#include "caf/serializer.hpp"
+#include "caf/deserializer.hpp"
+#include "caf/deep_to_string.hpp"
+
+#include "caf/detail/type_traits.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Static information about a single logging statement. Each statement owns
+/// one instance with static storage duration, i.e., its address identifies
+/// the statement for the lifetime of the process.
+struct log_site {
+  int level;
+  const char* category_name;
+  const char* pretty_fun;
+  const char* file_name;
+  int line_number;
+};
+
+/// Type tags for arguments in binary log records.
+enum log_arg_tag : uint8_t {
+  log_text_arg,
+  log_int_arg,
+  log_uint_arg,
+  log_double_arg,
+  log_bool_arg,
+  log_string_arg,
+  /// Serialized argument that gets formatted by the writer thread.
+  log_deferred_arg,
+  /// Flags an argument as named, i.e., created via `CAF_ARG`.
+  log_named_arg = 0x80
+};
+
+/// Fixed-size header of binary log records.
+struct log_record_header {
+  /// Size of the record including this header.
+  uint32_t size;
+  /// Address of the `log_site` of the logging statement.
+  uint64_t site;
+  /// Nanoseconds since the UNIX epoch.
+  int64_t tstamp;
+  /// ID of the actor that was running when logging the record.
+  uint64_t aid;
+};
+
+/// Serialized size of `log_record_header`.
+constexpr size_t log_record_header_size = 28;
+
+/// Renders a deferred argument from its serialized representation.
+using log_arg_renderer = bool (*)(const char* buf, size_t size,
+                                  std::string& out);
+
+/// Appends the output of `f` to `buf` via a binary serializer without
+/// context.
+error save_log_arg(std::vector<char>& buf,
+                   const std::function<error (serializer&)>& f);
+
+/// Reads `buf` via a binary deserializer without context.
+error load_log_arg(const char* buf, size_t size,
+                   const std::function<error (deserializer&)>& f);
+
+/// Restores a `T` from `buf` and renders it via `deep_to_string`.
+template <class T>
+bool render_log_arg(const char* buf, size_t size, std::string& out) {
+  T x;
+  auto err = load_log_arg(buf, size, [&](deserializer& source) {
+    return source(x);
+  });
+  if (err)
+    return false;
+  out = deep_to_string(x);
+  return true;
+}
+
+/// Checks whether arguments of type `T` can be serialized at the call site
+/// for formatting them in the writer thread.
+template <class T>
+struct is_deferrable_log_arg {
+  static constexpr bool value = is_serializable<T>::value
+                                && std::is_default_constructible<T>::value;
+};
+
+/// Optional references cannot get restored from their serialized form.
+template <class T>
+struct is_deferrable_log_arg<optional<T&>> : std::false_type {};
+
+/// Encodes log records into a byte buffer. Scalar arguments get stored in
+/// their raw representation and serializable arguments in their serialized
+/// form. Only the remaining arguments, e.g., actor handles that require a
+/// serialization context, get converted to strings right away.
+class log_record_writer {
+public:
+  explicit log_record_writer(std::vector<char>& buf);
+
+  /// Starts a new record, discarding all previous content of the buffer.
+  void begin(const log_site& site, timestamp tstamp, actor_id aid);
+
+  /// Fills in the size of the record.
+  void end();
+
+  /// Appends plain text.
+  void text(const char* str, size_t len);
+
+  /// Appends an unnamed argument.
+  template <class T>
+  void value(const T& x) {
+    put(x, nullptr);
+  }
+
+  /// Appends a named argument.
+  template <class T>
+  void value(const char* name, const T& x) {
+    put(x, name);
+  }
+
+private:
+  void put(bool x, const char* name) {
+    tag(log_bool_arg, name);
+    uint8_t y = x ? 1 : 0;
+    append(&y, 1);
+  }
+
+  template <class T>
+  typename std::enable_if<std::is_integral<T>::value
+                          && std::is_signed<T>::value>::type
+  put(T x, const char* name) {
+    tag(log_int_arg, name);
+    auto y = static_cast<int64_t>(x);
+    append(&y, sizeof(y));
+  }
+
+  template <class T>
+  typename std::enable_if<std::is_integral<T>::value
+                          && !std::is_signed<T>::value>::type
+  put(T x, const char* name) {
+    tag(log_uint_arg, name);
+    auto y = static_cast<uint64_t>(x);
+    append(&y, sizeof(y));
+  }
+
+  template <class T>
+  typename std::enable_if<std::is_floating_point<T>::value>::type
+  put(T x, const char* name) {
+    tag(log_double_arg, name);
+    auto y = static_cast<double>(x);
+    append(&y, sizeof(y));
+  }
+
+  template <class T>
+  typename std::enable_if<!std::is_arithmetic<T>::value>::type
+  put(const T& x, const char* name) {
+    using token = std::integral_constant<bool,
+                                         is_deferrable_log_arg<T>::value>;
+    put_object(x, name, token{});
+  }
+
+  template <class T>
+  void put_object(const T& x, const char* name, std::true_type) {
+    auto start = buf_.size();
+    tag(log_deferred_arg, name);
+    log_arg_renderer f = render_log_arg<T>;
+    auto fun = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(f));
+    append(&fun, sizeof(fun));
+    auto size_pos = buf_.size();
+    uint32_t n = 0;
+    append(&n, sizeof(n));
+    auto err = save_log_arg(buf_, [&](serializer& sink) {
+      return sink(const_cast<T&>(x));
+    });
+    if (err) {
+      // e.g., actor handles fail to serialize without context
+      buf_.resize(start);
+      put_object(x, name, std::false_type{});
+      return;
+    }
+    n = static_cast<uint32_t>(buf_.size() - size_pos - sizeof(n));
+    memcpy(buf_.data() + size_pos, &n, sizeof(n));
+  }
+
+  template <class T>
+  void put_object(const T& x, const char* name, std::false_type) {
+    tag(log_string_arg, name);
+    str(deep_to_string(x));
+  }
+
+  void tag(log_arg_tag x, const char* name);
+
+  void str(const std::string& x);
+
+  void append(const void* data, size_t len) {
+    auto first = static_cast<const char*>(data);
+    buf_.insert(buf_.end(), first, first + len);
+  }
+
+  std::vector<char>& buf_;
+};
+
+/// Reads the header of the record in `buf`. Returns `false` if `buf` is too
+/// small to contain a record header.
+bool read_log_record_header(const char* buf, size_t size,
+                            log_record_header& hdr);
+
+/// Renders all arguments of the record in `buf` to `out`, producing the same
+/// output as `logger::line_builder`. Returns `false` on malformed input.
+bool render_log_args(const char* buf, size_t size, std::string& out);
+
+/// Copies the record in `buf` to `out`, replacing deferred arguments with
+/// their rendered string. Deferred arguments refer to functions of this
+/// process, i.e., records must be resolved before writing them to a file.
+/// Returns `false` on malformed input.
+bool resolve_log_args(const char* buf, size_t size, std::vector<char>& out);
+
+/// A bounded single-producer, single-consumer queue of binary log records.
+/// Each thread that logs in binary mode owns one ring.
+class log_ring {
+public:
+  log_ring(size_t capacity, std::thread::id tid);
+
+  log_ring(const log_ring&) = delete;
+  log_ring& operator=(const log_ring&) = delete;
+
+  /// Copies the record in `buf` into the ring. Returns `false` if the ring
+  /// currently has not enough free space. Must only be called by the owning
+  /// thread.
+  bool try_push(const char* buf, size_t size);
+
+  /// Calls `f(buf, size)` for each available record. Must only be called by
+  /// the consumer.
+  size_t drain(const std::function<void (const char*, size_t)>& f);
+
+  /// Returns the maximum number of bytes in the ring.
+  inline size_t capacity() const {
+    return capacity_;
+  }
+
+  /// Returns the ID of the producer thread.
+  inline std::thread::id tid() const {
+    return tid_;
+  }
+
+  /// Marks this ring as abandoned by its producer, e.g., because the thread
+  /// terminated. The consumer drops retired rings after draining them.
+  inline void retire() {
+    retired_.store(true, std::memory_order_release);
+  }
+
+  /// Returns whether the producer abandoned this ring.
+  inline bool retired() const {
+    return retired_.load(std::memory_order_acquire);
+  }
+
+private:
+  void copy_out(size_t pos, char* dst, size_t len) const;
+
+  size_t capacity_;
+  std::thread::id tid_;
+  std::unique_ptr<char[]> buf_;
+  std::vector<char> scratch_;
+  // keep producer and consumer positions on separate cache lines
+  char pad1_[CAF_CACHE_LINE_SIZE];
+  std::atomic<size_t> wr_pos_;
+  char pad2_[CAF_CACHE_LINE_SIZE];
+  std::atomic<size_t> rd_pos_;
+  std::atomic<bool> retired_;
+};
+
+// -- binary log files ---------------------------------------------------------
+
+/// A fully decoded log entry, e.g., from a binary log file.
+struct log_entry {
+  int level;
+  std::string category_name;
+  std::string pretty_fun;
+  std::string file_name;
+  int line_number;
+  std::string message;
+  std::string tid;
+  actor_id aid;
+  timestamp tstamp;
+};
+
+/// Writes the header of a binary log file.
+void write_binary_log_header(std::ostream& out, timestamp t0);
+
+/// Writes the definition of a logging statement with ID `id`.
+void write_binary_log_site(std::ostream& out, uint64_t id,
+                           const log_site& x);
+
+/// Writes the definition of a thread with index `idx`.
+void write_binary_log_thread(std::ostream& out, uint32_t idx,
+                             const std::string& tid);
+
+/// Writes the binary record `buf` of the thread with index `idx`. The site
+/// of the record and the thread must be defined previously and `buf` must not
+/// contain deferred arguments.
+void write_binary_log_record(std::ostream& out, uint32_t idx, const char* buf,
+                             size_t size);
+
+/// Writes a fully decoded log entry.
+void write_binary_log_entry(std::ostream& out, const log_entry& x);
+
+/// Reads a binary log file from `in`, calling `f` for each entry. Returns
+/// `false` if `in` does not contain a binary log.
+bool read_binary_log(std::istream& in, timestamp& t0,
+                     const std::function<void (const log_entry&)>& f);
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_LOG_RECORD_HPP
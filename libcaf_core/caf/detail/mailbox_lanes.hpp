@@ -0,0 +1,141 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_MAILBOX_LANES_HPP
+#define CAF_DETAIL_MAILBOX_LANES_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "caf/fwd.hpp"
+#include "caf/mailbox_element.hpp"
+
+#include "caf/detail/disposer.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Sorts the elements fetched from the mailbox of a priority-aware actor into
+/// FIFO lanes. The `urgent` lane holds high-priority messages, the `system`
+/// lane holds `exit_msg`, `down_msg`, and `stream_msg` elements, and the
+/// `normal` lane holds everything else. Both `push` and `take` run in O(1).
+/// To prevent total starvation, `take` serves a lower lane once after
+/// `fairness` consecutive elements from a higher lane if `fairness > 0`.
+/// @warning Call only from the reader (owner) of the mailbox.
+class mailbox_lanes {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Identifies a lane, ordered from highest to lowest priority.
+  enum lane_id : size_t {
+    urgent_lane,
+    system_lane,
+    normal_lane,
+    num_lanes
+  };
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  explicit mailbox_lanes(size_t fairness);
+
+  mailbox_lanes(const mailbox_lanes&) = delete;
+
+  mailbox_lanes& operator=(const mailbox_lanes&) = delete;
+
+  ~mailbox_lanes();
+
+  // -- static utility functions -----------------------------------------------
+
+  /// Returns the lane for `x`.
+  static lane_id classify(const mailbox_element& x);
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Appends `x` to its lane.
+  void push(mailbox_element* x);
+
+  /// Removes the next element or returns `nullptr` if all lanes are empty.
+  mailbox_element* take();
+
+  /// Applies `f` to all elements before deleting them.
+  template <class F>
+  void clear(F& f) {
+    for (auto& x : lanes_) {
+      while (x.head != nullptr) {
+        auto next = x.head->next;
+        f(*x.head);
+        disposer{}(x.head);
+        x.head = next;
+      }
+      x.tail = nullptr;
+      x.size = 0;
+    }
+    mask_ = 0;
+    streak_ = 0;
+  }
+
+  // -- observers --------------------------------------------------------------
+
+  /// Queries whether all lanes are empty.
+  inline bool empty() const {
+    return mask_ == 0;
+  }
+
+  /// Returns the number of elements in lane `x`.
+  inline size_t size(lane_id x) const {
+    return lanes_[x].size;
+  }
+
+  /// Returns the total number of elements in all lanes.
+  size_t size() const;
+
+  /// Returns the maximum number of consecutive elements from higher lanes
+  /// while a lower lane is waiting or 0 for strict priority ordering.
+  inline size_t fairness() const {
+    return fairness_;
+  }
+
+private:
+  struct lane {
+    mailbox_element* head = nullptr;
+    mailbox_element* tail = nullptr;
+    size_t size = 0;
+  };
+
+  mailbox_element* take(lane_id x);
+
+  std::array<lane, num_lanes> lanes_;
+
+  // bit `i` is set if lane `i` is non-empty
+  uint32_t mask_;
+
+  size_t fairness_;
+
+  // consecutive elements taken while a lower lane was waiting
+  size_t streak_;
+
+  // lower lane that got served most recently, for rotating between them
+  lane_id last_bumped_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_MAILBOX_LANES_HPP
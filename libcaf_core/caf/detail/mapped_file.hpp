@@ -0,0 +1,81 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_MAPPED_FILE_HPP
+#define CAF_DETAIL_MAPPED_FILE_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "caf/error.hpp"
+#include "caf/config.hpp"
+
+namespace caf {
+namespace detail {
+
+/// A read-only view to the content of a file that gets mapped into memory
+/// with a hint for sequential access.
+/// @note Falls back to reading the file into a heap buffer on Windows.
+class mapped_file {
+public:
+  mapped_file();
+
+  ~mapped_file();
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  /// Maps the file at `path` into memory.
+  error open(const std::string& path);
+
+  /// Returns whether `open` succeeded previously.
+  inline bool is_open() const {
+    return open_;
+  }
+
+  /// Returns a pointer to the first byte of the file.
+  inline const char* data() const {
+    return data_;
+  }
+
+  /// Returns the size of the file in bytes.
+  inline size_t size() const {
+    return size_;
+  }
+
+  /// Allows the OS to drop the pages in `[0, num_bytes)` from memory.
+  void release(size_t num_bytes);
+
+private:
+  // releases all resources
+  void close();
+
+  bool open_;
+  const char* data_;
+  size_t size_;
+#ifdef CAF_WINDOWS
+  std::vector<char> storage_;
+#endif
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_MAPPED_FILE_HPP
@@ -50,14 +50,16 @@ public:
 
   void notify_self_destroyed();
 
-  void await_self_destroyed();
-
   void start();
 
 private:
+  // deletes this object once both the actor and the job are done
+  void finalize();
+
   std::mutex mtx_;
   std::condition_variable cv_;
   volatile bool self_destroyed_;
+  volatile bool job_done_;
   volatile scheduled_actor* self_;
   volatile worker_state state_;
   actor_system& system_;
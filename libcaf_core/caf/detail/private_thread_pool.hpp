@@ -0,0 +1,127 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_PRIVATE_THREAD_POOL_HPP
+#define CAF_DETAIL_PRIVATE_THREAD_POOL_HPP
+
+#include <mutex>
+#include <chrono>
+#include <deque>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <condition_variable>
+
+#include "caf/fwd.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Runs detached actors on an elastic pool of threads that outlive the
+/// actors instead of starting and stopping one thread per actor. The pool
+/// keeps `scheduler.detached-min-threads` threads alive, runs at most
+/// `scheduler.detached-max-threads` threads (0: unlimited), and stops any
+/// additional thread after `scheduler.detached-idle-timeout` milliseconds
+/// without work. Jobs wait in a FIFO queue while all threads are busy and
+/// the pool has reached its maximum size.
+/// @warning Each job occupies its thread until it returns. Limiting the pool
+///          size can therefore deadlock detached actors that wait for each
+///          other.
+class private_thread_pool {
+public:
+  friend class caf::actor_system;
+
+  using job = std::function<void ()>;
+
+  using clock_type = std::chrono::steady_clock;
+
+  /// Counters of a pool, taken at a single point in time.
+  struct stats {
+    /// Threads started since initializing the pool.
+    size_t threads_started;
+    /// Threads stopped since initializing the pool.
+    size_t threads_stopped;
+    /// Currently running threads, including idle ones.
+    size_t threads;
+    /// Currently idle threads.
+    size_t idle_threads;
+    /// Jobs passed to `run`.
+    size_t jobs;
+    /// Jobs currently waiting for a thread.
+    size_t queued_jobs;
+    /// Nanoseconds all jobs spent waiting for a thread.
+    uint64_t total_wait_ns;
+    /// Longest time in nanoseconds a job waited for a thread.
+    uint64_t max_wait_ns;
+  };
+
+  private_thread_pool();
+
+  private_thread_pool(const private_thread_pool&) = delete;
+  private_thread_pool& operator=(const private_thread_pool&) = delete;
+
+  ~private_thread_pool();
+
+  /// Runs `f` on an idle thread, a new thread, or the next thread that
+  /// becomes available if the pool has reached its maximum size.
+  void run(job f);
+
+  /// Returns a snapshot of all counters.
+  stats collect_stats() const;
+
+private:
+  struct queued_job {
+    job f;
+    clock_type::time_point enqueued;
+  };
+
+  void init(actor_system& sys);
+
+  void stop();
+
+  // requires `mtx_` to be locked
+  void launch_thread();
+
+  // returns `false` if the calling thread shall stop
+  bool await_job(std::unique_lock<std::mutex>& guard);
+
+  void worker_loop();
+
+  mutable std::mutex mtx_;
+  std::condition_variable jobs_cv_;
+  std::condition_variable stopped_cv_;
+  std::deque<queued_job> queue_;
+  size_t min_threads_;
+  size_t max_threads_;
+  std::chrono::milliseconds idle_timeout_;
+  bool stopping_;
+  size_t threads_;
+  size_t idle_threads_;
+  size_t threads_started_;
+  size_t threads_stopped_;
+  size_t jobs_;
+  uint64_t total_wait_ns_;
+  uint64_t max_wait_ns_;
+  metrics::runtime_metrics* rt_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_PRIVATE_THREAD_POOL_HPP
@@ -0,0 +1,163 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_PROFILER_LOG_HPP
+#define CAF_DETAIL_PROFILER_LOG_HPP
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+
+#include "caf/config.hpp"
+
+namespace caf {
+namespace detail {
+
+/// A fixed-size record in the binary output of the profiled coordinator.
+/// Timestamps are nanoseconds on the steady clock, relative to the start of
+/// the scheduler. All fields use host byte order.
+struct profiler_event {
+  enum kind_type : uint16_t {
+    /// A worker resumed the job `id` at `timestamp` for `duration`
+    /// nanoseconds. The fields `usr`, `sys` and `mem` are unused.
+    resume,
+    /// A worker sampled its resource usage at `timestamp`. The fields `usr`
+    /// and `sys` contain the cumulative CPU time of the worker thread in
+    /// microseconds, `mem` contains the maximum resident set size.
+    rusage,
+    /// The job `id` has been completed at `timestamp`.
+    done,
+    /// The ring buffer of a worker dropped `id` events at `timestamp`,
+    /// because the background thread fell behind.
+    dropped
+  };
+
+  uint64_t timestamp;
+  uint64_t duration;
+  uint64_t id;
+  uint32_t worker;
+  uint16_t kind;
+  uint16_t reserved;
+  int64_t usr;
+  int64_t sys;
+  int64_t mem;
+};
+
+/// Fixed-size header of a profiler log file.
+struct profiler_log_header {
+  /// Magic number identifying profiler logs: "CAFPROF" followed by the
+  /// format version.
+  char magic[8];
+  /// Size of a single event in bytes.
+  uint32_t event_size;
+  /// Number of workers in the scheduler.
+  uint32_t num_workers;
+  /// UNIX timestamp in microseconds marking the start of the scheduler, i.e.,
+  /// the origin for all event timestamps.
+  int64_t system_start;
+  /// Configured flush resolution in milliseconds.
+  uint64_t resolution;
+};
+
+/// Initializes `x` with the magic number and event size of this version.
+void init_profiler_log_header(profiler_log_header& x);
+
+/// Returns whether `x` has a valid magic number and event size.
+bool valid_profiler_log_header(const profiler_log_header& x);
+
+/// Reads a profiler log with header from `in`. Returns `false` if `in` does
+/// not contain a valid profiler log, otherwise appends all events to `out`.
+bool read_profiler_log(std::istream& in, profiler_log_header& hdr,
+                       std::vector<profiler_event>& out);
+
+/// A bounded single-producer, single-consumer queue of profiler events. The
+/// producer is a worker thread, the consumer is the background thread that
+/// writes events to disk. Neither side ever blocks: the producer drops events
+/// when the ring is full and counts them instead.
+class profiler_ring {
+public:
+  /// Creates a ring for at least `min_capacity` events.
+  explicit profiler_ring(size_t min_capacity);
+
+  profiler_ring(const profiler_ring&) = delete;
+  profiler_ring& operator=(const profiler_ring&) = delete;
+
+  /// Appends `x` to the ring unless it is full. Returns `false` if the ring
+  /// is full.
+  inline bool try_push(const profiler_event& x) {
+    auto wr = wr_pos_.load(std::memory_order_relaxed);
+    if (wr - rd_pos_.load(std::memory_order_acquire) == capacity())
+      return false;
+    buf_[wr & mask_] = x;
+    wr_pos_.store(wr + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Appends `x` to the ring. Returns `false` and increments the drop counter
+  /// if the ring is full.
+  inline bool push(const profiler_event& x) {
+    if (try_push(x))
+      return true;
+    ++dropped_;
+    return false;
+  }
+
+  /// Returns the number of dropped events. Must only be called by the
+  /// producer.
+  inline uint64_t dropped() const {
+    return dropped_;
+  }
+
+  /// Resets the drop counter. Must only be called by the producer.
+  inline void reset_dropped() {
+    dropped_ = 0;
+  }
+
+  /// Writes all available events to `f` and returns the number of events
+  /// written. Must only be called by the consumer.
+  size_t drain(std::FILE* f);
+
+  /// Moves all available events to `out`. Must only be called by the
+  /// consumer.
+  size_t drain(std::vector<profiler_event>& out);
+
+  /// Returns the maximum number of events in the ring.
+  inline size_t capacity() const {
+    return mask_ + 1;
+  }
+
+private:
+  size_t mask_;
+  std::unique_ptr<profiler_event[]> buf_;
+  // keep producer and consumer positions on separate cache lines
+  char pad1_[CAF_CACHE_LINE_SIZE];
+  std::atomic<size_t> wr_pos_;
+  uint64_t dropped_;
+  char pad2_[CAF_CACHE_LINE_SIZE];
+  std::atomic<size_t> rd_pos_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_PROFILER_LOG_HPP
@@ -0,0 +1,119 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_RESPONSE_RECEIVER_HPP
+#define CAF_DETAIL_RESPONSE_RECEIVER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "caf/config.hpp"
+
+#ifndef CAF_LINUX
+#include <mutex>
+#include <condition_variable>
+#endif // CAF_LINUX
+
+#include "caf/fwd.hpp"
+#include "caf/message_id.hpp"
+#include "caf/mailbox_element.hpp"
+#include "caf/message_priority.hpp"
+#include "caf/monitorable_actor.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Receives the response to one request at a time on behalf of a thread
+/// that is not an actor. Unlike a `blocking_actor`, the receiver has neither
+/// a mailbox nor a behavior: `enqueue` stores the expected response in a
+/// single slot and drops everything else, including late responses to
+/// requests that timed out. The waiting thread spins for a short while,
+/// since responses from local actors usually arrive within microseconds,
+/// and then sleeps on a futex (a mutex and condition variable on platforms
+/// other than Linux).
+class response_receiver : public monitorable_actor {
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  /// Number of polling attempts before going to sleep on machines with more
+  /// than one core.
+  static constexpr size_t spin_iterations = 1000;
+
+  explicit response_receiver(actor_config& cfg);
+
+  ~response_receiver() override;
+
+  void enqueue(mailbox_element_ptr what, execution_unit* host) override;
+
+  const char* name() const override;
+
+  /// Returns a new request ID and prepares the receiver for its response.
+  /// @pre no other response is pending
+  message_id new_request_id(message_priority mp);
+
+  /// Blocks until the response arrives or until `deadline` passes unless
+  /// `deadline == nullptr`.
+  /// @returns the response or `nullptr` after a timeout, in which case the
+  ///          receiver drops the response should it arrive later.
+  mailbox_element_ptr await_response(const clock_type::time_point* deadline);
+
+  /// Discards the pending response.
+  void cancel();
+
+private:
+  // returns the response and resets the receiver
+  mailbox_element_ptr take();
+
+  // blocks while `state_ == sleeping` or until `deadline` passes
+  void sleep(const clock_type::time_point* deadline);
+
+  // wakes up a thread blocked in `sleep`
+  void wake();
+
+  enum state : uint32_t {
+    idle,
+    pending,
+    sleeping,
+    writing,
+    ready
+  };
+
+  // the futex word, i.e., must have 32 bits
+  std::atomic<uint32_t> state_;
+
+  // integer value of the expected response ID or 0
+  std::atomic<uint64_t> expected_;
+
+  // ID of the last request, only accessed by the waiting thread
+  message_id last_request_id_;
+
+  // written by `enqueue` while `state_ == writing`
+  mailbox_element_ptr result_;
+
+# ifndef CAF_LINUX
+  std::mutex mtx_;
+  std::condition_variable cv_;
+# endif // CAF_LINUX
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_RESPONSE_RECEIVER_HPP
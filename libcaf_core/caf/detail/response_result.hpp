@@ -0,0 +1,113 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_RESPONSE_RESULT_HPP
+#define CAF_DETAIL_RESPONSE_RESULT_HPP
+
+#include <tuple>
+#include <cstddef>
+#include <utility>
+
+#include "caf/sec.hpp"
+#include "caf/unit.hpp"
+#include "caf/error.hpp"
+#include "caf/message.hpp"
+#include "caf/expected.hpp"
+
+#include "caf/detail/int_list.hpp"
+#include "caf/detail/type_list.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Converts a response message into an `expected` of the result types
+/// `Output` of a request, i.e., `expected<T>` for a single value,
+/// `expected<std::tuple<Ts...>>` for multiple values, `expected<void>` for
+/// empty responses, and `expected<message>` for dynamically typed actors.
+/// Statically typed results convert from either a `message` or the
+/// `type_erased_tuple` of a mailbox element.
+template <class Output>
+struct response_result;
+
+// dynamically typed requests yield the message itself
+template <>
+struct response_result<message> {
+  using type = message;
+
+  static expected<message> convert(message& x) {
+    if (x.match_elements<error>())
+      return std::move(x.get_mutable_as<error>(0));
+    return std::move(x);
+  }
+};
+
+template <>
+struct response_result<type_list<>> {
+  using type = void;
+
+  template <class Tuple>
+  static expected<void> convert(Tuple& x) {
+    if (x.template match_elements<error>())
+      return std::move(x.template get_mutable_as<error>(0));
+    if (x.empty())
+      return unit;
+    return sec::unexpected_response;
+  }
+};
+
+template <class T>
+struct response_result<type_list<T>> {
+  using type = T;
+
+  template <class Tuple>
+  static expected<T> convert(Tuple& x) {
+    if (x.template match_elements<T>())
+      return std::move(x.template get_mutable_as<T>(0));
+    if (x.template match_elements<error>())
+      return std::move(x.template get_mutable_as<error>(0));
+    return sec::unexpected_response;
+  }
+};
+
+template <class T0, class T1, class... Ts>
+struct response_result<type_list<T0, T1, Ts...>> {
+  using type = std::tuple<T0, T1, Ts...>;
+
+  template <class Tuple>
+  static expected<type> convert(Tuple& x) {
+    if (x.template match_elements<T0, T1, Ts...>())
+      return extract(x, typename il_range<0, sizeof...(Ts) + 2>::type{});
+    if (x.template match_elements<error>())
+      return std::move(x.template get_mutable_as<error>(0));
+    return sec::unexpected_response;
+  }
+
+  template <class Tuple, long... Is>
+  static type extract(Tuple& x, int_list<Is...>) {
+    return type{std::move(x.template get_mutable_as<
+                            typename tl_at<type_list<T0, T1, Ts...>,
+                                           static_cast<size_t>(Is)>::type
+                          >(static_cast<size_t>(Is)))...};
+  }
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_RESPONSE_RESULT_HPP
@@ -87,6 +87,45 @@ public:
     }
   }
 
+  /// Tries to enqueue the `nullptr`-terminated list starting at `first` to
+  /// the mailbox with a single CAS operation. The elements must be linked
+  /// via `next` in the order the reader shall receive them. Applies `f` to
+  /// all elements before deleting them if the queue has been closed.
+  /// @threadsafe
+  template <class F>
+  enqueue_result enqueue_list(pointer first, F f) {
+    CAF_ASSERT(first != nullptr);
+    // the stack stores elements in reverse order
+    pointer top = nullptr;
+    pointer bottom = first;
+    while (first) {
+      auto next = first->next;
+      first->next = top;
+      top = first;
+      first = next;
+    }
+    pointer e = stack_.load();
+    for (;;) {
+      if (!e) {
+        // if tail is nullptr, the queue has been closed
+        while (top) {
+          auto next = top->next;
+          f(*top);
+          delete_(top);
+          top = next;
+        }
+        return enqueue_result::queue_closed;
+      }
+      // a dummy is never part of a non-empty list
+      bottom->next = is_dummy(e) ? nullptr : e;
+      if (stack_.compare_exchange_strong(e, top)) {
+        return  (e == reader_blocked_dummy()) ? enqueue_result::unblocked_reader
+                                              : enqueue_result::success;
+      }
+      // continue with new value of e
+    }
+  }
+
   /// Queries whether there is new data to read, i.e., whether the next
   /// call to {@link try_pop} would succeeed.
   /// @pre !closed()
@@ -240,6 +279,23 @@ public:
     CAF_CRITICAL("invalid result of enqueue()");
   }
 
+  template <class Mutex, class CondVar, class F>
+  bool synchronized_enqueue_list(Mutex& mtx, CondVar& cv, pointer first, F f) {
+    switch (enqueue_list(first, f)) {
+      case enqueue_result::unblocked_reader: {
+        std::unique_lock<Mutex> guard(mtx);
+        cv.notify_one();
+        return true;
+      }
+      case enqueue_result::success:
+        return true;
+      case enqueue_result::queue_closed:
+        return false;
+    }
+    // should be unreachable
+    CAF_CRITICAL("invalid result of enqueue_list()");
+  }
+
   template <class Mutex, class CondVar>
   void synchronized_await(Mutex& mtx, CondVar& cv) {
     CAF_ASSERT(!closed());
@@ -0,0 +1,101 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_SPILL_FILE_HPP
+#define CAF_DETAIL_SPILL_FILE_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "caf/error.hpp"
+#include "caf/config.hpp"
+
+namespace caf {
+namespace detail {
+
+/// An append-only segment file for buffering data that does not fit into
+/// memory. The file gets mapped into memory and is removed from the file
+/// system immediately after creation, i.e., its content never outlives the
+/// process. Readers consume data in the order it was written. Once all data
+/// has been consumed, the segment gets reused from its beginning.
+/// @note Falls back to a heap-allocated segment on Windows.
+class spill_file {
+public:
+  spill_file();
+
+  ~spill_file();
+
+  spill_file(const spill_file&) = delete;
+  spill_file& operator=(const spill_file&) = delete;
+
+  /// Creates the segment file in `dir`, using the system-wide directory for
+  /// temporary files if `dir` is empty.
+  error open(const std::string& dir);
+
+  /// Returns whether `open` succeeded previously.
+  inline bool is_open() const {
+    return data_ != nullptr;
+  }
+
+  /// Appends `num_bytes` from `buf` to the segment.
+  /// @pre `is_open()`
+  error append(const void* buf, size_t num_bytes);
+
+  /// Returns the number of bytes that are not consumed yet.
+  inline size_t available() const {
+    return wr_pos_ - rd_pos_;
+  }
+
+  /// Returns a pointer to the first unconsumed byte.
+  inline const char* read_ptr() const {
+    return data_ + rd_pos_;
+  }
+
+  /// Drops the first `num_bytes` unconsumed bytes.
+  /// @pre `num_bytes <= available()`
+  void consume(size_t num_bytes);
+
+  /// Returns the current size of the segment.
+  inline size_t capacity() const {
+    return capacity_;
+  }
+
+private:
+  // makes room for at least `num_bytes` more bytes
+  error reserve(size_t num_bytes);
+
+  // releases all resources
+  void close();
+
+  char* data_;
+  size_t capacity_;
+  size_t rd_pos_;
+  size_t wr_pos_;
+#ifdef CAF_WINDOWS
+  std::vector<char> storage_;
+#else
+  int fd_;
+#endif
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_SPILL_FILE_HPP
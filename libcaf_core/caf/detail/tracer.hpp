@@ -0,0 +1,169 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_TRACER_HPP
+#define CAF_DETAIL_TRACER_HPP
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <iosfwd>
+
+#include "caf/fwd.hpp"
+#include "caf/config.hpp"
+#include "caf/trace_context.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Returns the trace context of the message handler running in the calling
+/// thread or `nullptr` if the thread currently runs no message handler.
+#ifdef CAF_NO_THREAD_LOCAL
+const trace_context* current_trace_context();
+#else // CAF_NO_THREAD_LOCAL
+inline const trace_context*& current_trace_context_ref() {
+  static thread_local const trace_context* result = nullptr;
+  return result;
+}
+
+inline const trace_context* current_trace_context() {
+  return current_trace_context_ref();
+}
+#endif // CAF_NO_THREAD_LOCAL
+
+/// Sets the trace context of the calling thread.
+#ifdef CAF_NO_THREAD_LOCAL
+void current_trace_context(const trace_context* x);
+#else // CAF_NO_THREAD_LOCAL
+inline void current_trace_context(const trace_context* x) {
+  current_trace_context_ref() = x;
+}
+#endif // CAF_NO_THREAD_LOCAL
+
+/// Returns the trace context for a new message: a copy of the current context
+/// if the calling thread runs a message handler, otherwise an empty context
+/// with the `root_flag`.
+inline trace_context propagated_trace_context() {
+  auto x = current_trace_context();
+  return x != nullptr ? *x : trace_context{0, 0, trace_context::root_flag};
+}
+
+/// Installs a trace context for the lifetime of this object.
+class trace_scope {
+public:
+  explicit trace_scope(const trace_context* x)
+      : prev_(current_trace_context()) {
+    current_trace_context(x);
+  }
+
+  trace_scope(const trace_scope&) = delete;
+  trace_scope& operator=(const trace_scope&) = delete;
+
+  ~trace_scope() {
+    current_trace_context(prev_);
+  }
+
+private:
+  const trace_context* prev_;
+};
+
+/// A finished span, i.e., the processing of a sampled message.
+struct span_record {
+  uint64_t trace_id;
+  uint64_t span_id;
+  /// Span of the sender or 0 for the root span of a trace.
+  uint64_t parent_span_id;
+  actor_id aid;
+  std::string name;
+  /// Nanoseconds since the UNIX epoch.
+  int64_t start;
+  /// Nanoseconds since the UNIX epoch.
+  int64_t end;
+};
+
+/// Records spans for sampled messages into per-thread buffers and writes
+/// them in the OpenTelemetry JSON format (OTLP/JSON) to
+/// `tracing.output-file` when the actor system shuts down.
+class tracer {
+public:
+  friend class caf::actor_system;
+
+  tracer();
+
+  tracer(const tracer&) = delete;
+  tracer& operator=(const tracer&) = delete;
+
+  ~tracer();
+
+  /// Queries whether the tracer samples any messages.
+  inline bool enabled() const {
+    return sample_threshold_ != 0;
+  }
+
+  /// Decides whether a root message starts a new trace.
+  bool sample();
+
+  /// Returns a new random trace or span ID.
+  static uint64_t make_id();
+
+  /// Stores `x` in the buffer of the calling thread.
+  void record(span_record x);
+
+  /// Moves all recorded spans out of the per-thread buffers.
+  std::vector<span_record> collect();
+
+  /// Returns the number of spans dropped due to full buffers.
+  inline size_t dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  /// Writes `xs` in the OpenTelemetry JSON format to `out`.
+  static void write_json(std::ostream& out, const std::vector<span_record>& xs,
+                         const std::string& service_name,
+                         const std::string& node);
+
+private:
+  struct buffer {
+    std::mutex mtx;
+    std::vector<span_record> spans;
+  };
+
+  void init(actor_system& sys);
+
+  void stop();
+
+  buffer& local_buffer();
+
+  actor_system* system_;
+  size_t id_;
+  uint64_t sample_threshold_;
+  size_t buffer_size_;
+  std::string output_file_;
+  std::atomic<size_t> dropped_;
+  std::mutex buffers_mtx_;
+  std::vector<std::unique_ptr<buffer>> buffers_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_TRACER_HPP
@@ -256,6 +256,20 @@ struct is_byte_sequence<std::vector<unsigned char>> : std::true_type { };
 template <>
 struct is_byte_sequence<std::string> : std::true_type { };
 
+/// Checks whether T is a contiguous sequence of arithmetic values that a
+/// data processor can handle in bulk, i.e., a `std::vector` of integers or
+/// floating points other than `bool`, `long double` and byte types.
+template <class T>
+struct is_arithmetic_sequence : std::false_type { };
+
+template <class T>
+struct is_arithmetic_sequence<std::vector<T>>
+  : std::integral_constant<bool, std::is_arithmetic<T>::value
+                                 && !std::is_same<T, bool>::value
+                                 && !std::is_same<T, long double>::value
+                                 && !is_byte_sequence<std::vector<T>>::value> {
+};
+
 /// Checks whether `T` provides either a free function or a member function for
 /// serialization. The checks test whether both serialization and
 /// deserialization can succeed. The meta function tests the following
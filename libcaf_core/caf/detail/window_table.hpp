@@ -0,0 +1,150 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_WINDOW_TABLE_HPP
+#define CAF_DETAIL_WINDOW_TABLE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+namespace caf {
+namespace detail {
+
+/// An open-addressing hash table with linear probing that maps keys to
+/// accumulators of a single window. Clearing a table keeps its capacity,
+/// which allows windowing stages to recycle tables instead of allocating a
+/// fresh table per window.
+/// @note Never shrinks and does not support erasing individual entries.
+template <class Key, class Value, class Hash = std::hash<Key>>
+class window_table {
+public:
+  using key_type = Key;
+
+  using mapped_type = Value;
+
+  window_table() : size_(0), shift_(64) {
+    // nop
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  size_t capacity() const {
+    return keys_.size();
+  }
+
+  /// Returns the value for `key`, inserting a default-constructed value
+  /// on first access.
+  Value& operator[](const Key& key) {
+    if ((size_ + 1) * 2 > capacity())
+      grow();
+    auto i = slot(key);
+    if (used_[i] == 0) {
+      used_[i] = 1;
+      keys_[i] = key;
+      values_[i] = Value{};
+      ++size_;
+    }
+    return values_[i];
+  }
+
+  /// Returns a pointer to the value for `key` or `nullptr`.
+  Value* find(const Key& key) {
+    if (size_ == 0)
+      return nullptr;
+    auto i = slot(key);
+    return used_[i] != 0 ? &values_[i] : nullptr;
+  }
+
+  /// Calls `f(key, value)` for each entry in unspecified order.
+  template <class F>
+  void for_each(F f) {
+    for (size_t i = 0; i < used_.size(); ++i)
+      if (used_[i] != 0)
+        f(const_cast<const Key&>(keys_[i]), values_[i]);
+  }
+
+  /// Removes all entries without releasing memory.
+  void clear() {
+    if (size_ > 0) {
+      std::fill(used_.begin(), used_.end(), uint8_t{0});
+      size_ = 0;
+    }
+  }
+
+private:
+  // Fibonacci hashing spreads sequential keys, e.g., from `std::hash<int>`,
+  // over the whole table instead of creating long probe sequences.
+  size_t home(const Key& key) const {
+    auto h = static_cast<uint64_t>(Hash{}(key));
+    return static_cast<size_t>((h * 0x9E3779B97F4A7C15ull) >> shift_);
+  }
+
+  size_t slot(const Key& key) const {
+    auto mask = capacity() - 1;
+    auto i = home(key);
+    while (used_[i] != 0 && !(keys_[i] == key))
+      i = (i + 1) & mask;
+    return i;
+  }
+
+  void grow() {
+    auto new_capacity = std::max(capacity() * 2, size_t{16});
+    std::vector<Key> keys(new_capacity);
+    std::vector<Value> values(new_capacity);
+    std::vector<uint8_t> used(new_capacity);
+    keys_.swap(keys);
+    values_.swap(values);
+    used_.swap(used);
+    shift_ = 64;
+    for (auto n = new_capacity; n > 1; n >>= 1)
+      --shift_;
+    auto mask = new_capacity - 1;
+    for (size_t i = 0; i < used.size(); ++i) {
+      if (used[i] != 0) {
+        auto j = home(keys[i]);
+        while (used_[j] != 0)
+          j = (j + 1) & mask;
+        used_[j] = 1;
+        keys_[j] = std::move(keys[i]);
+        values_[j] = std::move(values[i]);
+      }
+    }
+  }
+
+  std::vector<Key> keys_;
+  std::vector<Value> values_;
+  std::vector<uint8_t> used_;
+  size_t size_;
+  int shift_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_WINDOW_TABLE_HPP
@@ -0,0 +1,287 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_FILE_STREAM_HPP
+#define CAF_FILE_STREAM_HPP
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "caf/sec.hpp"
+#include "caf/logger.hpp"
+#include "caf/stream.hpp"
+#include "caf/expected.hpp"
+#include "caf/downstream.hpp"
+#include "caf/stream_result.hpp"
+#include "caf/random_gatherer.hpp"
+#include "caf/broadcast_scatterer.hpp"
+#include "caf/terminal_stream_scatterer.hpp"
+
+#include "caf/policy/arg.hpp"
+
+#include "caf/detail/file_writer.hpp"
+#include "caf/detail/mapped_file.hpp"
+#include "caf/detail/network_order.hpp"
+
+namespace caf {
+
+// -- record formats -----------------------------------------------------------
+
+/// Stores records of type `T` back-to-back in their in-memory representation.
+/// Reading copies records directly from the mapped file into the output
+/// buffer of the stream.
+template <class T>
+struct fixed_size_records {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "fixed_size_records requires a trivially copyable type");
+
+  using value_type = T;
+
+  /// Pushes up to `num` records from `[first, first + size)` to `out`.
+  /// @returns The number of consumed bytes.
+  size_t read(const char* first, size_t size, downstream<T>& out,
+              size_t num) const {
+    auto n = std::min(num, size / sizeof(T));
+    // records are properly aligned, because mappings start at page boundaries
+    auto xs = reinterpret_cast<const T*>(first);
+    out.buf().insert(out.buf().end(), xs, xs + n);
+    return n * sizeof(T);
+  }
+
+  /// Appends `x` to `buf`.
+  void write(std::vector<char>& buf, const T& x) const {
+    auto bytes = reinterpret_cast<const char*>(&x);
+    buf.insert(buf.end(), bytes, bytes + sizeof(T));
+  }
+};
+
+/// Stores each record as 32-bit length in network byte order followed by
+/// the raw bytes of the record.
+struct length_prefixed_records {
+  using value_type = std::string;
+
+  /// Pushes up to `num` records from `[first, first + size)` to `out`.
+  /// @returns The number of consumed bytes.
+  size_t read(const char* first, size_t size, downstream<std::string>& out,
+              size_t num) const {
+    size_t pos = 0;
+    for (size_t i = 0; i < num && size - pos >= sizeof(uint32_t); ++i) {
+      uint32_t len;
+      memcpy(&len, first + pos, sizeof(uint32_t));
+      len = detail::from_network_order(len);
+      if (size - pos - sizeof(uint32_t) < len)
+        break;
+      pos += sizeof(uint32_t);
+      out.push(first + pos, len);
+      pos += len;
+    }
+    return pos;
+  }
+
+  /// Appends `x` to `buf`.
+  void write(std::vector<char>& buf, const std::string& x) const {
+    auto len = detail::to_network_order(static_cast<uint32_t>(x.size()));
+    auto bytes = reinterpret_cast<const char*>(&len);
+    buf.insert(buf.end(), bytes, bytes + sizeof(uint32_t));
+    buf.insert(buf.end(), x.begin(), x.end());
+  }
+};
+
+// -- sources ------------------------------------------------------------------
+
+/// State of stream sources reading from a memory-mapped file.
+struct file_source_state {
+  std::shared_ptr<detail::mapped_file> file;
+  size_t pos = 0;
+  size_t released = 0;
+  bool at_end = false;
+};
+
+namespace detail {
+
+// releases pages of the mapped file in steps of 64MB
+constexpr size_t file_source_release_interval = 64 * 1024 * 1024;
+
+template <class Format>
+struct file_source_getter {
+  Format fmt;
+
+  void operator()(file_source_state& st,
+                  downstream<typename Format::value_type>& out,
+                  size_t num) const {
+    auto& f = *st.file;
+    auto n = fmt.read(f.data() + st.pos, f.size() - st.pos, out, num);
+    if (n == 0 && num > 0) {
+      CAF_LOG_WARNING_IF(st.pos < f.size(), "ignore trailing bytes in file:"
+                         << CAF_ARG2("num", f.size() - st.pos));
+      st.at_end = true;
+    }
+    st.pos += n;
+    if (st.pos - st.released >= file_source_release_interval) {
+      f.release(st.pos);
+      st.released = st.pos;
+    }
+  }
+};
+
+struct file_source_predicate {
+  bool operator()(const file_source_state& st) const {
+    return st.at_end || st.pos == st.file->size();
+  }
+};
+
+struct file_source_init {
+  std::shared_ptr<mapped_file> file;
+
+  void operator()(file_source_state& st) const {
+    st.file = file;
+  }
+};
+
+} // namespace detail
+
+/// Creates a new stream source for `self` that reads records in `Format`
+/// from the memory-mapped file at `path` and starts streaming to `dest`. The
+/// size of each batch follows the downstream credit.
+/// @returns A stream object with a pointer to the generated `stream_manager`
+///          or `none` if the file cannot be opened.
+template <class Format, class Self, class Handle, class ResHandler,
+          class Scatterer = broadcast_scatterer<typename Format::value_type>>
+stream<typename Format::value_type>
+make_file_source(Self* self, const Handle& dest, const std::string& path,
+                 ResHandler res_handler, Format fmt = {},
+                 policy::arg<Scatterer> scatterer_type = {}) {
+  auto file = std::make_shared<detail::mapped_file>();
+  auto err = file->open(path);
+  if (err) {
+    CAF_LOG_ERROR("cannot open file for streaming:" << CAF_ARG(path));
+    res_handler(std::move(err));
+    return none;
+  }
+  return self->make_source(dest, detail::file_source_init{std::move(file)},
+                           detail::file_source_getter<Format>{std::move(fmt)},
+                           detail::file_source_predicate{},
+                           std::move(res_handler), scatterer_type);
+}
+
+/// Creates a new stream source for `self` that reads records in `Format`
+/// from the memory-mapped file at `path`. The size of each batch follows the
+/// downstream credit.
+/// @pre `self->current_mailbox_element()` is a request for the stream
+/// @returns A stream object with a pointer to the generated `stream_manager`
+///          or `none` if the file cannot be opened.
+template <class Format, class Self,
+          class Scatterer = broadcast_scatterer<typename Format::value_type>>
+stream<typename Format::value_type>
+make_file_source(Self* self, const std::string& path, Format fmt = {},
+                 policy::arg<Scatterer> scatterer_type = {}) {
+  auto file = std::make_shared<detail::mapped_file>();
+  auto err = file->open(path);
+  if (err) {
+    CAF_LOG_ERROR("cannot open file for streaming:" << CAF_ARG(path));
+    self->make_response_promise().deliver(std::move(err));
+    return none;
+  }
+  return self->make_source(detail::file_source_init{std::move(file)},
+                           detail::file_source_getter<Format>{std::move(fmt)},
+                           detail::file_source_predicate{}, scatterer_type);
+}
+
+// -- sinks --------------------------------------------------------------------
+
+/// State of stream sinks appending to a file.
+struct file_sink_state {
+  std::shared_ptr<detail::file_writer> file;
+};
+
+namespace detail {
+
+template <class Format>
+struct file_sink_consumer {
+  Format fmt;
+
+  // a write error aborts the stream, i.e., we never receive more input
+  error operator()(file_sink_state& st, typename Format::value_type x) const {
+    fmt.write(st.file->buf(), x);
+    auto err = st.file->flush_if_full();
+    if (err)
+      CAF_LOG_ERROR("cannot write to file:" << CAF_ARG(err));
+    return err;
+  }
+};
+
+struct file_sink_init {
+  std::shared_ptr<file_writer> file;
+
+  void operator()(file_sink_state& st) const {
+    st.file = file;
+  }
+};
+
+struct file_sink_finalizer {
+  expected<uint64_t> operator()(file_sink_state& st) const {
+    auto err = st.file->close();
+    if (err) {
+      CAF_LOG_ERROR("cannot write to file:" << CAF_ARG(err));
+      return err;
+    }
+    return st.file->written();
+  }
+};
+
+} // namespace detail
+
+/// Creates a new stream sink for `self` that appends records in `Format` to
+/// the file at `path`. Records are collected in a write-behind buffer of
+/// `buffer_size` bytes before writing them to disk. The result of the stream
+/// is the number of written bytes. A write error aborts the stream with that
+/// error.
+/// @pre `self->current_mailbox_element()` is a `stream_msg::open` handshake
+template <class Format, class Self, class In,
+          class Gatherer = random_gatherer>
+stream_result<uint64_t>
+make_file_sink(Self* self, const stream<In>& in, const std::string& path,
+               size_t buffer_size = 1024 * 1024, Format fmt = {},
+               policy::arg<Gatherer, terminal_stream_scatterer> policies = {}) {
+  static_assert(std::is_same<In, typename Format::value_type>::value,
+                "Format::value_type does not match the input stream");
+  auto file = std::make_shared<detail::file_writer>();
+  auto err = file->open(path, buffer_size);
+  auto result = self->make_sink(in, detail::file_sink_init{file},
+                                detail::file_sink_consumer<Format>{
+                                  std::move(fmt)},
+                                detail::file_sink_finalizer{}, policies);
+  if (err && result.ptr() != nullptr) {
+    CAF_LOG_ERROR("cannot open file for streaming:" << CAF_ARG(path));
+    // reject the stream after completing the handshake
+    result.ptr()->abort(std::move(err));
+    self->streams().erase(in.id());
+    return none;
+  }
+  return result;
+}
+
+} // namespace caf
+
+#endif // CAF_FILE_STREAM_HPP
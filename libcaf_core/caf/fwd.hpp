@@ -33,6 +33,7 @@ template <class> class optional;
 template <class> class expected;
 template <class> class downstream;
 template <class> class intrusive_ptr;
+template <class> class response_future;
 template <class> class behavior_type_of;
 template <class> class trivial_match_case;
 template <class> class weak_intrusive_ptr;
@@ -73,6 +74,7 @@ class resumable;
 class stream_id;
 class actor_addr;
 class actor_pool;
+class actor_task;
 class message_id;
 class serializer;
 class actor_proxy;
@@ -93,6 +95,7 @@ class blocking_actor;
 class execution_unit;
 class proxy_registry;
 class stream_manager;
+class sync_requester;
 class random_gatherer;
 class stream_gatherer;
 class actor_companion;
@@ -175,6 +178,15 @@ class abstract_coordinator;
 } // namespace scheduler
 
 
+// -- metrics classes ----------------------------------------------------------
+
+namespace metrics {
+
+class registry;
+struct runtime_metrics;
+
+} // namespace metrics
+
 // -- OpenSSL classes ----------------------------------------------------------
 
 namespace openssl {
@@ -192,9 +204,14 @@ template <class> class stream_distribution_tree;
 
 class disposer;
 class message_data;
+class blocking_fiber;
 class group_manager;
 class private_thread;
+class private_thread_pool;
+class response_receiver;
+class coroutine_frame_pool;
 class dynamic_message_data;
+class coroutine_response_slot;
 
 } // namespace detail
 
@@ -62,6 +62,7 @@
 #include "caf/scheduler/abstract_coordinator.hpp"
 
 #include "caf/detail/disposer.hpp"
+#include "caf/detail/mailbox_lanes.hpp"
 #include "caf/detail/behavior_stack.hpp"
 #include "caf/detail/typed_actor_util.hpp"
 #include "caf/detail/single_reader_queue.hpp"
@@ -413,7 +414,8 @@ public:
   // -- message processing -----------------------------------------------------
 
   /// Returns the next message from the mailbox or `nullptr`
-  /// if the mailbox is drained.
+  /// if the mailbox is drained. Priority-aware actors sort new messages
+  /// into lanes first and then take from the highest non-empty lane.
   mailbox_element_ptr next_message();
 
   /// Returns whether the mailbox contains at least one element.
@@ -428,6 +430,9 @@ protected:
   // used by both event-based and blocking actors
   mailbox_type mailbox_;
 
+  // lanes of priority-aware actors, allocated on first use
+  std::unique_ptr<detail::mailbox_lanes> lanes_;
+
   // identifies the execution unit this actor is currently executed by
   execution_unit* context_;
 
@@ -20,7 +20,10 @@
 #ifndef CAF_LOGGER_HPP
 #define CAF_LOGGER_HPP
 
+#include <atomic>
+#include <memory>
 #include <thread>
+#include <vector>
 #include <fstream>
 #include <cstring>
 #include <sstream>
@@ -28,6 +31,7 @@
 #include <typeinfo>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "caf/fwd.hpp"
 #include "caf/config.hpp"
@@ -38,6 +42,7 @@
 #include "caf/abstract_actor.hpp"
 #include "caf/deep_to_string.hpp"
 
+#include "caf/detail/log_record.hpp"
 #include "caf/detail/scope_guard.hpp"
 #include "caf/detail/shared_spinlock.hpp"
 #include "caf/detail/pretty_type_name.hpp"
@@ -174,6 +179,37 @@ public:
     bool behind_arg_;
   };
 
+  /// Utility class for encoding user-defined log messages with `CAF_ARG` into
+  /// binary records. Formatting of the arguments is deferred to the writer
+  /// thread of the logger.
+  class record_builder {
+  public:
+    record_builder(logger& owner, const detail::log_site& site);
+
+    template <class T>
+    record_builder& operator<<(const T& x) {
+      writer_.value(x);
+      return *this;
+    }
+
+    template <class T>
+    record_builder& operator<<(const arg_wrapper<T>& x) {
+      writer_.value(x.name, x.value);
+      return *this;
+    }
+
+    record_builder& operator<<(const std::string& str);
+
+    record_builder& operator<<(const char* str);
+
+    /// Hands the record over to the logger.
+    void commit();
+
+  private:
+    logger& owner_;
+    detail::log_record_writer writer_;
+  };
+
   /// Returns the ID of the actor currently associated to the calling thread.
   actor_id thread_local_aid();
 
@@ -183,6 +219,12 @@ public:
   /// Writes an entry to the log file.
   void log(event* x);
 
+  /// Returns whether logging statements encode binary records instead of
+  /// rendering their message at the call site.
+  inline bool binary_output() const {
+    return binary_output_;
+  }
+
   ~logger() override;
 
   /** @cond PRIVATE */
@@ -253,8 +295,18 @@ public:
   }
 
 private:
+  /// Stores a binary record in the ring buffer of the calling thread.
+  void log_record(const std::vector<char>& buf);
+
   void handle_event(event& x);
 
+  void render_console(event& x);
+
+  void handle_record(uint32_t thread_idx, std::thread::id tid,
+                     const char* buf, size_t size);
+
+  void drain_rings();
+
   void log_first_line();
 
   void log_last_line();
@@ -283,6 +335,16 @@ private:
   line_format file_format_;
   line_format console_format_;
   std::fstream file_;
+  // binary output state; rings are only accessed by their owning thread and
+  // the writer thread after registration
+  bool binary_output_;
+  uint64_t serial_;
+  std::atomic<bool> rings_active_;
+  std::mutex rings_mtx_;
+  std::vector<std::shared_ptr<detail::log_ring>> rings_;
+  std::vector<std::thread::id> threads_written_;
+  std::unordered_set<uint64_t> sites_written_;
+  std::vector<char> resolved_;
 };
 
 std::string to_string(logger::field_type x);
@@ -340,8 +402,16 @@ inline caf::actor_id caf_set_aid_dummy() { return 0; }
 #define CAF_LOG_IMPL(component, loglvl, message)                               \
   do {                                                                         \
     auto CAF_UNIFYN(caf_logger) = caf::logger::current_logger();               \
-    if (CAF_UNIFYN(caf_logger) != nullptr                                      \
-        && CAF_UNIFYN(caf_logger)->accepts(loglvl, component))                 \
+    if (CAF_UNIFYN(caf_logger) == nullptr                                      \
+        || !CAF_UNIFYN(caf_logger)->accepts(loglvl, component))                \
+      break;                                                                   \
+    if (CAF_UNIFYN(caf_logger)->binary_output()) {                             \
+      static const ::caf::detail::log_site CAF_UNIFYN(caf_log_site){           \
+        loglvl, component, CAF_PRETTY_FUN, __FILE__, __LINE__};                \
+      (::caf::logger::record_builder{*CAF_UNIFYN(caf_logger),                  \
+                                     CAF_UNIFYN(caf_log_site)}                 \
+       << message).commit();                                                   \
+    } else {                                                                   \
       CAF_UNIFYN(caf_logger)                                                   \
         ->log(new ::caf::logger::event{                                        \
           nullptr, nullptr, loglvl, component, CAF_PRETTY_FUN, __FILE__,       \
@@ -349,6 +419,7 @@ inline caf::actor_id caf_set_aid_dummy() { return 0; }
           ::std::this_thread::get_id(),                                        \
           CAF_UNIFYN(caf_logger)->thread_local_aid(),                          \
           ::caf::make_timestamp()});                                           \
+    }                                                                          \
   } while (false)
 
 #define CAF_PUSH_AID(aarg)                                                     \
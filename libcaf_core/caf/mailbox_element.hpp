@@ -20,12 +20,14 @@
 #ifndef CAF_MAILBOX_ELEMENT_HPP
 #define CAF_MAILBOX_ELEMENT_HPP
 
+#include <chrono>
 #include <cstddef>
 
 #include "caf/extend.hpp"
 #include "caf/message.hpp"
 #include "caf/message_id.hpp"
 #include "caf/ref_counted.hpp"
+#include "caf/trace_context.hpp"
 #include "caf/make_message.hpp"
 #include "caf/message_view.hpp"
 #include "caf/memory_managed.hpp"
@@ -35,6 +37,7 @@
 #include "caf/meta/type_name.hpp"
 #include "caf/meta/omittable_if_empty.hpp"
 
+#include "caf/detail/tracer.hpp"
 #include "caf/detail/disposer.hpp"
 #include "caf/detail/tuple_vals.hpp"
 #include "caf/detail/type_erased_tuple_view.hpp"
@@ -64,6 +67,16 @@ public:
   /// if this is empty then the original sender receives the response.
   forwarding_stack stages;
 
+  /// Identifies the trace and the span of the sender if this message belongs
+  /// to a sampled trace. Copied from the sending message handler.
+  trace_context trace;
+
+# ifdef CAF_ENABLE_MAILBOX_LATENCY
+  /// Stores when a scheduled actor with mailbox latency measurement received
+  /// this element. Default-constructed for all other elements.
+  std::chrono::steady_clock::time_point enqueue_time;
+# endif // CAF_ENABLE_MAILBOX_LATENCY
+
   mailbox_element();
 
   mailbox_element(strong_actor_ptr&& x, message_id y,
@@ -0,0 +1,58 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_METRICS_COUNTER_HPP
+#define CAF_METRICS_COUNTER_HPP
+
+#include <cstdint>
+
+#include "caf/metrics/shard.hpp"
+
+namespace caf {
+namespace metrics {
+
+/// A monotonically increasing value, e.g., the number of processed messages.
+class counter {
+public:
+  counter() = default;
+
+  counter(const counter&) = delete;
+  counter& operator=(const counter&) = delete;
+
+  /// Increments the counter by `x`.
+  inline void inc(uint64_t x = 1) {
+    slots_[this_shard()].value.fetch_add(x, std::memory_order_relaxed);
+  }
+
+  /// Returns the current value of the counter.
+  uint64_t value() const {
+    uint64_t result = 0;
+    for (auto& x : slots_)
+      result += x.value.load(std::memory_order_relaxed);
+    return result;
+  }
+
+private:
+  padded_atomic<uint64_t> slots_[num_shards];
+};
+
+} // namespace metrics
+} // namespace caf
+
+#endif // CAF_METRICS_COUNTER_HPP
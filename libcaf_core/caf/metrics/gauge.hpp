@@ -0,0 +1,65 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_METRICS_GAUGE_HPP
+#define CAF_METRICS_GAUGE_HPP
+
+#include <cstdint>
+
+#include "caf/metrics/shard.hpp"
+
+namespace caf {
+namespace metrics {
+
+/// A value that can go up and down, e.g., the number of queued jobs. A
+/// single thread may decrement a value that another thread incremented, i.e.,
+/// individual slots can become negative but their sum is always accurate.
+class gauge {
+public:
+  gauge() = default;
+
+  gauge(const gauge&) = delete;
+  gauge& operator=(const gauge&) = delete;
+
+  /// Increments the gauge by `x`.
+  inline void inc(int64_t x = 1) {
+    slots_[this_shard()].value.fetch_add(x, std::memory_order_relaxed);
+  }
+
+  /// Decrements the gauge by `x`.
+  inline void dec(int64_t x = 1) {
+    slots_[this_shard()].value.fetch_sub(x, std::memory_order_relaxed);
+  }
+
+  /// Returns the current value of the gauge.
+  int64_t value() const {
+    int64_t result = 0;
+    for (auto& x : slots_)
+      result += x.value.load(std::memory_order_relaxed);
+    return result;
+  }
+
+private:
+  padded_atomic<int64_t> slots_[num_shards];
+};
+
+} // namespace metrics
+} // namespace caf
+
+#endif // CAF_METRICS_GAUGE_HPP
@@ -0,0 +1,114 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_METRICS_HISTOGRAM_HPP
+#define CAF_METRICS_HISTOGRAM_HPP
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "caf/metrics/shard.hpp"
+
+namespace caf {
+namespace metrics {
+
+/// Counts observations of non-negative integers, e.g., durations in
+/// nanoseconds, in log-linear buckets: each power of two is divided into four
+/// equally sized buckets, which bounds the relative error of any quantile
+/// estimate to 25% while covering the full range of `uint64_t` with a fixed
+/// number of buckets.
+class histogram {
+public:
+  /// Number of linear sub-buckets per power of two (as a power of two).
+  static constexpr size_t sub_bucket_bits = 2;
+
+  /// Number of linear sub-buckets per power of two.
+  static constexpr size_t sub_buckets = size_t{1} << sub_bucket_bits;
+
+  /// Total number of buckets.
+  static constexpr size_t num_buckets = 252;
+
+  /// Aggregated state of a histogram.
+  struct data {
+    /// Number of observations per bucket.
+    std::vector<uint64_t> buckets;
+    /// Total number of observations.
+    uint64_t count;
+    /// Sum of all observed values.
+    uint64_t sum;
+  };
+
+  histogram();
+
+  histogram(const histogram&) = delete;
+  histogram& operator=(const histogram&) = delete;
+
+  ~histogram();
+
+  /// Returns the index of the bucket for `x`.
+  static inline size_t bucket_of(uint64_t x) {
+    if (x < sub_buckets)
+      return static_cast<size_t>(x);
+    auto msb = log2(x);
+    return (msb - sub_bucket_bits + 1) * sub_buckets
+           + static_cast<size_t>((x >> (msb - sub_bucket_bits))
+                                 & (sub_buckets - 1));
+  }
+
+  /// Returns the largest value that falls into the bucket `index`.
+  static uint64_t upper_bound(size_t index);
+
+  /// Records the observation `x`.
+  inline void observe(uint64_t x) {
+    auto& s = shards_[this_shard()];
+    s.buckets[bucket_of(x)].fetch_add(1, std::memory_order_relaxed);
+    s.sum.fetch_add(x, std::memory_order_relaxed);
+  }
+
+  /// Returns the aggregated state of all shards.
+  data collect() const;
+
+private:
+  // returns the position of the most significant bit in `x`
+  static inline size_t log2(uint64_t x) {
+#   ifdef CAF_MSVC
+    size_t result = 0;
+    while (x >>= 1)
+      ++result;
+    return result;
+#   else
+    return static_cast<size_t>(63 - __builtin_clzll(x));
+#   endif
+  }
+
+  struct shard {
+    shard();
+    std::array<std::atomic<uint64_t>, num_buckets> buckets;
+    std::atomic<uint64_t> sum;
+    char pad[CAF_CACHE_LINE_SIZE];
+  };
+
+  shard* shards_;
+};
+
+} // namespace metrics
+} // namespace caf
+
+#endif // CAF_METRICS_HISTOGRAM_HPP
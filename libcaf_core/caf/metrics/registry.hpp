@@ -0,0 +1,205 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_METRICS_REGISTRY_HPP
+#define CAF_METRICS_REGISTRY_HPP
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <functional>
+
+#include "caf/fwd.hpp"
+
+#include "caf/meta/type_name.hpp"
+
+#include "caf/metrics/gauge.hpp"
+#include "caf/metrics/counter.hpp"
+#include "caf/metrics/histogram.hpp"
+
+namespace caf {
+namespace metrics {
+
+/// Denotes the kind of a metric.
+enum class metric_type : uint8_t {
+  counter,
+  gauge,
+  histogram
+};
+
+/// @relates metric_type
+std::string to_string(metric_type x);
+
+/// A point-in-time copy of a single metric.
+struct snapshot {
+  /// Name of the metric, e.g., `caf_actor_messages_processed_total`.
+  std::string name;
+  /// Comma-separated list of `key="value"` pairs, e.g., `peer="..."`.
+  std::string labels;
+  /// Human-readable description of the metric.
+  std::string help;
+  /// Kind of the metric.
+  metric_type type;
+  /// Current value of counters and gauges, number of observations for
+  /// histograms.
+  int64_t value;
+  /// Sum of all observed values (histograms only).
+  uint64_t sum;
+  /// Number of observations per bucket (histograms only). The upper bound of
+  /// each bucket is given by `histogram::upper_bound`.
+  std::vector<uint64_t> buckets;
+};
+
+/// @relates snapshot
+template <class Inspector>
+typename Inspector::result_type inspect(Inspector& f, snapshot& x) {
+  return f(meta::type_name("snapshot"), x.name, x.labels, x.help,
+           x.type, x.value, x.sum, x.buckets);
+}
+
+/// Metrics the runtime collects about itself if `metrics.enable-runtime` is
+/// set.
+struct runtime_metrics {
+  /// Messages enqueued to mailboxes of scheduled actors.
+  counter* messages_enqueued;
+  /// Messages processed by scheduled actors.
+  counter* messages_processed;
+  /// Resumes of scheduled actors that ended because the actor exhausted its
+  /// time budget.
+  counter* resume_budget_exhausted;
+  /// Mailbox size of scheduled actors on every
+  /// `mailbox_size_sample_interval`-th resume, counted up to
+  /// `max_sampled_mailbox_size` elements.
+  histogram* mailbox_size;
+  /// Jobs in the queues of the scheduler.
+  gauge* queued_jobs;
+  /// Attempts of workers to steal jobs from other workers.
+  counter* steal_attempts;
+  /// Jobs stolen from other workers.
+  counter* steals;
+  /// Threads started by the pool for detached actors.
+  counter* detached_threads_started;
+  /// Threads stopped by the pool for detached actors.
+  counter* detached_threads_stopped;
+  /// Nanoseconds detached actors waited for a thread.
+  histogram* detached_queue_wait;
+  /// Proxies for remote actors.
+  gauge* proxies;
+  /// Batches emitted on outbound stream paths.
+  counter* stream_batches;
+  /// Elements emitted on outbound stream paths.
+  counter* stream_elements;
+};
+
+/// Limits the number of mailbox elements counted for `mailbox_size`.
+constexpr size_t max_sampled_mailbox_size = 256;
+
+/// Samples `mailbox_size` only on every n-th resume of an actor, since
+/// counting the mailbox elements is linear in the mailbox size.
+constexpr size_t mailbox_size_sample_interval = 16;
+
+/// Manages all metrics of an actor system. Metrics are identified by name and
+/// labels, and registering a metric twice returns the same instance. Any
+/// thread may update metrics or take a snapshot at any time.
+class registry {
+public:
+  friend class caf::actor_system;
+
+  using callback = std::function<int64_t ()>;
+
+  registry();
+
+  registry(const registry&) = delete;
+  registry& operator=(const registry&) = delete;
+
+  ~registry();
+
+  /// Returns the counter `name` with `labels`, creating it if needed.
+  counter& get_counter(const std::string& name, const std::string& labels = "",
+                       const std::string& help = "");
+
+  /// Returns the gauge `name` with `labels`, creating it if needed.
+  gauge& get_gauge(const std::string& name, const std::string& labels = "",
+                   const std::string& help = "");
+
+  /// Returns the histogram `name` with `labels`, creating it if needed.
+  histogram& get_histogram(const std::string& name,
+                           const std::string& labels = "",
+                           const std::string& help = "");
+
+  /// Adds a gauge that computes its value by calling `f` whenever taking a
+  /// snapshot. Replaces any previous callback for `name` and `labels`.
+  /// @warning `f` runs in the thread calling `collect` and must not call
+  ///          member functions of this registry.
+  void add_callback(const std::string& name, const std::string& labels,
+                    const std::string& help, callback f);
+
+  /// Removes a callback previously added via `add_callback`.
+  void remove_callback(const std::string& name, const std::string& labels);
+
+  /// Returns a snapshot of all metrics, sorted by name and labels.
+  std::vector<snapshot> collect() const;
+
+  /// Returns the histogram for the mailbox latency of actors named `name` or
+  /// `nullptr` if `metrics.mailbox-latency-actors` does not list `name`.
+  /// All actors with the same name share a single histogram.
+  histogram* mailbox_latency(const char* name);
+
+  /// Returns the histogram for the processing time of actors named `name` or
+  /// `nullptr` if `metrics.enable-runtime` is not set. All actors with the
+  /// same name share a single histogram.
+  histogram* processing_time(const char* name);
+
+  /// Returns the metrics of the runtime or `nullptr` if disabled.
+  inline runtime_metrics* runtime() {
+    return runtime_enabled_ ? &runtime_ : nullptr;
+  }
+
+private:
+  using key_type = std::pair<std::string, std::string>;
+
+  struct entry {
+    metric_type type;
+    std::string help;
+    std::unique_ptr<counter> ctr;
+    std::unique_ptr<gauge> gge;
+    std::unique_ptr<histogram> hst;
+    callback fun;
+  };
+
+  void init(actor_system_config& cfg);
+
+  entry& get(metric_type type, const std::string& name,
+             const std::string& labels, const std::string& help);
+
+  mutable std::mutex mtx_;
+  std::map<key_type, entry> entries_;
+  bool runtime_enabled_;
+  runtime_metrics runtime_;
+  std::vector<std::string> mailbox_latency_actors_;
+};
+
+} // namespace metrics
+} // namespace caf
+
+#endif // CAF_METRICS_REGISTRY_HPP
@@ -0,0 +1,63 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_METRICS_SHARD_HPP
+#define CAF_METRICS_SHARD_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "caf/config.hpp"
+
+namespace caf {
+namespace metrics {
+
+/// Number of independent slots per metric. Each thread updates only one
+/// slot, which keeps cache lines mostly thread-local. Readers sum up all
+/// slots.
+constexpr size_t num_shards = 16;
+
+/// Returns the index of a new shard in round-robin fashion.
+size_t next_shard();
+
+/// Returns the shard assigned to the calling thread.
+#ifdef CAF_NO_THREAD_LOCAL
+size_t this_shard();
+#else // CAF_NO_THREAD_LOCAL
+inline size_t this_shard() {
+  static thread_local size_t result = next_shard();
+  return result;
+}
+#endif // CAF_NO_THREAD_LOCAL
+
+/// A single value padded to a full cache line.
+template <class T>
+struct padded_atomic {
+  padded_atomic() : value(0) {
+    // nop
+  }
+  std::atomic<T> value;
+  char pad[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<T>)];
+};
+
+} // namespace metrics
+} // namespace caf
+
+#endif // CAF_METRICS_SHARD_HPP
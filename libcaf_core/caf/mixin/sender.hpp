@@ -22,11 +22,14 @@
 
 #include <tuple>
 #include <chrono>
+#include <vector>
+#include <iterator>
 
 #include "caf/fwd.hpp"
 #include "caf/actor.hpp"
 #include "caf/message.hpp"
 #include "caf/duration.hpp"
+#include "caf/mailbox_element.hpp"
 #include "caf/response_type.hpp"
 #include "caf/response_handle.hpp"
 #include "caf/message_priority.hpp"
@@ -82,6 +85,34 @@ public:
                     dptr()->context(), std::forward<Ts>(xs)...);
   }
 
+  /// Sends all messages in `[first, last)` to `dest` with priority `P`. A
+  /// local receiver gets the entire batch published to its mailbox with a
+  /// single atomic operation and is scheduled at most once.
+  template <message_priority P = message_priority::normal,
+            class Dest = actor, class Iterator>
+  void send_batch(const Dest& dest, Iterator first, Iterator last) {
+    static_assert(!statically_typed<Subtype>() && !statically_typed<Dest>(),
+                  "send_batch() sends type-erased messages and is only "
+                  "available for dynamically typed actors");
+    if (!dest || first == last)
+      return;
+    std::vector<mailbox_element_ptr> xs;
+    for (; first != last; ++first)
+      xs.emplace_back(make_mailbox_element(dptr()->ctrl(), message_id::make(P),
+                                           {}, *first));
+    dest->enqueue_batch(std::move(xs), dptr()->context());
+  }
+
+  /// Sends all messages in `xs` to `dest` with priority `P`.
+  /// @copydetails send_batch
+  template <message_priority P = message_priority::normal,
+            class Dest = actor, class Container>
+  void send_batch(const Dest& dest, const Container& xs) {
+    using std::begin;
+    using std::end;
+    send_batch<P>(dest, begin(xs), end(xs));
+  }
+
   template <message_priority P = message_priority::normal,
             class Source = actor, class Dest = actor, class... Ts>
   void anon_send(const Dest& dest, Ts&&... xs) {
@@ -20,6 +20,7 @@
 #ifndef CAF_MIXIN_SUBSCRIBER_HPP
 #define CAF_MIXIN_SUBSCRIBER_HPP
 
+#include <memory>
 #include <unordered_set>
 
 #include "caf/fwd.hpp"
@@ -57,10 +58,12 @@ public:
   // -- overridden functions of monitorable_actor ------------------------------
 
   bool cleanup(error&& fail_state, execution_unit* ptr) override {
-    auto me = dptr()->ctrl();
-    for (auto& subscription : subscriptions_)
-      subscription->unsubscribe(me);
-    subscriptions_.clear();
+    if (subscriptions_) {
+      auto me = dptr()->ctrl();
+      for (auto& subscription : *subscriptions_)
+        subscription->unsubscribe(me);
+      subscriptions_.reset();
+    }
     return Base::cleanup(std::move(fail_state), ptr);
   }
 
@@ -72,20 +75,24 @@ public:
     CAF_LOG_TRACE(CAF_ARG(what));
     if (what == invalid_group)
       return;
-    if (what->subscribe(dptr()->ctrl()))
-      subscriptions_.emplace(what);
+    if (what->subscribe(dptr()->ctrl())) {
+      if (!subscriptions_)
+        subscriptions_.reset(new subscriptions);
+      subscriptions_->emplace(what);
+    }
   }
 
   /// Causes this actor to leave the group `what`.
   void leave(const group& what) {
     CAF_LOG_TRACE(CAF_ARG(what));
-    if (subscriptions_.erase(what) > 0)
+    if (subscriptions_ && subscriptions_->erase(what) > 0)
       what->unsubscribe(dptr()->ctrl());
   }
 
   /// Returns all subscribed groups.
   const subscriptions& joined_groups() const {
-    return subscriptions_;
+    static const subscriptions empty_subscriptions;
+    return subscriptions_ ? *subscriptions_ : empty_subscriptions;
   }
 
 private:
@@ -95,8 +102,8 @@ private:
 
   // -- data members -----------------------------------------------------------
 
-  /// Stores all subscribed groups.
-  subscriptions subscriptions_;
+  /// Stores all subscribed groups, allocated on the first `join`.
+  std::unique_ptr<subscriptions> subscriptions_;
 };
 
 } // namespace mixin
@@ -28,7 +28,6 @@
 #include <vector>
 #include <cstdint>
 #include <type_traits>
-#include <condition_variable>
 
 #include "caf/type_nr.hpp"
 #include "caf/actor_addr.hpp"
@@ -162,9 +161,6 @@ protected:
   // can be accessed without lock for event-based and blocking actors
   error fail_state_;
 
-  // only used in blocking and thread-mapped actors
-  mutable std::condition_variable cv_;
-
   // attached functors that are executed on cleanup (monitors, links, etc)
   attachable_ptr attachables_head_;
 
@@ -64,7 +64,7 @@ struct profiled : Policy {
   void after_completion(Worker* worker, resumable* job) {
     Policy::after_completion(worker, job);
     auto parent = static_cast<coordinator_type*>(worker->parent());
-    parent->remove_job(id_of(job));
+    parent->remove_job(worker->id(), id_of(job));
   }
 };
 
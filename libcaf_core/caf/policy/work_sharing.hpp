@@ -28,6 +28,8 @@
 #include "caf/resumable.hpp"
 #include "caf/policy/unprofiled.hpp"
 
+#include "caf/scheduler/worker_stats.hpp"
+
 namespace caf {
 namespace policy {
 
@@ -91,7 +93,13 @@ public:
   resumable* dequeue(Worker* self) {
     auto& parent_data = d(self->parent());
     std::unique_lock<std::mutex> guard(parent_data.lock);
-    parent_data.cv.wait(guard, [&] { return !parent_data.queue.empty(); });
+    if (parent_data.queue.empty()) {
+      // there are no poll phases, all waiting is sleeping on the condition
+      using clock_type = scheduler::worker_counters::clock_type;
+      auto t0 = clock_type::now();
+      parent_data.cv.wait(guard, [&] { return !parent_data.queue.empty(); });
+      self->counters().slept(clock_type::now() - t0);
+    }
     resumable* job = parent_data.queue.front();
     parent_data.queue.pop_front();
     return job;
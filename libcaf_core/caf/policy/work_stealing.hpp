@@ -29,8 +29,12 @@
 #include "caf/resumable.hpp"
 #include "caf/actor_system_config.hpp"
 
+#include "caf/metrics/registry.hpp"
+
 #include "caf/policy/unprofiled.hpp"
 
+#include "caf/scheduler/worker_stats.hpp"
+
 #include "caf/detail/double_ended_queue.hpp"
 
 namespace caf {
@@ -81,7 +85,8 @@ public:
              usec{p->system().config().work_stealing_moderate_sleep_duration_us}},
             {1, 0, p->system().config().work_stealing_relaxed_steal_interval,
             usec{p->system().config().work_stealing_relaxed_sleep_duration_us}}
-          } {
+          },
+          metrics(p->system().metrics().runtime()) {
       // nop
     }
 
@@ -92,6 +97,8 @@ public:
     std::default_random_engine rengine;
     std::uniform_int_distribution<size_t> uniform;
     poll_strategy strategies[3];
+    // runtime metrics of the actor system or `nullptr` if disabled
+    metrics::runtime_metrics* metrics;
   };
 
   // Goes on a raid in quest for a shiny new job.
@@ -107,7 +114,20 @@ public:
     if (victim == self->id())
       victim = p->num_workers() - 1;
     // steal oldest element from the victim's queue
-    return d(p->worker_by_id(victim)).queue.take_tail();
+    auto victim_ptr = p->worker_by_id(victim);
+    auto job = d(victim_ptr).queue.take_tail();
+    self->counters().steal_attempt(job != nullptr);
+    if (job != nullptr)
+      victim_ptr->counters().job_dequeued();
+    auto rt = d(self).metrics;
+    if (rt != nullptr) {
+      rt->steal_attempts->inc();
+      if (job != nullptr) {
+        rt->steals->inc();
+        rt->queued_jobs->dec();
+      }
+    }
+    return job;
   }
 
   template <class Coordinator>
@@ -118,11 +138,13 @@ public:
 
   template <class Worker>
   void external_enqueue(Worker* self, resumable* job) {
+    count_enqueue(self);
     d(self).queue.append(job);
   }
 
   template <class Worker>
   void internal_enqueue(Worker* self, resumable* job) {
+    count_enqueue(self);
     d(self).queue.prepend(job);
   }
 
@@ -130,6 +152,7 @@ public:
   void resume_job_later(Worker* self, resumable* job) {
     // job has voluntarily released the CPU to let others run instead
     // this means we are going to put this job to the very end of our queue
+    count_enqueue(self);
     d(self).queue.append(job);
   }
 
@@ -143,21 +166,46 @@ public:
     // downside of "busy waiting", which still performs much better than a
     // "signalizing" implementation based on mutexes and conition variables
     auto& strategies = d(self).strategies;
-    resumable* job = nullptr;
-    for (auto& strat : strategies) {
+    // skip reading the clock if a job is available right away
+    resumable* job = d(self).queue.take_head();
+    if (job) {
+      count_dequeue(self);
+      return job;
+    }
+    using clock_type = scheduler::worker_counters::clock_type;
+    auto& counters = self->counters();
+    auto phase_start = clock_type::now();
+    for (size_t phase = 0; phase < scheduler::worker_counters::num_poll_phases;
+         ++phase) {
+      auto& strat = strategies[phase];
       for (size_t i = 0; i < strat.attempts; i += strat.step_size) {
         job = d(self).queue.take_head();
-        if (job)
+        if (job) {
+          count_dequeue(self);
+          counters.polled(phase, clock_type::now() - phase_start);
           return job;
+        }
         // try to steal every X poll attempts
         if ((i % strat.steal_interval) == 0) {
           job = try_steal(self);
-          if (job)
+          if (job) {
+            counters.polled(phase, clock_type::now() - phase_start);
             return job;
+          }
         }
-        if (strat.sleep_duration.count() > 0)
+        if (strat.sleep_duration.count() > 0) {
+          auto t0 = clock_type::now();
           std::this_thread::sleep_for(strat.sleep_duration);
+          auto t1 = clock_type::now();
+          counters.slept(t1 - t0);
+          // account long-running relaxed polling periodically
+          counters.polled(phase, t1 - phase_start);
+          phase_start = t1;
+        }
       }
+      auto now = clock_type::now();
+      counters.polled(phase, now - phase_start);
+      phase_start = now;
     }
     // unreachable, because the last strategy loops
     // until a job has been dequeued
@@ -168,6 +216,7 @@ public:
   void foreach_resumable(Worker* self, UnaryFunction f) {
     auto next = [&] { return d(self).queue.take_head(); };
     for (auto job = next(); job != nullptr; job = next()) {
+      count_dequeue(self);
       f(job);
     }
   }
@@ -176,6 +225,21 @@ public:
   void foreach_central_resumable(Coordinator*, UnaryFunction) {
     // nop
   }
+
+private:
+  template <class Worker>
+  void count_enqueue(Worker* self) {
+    self->counters().job_enqueued();
+    if (d(self).metrics != nullptr)
+      d(self).metrics->queued_jobs->inc();
+  }
+
+  template <class Worker>
+  void count_dequeue(Worker* self) {
+    self->counters().job_dequeued();
+    if (d(self).metrics != nullptr)
+      d(self).metrics->queued_jobs->dec();
+  }
 };
 
 } // namespace policy
@@ -0,0 +1,133 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RESPONSE_FUTURE_HPP
+#define CAF_RESPONSE_FUTURE_HPP
+
+#include <type_traits>
+
+#include "caf/sec.hpp"
+#include "caf/message.hpp"
+#include "caf/expected.hpp"
+#include "caf/mailbox_element.hpp"
+
+#include "caf/detail/response_result.hpp"
+#include "caf/detail/response_receiver.hpp"
+
+namespace caf {
+
+/// Represents the response to a request sent by a `sync_requester`. Calling
+/// `get` blocks the current thread until the response arrives or until the
+/// request times out. Destroying a future without calling `get` discards the
+/// response.
+template <class Output>
+class response_future {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using value_type = typename detail::response_result<Output>::type;
+
+  using clock_type = detail::response_receiver::clock_type;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  response_future(detail::response_receiver* self,
+                  clock_type::time_point deadline, bool has_deadline)
+      : self_(self),
+        deadline_(deadline),
+        has_deadline_(has_deadline) {
+    // nop
+  }
+
+  response_future(response_future&& other)
+      : self_(other.self_),
+        deadline_(other.deadline_),
+        has_deadline_(other.has_deadline_) {
+    other.self_ = nullptr;
+  }
+
+  response_future& operator=(response_future&& other) {
+    if (this != &other) {
+      discard();
+      self_ = other.self_;
+      deadline_ = other.deadline_;
+      has_deadline_ = other.has_deadline_;
+      other.self_ = nullptr;
+    }
+    return *this;
+  }
+
+  response_future(const response_future&) = delete;
+
+  response_future& operator=(const response_future&) = delete;
+
+  ~response_future() {
+    discard();
+  }
+
+  // -- observers --------------------------------------------------------------
+
+  /// Returns whether `get` has not been called yet.
+  bool valid() const {
+    return self_ != nullptr;
+  }
+
+  // -- blocking access --------------------------------------------------------
+
+  /// Blocks until the response arrives and converts it to the result type
+  /// of the request. Returns `sec::request_timeout` if no response arrived
+  /// before the deadline.
+  /// @pre `valid()`
+  expected<value_type> get() {
+    CAF_ASSERT(valid());
+    auto self = self_;
+    self_ = nullptr;
+    auto ptr = self->await_response(has_deadline_ ? &deadline_ : nullptr);
+    if (!ptr)
+      return sec::request_timeout;
+    return convert(*ptr, std::is_same<Output, message>{});
+  }
+
+private:
+  void discard() {
+    if (self_ != nullptr) {
+      self_->cancel();
+      self_ = nullptr;
+    }
+  }
+
+  // dynamically typed requests hand out the content as `message`
+  static expected<value_type> convert(mailbox_element& x, std::true_type) {
+    auto msg = x.move_content_to_message();
+    return detail::response_result<Output>::convert(msg);
+  }
+
+  // statically typed requests read the content without allocating a message
+  static expected<value_type> convert(mailbox_element& x, std::false_type) {
+    return detail::response_result<Output>::convert(x.content());
+  }
+
+  detail::response_receiver* self_;
+  clock_type::time_point deadline_;
+  bool has_deadline_;
+};
+
+} // namespace caf
+
+#endif // CAF_RESPONSE_FUTURE_HPP
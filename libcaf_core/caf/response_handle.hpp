@@ -76,6 +76,16 @@ public:
     then_impl(f, e);
   }
 
+  /// Returns the ID of the expected response.
+  message_id id() const {
+    return mid_;
+  }
+
+  /// Returns the actor that receives the response.
+  Self* self() const {
+    return self_;
+  }
+
 private:
   template <class F>
   void await_impl(F& f) const {
@@ -26,9 +26,12 @@
 #include "caf/message.hpp"
 #include "caf/actor_addr.hpp"
 #include "caf/message_id.hpp"
+#include "caf/trace_context.hpp"
 #include "caf/response_type.hpp"
 #include "caf/check_typed_input.hpp"
 
+#include "caf/detail/tracer.hpp"
+
 namespace caf {
 
 /// A response promise can be used to deliver a uniquely identifiable
@@ -78,6 +81,7 @@ public:
     static_assert(response_type_unbox<signatures_of_t<Handle>, token>::valid,
                   "receiver does not accept given message");
     if (dest) {
+      detail::trace_scope scope{&trace_};
       auto mid = P == message_priority::high ? id_.with_high_priority() : id_;
       dest->enqueue(make_mailbox_element(std::move(source_), mid,
                                          std::move(stages_),
@@ -123,6 +127,7 @@ private:
   strong_actor_ptr source_;
   forwarding_stack stages_;
   message_id id_;
+  trace_context trace_;
 };
 
 } // namespace caf
@@ -23,9 +23,11 @@
 #include "caf/config.hpp"
 
 #ifndef CAF_NO_EXCEPTIONS
+#include <memory>
 #include <exception>
 #endif // CAF_NO_EXCEPTIONS
 
+#include <chrono>
 #include <type_traits>
 
 #include "caf/fwd.hpp"
@@ -42,6 +44,7 @@
 #include "caf/stream_sink_impl.hpp"
 #include "caf/stream_stage_impl.hpp"
 #include "caf/stream_source_impl.hpp"
+#include "caf/stream_window_stage_impl.hpp"
 #include "caf/stream_result_trait.hpp"
 #include "caf/broadcast_scatterer.hpp"
 #include "caf/terminal_stream_scatterer.hpp"
@@ -50,6 +53,8 @@
 
 #include "caf/policy/arg.hpp"
 
+#include "caf/detail/coroutine_frame_pool.hpp"
+
 #include "caf/mixin/sender.hpp"
 #include "caf/mixin/requester.hpp"
 #include "caf/mixin/behavior_changer.hpp"
@@ -169,6 +174,9 @@ public:
 
   void enqueue(mailbox_element_ptr ptr, execution_unit* eu) override;
 
+  void enqueue_batch(std::vector<mailbox_element_ptr> xs,
+                     execution_unit* eu) override;
+
   // -- overridden functions of local_actor ------------------------------------
 
   const char* name() const override;
@@ -214,14 +222,24 @@ public:
   ///          blocking API calls such as {@link receive()}.
   void quit(error x = error{});
 
+  /// Limits the time this actor may run per resume, overriding the global
+  /// `scheduler.resume-budget`. A zero duration selects the global budget.
+  inline void set_resume_budget(std::chrono::nanoseconds x) {
+    ext().resume_budget = x;
+  }
+
+  /// Returns the time this actor may run per resume or zero if only the
+  /// message-count limit of the scheduler applies.
+  std::chrono::nanoseconds resume_budget();
+
   // -- event handlers ---------------------------------------------------------
 
   /// Sets a custom handler for unexpected messages.
   inline void set_default_handler(default_handler fun) {
     if (fun)
-      default_handler_ = std::move(fun);
+      ext().default_hdl = std::move(fun);
     else
-      default_handler_ = print_and_drop;
+      ext().default_hdl = print_and_drop;
   }
 
   /// Sets a custom handler for unexpected messages.
@@ -233,7 +251,7 @@ public:
     >::value
   >::type
   set_default_handler(F fun) {
-    default_handler_ = [=](scheduled_actor*, const type_erased_tuple& xs) {
+    ext().default_hdl = [=](scheduled_actor*, const type_erased_tuple& xs) {
       return fun(xs);
     };
   }
@@ -241,9 +259,9 @@ public:
   /// Sets a custom handler for error messages.
   inline void set_error_handler(error_handler fun) {
     if (fun)
-      error_handler_ = std::move(fun);
+      ext().error_hdl = std::move(fun);
     else
-      error_handler_ = default_error_handler;
+      ext().error_hdl = default_error_handler;
   }
 
   /// Sets a custom handler for error messages.
@@ -255,9 +273,9 @@ public:
   /// Sets a custom handler for down messages.
   inline void set_down_handler(down_handler fun) {
     if (fun)
-      down_handler_ = std::move(fun);
+      ext().down_hdl = std::move(fun);
     else
-      down_handler_ = default_down_handler;
+      ext().down_hdl = default_down_handler;
   }
 
   /// Sets a custom handler for down messages.
@@ -269,9 +287,9 @@ public:
   /// Sets a custom handler for error messages.
   inline void set_exit_handler(exit_handler fun) {
     if (fun)
-      exit_handler_ = std::move(fun);
+      ext().exit_hdl = std::move(fun);
     else
-      exit_handler_ = default_exit_handler;
+      ext().exit_hdl = default_exit_handler;
   }
 
   /// Sets a custom handler for exit messages.
@@ -285,9 +303,9 @@ public:
   /// defined, only the functor that was added *last* is being executed.
   inline void set_exception_handler(exception_handler fun) {
     if (fun)
-      exception_handler_ = std::move(fun);
+      ext().exception_hdl = std::move(fun);
     else
-      exception_handler_ = default_exception_handler;
+      ext().exception_hdl = default_exception_handler;
   }
 
   /// Sets a custom exception handler for this actor. If multiple handlers are
@@ -321,6 +339,7 @@ public:
   /// @param pred Predicate returning `true` when the stream is done.
   /// @param res_handler Function object for receiving the stream result.
   /// @param scatterer_type Configures the policy for downstream communication.
+  /// @param prio Priority of the stream at the gatherer of `dest`.
   /// @returns A stream object with a pointer to the generated `stream_manager`.
   template <class Handle, class... Ts, class Init, class Getter,
             class ClosedPredicate, class ResHandler,
@@ -329,7 +348,8 @@ public:
   annotated_stream<typename stream_source_trait_t<Getter>::output, Ts...>
   make_source(const Handle& dest, std::tuple<Ts...> xs, Init init,
               Getter getter, ClosedPredicate pred, ResHandler res_handler,
-              policy::arg<Scatterer> scatterer_type = {}) {
+              policy::arg<Scatterer> scatterer_type = {},
+              stream_priority prio = stream_priority::normal) {
     CAF_IGNORE_UNUSED(scatterer_type);
     using type = typename stream_source_trait_t<Getter>::output;
     using state_type = typename stream_source_trait_t<Getter>::state;
@@ -362,13 +382,13 @@ public:
     auto ptr = make_counted<impl>(this, std::move(getter), std::move(pred));
     auto mid = new_request_id(message_priority::normal);
     if (!add_sink<type>(ptr, sid, ctrl(), actor_cast<strong_actor_ptr>(dest),
-                        no_stages, mid, stream_priority::normal, std::move(xs)))
+                        no_stages, mid, prio, std::move(xs)))
       return none;
     init(ptr->state());
     this->add_multiplexed_response_handler(
       mid.response_id(),
       stream_result_trait_t<ResHandler>::make_result_handler(res_handler));
-    streams_.emplace(sid, ptr);
+    streams().emplace(sid, ptr);
     return {std::move(sid), std::move(ptr)};
   }
 
@@ -379,6 +399,7 @@ public:
   /// @param pred Predicate returning `true` when the stream is done.
   /// @param res_handler Function object for receiving the stream result.
   /// @param scatterer_type Configures the policy for downstream communication.
+  /// @param prio Priority of the stream at the gatherer of `dest`.
   /// @returns A stream object with a pointer to the generated `stream_manager`.
   template <class Handle, class Init, class Getter, class ClosedPredicate,
             class ResHandler,
@@ -387,10 +408,11 @@ public:
   stream<typename stream_source_trait_t<Getter>::output>
   make_source(const Handle& dest, Init init, Getter getter,
               ClosedPredicate pred, ResHandler res_handler,
-              policy::arg<Scatterer> scatterer_type = {}) {
+              policy::arg<Scatterer> scatterer_type = {},
+              stream_priority prio = stream_priority::normal) {
     return make_source(dest, std::make_tuple(), std::move(init),
                        std::move(getter), std::move(pred),
-                       std::move(res_handler), scatterer_type);
+                       std::move(res_handler), scatterer_type, prio);
   }
 
   /// Creates a new stream source.
@@ -443,7 +465,7 @@ public:
     }
     drop_current_message_id();
     init(ptr->state());
-    streams_.emplace(sid, ptr);
+    streams().emplace(sid, ptr);
     return {std::move(sid), std::move(ptr)};
   }
 
@@ -525,6 +547,65 @@ public:
                       std::move(cleanup), policies);
   }
 
+  /// Creates a new stream stage that aggregates elements per key over
+  /// tumbling or sliding windows.
+  /// @pre `current_mailbox_element()` is a `stream_msg::open` handshake
+  /// @param in The input of the stage.
+  /// @param xs User-defined handshake payload.
+  /// @param win Configures size, slide, and allowed lateness of windows.
+  /// @param key Function object for extracting the key of an element.
+  /// @param time Function object for extracting the event time of an element.
+  /// @param agg Incremental aggregator, see `stream_window_stage_impl`.
+  /// @param policies Sets the policies for up- and downstream communication.
+  /// @returns A stream object with a pointer to the generated `stream_manager`.
+  template <class In, class... Ts, class KeyFun, class TimeFun,
+            class Aggregator, class Gatherer = random_gatherer,
+            class Scatterer =
+              broadcast_scatterer<typename Aggregator::output_type>>
+  stream<typename Aggregator::output_type>
+  make_window_stage(const stream<In>& in, std::tuple<Ts...> xs,
+                    stream_window win, KeyFun key, TimeFun time,
+                    Aggregator agg,
+                    policy::arg<Gatherer, Scatterer> policies = {}) {
+    CAF_IGNORE_UNUSED(policies);
+    CAF_ASSERT(current_mailbox_element() != nullptr);
+    CAF_ASSERT(current_mailbox_element()->content().match_elements<stream_msg>());
+    using output_type = typename Aggregator::output_type;
+    static_assert(std::is_same<In, typename Aggregator::input_type>::value,
+                  "Aggregator::input_type does not match the input stream");
+    using impl = stream_window_stage_impl<KeyFun, TimeFun, Aggregator,
+                                          Gatherer, Scatterer>;
+    auto ptr = make_counted<impl>(this, in.id(), win, std::move(key),
+                                  std::move(time), std::move(agg));
+    if (!serve_as_stage<output_type>(ptr, in, std::move(xs))) {
+      CAF_LOG_ERROR("installing sink and source to the manager failed");
+      return none;
+    }
+    return {in.id(), std::move(ptr)};
+  }
+
+  /// Creates a new stream stage that aggregates elements per key over
+  /// tumbling or sliding windows.
+  /// @pre `current_mailbox_element()` is a `stream_msg::open` handshake
+  /// @param in The input of the stage.
+  /// @param win Configures size, slide, and allowed lateness of windows.
+  /// @param key Function object for extracting the key of an element.
+  /// @param time Function object for extracting the event time of an element.
+  /// @param agg Incremental aggregator, see `stream_window_stage_impl`.
+  /// @param policies Sets the policies for up- and downstream communication.
+  /// @returns A stream object with a pointer to the generated `stream_manager`.
+  template <class In, class KeyFun, class TimeFun, class Aggregator,
+            class Gatherer = random_gatherer,
+            class Scatterer =
+              broadcast_scatterer<typename Aggregator::output_type>>
+  stream<typename Aggregator::output_type>
+  make_window_stage(const stream<In>& in, stream_window win, KeyFun key,
+                    TimeFun time, Aggregator agg,
+                    policy::arg<Gatherer, Scatterer> policies = {}) {
+    return make_window_stage(in, std::make_tuple(), win, std::move(key),
+                             std::move(time), std::move(agg), policies);
+  }
+
   /// Creates a new stream sink of type T.
   /// @pre `current_mailbox_element()` is a `stream_msg::open` handshake
   /// @param in The input of the sink.
@@ -551,7 +632,7 @@ public:
       return none;
     }
     f(*ptr);
-    streams_.emplace(in.id(), ptr);
+    streams().emplace(in.id(), ptr);
     return {in.id(), std::move(ptr)};
   }
 
@@ -559,7 +640,8 @@ public:
   /// @pre `current_mailbox_element()` is a `stream_msg::open` handshake
   /// @param in The input of the sink.
   /// @param init Function object for initializing the state of the stage.
-  /// @param fun Function object for processing stream elements.
+  /// @param fun Function object for processing stream elements. Returning an
+  ///            `error` other than `none` aborts the stream.
   /// @param finalize Function object for producing the final result.
   /// @param policies Sets the policies for up- and downstream communication.
   /// @returns A stream object with a pointer to the generated `stream_manager`.
@@ -576,12 +658,11 @@ public:
                     typename detail::get_callable_trait<Init>::fun_sig
                   >::value,
                   "Expected signature `void (State&)` for init function");
-    static_assert(std::is_same<
-                    void (state_type&, In),
-                    typename detail::get_callable_trait<Fun>::fun_sig
-                  >::value,
-                  "Expected signature `void (State&, Input)` "
-                  "for consume function");
+    using consume_sig = typename detail::get_callable_trait<Fun>::fun_sig;
+    static_assert(std::is_same<void (state_type&, In), consume_sig>::value
+                  || std::is_same<error (state_type&, In), consume_sig>::value,
+                  "Expected signature `void (State&, Input)` or "
+                  "`error (State&, Input)` for consume function");
     using impl = stream_sink_impl<Fun, Finalize, Gatherer, Scatterer>;
     auto initializer = [&](impl& x) {
       init(x.state());
@@ -591,7 +672,7 @@ public:
   }
 
   inline streams_map& streams() {
-    return streams_;
+    return ext().streams;
   }
 
   /// Tries to send more data on all downstream paths. Use this function to
@@ -619,18 +700,48 @@ public:
   /// Adds a callback for a multiplexed response.
   void add_multiplexed_response_handler(message_id response_id, behavior bhvr);
 
+  /// Adds a coroutine that suspended until receiving a response.
+  void add_coroutine_response_handler(message_id response_id,
+                                      detail::coroutine_response_slot* ptr);
+
+  /// Returns the allocator for coroutine frames of this actor.
+  inline detail::coroutine_frame_pool& frame_pool() {
+    return ext().frame_pool;
+  }
+
+# ifndef CAF_NO_EXCEPTIONS
+  /// Terminates the actor with the result of its exception handler for an
+  /// exception that escaped a coroutine.
+  void handle_coroutine_exception(std::exception_ptr eptr);
+# endif // CAF_NO_EXCEPTIONS
+
   /// Returns the category of `x`.
   message_category categorize(mailbox_element& x);
 
   /// Tries to consume `x`.
   virtual invoke_message_result consume(mailbox_element& x);
 
+  /// Calls `consume(x)` with the trace context of `x` installed for the
+  /// calling thread and records a span if `x` belongs to a sampled trace.
+  invoke_message_result traced_consume(mailbox_element& x);
+
   /// Tries to consume `x`.
   void consume(mailbox_element_ptr x);
 
   /// Tries to consume one element form the cache using the current behavior.
+  /// Skips all elements with a type the actor cannot consume in its current
+  /// state without invoking the behavior, preserving FIFO order otherwise.
   bool consume_from_cache();
 
+  /// Moves the skipped element `x` to the cache and indexes it by its type.
+  /// Scheduled actors must put all skipped messages into the cache via this
+  /// function, because `consume_from_cache` relies on the index.
+  void stash(mailbox_element_ptr x);
+
+  /// Returns whether the actor may consume a cached ordinary message with
+  /// type token `tt` in its current state.
+  bool may_consume_stashed(uint32_t tt);
+
   /// Activates an actor and runs initialization code if necessary.
   /// @returns `true` if the actor is alive and ready for `reactivate`,
   ///          `false` otherwise.
@@ -650,8 +761,10 @@ public:
   inline bool has_behavior() const {
     return !bhvr_stack_.empty()
            || !awaited_responses_.empty()
-           || !multiplexed_responses_.empty()
-           || !streams_.empty();
+           || (ext_ != nullptr
+               && (!ext_->multiplexed_responses.empty()
+                   || !ext_->coroutine_responses.empty()
+                   || !ext_->streams.empty()));
   }
 
   inline behavior& current_behavior() {
@@ -775,7 +888,7 @@ public:
       rp.deliver(sec::cannot_add_upstream);
       return false;
     }
-    streams_.emplace(sid, mgr);
+    streams().emplace(sid, mgr);
     return true;
   }
 
@@ -807,6 +920,118 @@ public:
 protected:
   /// @cond PRIVATE
 
+  /// Bundles state that only few actors ever use. Idle actors carry only a
+  /// pointer to this side block, which is allocated on first use.
+  struct extended_state {
+    /// Recycles coroutine frames. Declared first to outlive suspended
+    /// coroutines that other members may still destroy.
+    detail::coroutine_frame_pool frame_pool;
+
+    /// Stores callbacks for multiplexed responses.
+    std::unordered_map<message_id, behavior> multiplexed_responses;
+
+    /// Stores coroutines awaiting a response.
+    std::unordered_map<message_id, detail::coroutine_response_slot*>
+      coroutine_responses;
+
+    /// Holds state for all streams running through this actor.
+    streams_map streams;
+
+    /// Counts the ordinary messages in the cache per type token.
+    std::unordered_map<uint32_t, size_t> stash_index;
+
+    /// Counts the response messages in the cache.
+    size_t stashed_responses = 0;
+
+    /// Overrides the global time budget per resume if non-zero.
+    std::chrono::nanoseconds resume_budget{0};
+
+    /// Caches the processing time histogram for the name of this actor.
+    metrics::histogram* processing_time = nullptr;
+
+    /// Counts resumes for sampling the mailbox size.
+    size_t resumes = 0;
+
+    /// Custom handlers, empty handlers select the shared static defaults.
+    default_handler default_hdl;
+    error_handler error_hdl;
+    down_handler down_hdl;
+    exit_handler exit_hdl;
+#   ifndef CAF_NO_EXCEPTIONS
+    exception_handler exception_hdl;
+#   endif // CAF_NO_EXCEPTIONS
+  };
+
+  /// Returns the side block for rarely used state, allocating it if needed.
+  inline extended_state& ext() {
+    if (!ext_)
+      ext_.reset(new extended_state);
+    return *ext_;
+  }
+
+  /// @endcond
+
+  // -- handler and state accessors for subclasses -----------------------------
+
+  // Handlers and rarely used containers no longer are protected member
+  // variables (`default_handler_`, `error_handler_`, `down_handler_`,
+  // `exit_handler_`, `exception_handler_`, `multiplexed_responses_` and
+  // `streams_`). Subclasses that chain handlers use the accessors below.
+
+  /// Returns the handler for unexpected messages currently in effect, i.e.,
+  /// the custom handler if set or the default handler otherwise.
+  inline default_handler current_default_handler() const {
+    return current_handler(&extended_state::default_hdl, print_and_drop);
+  }
+
+  /// Returns the handler for error messages currently in effect.
+  inline error_handler current_error_handler() const {
+    return current_handler(&extended_state::error_hdl, default_error_handler);
+  }
+
+  /// Returns the handler for down messages currently in effect.
+  inline down_handler current_down_handler() const {
+    return current_handler(&extended_state::down_hdl, default_down_handler);
+  }
+
+  /// Returns the handler for exit messages currently in effect.
+  inline exit_handler current_exit_handler() const {
+    return current_handler(&extended_state::exit_hdl, default_exit_handler);
+  }
+
+# ifndef CAF_NO_EXCEPTIONS
+  /// Returns the exception handler currently in effect.
+  inline exception_handler current_exception_handler() const {
+    return current_handler(&extended_state::exception_hdl,
+                           default_exception_handler);
+  }
+# endif // CAF_NO_EXCEPTIONS
+
+  /// Returns the callbacks for pending multiplexed responses.
+  inline std::unordered_map<message_id, behavior>& multiplexed_responses() {
+    return ext().multiplexed_responses;
+  }
+
+  /// @cond PRIVATE
+
+  /// Returns the custom handler `member` if set or `fallback` otherwise.
+  template <class F, class G>
+  F current_handler(F extended_state::*member, G fallback) const {
+    if (ext_ != nullptr && (ext_.get()->*member))
+      return ext_.get()->*member;
+    return F{fallback};
+  }
+
+  /// Calls the custom handler `member` via `call_handler` if the actor has
+  /// one or the static default `fallback` otherwise.
+  template <class F, class G, class... Ts>
+  auto call_handler(F extended_state::*member, G fallback, Ts&&... xs)
+  -> decltype(fallback(std::forward<Ts>(xs)...)) {
+    if (ext_ != nullptr && (ext_.get()->*member))
+      return call_handler(ext_.get()->*member, std::forward<Ts>(xs)...);
+    return fallback(std::forward<Ts>(xs)...);
+  }
+
   /// Utility function that swaps `f` into a temporary before calling it
   /// and restoring `f` only if it has not been replaced by the user.
   template <class F, class... Ts>
@@ -839,6 +1064,9 @@ protected:
 
   bool handle_stream_msg(mailbox_element& x, behavior* active_behavior);
 
+  /// Schedules this actor after an enqueue operation unblocked its mailbox.
+  void schedule_unblocked(execution_unit* eu);
+
   // -- Member Variables -------------------------------------------------------
 
   /// Stores user-defined callbacks for message handling.
@@ -850,32 +1078,17 @@ protected:
   /// Stores callbacks for awaited responses.
   std::forward_list<pending_response> awaited_responses_;
 
-  /// Stores callbacks for multiplexed responses.
-  std::unordered_map<message_id, behavior> multiplexed_responses_;
-
-  /// Customization point for setting a default `message` callback.
-  default_handler default_handler_;
-
-  /// Customization point for setting a default `error` callback.
-  error_handler error_handler_;
-
-  /// Customization point for setting a default `down_msg` callback.
-  down_handler down_handler_;
-
-  /// Customization point for setting a default `exit_msg` callback.
-  exit_handler exit_handler_;
+  /// Stores multiplexed responses, streams, and custom handlers.
+  std::unique_ptr<extended_state> ext_;
 
   /// Pointer to a private thread object associated with a detached actor.
   detail::private_thread* private_thread_;
 
-  // TODO: this type is quite heavy in terms of memory, maybe use vector?
-  /// Holds state for all streams running through this actor.
-  streams_map streams_;
-
-# ifndef CAF_NO_EXCEPTIONS
-  /// Customization point for setting a default exception callback.
-  exception_handler exception_handler_;
-# endif // CAF_NO_EXCEPTIONS
+# ifdef CAF_ENABLE_MAILBOX_LATENCY
+  /// Records the time messages spend in the mailbox or `nullptr` if the
+  /// configuration does not select this actor.
+  metrics::histogram* mailbox_latency_;
+# endif // CAF_ENABLE_MAILBOX_LATENCY
 
   /// @endcond
 };
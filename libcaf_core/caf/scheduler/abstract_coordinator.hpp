@@ -22,6 +22,7 @@
 
 #include <chrono>
 #include <atomic>
+#include <vector>
 #include <cstddef>
 
 #include "caf/fwd.hpp"
@@ -32,6 +33,8 @@
 #include "caf/actor_addr.hpp"
 #include "caf/actor_system.hpp"
 
+#include "caf/scheduler/worker_stats.hpp"
+
 namespace caf {
 namespace scheduler {
 
@@ -66,10 +69,26 @@ public:
     return max_throughput_;
   }
 
+  /// Returns the time an actor may run per resume or zero for no limit.
+  inline std::chrono::nanoseconds resume_budget() const {
+    return resume_budget_;
+  }
+
+  /// Returns the number of messages between two checks of the budget.
+  inline size_t resume_budget_interval() const {
+    return resume_budget_interval_;
+  }
+
   inline size_t num_workers() const {
     return num_workers_;
   }
 
+  /// Returns the counters of all workers. Each worker updates its counters
+  /// with relaxed atomic operations, i.e., the result is not a consistent
+  /// snapshot across workers. Returns an empty vector for schedulers without
+  /// worker threads.
+  virtual std::vector<worker_stats> collect_worker_stats() const;
+
   void start() override;
 
   void init(actor_system_config& cfg) override;
@@ -89,6 +108,12 @@ protected:
   // number of messages each actor is allowed to consume per resume
   size_t max_throughput_;
 
+  // time each actor is allowed to run per resume
+  std::chrono::nanoseconds resume_budget_;
+
+  // number of messages between two checks of the time budget
+  size_t resume_budget_interval_;
+
   // configured number of workers
   size_t num_workers_;
 
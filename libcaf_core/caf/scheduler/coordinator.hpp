@@ -55,6 +55,14 @@ public:
     return data_;
   }
 
+  std::vector<worker_stats> collect_worker_stats() const override {
+    std::vector<worker_stats> result;
+    result.reserve(workers_.size());
+    for (size_t i = 0; i < workers_.size(); ++i)
+      result.emplace_back(workers_[i]->counters().snapshot(i));
+    return result;
+  }
+
   static actor_system::module* make(actor_system& sys, detail::type_list<>) {
     return new coordinator(sys);
   }
@@ -34,15 +34,21 @@
 #include <cmath>
 #include <mutex>
 #include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
 #include <vector>
-#include <fstream>
+#include <cstring>
 #include <iomanip>
-#include <unordered_map>
+#include <iostream>
+#include <condition_variable>
 
 #include "caf/actor_system_config.hpp"
 
 #include "caf/scheduler/coordinator.hpp"
 
+#include "caf/detail/profiler_log.hpp"
+
 #include "caf/policy/profiled.hpp"
 #include "caf/policy/work_stealing.hpp"
 
@@ -52,12 +58,15 @@ namespace caf {
 namespace scheduler {
 
 /// A coordinator which keeps fine-grained profiling state about its workers
-/// and their jobs.
+/// and their jobs. Each worker appends binary events to its own ring buffer
+/// without taking any lock and a background thread periodically writes all
+/// events to the output file. Use `caf-prof` to convert the output into
+/// human-readable text or the Chrome trace-event format.
 template <class Policy = policy::profiled<policy::work_stealing>>
 class profiled_coordinator : public coordinator<Policy> {
 public:
   using super = coordinator<Policy>;
-  using clock_type = std::chrono::high_resolution_clock;
+  using clock_type = std::chrono::steady_clock;
 
   using usec = std::chrono::microseconds;
   using msec = std::chrono::milliseconds;
@@ -169,131 +178,159 @@ public:
   };
 
   struct worker_state {
-    actor_id current;
-    measurement job;
-    measurement worker;
-    clock_type::duration last_flush = clock_type::duration::zero();
+    worker_state(size_t ring_size) : ring(ring_size), resumes(0) {
+      // nop
+    }
+    detail::profiler_ring ring;
+    clock_type::time_point job_start;
+    size_t resumes;
   };
 
-  profiled_coordinator(actor_system& sys) : super{sys} {
+  profiled_coordinator(actor_system& sys)
+      : super{sys},
+        file_(nullptr),
+        rusage_interval_(0),
+        ring_size_(0),
+        done_(false) {
     // nop
   }
 
+  ~profiled_coordinator() {
+    if (file_ != nullptr)
+      fclose(file_);
+  }
+
   void init(actor_system_config& cfg) override {
     super::init(cfg);
-    file_.open(cfg.scheduler_profiling_output_file);
-    if (!file_)
+    file_ = fopen(cfg.scheduler_profiling_output_file.c_str(), "wb");
+    if (file_ == nullptr)
       std::cerr << R"([WARNING] could not open file ")"
                 << cfg.scheduler_profiling_output_file
                 << R"(" (no profiler output will be generated))"
                 << std::endl;
     resolution_ = msec{cfg.scheduler_profiling_ms_resolution};
+    rusage_interval_ = cfg.scheduler_profiling_rusage_interval;
+    ring_size_ = cfg.scheduler_profiling_buffer_size;
   }
 
   void start() override {
-    clock_start_ = clock_type::now().time_since_epoch();
+    // worker states must exist before the first worker runs
+    worker_states_.clear();
+    for (size_t i = 0; i < this->num_workers(); ++i)
+      worker_states_.emplace_back(new worker_state(ring_size_));
+    system_start_ = std::chrono::system_clock::now();
+    clock_start_ = clock_type::now();
+    if (file_ != nullptr) {
+      detail::profiler_log_header hdr;
+      detail::init_profiler_log_header(hdr);
+      hdr.num_workers = static_cast<uint32_t>(this->num_workers());
+      hdr.system_start = std::chrono::duration_cast<usec>(
+                           system_start_.time_since_epoch()).count();
+      hdr.resolution = static_cast<uint64_t>(resolution_.count());
+      fwrite(&hdr, sizeof(hdr), 1, file_);
+    }
+    done_ = false;
+    drain_thread_ = std::thread{[=] { drain_loop(); }};
     super::start();
-    worker_states_.resize(this->num_workers());
-    using std::setw;
-    file_.flags(std::ios::left);
-    file_ << setw(21) << "clock"     // UNIX timestamp in microseconds
-          << setw(10) << "type"      // "actor" or "worker"
-          << setw(10) << "id"        // ID of the above
-          << setw(15) << "time"      // duration of this sample (cumulative)
-          << setw(15) << "usr"       // time spent in user mode (cumulative)
-          << setw(15) << "sys"       // time spent in kernel model (cumulative)
-          << "mem"                   // used memory (cumulative)
-          << '\n';
   }
 
   void stop() override {
     CAF_LOG_TRACE("");
     super::stop();
-    auto now = clock_type::now().time_since_epoch();
-    auto wallclock = system_start_ + (now - clock_start_);
-    for (size_t i = 0; i < worker_states_.size(); ++i) {
-      record(wallclock, "worker", i, worker_states_[i].worker);
+    { // lifetime scope of guard
+      std::lock_guard<std::mutex> guard{drain_mtx_};
+      done_ = true;
     }
+    drain_cv_.notify_one();
+    drain_thread_.join();
   }
 
-  void start_measuring(size_t worker, actor_id job) {
-    auto& w = worker_states_[worker];
-    w.current = job;
-    w.job = measurement::take();
+  void start_measuring(size_t worker, actor_id) {
+    worker_states_[worker]->job_start = clock_type::now();
   }
 
   void stop_measuring(size_t worker, actor_id job) {
-    auto m = measurement::take();
-    auto& w = worker_states_[worker];
-    CAF_ASSERT(job == w.current);
-    auto delta = m - w.job;
-    // It's not possible that the wallclock timer is less than actual CPU time
-    // spent. Due to resolution mismatches of the C++ high-resolution clock and
-    // the system timers, this may appear to be the case sometimes. We "fix"
-    // this by adjusting the wallclock to the sum of user and system time, so
-    // that utilization never exceeds 100%.
-    if (delta.runtime < delta.usr + delta.sys) {
-      delta.runtime = delta.usr + delta.sys;
-    }
-    w.worker += delta;
-    report(job, delta);
-    if (m.runtime - w.last_flush >= resolution_) {
-      w.last_flush = m.runtime;
-      auto wallclock = system_start_ + (m.runtime - clock_start_);
-      std::lock_guard<std::mutex> file_guard{file_mtx_};
-      record(wallclock, "worker", worker, w.worker);
-      w.worker = {};
+    auto now = clock_type::now();
+    auto& w = *worker_states_[worker];
+    auto ev = make_event(detail::profiler_event::resume, worker, job,
+                         w.job_start);
+    ev.duration = static_cast<uint64_t>(nsec(now - w.job_start).count());
+    emit(w, ev);
+    if (rusage_interval_ > 0 && ++w.resumes >= rusage_interval_) {
+      w.resumes = 0;
+      auto m = measurement::take();
+      auto rev = make_event(detail::profiler_event::rusage, worker, 0, now);
+      rev.usr = m.usr.count();
+      rev.sys = m.sys.count();
+      rev.mem = m.mem;
+      emit(w, rev);
     }
   }
 
-  void remove_job(actor_id job) {
-    std::lock_guard<std::mutex> job_guard{job_mtx_};
-    auto j = jobs_.find(job);
-    if (j != jobs_.end()) {
-      if (job != 0) {
-        auto now = clock_type::now().time_since_epoch();
-        auto wallclock = system_start_ + (now - clock_start_);
-        std::lock_guard<std::mutex> file_guard{file_mtx_};
-        record(wallclock, "actor", job, j->second);
-      }
-      jobs_.erase(j);
-    }
+  void remove_job(size_t worker, actor_id job) {
+    if (job == 0)
+      return;
+    auto& w = *worker_states_[worker];
+    emit(w, make_event(detail::profiler_event::done, worker, job,
+                       clock_type::now()));
   }
 
-  template <class Time, class Label>
-  void record(Time t, Label label, size_t rec_id, const measurement& m) {
-    using std::setw;
-    file_ << setw(21) << t.time_since_epoch().count()
-           << setw(10) << label
-           << setw(10) << rec_id
-           << m
-           << '\n';
+private:
+  using nsec = std::chrono::nanoseconds;
+
+  detail::profiler_event make_event(uint16_t kind, size_t worker,
+                                    uint64_t id, clock_type::time_point t) {
+    detail::profiler_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.timestamp = static_cast<uint64_t>(nsec(t - clock_start_).count());
+    ev.id = id;
+    ev.worker = static_cast<uint32_t>(worker);
+    ev.kind = kind;
+    return ev;
   }
 
-  void report(const actor_id& job, const measurement& m) {
-    std::lock_guard<std::mutex> job_guard{job_mtx_};
-    jobs_[job] += m;
-    if (m.runtime - last_flush_ >= resolution_) {
-      last_flush_ = m.runtime;
-      auto now = clock_type::now().time_since_epoch();
-      auto wallclock = system_start_ + (now - clock_start_);
-      std::lock_guard<std::mutex> file_guard{file_mtx_};
-      for (auto& j : jobs_) {
-        record(wallclock, "actor", j.first, j.second);
-        j.second = {};
+  // Pushes `ev` to the ring buffer of `w`, reporting previously dropped
+  // events first if the ring has space again.
+  void emit(worker_state& w, const detail::profiler_event& ev) {
+    if (w.ring.dropped() > 0) {
+      auto dev = make_event(detail::profiler_event::dropped, ev.worker,
+                            w.ring.dropped(), clock_type::now());
+      if (!w.ring.try_push(dev)) {
+        w.ring.push(ev);
+        return;
       }
+      w.ring.reset_dropped();
+    }
+    w.ring.push(ev);
+  }
+
+  void drain_loop() {
+    std::unique_lock<std::mutex> guard{drain_mtx_};
+    while (!done_) {
+      drain_cv_.wait_for(guard, resolution_);
+      for (auto& w : worker_states_)
+        w->ring.drain(file_);
+      if (file_ != nullptr)
+        fflush(file_);
     }
+    // pick up events from the shutdown of the workers
+    for (auto& w : worker_states_)
+      w->ring.drain(file_);
+    if (file_ != nullptr)
+      fflush(file_);
   }
 
-  std::mutex job_mtx_;
-  std::mutex file_mtx_;
-  std::ofstream file_;
+  std::FILE* file_;
   msec resolution_;
+  size_t rusage_interval_;
+  size_t ring_size_;
   std::chrono::system_clock::time_point system_start_;
-  clock_type::duration clock_start_;
-  std::vector<worker_state> worker_states_;
-  std::unordered_map<actor_id, measurement> jobs_;
-  clock_type::duration last_flush_ = clock_type::duration::zero();
+  clock_type::time_point clock_start_;
+  std::vector<std::unique_ptr<worker_state>> worker_states_;
+  std::thread drain_thread_;
+  std::mutex drain_mtx_;
+  std::condition_variable drain_cv_;
+  bool done_;
 };
 
 } // namespace scheduler
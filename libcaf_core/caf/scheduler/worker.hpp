@@ -26,6 +26,8 @@
 #include "caf/resumable.hpp"
 #include "caf/execution_unit.hpp"
 
+#include "caf/scheduler/worker_stats.hpp"
+
 #include "caf/detail/double_ended_queue.hpp"
 
 namespace caf {
@@ -103,6 +105,14 @@ public:
     return max_throughput_;
   }
 
+  worker_counters& counters() {
+    return counters_;
+  }
+
+  const worker_counters& counters() const {
+    return counters_;
+  }
+
 private:
   void run() {
     CAF_SET_LOGGER_SYS(&system());
@@ -112,6 +122,7 @@ private:
       CAF_ASSERT(job != nullptr);
       CAF_ASSERT(job->subtype() != resumable::io_actor);
       CAF_PUSH_AID_FROM_PTR(dynamic_cast<abstract_actor*>(job));
+      counters_.job_resumed();
       policy_.before_resume(this, job);
       auto res = job->resume(this, max_throughput_);
       policy_.after_resume(this, job);
@@ -149,6 +160,8 @@ private:
   coordinator_ptr parent_;
   // policy-specific data
   policy_data data_;
+  // counters for scheduler introspection
+  worker_counters counters_;
   // instance of our policy object
   Policy policy_;
 };
@@ -0,0 +1,153 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_SCHEDULER_WORKER_STATS_HPP
+#define CAF_SCHEDULER_WORKER_STATS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "caf/meta/type_name.hpp"
+
+namespace caf {
+namespace scheduler {
+
+/// A snapshot of the counters of a single worker.
+struct worker_stats {
+  /// ID of the worker.
+  size_t worker_id;
+  /// Number of jobs resumed by the worker.
+  uint64_t jobs_resumed;
+  /// Number of jobs the worker stole from others.
+  uint64_t steals;
+  /// Number of steal attempts that found no job.
+  uint64_t failed_steals;
+  /// Time spent polling for jobs in the aggressive phase.
+  uint64_t aggressive_poll_ns;
+  /// Time spent polling for jobs in the moderate phase.
+  uint64_t moderate_poll_ns;
+  /// Time spent polling for jobs in the relaxed phase.
+  uint64_t relaxed_poll_ns;
+  /// Time the worker slept while waiting for jobs, included in the poll times.
+  uint64_t sleep_ns;
+  /// Approximate number of jobs in the queue of the worker.
+  size_t queue_length;
+};
+
+/// @relates worker_stats
+template <class Inspector>
+typename Inspector::result_type inspect(Inspector& f, worker_stats& x) {
+  return f(meta::type_name("worker_stats"), x.worker_id, x.jobs_resumed,
+           x.steals, x.failed_steals, x.aggressive_poll_ns, x.moderate_poll_ns,
+           x.relaxed_poll_ns, x.sleep_ns, x.queue_length);
+}
+
+/// Counters of a single worker. All counters except `queue_length` have only
+/// one writer, the worker thread, and use relaxed loads and stores instead of
+/// read-modify-write operations.
+class worker_counters {
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  /// Number of poll phases, see `policy::work_stealing::poll_strategy`.
+  static constexpr size_t num_poll_phases = 3;
+
+  worker_counters()
+      : jobs_resumed_(0),
+        steals_(0),
+        failed_steals_(0),
+        sleep_ns_(0),
+        queue_length_(0) {
+    for (auto& x : poll_ns_)
+      x.store(0, std::memory_order_relaxed);
+  }
+
+  worker_counters(const worker_counters&) = delete;
+  worker_counters& operator=(const worker_counters&) = delete;
+
+  inline void job_resumed() {
+    inc(jobs_resumed_, 1);
+  }
+
+  inline void steal_attempt(bool success) {
+    inc(success ? steals_ : failed_steals_, 1);
+  }
+
+  inline void polled(size_t phase, clock_type::duration x) {
+    inc(poll_ns_[phase], to_ns(x));
+  }
+
+  inline void slept(clock_type::duration x) {
+    inc(sleep_ns_, to_ns(x));
+  }
+
+  /// Called from any thread when adding a job to the queue of the worker.
+  inline void job_enqueued() {
+    queue_length_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Called from any thread when removing a job from the queue of the worker.
+  inline void job_dequeued() {
+    queue_length_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /// Returns the current values of all counters.
+  worker_stats snapshot(size_t worker_id) const {
+    auto get = [](const std::atomic<uint64_t>& x) {
+      return x.load(std::memory_order_relaxed);
+    };
+    // dequeue operations may overtake their enqueue operations
+    auto qlen = queue_length_.load(std::memory_order_relaxed);
+    return {worker_id,
+            get(jobs_resumed_),
+            get(steals_),
+            get(failed_steals_),
+            get(poll_ns_[0]),
+            get(poll_ns_[1]),
+            get(poll_ns_[2]),
+            get(sleep_ns_),
+            qlen > 0 ? static_cast<size_t>(qlen) : 0u};
+  }
+
+private:
+  static uint64_t to_ns(clock_type::duration x) {
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(x).count());
+  }
+
+  static void inc(std::atomic<uint64_t>& x, uint64_t value) {
+    x.store(x.load(std::memory_order_relaxed) + value,
+            std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> jobs_resumed_;
+  std::atomic<uint64_t> steals_;
+  std::atomic<uint64_t> failed_steals_;
+  std::atomic<uint64_t> poll_ns_[num_poll_phases];
+  std::atomic<uint64_t> sleep_ns_;
+  std::atomic<int64_t> queue_length_;
+};
+
+} // namespace scheduler
+} // namespace caf
+
+#endif // CAF_SCHEDULER_WORKER_STATS_HPP
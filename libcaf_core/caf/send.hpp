@@ -20,6 +20,9 @@
 #ifndef CAF_SEND_HPP
 #define CAF_SEND_HPP
 
+#include <vector>
+#include <iterator>
+
 #include "caf/actor.hpp"
 #include "caf/message.hpp"
 #include "caf/actor_cast.hpp"
@@ -108,6 +111,33 @@ void anon_send(const Dest& dest, Ts&&... xs) {
                   std::forward<Ts>(xs)...);
 }
 
+/// Anonymously sends all messages in `[first, last)` to `dest`. A local
+/// receiver gets the entire batch published to its mailbox with a single
+/// atomic operation and is scheduled at most once.
+template <message_priority P = message_priority::normal,
+          class Dest = actor, class Iterator>
+void anon_send_batch(const Dest& dest, Iterator first, Iterator last) {
+  static_assert(!statically_typed<Dest>(),
+                "anon_send_batch() sends type-erased messages and is only "
+                "available for dynamically typed actors");
+  if (!dest || first == last)
+    return;
+  std::vector<mailbox_element_ptr> xs;
+  for (; first != last; ++first)
+    xs.emplace_back(make_mailbox_element(nullptr, message_id::make(P),
+                                         {}, *first));
+  dest->enqueue_batch(std::move(xs), nullptr);
+}
+
+/// Anonymously sends all messages in `xs` to `dest`.
+template <message_priority P = message_priority::normal,
+          class Dest = actor, class Container>
+void anon_send_batch(const Dest& dest, const Container& xs) {
+  using std::begin;
+  using std::end;
+  anon_send_batch<P>(dest, begin(xs), end(xs));
+}
+
 /// Anonymously sends `dest` an exit message.
 template <class Dest>
 void anon_send_exit(const Dest& dest, exit_reason reason) {
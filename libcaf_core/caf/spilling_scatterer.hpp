@@ -0,0 +1,205 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_SPILLING_SCATTERER_HPP
+#define CAF_SPILLING_SCATTERER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "caf/logger.hpp"
+#include "caf/local_actor.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/binary_deserializer.hpp"
+#include "caf/broadcast_scatterer.hpp"
+#include "caf/actor_system_config.hpp"
+
+#include "caf/detail/spill_file.hpp"
+
+namespace caf {
+
+/// A broadcast scatterer that keeps at most `stream-spill-threshold` elements
+/// in memory and moves any further element to an append-only segment file in
+/// `stream-spill-directory`. Spilled elements are replayed in order as soon as
+/// downstream credit becomes available. Useful for sources that cannot get
+/// paused, e.g., when ingesting data from the network.
+/// If spilling fails while older elements remain on disk, the scatterer
+/// aborts all downstream paths with the error instead of emitting elements
+/// out of order.
+/// @note Requires `T` to be default constructible and serializable. Only
+///       `emit_batches` may remove elements from the buffer.
+template <class T>
+class spilling_scatterer : public broadcast_scatterer<T> {
+public:
+  using super = broadcast_scatterer<T>;
+
+  spilling_scatterer(local_actor* selfptr)
+      : super(selfptr),
+        spilled_(0),
+        head_(0),
+        bytes_spilled_(0),
+        bytes_replayed_(0),
+        failed_(false) {
+    auto& cfg = selfptr->system().config();
+    max_in_memory_ = std::max(cfg.stream_spill_threshold, size_t{1});
+    dir_ = cfg.stream_spill_directory;
+  }
+
+  long buffered() const override {
+    return super::buffered() + static_cast<long>(spilled_);
+  }
+
+  void emit_batches() override {
+    CAF_LOG_TRACE(CAF_ARG(spilled_));
+    if (failed_) {
+      // drop anything the source still pushes after aborting the stream
+      this->buf_.clear();
+      return;
+    }
+    spill();
+    if (failed_)
+      return;
+    replay();
+    super::emit_batches();
+    while (spilled_ > 0 && this->min_credit() > 0) {
+      replay();
+      super::emit_batches();
+    }
+    // all elements pushed from now on are newer than the spilled elements
+    head_ = this->buf_.size();
+  }
+
+  /// Returns the number of elements currently stored on disk.
+  size_t spilled() const {
+    return spilled_;
+  }
+
+  /// Returns how many bytes this scatterer wrote to disk in total.
+  uint64_t bytes_spilled() const {
+    return bytes_spilled_;
+  }
+
+  /// Returns how many bytes this scatterer read back from disk in total.
+  uint64_t bytes_replayed() const {
+    return bytes_replayed_;
+  }
+
+private:
+  // moves all elements exceeding our memory limit to the segment file
+  void spill() {
+    auto& buf = this->buf_;
+    size_t first;
+    if (spilled_ > 0)
+      first = std::min(head_, buf.size());
+    else if (buf.size() > max_in_memory_)
+      first = max_in_memory_;
+    else
+      return;
+    if (first >= buf.size())
+      return;
+    if (!file_.is_open()) {
+      auto err = file_.open(dir_);
+      if (err) {
+        CAF_LOG_ERROR("unable to spill stream elements:" << CAF_ARG(err));
+        return;
+      }
+    }
+    // store each element with a 32-bit length prefix in native byte order
+    std::vector<char> tmp;
+    for (auto i = buf.begin() + static_cast<ptrdiff_t>(first);
+         i != buf.end(); ++i) {
+      auto pos = tmp.size();
+      tmp.resize(pos + sizeof(uint32_t));
+      binary_serializer sink{this->self()->context(), tmp};
+      auto err = sink(*i);
+      if (err) {
+        CAF_LOG_ERROR("unable to serialize stream element:" << CAF_ARG(err));
+        if (spilled_ > 0)
+          fail(std::move(err));
+        return;
+      }
+      auto len = static_cast<uint32_t>(tmp.size() - pos - sizeof(uint32_t));
+      memcpy(tmp.data() + pos, &len, sizeof(uint32_t));
+    }
+    auto err = file_.append(tmp.data(), tmp.size());
+    if (err) {
+      CAF_LOG_ERROR("unable to spill stream elements:" << CAF_ARG(err));
+      // keeping the new elements in memory is only safe as long as there are
+      // no older elements on disk
+      if (spilled_ > 0)
+        fail(std::move(err));
+      return;
+    }
+    spilled_ += buf.size() - first;
+    bytes_spilled_ += tmp.size();
+    buf.erase(buf.begin() + static_cast<ptrdiff_t>(first), buf.end());
+  }
+
+  // moves spilled elements back into memory as long as there is room
+  void replay() {
+    auto& buf = this->buf_;
+    while (spilled_ > 0 && buf.size() < max_in_memory_) {
+      uint32_t len;
+      memcpy(&len, file_.read_ptr(), sizeof(uint32_t));
+      binary_deserializer source{this->self()->context(),
+                                 const_cast<char*>(file_.read_ptr())
+                                 + sizeof(uint32_t),
+                                 len};
+      T x;
+      auto err = source(x);
+      if (err) {
+        CAF_LOG_ERROR("unable to replay stream elements:" << CAF_ARG(err));
+        file_.consume(file_.available());
+        spilled_ = 0;
+        return;
+      }
+      buf.emplace_back(std::move(x));
+      file_.consume(sizeof(uint32_t) + len);
+      bytes_replayed_ += sizeof(uint32_t) + len;
+      --spilled_;
+    }
+  }
+
+  // aborts all downstream paths, since we can no longer emit the remaining
+  // elements in order
+  void fail(error reason) {
+    this->buf_.clear();
+    file_.consume(file_.available());
+    spilled_ = 0;
+    head_ = 0;
+    failed_ = true;
+    this->abort(std::move(reason));
+  }
+
+  size_t max_in_memory_;
+  std::string dir_;
+  detail::spill_file file_;
+  size_t spilled_;
+  size_t head_;
+  uint64_t bytes_spilled_;
+  uint64_t bytes_replayed_;
+  bool failed_;
+};
+
+} // namespace caf
+
+#endif // CAF_SPILLING_SCATTERER_HPP
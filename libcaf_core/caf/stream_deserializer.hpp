@@ -208,6 +208,60 @@ protected:
     return none;
   }
 
+  error apply_builtin_range(builtin type, size_t num, void* first) override {
+    CAF_ASSERT(first != nullptr);
+    switch (type) {
+      default:
+        return deserializer::apply_builtin_range(type, num, first);
+      case i8_v:
+      case u8_v:
+        return apply_raw(num, first);
+      case i16_v:
+      case u16_v:
+        return apply_int_range<uint16_t, uint16_t>(first, num);
+      case i32_v:
+      case u32_v:
+        return apply_int_range<uint32_t, uint32_t>(first, num);
+      case i64_v:
+      case u64_v:
+        return apply_int_range<uint64_t, uint64_t>(first, num);
+      case float_v:
+        return apply_int_range<uint32_t, float>(first, num);
+      case double_v:
+        return apply_int_range<uint64_t, double>(first, num);
+    }
+  }
+
+  // Reads `num` packed values of type `P` with a single call to the streambuf
+  // directly into the destination and then converts them in place to `T`.
+  template <class P, class T>
+  error apply_int_range(void* first, size_t num) {
+    static_assert(sizeof(P) == sizeof(T), "packed type has different size");
+    auto e = apply_raw(num * sizeof(P), first);
+    if (e)
+      return e;
+    auto ptr = reinterpret_cast<char*>(first);
+    for (size_t i = 0; i < num; ++i, ptr += sizeof(P)) {
+      P tmp;
+      memcpy(&tmp, ptr, sizeof(P));
+      auto x = unpack_value<T>(detail::from_network_order(tmp));
+      memcpy(ptr, &x, sizeof(T));
+    }
+    return none;
+  }
+
+  template <class T, class P>
+  static typename std::enable_if<std::is_integral<T>::value, T>::type
+  unpack_value(P x) {
+    return x;
+  }
+
+  template <class T, class P>
+  static typename std::enable_if<std::is_floating_point<T>::value, T>::type
+  unpack_value(P x) {
+    return detail::unpack754(x);
+  }
+
 private:
   Streambuf streambuf_;
 };
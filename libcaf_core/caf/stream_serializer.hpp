@@ -183,6 +183,66 @@ protected:
     return apply_raw(sizeof(T), &y);
   }
 
+  error apply_builtin_range(builtin type, size_t num, void* first) override {
+    CAF_ASSERT(first != nullptr);
+    switch (type) {
+      default:
+        return serializer::apply_builtin_range(type, num, first);
+      case i8_v:
+      case u8_v:
+        return apply_raw(num, first);
+      case i16_v:
+      case u16_v:
+        return apply_int_range(reinterpret_cast<uint16_t*>(first), num);
+      case i32_v:
+      case u32_v:
+        return apply_int_range(reinterpret_cast<uint32_t*>(first), num);
+      case i64_v:
+      case u64_v:
+        return apply_int_range(reinterpret_cast<uint64_t*>(first), num);
+      case float_v:
+        return apply_int_range(reinterpret_cast<float*>(first), num);
+      case double_v:
+        return apply_int_range(reinterpret_cast<double*>(first), num);
+    }
+  }
+
+  // Converts `xs` chunk-wise into network representation and writes each
+  // chunk with a single call to the streambuf. Produces the same bytes as
+  // calling `apply_builtin` for each element.
+  template <class T>
+  error apply_int_range(const T* xs, size_t num) {
+    using packed = decltype(pack_value(std::declval<T>()));
+    static constexpr size_t chunk_size = 256;
+    packed buf[chunk_size];
+    while (num > 0) {
+      auto n = num < chunk_size ? num : chunk_size;
+      for (size_t i = 0; i < n; ++i)
+        buf[i] = detail::to_network_order(pack_value(xs[i]));
+      auto e = apply_raw(n * sizeof(packed), buf);
+      if (e)
+        return e;
+      xs += n;
+      num -= n;
+    }
+    return none;
+  }
+
+  template <class T>
+  static typename std::enable_if<std::is_integral<T>::value, T>::type
+  pack_value(T x) {
+    return x;
+  }
+
+  template <class T>
+  static typename std::enable_if<
+    std::is_floating_point<T>::value,
+    typename detail::ieee_754_trait<T>::packed_type
+  >::type
+  pack_value(T x) {
+    return detail::pack754(x);
+  }
+
 private:
   Streambuf streambuf_;
 };
@@ -20,6 +20,8 @@
 #ifndef CAF_STREAM_SINK_IMPL_HPP
 #define CAF_STREAM_SINK_IMPL_HPP
 
+#include <type_traits>
+
 #include "caf/sec.hpp"
 #include "caf/logger.hpp"
 #include "caf/message_id.hpp"
@@ -70,8 +72,12 @@ protected:
     using vec_type = std::vector<input_type>;
     if (msg.match_elements<vec_type>()) {
       auto& xs = msg.get_as<vec_type>(0);
-      for (auto& x : xs)
-        fun_(state_, x);
+      using consumer_result = decltype(fun_(state_, xs.front()));
+      for (auto& x : xs) {
+        auto err = consume(x, std::is_same<consumer_result, error>{});
+        if (err)
+          return err;
+      }
       return none;
     }
     CAF_LOG_ERROR("received unexpected batch type");
@@ -83,6 +89,17 @@ protected:
   }
 
 private:
+  template <class T>
+  error consume(T& x, std::true_type) {
+    return fun_(state_, x);
+  }
+
+  template <class T>
+  error consume(T& x, std::false_type) {
+    fun_(state_, x);
+    return none;
+  }
+
   state_type state_;
   Fun fun_;
   Finalize fin_;
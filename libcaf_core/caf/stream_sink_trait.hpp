@@ -21,6 +21,7 @@
 #define CAF_STREAM_SINK_TRAIT_HPP
 
 #include "caf/message.hpp"
+#include "caf/expected.hpp"
 #include "caf/make_message.hpp"
 
 #include "caf/detail/type_traits.hpp"
@@ -30,8 +31,11 @@ namespace caf {
 template <class Fun, class Fin>
 struct stream_sink_trait;
 
-template <class State, class In, class Out>
-struct stream_sink_trait<void (State&, In), Out (State&)> {
+// Consumers return either `void` or an `error`. A consumer returning an error
+// other than `none` aborts the stream.
+
+template <class Ret, class State, class In, class Out>
+struct stream_sink_trait<Ret (State&, In), Out (State&)> {
   using state = State;
   using input = In;
   using output = Out;
@@ -41,8 +45,23 @@ struct stream_sink_trait<void (State&, In), Out (State&)> {
   }
 };
 
-template <class State, class In>
-struct stream_sink_trait<void (State&, In), void (State&)> {
+// Finalizers returning `expected<Out>` fail the stream on error.
+template <class Ret, class State, class In, class Out>
+struct stream_sink_trait<Ret (State&, In), expected<Out> (State&)> {
+  using state = State;
+  using input = In;
+  using output = Out;
+  template <class F>
+  static message make_result(state& st, F f) {
+    auto x = f(st);
+    if (!x)
+      return make_message(std::move(x.error()));
+    return make_message(std::move(*x));
+  }
+};
+
+template <class Ret, class State, class In>
+struct stream_sink_trait<Ret (State&, In), void (State&)> {
   using state = State;
   using input = In;
   using output = void;
@@ -0,0 +1,74 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_STREAM_WINDOW_HPP
+#define CAF_STREAM_WINDOW_HPP
+
+#include "caf/timestamp.hpp"
+
+namespace caf {
+
+/// Configures the windows of a windowing stage. A window covers the
+/// half-open interval `[begin, begin + size)` and a new window starts every
+/// `slide` time units. Windows close once the watermark, i.e., the largest
+/// event time seen so far minus `allowed_lateness`, passes their end.
+struct stream_window {
+  using duration_type = timestamp::duration;
+
+  /// Length of a single window.
+  duration_type size;
+
+  /// Distance between the beginning of two consecutive windows. Equals
+  /// `size` for tumbling windows and must divide `size` for sliding windows.
+  duration_type slide;
+
+  /// Delays closing a window in order to include out-of-order elements.
+  duration_type allowed_lateness;
+};
+
+/// Returns a configuration for non-overlapping windows.
+/// @relates stream_window
+inline stream_window
+tumbling_window(stream_window::duration_type size,
+                stream_window::duration_type allowed_lateness = {}) {
+  return {size, size, allowed_lateness};
+}
+
+/// Returns a configuration for overlapping windows.
+/// @pre `size.count() % slide.count() == 0`
+/// @relates stream_window
+inline stream_window
+sliding_window(stream_window::duration_type size,
+               stream_window::duration_type slide,
+               stream_window::duration_type allowed_lateness = {}) {
+  return {size, slide, allowed_lateness};
+}
+
+/// Assigns the current system time to each element, i.e., turns event time
+/// into processing time.
+struct arrival_time {
+  template <class T>
+  timestamp operator()(const T&) const {
+    return make_timestamp();
+  }
+};
+
+} // namespace caf
+
+#endif // CAF_STREAM_WINDOW_HPP
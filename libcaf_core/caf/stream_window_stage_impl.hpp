@@ -0,0 +1,306 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_STREAM_WINDOW_STAGE_IMPL_HPP
+#define CAF_STREAM_WINDOW_STAGE_IMPL_HPP
+
+#include <deque>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "caf/sec.hpp"
+#include "caf/logger.hpp"
+#include "caf/timestamp.hpp"
+#include "caf/outbound_path.hpp"
+#include "caf/stream_window.hpp"
+#include "caf/stream_manager.hpp"
+
+#include "caf/detail/type_traits.hpp"
+#include "caf/detail/window_table.hpp"
+
+namespace caf {
+
+/// A stream stage that aggregates elements per key over tumbling or sliding
+/// windows. The stage splits time into panes of length `slide`, keeps one
+/// hash table per pane, and merges `size / slide` panes when a window closes.
+/// An `Aggregator` provides the following interface:
+///
+/// ~~~
+/// struct aggregator {
+///   using input_type = ...;
+///   using accumulator_type = ...; // default-constructed value is neutral
+///   using output_type = ...;
+///   void add(accumulator_type&, const input_type&);
+///   void merge(accumulator_type&, const accumulator_type&);
+///   output_type emit(const key_type&, const accumulator_type&,
+///                    timestamp window_begin);
+/// };
+/// ~~~
+///
+/// Elements that belong to a window that already closed count as late
+/// elements and are dropped.
+template <class KeyFun, class TimeFun, class Aggregator,
+          class UpstreamPolicy, class DownstreamPolicy>
+class stream_window_stage_impl : public stream_manager {
+public:
+  using input_type = typename Aggregator::input_type;
+
+  using accumulator_type = typename Aggregator::accumulator_type;
+
+  using output_type = typename Aggregator::output_type;
+
+  using key_type =
+    typename std::decay<
+      typename detail::get_callable_trait<KeyFun>::result_type
+    >::type;
+
+  using table_type = detail::window_table<key_type, accumulator_type>;
+
+  stream_window_stage_impl(local_actor* self, const stream_id&,
+                           stream_window win, KeyFun key, TimeFun time,
+                           Aggregator agg)
+      : win_(win),
+        key_(std::move(key)),
+        time_(std::move(time)),
+        agg_(std::move(agg)),
+        panes_per_window_(win.size.count() / win.slide.count()),
+        started_(false),
+        first_pane_(0),
+        next_close_(0),
+        max_time_(timestamp::min()),
+        late_(0),
+        in_(self),
+        out_(self) {
+    CAF_ASSERT(win.slide.count() > 0);
+    CAF_ASSERT(win.size.count() % win.slide.count() == 0);
+  }
+
+  Aggregator& aggregator() {
+    return agg_;
+  }
+
+  UpstreamPolicy& in() override {
+    return in_;
+  }
+
+  DownstreamPolicy& out() override {
+    return out_;
+  }
+
+  bool done() const override {
+    return in_.closed() && out_.closed();
+  }
+
+  /// Returns the time up to which all windows have been emitted.
+  timestamp watermark() const {
+    return started_ ? pane_begin(next_close_) : timestamp::min();
+  }
+
+  /// Returns the number of dropped elements due to lateness.
+  size_t late_elements() const {
+    return late_;
+  }
+
+  /// Closes all windows ending at or before `x`. The stage advances the
+  /// watermark automatically based on event times. Calling this function
+  /// allows the parent actor to close windows while the input is idle, e.g.,
+  /// by periodically passing the current time when using `arrival_time`.
+  void advance_watermark(timestamp x) {
+    CAF_LOG_TRACE(CAF_ARG(x));
+    if (!started_)
+      return;
+    // index of the last pane that ends at or before `x`
+    auto last = pane_of(x) - 1;
+    if (next_close_ > last)
+      return;
+    while (next_close_ <= last) {
+      // skip all windows without data in a single step, otherwise long gaps
+      // in event time result in one iteration per slide
+      auto p = first_nonempty_pane();
+      if (p > next_close_) {
+        next_close_ = std::min(p, last + 1);
+        drop_panes();
+        continue;
+      }
+      emit_window(next_close_++);
+      drop_panes();
+    }
+  }
+
+protected:
+  void input_closed(error reason) override {
+    if (reason == none) {
+      // flush all windows that contain at least one pane
+      while (!panes_.empty()) {
+        emit_window(next_close_++);
+        drop_panes();
+      }
+      push();
+      if (out_.buffered() == 0)
+        out_.close();
+    } else {
+      out_.abort(std::move(reason));
+    }
+  }
+
+  error process_batch(message& msg) override {
+    CAF_LOG_TRACE(CAF_ARG(msg));
+    using vec_type = std::vector<input_type>;
+    if (msg.match_elements<vec_type>()) {
+      auto& xs = msg.get_as<vec_type>(0);
+      for (auto& x : xs) {
+        auto t = time_(x);
+        auto p = pane_of(t);
+        if (!started_) {
+          started_ = true;
+          next_close_ = p;
+          first_pane_ = p - panes_per_window_ + 1;
+        }
+        // closing windows before adding `x` never allocates the panes of a
+        // gap in event time, `x` belongs to none of the closed windows
+        if (t > max_time_) {
+          max_time_ = t;
+          advance_watermark(t - win_.allowed_lateness);
+        }
+        if (p < first_pane_) {
+          ++late_;
+          continue;
+        }
+        agg_.add(pane(p)[key_(x)], x);
+      }
+      return none;
+    }
+    CAF_LOG_ERROR("received unexpected batch type");
+    return sec::unexpected_message;
+  }
+
+  message make_output_token(const stream_id& x) const override {
+    return make_message(stream<output_type>{x});
+  }
+
+  void downstream_demand(outbound_path* path, long) override {
+    CAF_LOG_TRACE(CAF_ARG(path));
+    auto hdl = path->hdl;
+    if(out_.buffered() > 0)
+      push();
+    else if (in_.closed()) {
+      // don't pass path->hdl: path can become invalid
+      auto sid = path->sid;
+      out_.remove_path(sid, hdl, none, false);
+    }
+    auto current_size = out_.buffered();
+    auto desired_size = out_.credit();
+    if (current_size < desired_size)
+      in_.assign_credit(desired_size - current_size);
+  }
+
+private:
+  int64_t pane_of(timestamp x) const {
+    auto t = x.time_since_epoch().count();
+    auto n = win_.slide.count();
+    // round towards negative infinity
+    return t >= 0 ? t / n : -((-t + n - 1) / n);
+  }
+
+  timestamp pane_begin(int64_t p) const {
+    return timestamp{p * win_.slide};
+  }
+
+  // Returns the table for pane `p`, allocating all panes up to `p`.
+  table_type& pane(int64_t p) {
+    CAF_ASSERT(p >= first_pane_);
+    auto i = static_cast<size_t>(p - first_pane_);
+    while (panes_.size() <= i) {
+      if (spare_.empty()) {
+        panes_.emplace_back();
+      } else {
+        panes_.emplace_back(std::move(spare_.back()));
+        spare_.pop_back();
+      }
+    }
+    return panes_[i];
+  }
+
+  // Returns the index of the first pane with data or the maximum index if
+  // all panes are empty.
+  int64_t first_nonempty_pane() const {
+    auto i = std::find_if(panes_.begin(), panes_.end(),
+                          [](const table_type& t) { return !t.empty(); });
+    if (i == panes_.end())
+      return std::numeric_limits<int64_t>::max();
+    return first_pane_ + static_cast<int64_t>(i - panes_.begin());
+  }
+
+  // Emits the window ending with pane `last`.
+  void emit_window(int64_t last) {
+    auto first = last - panes_per_window_ + 1;
+    auto begin = pane_begin(first);
+    auto emit = [&](const key_type& key, accumulator_type& acc) {
+      out_.push(agg_.emit(key, acc, begin));
+    };
+    auto available = first_pane_ + static_cast<int64_t>(panes_.size());
+    if (panes_per_window_ == 1) {
+      if (last >= first_pane_ && last < available)
+        panes_[static_cast<size_t>(last - first_pane_)].for_each(emit);
+      return;
+    }
+    merged_.clear();
+    for (auto p = std::max(first, first_pane_);
+         p <= last && p < available; ++p)
+      panes_[static_cast<size_t>(p - first_pane_)].for_each(
+        [&](const key_type& key, accumulator_type& acc) {
+          agg_.merge(merged_[key], acc);
+        });
+    merged_.for_each(emit);
+  }
+
+  // Recycles all panes that no longer contribute to an open window.
+  void drop_panes() {
+    auto new_first = next_close_ - panes_per_window_ + 1;
+    while (first_pane_ < new_first && !panes_.empty()) {
+      panes_.front().clear();
+      spare_.emplace_back(std::move(panes_.front()));
+      panes_.pop_front();
+      ++first_pane_;
+    }
+    first_pane_ = new_first;
+  }
+
+  stream_window win_;
+  KeyFun key_;
+  TimeFun time_;
+  Aggregator agg_;
+  int64_t panes_per_window_;
+  bool started_;
+  int64_t first_pane_;
+  int64_t next_close_;
+  timestamp max_time_;
+  size_t late_;
+  std::deque<table_type> panes_;
+  std::vector<table_type> spare_;
+  table_type merged_;
+  UpstreamPolicy in_;
+  DownstreamPolicy out_;
+};
+
+} // namespace caf
+
+#endif // CAF_STREAM_WINDOW_STAGE_IMPL_HPP
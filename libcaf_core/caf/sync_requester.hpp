@@ -0,0 +1,127 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_SYNC_REQUESTER_HPP
+#define CAF_SYNC_REQUESTER_HPP
+
+#include <chrono>
+#include <utility>
+#include <type_traits>
+
+#include "caf/fwd.hpp"
+#include "caf/actor.hpp"
+#include "caf/duration.hpp"
+#include "caf/actor_cast.hpp"
+#include "caf/response_type.hpp"
+#include "caf/response_future.hpp"
+#include "caf/message_priority.hpp"
+#include "caf/check_typed_input.hpp"
+#include "caf/actor_control_block.hpp"
+
+#include "caf/detail/type_list.hpp"
+#include "caf/detail/implicit_conversions.hpp"
+#include "caf/detail/response_receiver.hpp"
+
+namespace caf {
+
+/// Sends requests from threads that are not actors and waits for their
+/// responses. In contrast to `scoped_actor` and `function_view`, a requester
+/// is not a full actor: it creates a lightweight response receiver once and
+/// each request allocates nothing but its message. A requester has at most
+/// one pending request at a time, i.e., threads should own one requester each
+/// rather than sharing one.
+class sync_requester {
+public:
+  // -- constructors, destructors, and assignment operators --------------------
+
+  explicit sync_requester(actor_system& sys);
+
+  sync_requester(const sync_requester&) = delete;
+
+  sync_requester& operator=(const sync_requester&) = delete;
+
+  ~sync_requester();
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the address of the response receiver.
+  actor_addr address() const;
+
+  // -- request ----------------------------------------------------------------
+
+  /// Sends `{xs...}` as a synchronous message to `dest` with priority `P`.
+  /// @returns A future for the response. An infinite `timeout` disables the
+  ///          timeout.
+  /// @pre no other future of this requester is pending
+  template <message_priority P = message_priority::normal,
+            class Handle = actor, class... Ts>
+  response_future<response_type_t<
+    typename Handle::signatures,
+    typename detail::implicit_conversions<
+      typename std::decay<Ts>::type
+    >::type...>>
+  request(const Handle& dest, const duration& timeout, Ts&&... xs) {
+    static_assert(sizeof...(Ts) > 0, "no message to send");
+    using token =
+      detail::type_list<
+        typename detail::implicit_conversions<
+          typename std::decay<Ts>::type
+        >::type...>;
+    static_assert(response_type_unbox<signatures_of_t<Handle>, token>::valid,
+                  "receiver does not accept given message");
+    auto self = receiver();
+    auto req_id = self->new_request_id(P);
+    if (dest)
+      dest->eq_impl(req_id, self_, nullptr, std::forward<Ts>(xs)...);
+    else
+      self->eq_impl(req_id.response_id(), nullptr, nullptr,
+                    make_error(sec::invalid_argument));
+    auto deadline = detail::response_receiver::clock_type::now();
+    deadline += timeout;
+    return {self, deadline, timeout.valid()};
+  }
+
+  /// Sends `{xs...}` as a synchronous message to `dest` with priority `P`.
+  /// @returns A future for the response.
+  /// @pre no other future of this requester is pending
+  template <message_priority P = message_priority::normal,
+            class Rep = int, class Period = std::ratio<1>,
+            class Handle = actor, class... Ts>
+  response_future<response_type_t<
+    typename Handle::signatures,
+    typename detail::implicit_conversions<
+      typename std::decay<Ts>::type
+    >::type...>>
+  request(const Handle& dest, std::chrono::duration<Rep, Period> timeout,
+          Ts&&... xs) {
+    return request<P>(dest, duration{timeout}, std::forward<Ts>(xs)...);
+  }
+
+private:
+  detail::response_receiver* receiver() const {
+    return static_cast<detail::response_receiver*>(
+      actor_cast<abstract_actor*>(self_));
+  }
+
+  strong_actor_ptr self_;
+};
+
+} // namespace caf
+
+#endif // CAF_SYNC_REQUESTER_HPP
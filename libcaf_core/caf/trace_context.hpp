@@ -0,0 +1,67 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_TRACE_CONTEXT_HPP
+#define CAF_TRACE_CONTEXT_HPP
+
+#include <cstdint>
+
+#include "caf/meta/type_name.hpp"
+
+namespace caf {
+
+/// Identifies the position of a message in a distributed trace. Each mailbox
+/// element stores the context of the message handler that created it.
+struct trace_context {
+  /// Marks messages that belong to a recorded trace.
+  static constexpr uint8_t sampled_flag = 0x01;
+
+  /// Marks messages sent outside of any message handler, i.e., messages that
+  /// may start a new trace.
+  static constexpr uint8_t root_flag = 0x02;
+
+  /// Identifies the trace or 0 if the message belongs to no trace.
+  uint64_t trace_id;
+
+  /// Identifies the span of the message handler that sent the message.
+  uint64_t span_id;
+
+  /// Stores `sampled_flag` and `root_flag`.
+  uint8_t flags;
+
+  /// Queries whether the message belongs to a recorded trace.
+  inline bool sampled() const {
+    return (flags & sampled_flag) != 0;
+  }
+
+  /// Queries whether the message may start a new trace.
+  inline bool root() const {
+    return (flags & root_flag) != 0;
+  }
+};
+
+/// @relates trace_context
+template <class Inspector>
+typename Inspector::result_type inspect(Inspector& f, trace_context& x) {
+  return f(meta::type_name("trace_context"), x.trace_id, x.span_id, x.flags);
+}
+
+} // namespace caf
+
+#endif // CAF_TRACE_CONTEXT_HPP
@@ -0,0 +1,68 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_WEIGHTED_GATHERER_HPP
+#define CAF_WEIGHTED_GATHERER_HPP
+
+#include <array>
+
+#include "caf/stream_priority.hpp"
+#include "caf/stream_gatherer_impl.hpp"
+
+namespace caf {
+
+/// Pulls data from sources in proportion to the weight of their
+/// `stream_priority`. By default, each priority level doubles the weight of
+/// the next lower level, i.e., `very_high` has weight 16 and `very_low` has
+/// weight 1. Each path with free capacity receives at least
+/// `min_credit_assignment()` credit per round before distributing the
+/// remaining credit, which prevents low-priority paths from starving.
+class weighted_gatherer : public stream_gatherer_impl {
+public:
+  using super = stream_gatherer_impl;
+
+  weighted_gatherer(local_actor* selfptr);
+
+  ~weighted_gatherer() override;
+
+  void assign_credit(long downstream_capacity) override;
+
+  long initial_credit(long downstream_capacity, path_type* x) override;
+
+  /// Returns the weight for paths with priority `x`.
+  long weight(stream_priority x) const;
+
+  /// Sets the weight for paths with priority `x`.
+  /// @pre `y > 0`
+  void weight(stream_priority x, long y);
+
+private:
+  // Returns the credit `x` can receive without exceeding `max_credit()`.
+  long headroom(const path_type* x) const;
+
+  std::array<long, stream_priorities> weights_;
+
+  // Rotates the order for assigning the guaranteed minimum when the
+  // available credit does not suffice for all paths.
+  size_t offset_;
+};
+
+} // namespace caf
+
+#endif // CAF_WEIGHTED_GATHERER_HPP
@@ -65,6 +65,12 @@ void abstract_actor::enqueue(strong_actor_ptr sender, message_id mid,
   enqueue(make_mailbox_element(sender, mid, {}, std::move(msg)), host);
 }
 
+void abstract_actor::enqueue_batch(std::vector<mailbox_element_ptr> xs,
+                                   execution_unit* host) {
+  for (auto& x : xs)
+    enqueue(std::move(x), host);
+}
+
 abstract_actor::abstract_actor(actor_config& cfg)
     : abstract_channel(cfg.flags) {
   // nop
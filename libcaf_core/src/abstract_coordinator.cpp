@@ -23,6 +23,7 @@
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <unordered_map>
@@ -329,6 +330,9 @@ void abstract_coordinator::start() {
 
 void abstract_coordinator::init(actor_system_config& cfg) {
   max_throughput_ = cfg.scheduler_max_throughput;
+  resume_budget_ = std::chrono::microseconds(cfg.scheduler_resume_budget);
+  resume_budget_interval_ = std::max(cfg.scheduler_resume_budget_interval,
+                                     size_t{1});
   num_workers_ = cfg.scheduler_max_threads;
 }
 
@@ -340,6 +344,10 @@ void* abstract_coordinator::subtype_ptr() {
   return this;
 }
 
+std::vector<worker_stats> abstract_coordinator::collect_worker_stats() const {
+  return {};
+}
+
 void abstract_coordinator::stop_actors() {
   CAF_LOG_TRACE("");
   scoped_actor self{system_, true};
@@ -351,6 +359,8 @@ void abstract_coordinator::stop_actors() {
 abstract_coordinator::abstract_coordinator(actor_system& sys)
     : next_worker_(0),
       max_throughput_(0),
+      resume_budget_(0),
+      resume_budget_interval_(1),
       num_workers_(0),
       system_(sys) {
   // nop
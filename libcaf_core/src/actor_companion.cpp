@@ -52,6 +52,12 @@ void actor_companion::enqueue(strong_actor_ptr src, message_id mid,
   enqueue(std::move(ptr), eu);
 }
 
+void actor_companion::enqueue_batch(std::vector<mailbox_element_ptr> xs,
+                                    execution_unit* eu) {
+  // companions have no mailbox, i.e., each element goes to the handler
+  abstract_actor::enqueue_batch(std::move(xs), eu);
+}
+
 void actor_companion::launch(execution_unit*, bool, bool hide) {
   if (!hide)
     register_at_system();
@@ -37,44 +37,33 @@
 #include "caf/event_based_actor.hpp"
 #include "caf/uniform_type_info_map.hpp"
 
-#include "caf/detail/shared_spinlock.hpp"
-
 namespace caf {
 
-namespace {
-
-using exclusive_guard = unique_lock<detail::shared_spinlock>;
-using shared_guard = shared_lock<detail::shared_spinlock>;
-
-} // namespace <anonymous>
-
 actor_registry::~actor_registry() {
   // nop
 }
 
-actor_registry::actor_registry(actor_system& sys) : running_(0), system_(sys) {
+actor_registry::actor_registry(actor_system& sys)
+    : running_(0),
+      running_waiters_(0),
+      system_(sys) {
   // nop
 }
 
 strong_actor_ptr actor_registry::get(actor_id key) const {
-  shared_guard guard(instances_mtx_);
-  auto i = entries_.find(key);
-  if (i != entries_.end())
-    return i->second;
-  CAF_LOG_DEBUG("key invalid, assume actor no longer exists:" << CAF_ARG(key));
-  return nullptr;
+  auto result = entries_.get(key);
+  if (!result)
+    CAF_LOG_DEBUG("key invalid, assume actor no longer exists:"
+                  << CAF_ARG(key));
+  return result;
 }
 
 void actor_registry::put(actor_id key, strong_actor_ptr val) {
   CAF_LOG_TRACE(CAF_ARG(key));
   if (!val)
     return;
-  { // lifetime scope of guard
-    exclusive_guard guard(instances_mtx_);
-    if (!entries_.emplace(key, val).second)
-      return;
-  }
-  // attach functor without lock
+  if (!entries_.put(key, val))
+    return;
   CAF_LOG_INFO("added actor:" << CAF_ARG(key));
   actor_registry* reg = this;
   val->get()->attach_functor([key, reg]() {
@@ -83,7 +72,6 @@ void actor_registry::put(actor_id key, strong_actor_ptr val) {
 }
 
 void actor_registry::erase(actor_id key) {
-  exclusive_guard guard{instances_mtx_};
   entries_.erase(key);
 }
 
@@ -102,7 +90,7 @@ size_t actor_registry::running() const {
 
 void actor_registry::dec_running() {
   size_t new_val = --running_;
-  if (new_val <= 1) {
+  if (new_val <= 1 && running_waiters_.load() > 0) {
     std::unique_lock<std::mutex> guard(running_mtx_);
     running_cv_.notify_all();
   }
@@ -112,19 +100,21 @@ void actor_registry::dec_running() {
 void actor_registry::await_running_count_equal(size_t expected) const {
   CAF_ASSERT(expected == 0 || expected == 1);
   CAF_LOG_TRACE(CAF_ARG(expected));
-  std::unique_lock<std::mutex> guard{running_mtx_};
-  while (running_ != expected) {
-    CAF_LOG_DEBUG(CAF_ARG(running_.load()));
-    running_cv_.wait(guard);
+  // registering before reading `running_` guarantees that either we see
+  // the final count or `dec_running` sees us and notifies
+  ++running_waiters_;
+  { // lifetime scope of guard
+    std::unique_lock<std::mutex> guard{running_mtx_};
+    while (running_ != expected) {
+      CAF_LOG_DEBUG(CAF_ARG(running_.load()));
+      running_cv_.wait(guard);
+    }
   }
+  --running_waiters_;
 }
 
 strong_actor_ptr actor_registry::get(atom_value key) const {
-  shared_guard guard{named_entries_mtx_};
-  auto i = named_entries_.find(key);
-  if (i == named_entries_.end())
-    return nullptr;
-  return i->second;
+  return named_entries_.get(static_cast<uint64_t>(key));
 }
 
 void actor_registry::put(atom_value key, strong_actor_ptr value) {
@@ -132,18 +122,18 @@ void actor_registry::put(atom_value key, strong_actor_ptr value) {
     value->get()->attach_functor([=] {
       system_.registry().put(key, nullptr);
     });
-  exclusive_guard guard{named_entries_mtx_};
-  named_entries_.emplace(key, std::move(value));
+  named_entries_.put(static_cast<uint64_t>(key), std::move(value));
 }
 
 void actor_registry::erase(atom_value key) {
-  exclusive_guard guard{named_entries_mtx_};
-  named_entries_.erase(key);
+  named_entries_.erase(static_cast<uint64_t>(key));
 }
 
 auto actor_registry::named_actors() const -> name_map {
-  shared_guard guard{named_entries_mtx_};
-  return named_entries_;
+  name_map result;
+  for (auto& kvp : named_entries_.entries())
+    result.emplace(static_cast<atom_value>(kvp.first), std::move(kvp.second));
+  return result;
 }
 
 void actor_registry::start() {
@@ -268,6 +268,9 @@ actor_system::actor_system(actor_system_config& cfg)
   // to influence the system configuration, e.g., by adding more types
   logger_->init(cfg);
   CAF_SET_LOGGER_SYS(this);
+  metrics_.init(cfg);
+  tracer_.init(*this);
+  private_threads_.init(*this);
   for (auto& mod : modules_)
     if (mod)
       mod->init(cfg);
@@ -306,6 +309,8 @@ actor_system::~actor_system() {
     if (*i)
       (*i)->stop();
   await_detached_threads();
+  private_threads_.stop();
+  tracer_.stop();
   registry_.stop();
   // reset logger and wait until dtor was called
   CAF_SET_LOGGER_SYS(nullptr);
@@ -334,6 +339,18 @@ actor_registry& actor_system::registry() {
   return registry_;
 }
 
+metrics::registry& actor_system::metrics() {
+  return metrics_;
+}
+
+detail::tracer& actor_system::tracer() {
+  return tracer_;
+}
+
+detail::private_thread_pool& actor_system::private_threads() {
+  return private_threads_;
+}
+
 const uniform_type_info_map& actor_system::types() const {
   return types_;
 }
@@ -417,6 +434,10 @@ void actor_system::await_detached_threads() {
     detached_cv.wait(guard);
 }
 
+bool actor_system::blocking_fibers() const {
+  return cfg_.scheduler_blocking_fibers;
+}
+
 expected<strong_actor_ptr>
 actor_system::dyn_spawn_impl(const std::string& name, message& args,
                              execution_unit* ctx, bool check_interface,
@@ -118,6 +118,16 @@ actor_system_config::actor_system_config()
   scheduler_max_throughput = std::numeric_limits<size_t>::max();
   scheduler_enable_profiling = false;
   scheduler_profiling_ms_resolution = 100;
+  scheduler_profiling_rusage_interval = 64;
+  scheduler_profiling_buffer_size = 8192;
+  scheduler_lane_fairness = 0;
+  scheduler_resume_budget = 0;
+  scheduler_resume_budget_interval = 16;
+  scheduler_detached_min_threads = 0;
+  scheduler_detached_max_threads = 0;
+  scheduler_detached_idle_timeout = 1000;
+  scheduler_blocking_fibers = false;
+  scheduler_fiber_stack_size = 256 * 1024;
   work_stealing_aggressive_poll_attempts = 100;
   work_stealing_aggressive_steal_interval = 10;
   work_stealing_moderate_poll_attempts = 500;
@@ -131,11 +141,20 @@ actor_system_config::actor_system_config()
   logger_console_format = "%m";
   logger_verbosity = atom("trace");
   logger_inline_output = false;
+  logger_binary_output = false;
+  logger_ring_size = 1048576;
+  stream_spill_threshold = 1000;
+  metrics_enable_runtime = false;
+  tracing_sample_rate = 0.;
+  tracing_output_file = "caf-traces.json";
+  tracing_buffer_size = 65536;
   middleman_network_backend = atom("default");
   middleman_enable_automatic_connections = false;
   middleman_max_consecutive_reads = 50;
   middleman_heartbeat_interval = 0;
   middleman_detach_multiplexer = true;
+  middleman_stream_buffer_limit = 1048576;
+  middleman_metrics_port = 0;
   // fill our options vector for creating INI and CLI parsers
   opt_group{options_, "scheduler"}
   .add(scheduler_policy, "policy",
@@ -149,7 +168,32 @@ actor_system_config::actor_system_config()
   .add(scheduler_profiling_ms_resolution, "profiling-ms-resolution",
        "sets the rate in ms in which the profiler collects data")
   .add(scheduler_profiling_output_file, "profiling-output-file",
-       "sets the output file for the profiler");
+       "sets the output file for the profiler")
+  .add(scheduler_profiling_rusage_interval, "profiling-rusage-interval",
+       "sets how many resumes a worker runs between CPU time samples")
+  .add(scheduler_profiling_buffer_size, "profiling-buffer-size",
+       "sets the number of buffered profiler events per worker")
+  .add(scheduler_lane_fairness, "lane-fairness",
+       "sets how many messages priority-aware actors take from higher mailbox "
+       "lanes before serving a waiting lower lane once (0: strict priority)")
+  .add(scheduler_resume_budget, "resume-budget",
+       "sets the time in microseconds an actor may run before yielding, "
+       "measured with a coarse clock (0: only max-throughput applies)")
+  .add(scheduler_resume_budget_interval, "resume-budget-interval",
+       "sets the number of messages between two checks of the resume budget")
+  .add(scheduler_detached_min_threads, "detached-min-threads",
+       "sets the number of threads kept alive for running detached actors")
+  .add(scheduler_detached_max_threads, "detached-max-threads",
+       "sets the max. number of threads for running detached actors "
+       "(0: unlimited)")
+  .add(scheduler_detached_idle_timeout, "detached-idle-timeout",
+       "sets the time in ms before stopping an idle thread for detached "
+       "actors if more than detached-min-threads are running")
+  .add(scheduler_blocking_fibers, "blocking-fibers",
+       "runs blocking actors as fibers on the workers of the scheduler "
+       "unless spawned with the detached flag")
+  .add(scheduler_fiber_stack_size, "fiber-stack-size",
+       "sets the stack size in bytes for blocking actors running as fibers");
   opt_group(options_, "work-stealing")
   .add(work_stealing_aggressive_poll_attempts, "aggressive-poll-attempts",
        "sets the number of zero-sleep-interval polling attempts")
@@ -180,10 +224,32 @@ actor_system_config::actor_system_config()
        "sets the verbosity (quiet|error|warning|info|debug|trace)")
   .add(logger_inline_output, "inline-output",
        "sets whether a separate thread is used for I/O")
+  .add(logger_binary_output, "binary-output",
+       "sets whether the log file contains binary records (see caf-log)")
+  .add(logger_ring_size, "ring-size",
+       "sets the per-thread buffer size in bytes for binary records")
   .add(logger_file_name, "filename",
        "deprecated (use file-name instead)")
   .add(logger_component_filter, "filter",
        "deprecated (use console-component-filter instead)");
+  opt_group{options_, "stream"}
+  .add(stream_spill_directory, "spill-directory",
+       "sets the directory for spill files (default: TMPDIR or /tmp)")
+  .add(stream_spill_threshold, "spill-threshold",
+       "sets the max. number of in-memory elements of spilling scatterers");
+  opt_group{options_, "metrics"}
+  .add(metrics_enable_runtime, "enable-runtime",
+       "enables or disables metrics for the scheduler, mailboxes, and BASP")
+  .add(metrics_mailbox_latency_actors, "mailbox-latency-actors",
+       "lists actor names for measuring mailbox latency ('*' selects all)");
+  opt_group{options_, "tracing"}
+  .add(tracing_sample_rate, "sample-rate",
+       "sets the fraction of root messages starting a trace, 0 (default) "
+       "disables tracing")
+  .add(tracing_output_file, "output-file",
+       "sets the file for writing recorded spans in OpenTelemetry JSON format")
+  .add(tracing_buffer_size, "buffer-size",
+       "sets the max. number of recorded spans per thread");
   opt_group{options_, "middleman"}
   .add(middleman_network_backend, "network-backend",
        "sets the network backend to either 'default' or 'asio' (if available)")
@@ -198,7 +264,11 @@ actor_system_config::actor_system_config()
   .add(middleman_detach_utility_actors, "detach-utility-actors",
        "enables or disables detaching of utility actors")
   .add(middleman_detach_multiplexer, "detach-multiplexer",
-       "enables or disables background activity of the multiplexer");
+       "enables or disables background activity of the multiplexer")
+  .add(middleman_stream_buffer_limit, "stream-buffer-limit",
+       "sets the max. pending output (bytes) before throttling remote streams")
+  .add(middleman_metrics_port, "metrics-port",
+       "sets the port for serving metrics via HTTP, 0 (default) disables it");
   opt_group(options_, "opencl")
   .add(opencl_device_ids, "device-ids",
        "restricts which OpenCL devices are accessed by CAF");
@@ -231,6 +301,18 @@ actor_system_config::actor_system_config(actor_system_config&& other)
       scheduler_profiling_ms_resolution(
         other.scheduler_profiling_ms_resolution),
       scheduler_profiling_output_file(other.scheduler_profiling_output_file),
+      scheduler_profiling_rusage_interval(
+        other.scheduler_profiling_rusage_interval),
+      scheduler_profiling_buffer_size(other.scheduler_profiling_buffer_size),
+      scheduler_lane_fairness(other.scheduler_lane_fairness),
+      scheduler_resume_budget(other.scheduler_resume_budget),
+      scheduler_resume_budget_interval(
+        other.scheduler_resume_budget_interval),
+      scheduler_detached_min_threads(other.scheduler_detached_min_threads),
+      scheduler_detached_max_threads(other.scheduler_detached_max_threads),
+      scheduler_detached_idle_timeout(other.scheduler_detached_idle_timeout),
+      scheduler_blocking_fibers(other.scheduler_blocking_fibers),
+      scheduler_fiber_stack_size(other.scheduler_fiber_stack_size),
       work_stealing_aggressive_poll_attempts(
         other.work_stealing_aggressive_poll_attempts),
       work_stealing_aggressive_steal_interval(
@@ -252,8 +334,18 @@ actor_system_config::actor_system_config(actor_system_config&& other)
       logger_component_filter(std::move(other.logger_component_filter)),
       logger_verbosity(other.logger_verbosity),
       logger_inline_output(other.logger_inline_output),
+      logger_binary_output(other.logger_binary_output),
+      logger_ring_size(other.logger_ring_size),
       logger_filename(logger_file_name),
       logger_filter(logger_component_filter),
+      stream_spill_directory(std::move(other.stream_spill_directory)),
+      stream_spill_threshold(other.stream_spill_threshold),
+      metrics_enable_runtime(other.metrics_enable_runtime),
+      metrics_mailbox_latency_actors(
+        std::move(other.metrics_mailbox_latency_actors)),
+      tracing_sample_rate(other.tracing_sample_rate),
+      tracing_output_file(std::move(other.tracing_output_file)),
+      tracing_buffer_size(other.tracing_buffer_size),
       middleman_network_backend(other.middleman_network_backend),
       middleman_app_identifier(std::move(other.middleman_app_identifier)),
       middleman_enable_automatic_connections(
@@ -262,6 +354,8 @@ actor_system_config::actor_system_config(actor_system_config&& other)
       middleman_heartbeat_interval(other.middleman_heartbeat_interval),
       middleman_detach_utility_actors(other.middleman_detach_utility_actors),
       middleman_detach_multiplexer(other.middleman_detach_multiplexer),
+      middleman_stream_buffer_limit(other.middleman_stream_buffer_limit),
+      middleman_metrics_port(other.middleman_metrics_port),
       opencl_device_ids(std::move(other.opencl_device_ids)),
       openssl_certificate(std::move(other.openssl_certificate)),
       openssl_key(std::move(other.openssl_key)),
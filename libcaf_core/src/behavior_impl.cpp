@@ -18,6 +18,7 @@
  ******************************************************************************/
 
 #include <utility>
+#include <algorithm>
 
 #include "caf/detail/behavior_impl.hpp"
 
@@ -37,6 +38,10 @@ public:
     return x == match_case::no_match ? second->invoke(f, xs) : x;
   }
 
+  bool may_match(uint32_t tt) const override {
+    return first->may_match(tt) || second->may_match(tt);
+  }
+
   void handle_timeout() override {
     // the second behavior overrides the timeout handling of
     // first behavior
@@ -115,6 +120,13 @@ match_case::result behavior_impl::invoke(detail::invoke_result_visitor& f,
   return match_case::no_match;
 }
 
+bool behavior_impl::may_match(uint32_t tt) const {
+  auto pred = [=](const match_case_info& x) {
+    return x.type_token == tt;
+  };
+  return std::any_of(begin_, end_, pred);
+}
+
 optional<message> behavior_impl::invoke(message& xs) {
   maybe_message_visitor f;
   // the following const-cast is safe, because invoke() is aware of
@@ -24,7 +24,10 @@
 #include "caf/logger.hpp"
 #include "caf/actor_system.hpp"
 #include "caf/actor_registry.hpp"
+#include "caf/system_messages.hpp"
+#include "caf/actor_system_config.hpp"
 
+#include "caf/detail/blocking_fiber.hpp"
 #include "caf/detail/sync_request_bouncer.hpp"
 #include "caf/detail/invoke_result_visitor.hpp"
 #include "caf/detail/default_invoke_result_visitor.hpp"
@@ -52,7 +55,8 @@ bool blocking_actor::accept_one_cond::post() {
 }
 
 blocking_actor::blocking_actor(actor_config& cfg)
-    : extended_base(cfg.add_flag(local_actor::is_blocking_flag)) {
+    : extended_base(cfg.add_flag(local_actor::is_blocking_flag)),
+      fiber_timeout_id_(0) {
   // nop
 }
 
@@ -60,15 +64,35 @@ blocking_actor::~blocking_actor() {
   // avoid weak-vtables warning
 }
 
-void blocking_actor::enqueue(mailbox_element_ptr ptr, execution_unit*) {
+void blocking_actor::enqueue(mailbox_element_ptr ptr, execution_unit* eu) {
   CAF_ASSERT(ptr != nullptr);
   CAF_ASSERT(getf(is_blocking_flag));
   CAF_LOG_TRACE(CAF_ARG(*ptr));
   CAF_LOG_SEND_EVENT(ptr);
   auto mid = ptr->mid;
   auto src = ptr->sender;
+  if (fiber_ != nullptr) {
+    switch (mailbox().enqueue(ptr.release())) {
+      case detail::enqueue_result::unblocked_reader:
+        CAF_LOG_ACCEPT_EVENT(true);
+        schedule_fiber(eu);
+        break;
+      case detail::enqueue_result::queue_closed:
+        CAF_LOG_REJECT_EVENT();
+        if (mid.is_request()) {
+          detail::sync_request_bouncer srb{exit_reason()};
+          srb(src, mid);
+        }
+        break;
+      case detail::enqueue_result::success:
+        CAF_LOG_ACCEPT_EVENT(false);
+        break;
+    }
+    return;
+  }
   // returns false if mailbox has been closed
-  if (!mailbox().synchronized_enqueue(mtx_, cv_, ptr.release())) {
+  if (!mailbox().synchronized_enqueue(mailbox_mtx_, mailbox_cv_,
+                                      ptr.release())) {
     CAF_LOG_REJECT_EVENT();
     if (mid.is_request()) {
       detail::sync_request_bouncer srb{exit_reason()};
@@ -79,47 +103,122 @@ void blocking_actor::enqueue(mailbox_element_ptr ptr, execution_unit*) {
   }
 }
 
+void blocking_actor::enqueue_batch(std::vector<mailbox_element_ptr> xs,
+                                   execution_unit* eu) {
+  CAF_ASSERT(getf(is_blocking_flag));
+  CAF_LOG_TRACE(CAF_ARG2("size", xs.size()));
+  if (xs.empty())
+    return;
+  mailbox_element* first = nullptr;
+  mailbox_element* last = nullptr;
+  for (auto& x : xs) {
+    CAF_ASSERT(x != nullptr);
+    CAF_LOG_SEND_EVENT(x);
+    auto ptr = x.release();
+    ptr->next = nullptr;
+    if (last != nullptr)
+      last->next = ptr;
+    else
+      first = ptr;
+    last = ptr;
+  }
+  auto bounce = [&](mailbox_element& x) {
+    if (x.mid.is_request()) {
+      detail::sync_request_bouncer srb{exit_reason()};
+      srb(x.sender, x.mid);
+    }
+  };
+  if (fiber_ != nullptr) {
+    switch (mailbox().enqueue_list(first, bounce)) {
+      case detail::enqueue_result::unblocked_reader:
+        CAF_LOG_ACCEPT_EVENT(true);
+        schedule_fiber(eu);
+        break;
+      case detail::enqueue_result::queue_closed:
+        CAF_LOG_REJECT_EVENT();
+        break;
+      case detail::enqueue_result::success:
+        CAF_LOG_ACCEPT_EVENT(false);
+        break;
+    }
+    return;
+  }
+  if (!mailbox().synchronized_enqueue_list(mailbox_mtx_, mailbox_cv_, first,
+                                           bounce)) {
+    CAF_LOG_REJECT_EVENT();
+  } else {
+    CAF_LOG_ACCEPT_EVENT(false);
+  }
+}
+
 const char* blocking_actor::name() const {
   return "blocking_actor";
 }
 
-void blocking_actor::launch(execution_unit*, bool, bool hide) {
+void blocking_actor::launch(execution_unit* eu, bool, bool hide) {
   CAF_LOG_TRACE(CAF_ARG(hide));
   CAF_ASSERT(getf(is_blocking_flag));
   if (!hide)
     register_at_system();
+  if (!getf(is_detached_flag) && detail::blocking_fiber::available()) {
+    // actor lives in a fiber on the workers of the scheduler
+    auto stack_size = home_system().config().scheduler_fiber_stack_size;
+    fiber_.reset(new detail::blocking_fiber(this, stack_size));
+    schedule_fiber(eu);
+    return;
+  }
   home_system().inc_detached_threads();
-  std::thread([](strong_actor_ptr ptr) {
+  strong_actor_ptr ptr{ctrl()};
+  home_system().private_threads().run([ptr] {
     // actor lives in its own thread
     auto this_ptr = ptr->get();
     CAF_ASSERT(dynamic_cast<blocking_actor*>(this_ptr) != 0);
     auto self = static_cast<blocking_actor*>(this_ptr);
     CAF_SET_LOGGER_SYS(ptr->home_system);
     CAF_PUSH_AID_FROM_PTR(self);
-    self->initialize();
-    error rsn;
-#   ifndef CAF_NO_EXCEPTIONS
-    try {
-      self->act();
-      rsn = self->fail_state_;
-    }
-    catch (...) {
-      rsn = exit_reason::unhandled_exception;
-    }
-    try {
-      self->on_exit();
-    }
-    catch (...) {
-      // simply ignore exception
-    }
-#   else
-    self->act();
-    rsn = self->fail_state_;
-    self->on_exit();
-#   endif
-    self->cleanup(std::move(rsn), self->context());
+    self->execute();
     ptr->home_system->dec_detached_threads();
-  }, strong_actor_ptr{ctrl()}).detach();
+  });
+}
+
+void blocking_actor::execute() {
+  initialize();
+  error rsn;
+# ifndef CAF_NO_EXCEPTIONS
+  try {
+    act();
+    rsn = fail_state_;
+  }
+  catch (...) {
+    rsn = exit_reason::unhandled_exception;
+  }
+  try {
+    on_exit();
+  }
+  catch (...) {
+    // simply ignore exception
+  }
+# else
+  act();
+  rsn = fail_state_;
+  on_exit();
+# endif
+  if (fiber_pending_) {
+    detail::sync_request_bouncer srb{rsn};
+    srb(*fiber_pending_);
+    fiber_pending_.reset();
+  }
+  cleanup(std::move(rsn), context());
+}
+
+void blocking_actor::schedule_fiber(execution_unit* eu) {
+  CAF_ASSERT(fiber_ != nullptr);
+  // the scheduler releases this reference after resuming the fiber
+  intrusive_ptr_add_ref(ctrl());
+  if (eu != nullptr)
+    eu->exec_later(fiber_.get());
+  else
+    home_system().scheduler().enqueue(fiber_.get());
 }
 
 blocking_actor::receive_while_helper
@@ -410,20 +509,66 @@ void blocking_actor::receive_impl(receive_cond& rcc,
 }
 
 void blocking_actor::await_data() {
-  if (!has_next_message())
-    mailbox().synchronized_await(mtx_, cv_);
+  if (fiber_ != nullptr)
+    fiber_await_data(nullptr);
+  else if (!has_next_message())
+    mailbox().synchronized_await(mailbox_mtx_, mailbox_cv_);
 }
 
 bool blocking_actor::await_data(timeout_type timeout) {
+  if (fiber_ != nullptr)
+    return fiber_await_data(&timeout);
   if (has_next_message())
     return true;
-  return mailbox().synchronized_await(mtx_, cv_, timeout);
+  return mailbox().synchronized_await(mailbox_mtx_, mailbox_cv_, timeout);
 }
 
 mailbox_element_ptr blocking_actor::dequeue() {
+  if (fiber_pending_)
+    return std::move(fiber_pending_);
   return next_message();
 }
 
+bool blocking_actor::fiber_await_data(const timeout_type* timeout) {
+  CAF_ASSERT(fiber_ != nullptr);
+  if (fiber_pending_)
+    return true;
+  // fibers cannot wait on a condition variable without blocking the worker,
+  // hence the timer delivers a timeout_msg that wakes up the fiber instead
+  bool timer_started = false;
+  uint32_t tid = 0;
+  for (;;) {
+    auto ptr = next_message();
+    if (ptr == nullptr) {
+      if (timeout != nullptr && !timer_started) {
+        auto now = std::chrono::high_resolution_clock::now();
+        if (*timeout <= now)
+          return false;
+        // round up to make sure we never time out early
+        auto rel = std::chrono::duration_cast<std::chrono::microseconds>(
+                     *timeout - now)
+                   + std::chrono::microseconds{1};
+        tid = ++fiber_timeout_id_;
+        home_system().scheduler().delayed_send(
+          rel, nullptr, ctrl(), message_id::make(),
+          make_message(timeout_msg{tid}));
+        timer_started = true;
+      }
+      fiber_->await_messages();
+      continue;
+    }
+    if (ptr->content().type_token() == make_type_token<timeout_msg>()) {
+      // drop timeouts of previous calls
+      if (timer_started
+          && ptr->content().get_as<timeout_msg>(0).timeout_id == tid)
+        return false;
+      continue;
+    }
+    fiber_pending_ = std::move(ptr);
+    return true;
+  }
+}
+
 void blocking_actor::varargs_tup_receive(receive_cond& rcc, message_id mid,
                                          std::tuple<behavior&>& tup) {
   using namespace detail;
@@ -0,0 +1,236 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/blocking_fiber.hpp"
+
+#include <new>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+#ifdef CAF_HAS_BLOCKING_FIBERS
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif // CAF_HAS_BLOCKING_FIBERS
+
+#include "caf/logger.hpp"
+#include "caf/blocking_actor.hpp"
+
+namespace caf {
+namespace detail {
+
+#ifdef CAF_HAS_BLOCKING_FIBERS
+
+namespace {
+
+// upper bound for unused stacks kept in the pool
+constexpr size_t max_pooled_stacks = 128;
+
+struct fiber_stack {
+  // start of the mapping, i.e., the guard page
+  char* base;
+  // size of the mapping including the guard page
+  size_t size;
+};
+
+size_t page_size() {
+  static size_t result = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return result;
+}
+
+// recycles stacks of finished fibers, since mapping fresh memory and
+// setting up guard pages requires several system calls
+class fiber_stack_pool {
+public:
+  ~fiber_stack_pool() {
+    for (auto& x : stacks_)
+      munmap(x.base, x.size);
+  }
+
+  fiber_stack acquire(size_t usable_size) {
+    auto size = usable_size + page_size();
+    { // lifetime scope of guard
+      std::unique_lock<std::mutex> guard{mtx_};
+      for (auto i = stacks_.begin(); i != stacks_.end(); ++i) {
+        if (i->size == size) {
+          auto result = *i;
+          stacks_.erase(i);
+          return result;
+        }
+      }
+    }
+    auto ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED)
+      throw std::bad_alloc();
+    // stacks grow downwards, i.e., the guard page goes to the lowest address
+    if (mprotect(ptr, page_size(), PROT_NONE) != 0) {
+      munmap(ptr, size);
+      throw std::bad_alloc();
+    }
+    return {static_cast<char*>(ptr), size};
+  }
+
+  void release(fiber_stack x) {
+    { // lifetime scope of guard
+      std::unique_lock<std::mutex> guard{mtx_};
+      if (stacks_.size() < max_pooled_stacks) {
+        stacks_.push_back(x);
+        return;
+      }
+    }
+    munmap(x.base, x.size);
+  }
+
+  size_t size() {
+    std::unique_lock<std::mutex> guard{mtx_};
+    return stacks_.size();
+  }
+
+private:
+  std::mutex mtx_;
+  std::vector<fiber_stack> stacks_;
+};
+
+fiber_stack_pool& stack_pool() {
+  static fiber_stack_pool result;
+  return result;
+}
+
+} // namespace <anonymous>
+
+struct blocking_fiber::context {
+  ucontext_t fiber;
+  ucontext_t worker;
+  fiber_stack stack;
+};
+
+blocking_fiber::blocking_fiber(blocking_actor* self, size_t stack_size)
+    : self_(self),
+      ctx_(new context),
+      state_(state::running) {
+  auto ps = page_size();
+  stack_size = ((stack_size + ps - 1) / ps) * ps;
+  ctx_->stack = stack_pool().acquire(stack_size);
+  getcontext(&ctx_->fiber);
+  ctx_->fiber.uc_stack.ss_sp = ctx_->stack.base + ps;
+  ctx_->fiber.uc_stack.ss_size = ctx_->stack.size - ps;
+  ctx_->fiber.uc_link = nullptr;
+  // makecontext only passes int arguments to the entry point
+  auto addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(this));
+  makecontext(&ctx_->fiber, reinterpret_cast<void (*)()>(&entry), 2,
+              static_cast<int>(static_cast<uint32_t>(addr >> 32)),
+              static_cast<int>(static_cast<uint32_t>(addr)));
+}
+
+blocking_fiber::~blocking_fiber() {
+  stack_pool().release(ctx_->stack);
+}
+
+resumable::resume_result blocking_fiber::resume(execution_unit* ctx, size_t) {
+  CAF_ASSERT(state_ != state::done);
+  self_->context(ctx);
+  for (;;) {
+    state_ = state::running;
+    swapcontext(&ctx_->worker, &ctx_->fiber);
+    if (state_ == state::done)
+      return resumable::done;
+    // blocking the mailbox from the worker rather than the fiber guarantees
+    // that no other worker resumes this fiber before it has left the stack
+    if (self_->mailbox().try_block())
+      return resumable::awaiting_message;
+  }
+}
+
+void blocking_fiber::await_messages() {
+  state_ = state::awaiting_messages;
+  swapcontext(&ctx_->fiber, &ctx_->worker);
+}
+
+bool blocking_fiber::available() {
+  return true;
+}
+
+size_t blocking_fiber::pooled_stacks() {
+  return stack_pool().size();
+}
+
+void blocking_fiber::entry(int hi, int lo) {
+  auto addr = (static_cast<uint64_t>(static_cast<uint32_t>(hi)) << 32)
+              | static_cast<uint64_t>(static_cast<uint32_t>(lo));
+  auto ptr = reinterpret_cast<blocking_fiber*>(static_cast<uintptr_t>(addr));
+  ptr->self_->execute();
+  ptr->state_ = state::done;
+  // never returns, because done fibers are never resumed
+  setcontext(&ptr->ctx_->worker);
+}
+
+#else // CAF_HAS_BLOCKING_FIBERS
+
+struct blocking_fiber::context {
+  // nop
+};
+
+blocking_fiber::blocking_fiber(blocking_actor* self, size_t)
+    : self_(self),
+      state_(state::done) {
+  CAF_RAISE_ERROR("blocking fibers are not supported on this platform");
+}
+
+blocking_fiber::~blocking_fiber() {
+  // nop
+}
+
+resumable::resume_result blocking_fiber::resume(execution_unit*, size_t) {
+  return resumable::done;
+}
+
+void blocking_fiber::await_messages() {
+  // nop
+}
+
+bool blocking_fiber::available() {
+  return false;
+}
+
+size_t blocking_fiber::pooled_stacks() {
+  return 0;
+}
+
+void blocking_fiber::entry(int, int) {
+  // nop
+}
+
+#endif // CAF_HAS_BLOCKING_FIBERS
+
+resumable::subtype_t blocking_fiber::subtype() const {
+  return resumable::unspecified;
+}
+
+void blocking_fiber::intrusive_ptr_add_ref_impl() {
+  intrusive_ptr_add_ref(self_->ctrl());
+}
+
+void blocking_fiber::intrusive_ptr_release_impl() {
+  intrusive_ptr_release(self_->ctrl());
+}
+
+} // namespace detail
+} // namespace caf
@@ -0,0 +1,208 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/concurrent_actor_map.hpp"
+
+#include <thread>
+
+namespace caf {
+namespace detail {
+
+namespace {
+
+// initial number of slots per shard
+constexpr size_t min_capacity = 16;
+
+} // namespace <anonymous>
+
+constexpr size_t concurrent_actor_map::num_shards;
+
+concurrent_actor_map::concurrent_actor_map() : shards_(new shard[num_shards]) {
+  // nop
+}
+
+concurrent_actor_map::~concurrent_actor_map() {
+  for (size_t i = 0; i < num_shards; ++i) {
+    auto t = shards_[i].tbl.load();
+    if (t == nullptr)
+      continue;
+    for (size_t j = 0; j < t->capacity; ++j) {
+      auto ptr = t->slots[j].val.load();
+      if (ptr != nullptr)
+        intrusive_ptr_release(ptr);
+    }
+    delete t;
+  }
+}
+
+strong_actor_ptr concurrent_actor_map::get(key_type key) const {
+  auto h = hash(key);
+  auto& s = shard_for(h);
+  auto e = enter(s);
+  strong_actor_ptr result;
+  auto t = s.tbl.load();
+  if (t != nullptr) {
+    auto mask = t->capacity - 1;
+    for (auto i = h & mask;; i = (i + 1) & mask) {
+      auto& x = t->slots[i];
+      auto st = x.state.load();
+      if (st == empty_slot)
+        break;
+      if (st == used_slot && x.key == key) {
+        // the slot is `nullptr` if a writer removed the entry meanwhile
+        result.reset(x.val.load());
+        break;
+      }
+    }
+  }
+  leave(s, e);
+  return result;
+}
+
+auto concurrent_actor_map::entries() const -> std::vector<value_type> {
+  std::vector<value_type> result;
+  for (size_t i = 0; i < num_shards; ++i) {
+    auto& s = shards_[i];
+    std::unique_lock<std::mutex> guard{s.mtx};
+    auto t = s.tbl.load();
+    if (t == nullptr)
+      continue;
+    for (size_t j = 0; j < t->capacity; ++j) {
+      auto& x = t->slots[j];
+      if (x.state.load() == used_slot)
+        result.emplace_back(x.key, x.val.load());
+    }
+  }
+  return result;
+}
+
+bool concurrent_actor_map::put(key_type key, strong_actor_ptr val) {
+  if (!val)
+    return false;
+  auto h = hash(key);
+  auto& s = shard_for(h);
+  std::unique_lock<std::mutex> guard{s.mtx};
+  auto t = s.tbl.load();
+  // keep at least a quarter of all slots empty to bound probe sequences
+  if (t == nullptr || (t->used + 1) * 4 > t->capacity * 3)
+    t = rehash(s, t);
+  auto mask = t->capacity - 1;
+  for (auto i = h & mask;; i = (i + 1) & mask) {
+    auto& x = t->slots[i];
+    auto st = x.state.load();
+    if (st == used_slot && x.key == key)
+      return false;
+    if (st == empty_slot) {
+      // publish key and value before readers can match the slot
+      x.key = key;
+      x.val.store(val.release());
+      x.state.store(used_slot);
+      ++t->used;
+      ++t->size;
+      return true;
+    }
+  }
+}
+
+bool concurrent_actor_map::erase(key_type key) {
+  auto h = hash(key);
+  auto& s = shard_for(h);
+  actor_control_block* ptr;
+  { // lifetime scope of guard
+    std::unique_lock<std::mutex> guard{s.mtx};
+    auto t = s.tbl.load();
+    if (t == nullptr)
+      return false;
+    auto mask = t->capacity - 1;
+    for (auto i = h & mask;; i = (i + 1) & mask) {
+      auto& x = t->slots[i];
+      auto st = x.state.load();
+      if (st == empty_slot)
+        return false;
+      if (st == used_slot && x.key == key) {
+        ptr = x.val.exchange(nullptr);
+        x.state.store(erased_slot);
+        --t->size;
+        break;
+      }
+    }
+    // readers that loaded `ptr` must finish incrementing its reference
+    // count before we drop the reference of the map
+    synchronize(s);
+  }
+  intrusive_ptr_release(ptr);
+  return true;
+}
+
+size_t concurrent_actor_map::enter(shard& s) {
+  for (;;) {
+    auto e = s.epoch.load();
+    s.readers[e].fetch_add(1);
+    // a writer may have flipped the epoch and checked our counter before
+    // our increment, in which case we retry with the new epoch
+    if (s.epoch.load() == e)
+      return e;
+    s.readers[e].fetch_sub(1);
+  }
+}
+
+void concurrent_actor_map::leave(shard& s, size_t epoch) {
+  s.readers[epoch].fetch_sub(1);
+}
+
+void concurrent_actor_map::synchronize(shard& s) {
+  auto e = s.epoch.load();
+  s.epoch.store(e ^ 1);
+  // new readers observe the current state, only wait for older ones
+  while (s.readers[e].load() != 0)
+    std::this_thread::yield();
+}
+
+auto concurrent_actor_map::rehash(shard& s, table* old) -> table* {
+  auto n = min_capacity;
+  if (old != nullptr)
+    while ((old->size + 1) * 2 > n)
+      n *= 2;
+  std::unique_ptr<table> t{new table(n)};
+  if (old != nullptr) {
+    auto mask = n - 1;
+    for (size_t i = 0; i < old->capacity; ++i) {
+      auto& x = old->slots[i];
+      if (x.state.load() != used_slot)
+        continue;
+      auto j = hash(x.key) & mask;
+      while (t->slots[j].state.load() != empty_slot)
+        j = (j + 1) & mask;
+      t->slots[j].key = x.key;
+      t->slots[j].val.store(x.val.load());
+      t->slots[j].state.store(used_slot);
+    }
+    t->used = old->size;
+    t->size = old->size;
+  }
+  s.tbl.store(t.get());
+  if (old != nullptr) {
+    synchronize(s);
+    delete old;
+  }
+  return t.release();
+}
+
+} // namespace detail
+} // namespace caf
@@ -0,0 +1,151 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/coroutine_frame_pool.hpp"
+#include "caf/detail/coroutine_response_slot.hpp"
+
+#include <new>
+#include <cstdint>
+
+#ifdef CAF_NO_THREAD_LOCAL
+#include <pthread.h>
+#endif // CAF_NO_THREAD_LOCAL
+
+namespace caf {
+namespace detail {
+
+// prefixes each frame to find its pool on deallocation, padded to keep the
+// frame itself at the strictest fundamental alignment
+struct alignas(alignof(std::max_align_t)) coroutine_frame_pool::block {
+  coroutine_frame_pool* pool;
+  // index of the size class or `num_size_classes` for unpooled frames
+  size_t size_class;
+  // next cached block while sitting in a free list
+  block* next;
+};
+
+coroutine_response_slot::~coroutine_response_slot() {
+  // nop
+}
+
+constexpr size_t coroutine_frame_pool::min_block_size;
+
+constexpr size_t coroutine_frame_pool::num_size_classes;
+
+constexpr size_t coroutine_frame_pool::max_cached_blocks;
+
+namespace {
+
+size_t size_class_of(size_t size) {
+  auto n = coroutine_frame_pool::min_block_size;
+  for (size_t i = 0; i < coroutine_frame_pool::num_size_classes; ++i) {
+    if (size <= n)
+      return i;
+    n *= 2;
+  }
+  return coroutine_frame_pool::num_size_classes;
+}
+
+} // namespace <anonymous>
+
+coroutine_frame_pool::coroutine_frame_pool() {
+  for (size_t i = 0; i < num_size_classes; ++i) {
+    free_lists_[i] = nullptr;
+    free_list_sizes_[i] = 0;
+  }
+}
+
+coroutine_frame_pool::~coroutine_frame_pool() {
+  for (size_t i = 0; i < num_size_classes; ++i) {
+    auto ptr = free_lists_[i];
+    while (ptr != nullptr) {
+      auto next = ptr->next;
+      ::operator delete(ptr);
+      ptr = next;
+    }
+  }
+}
+
+void* coroutine_frame_pool::allocate(coroutine_frame_pool* pool, size_t size) {
+  auto cls = pool != nullptr ? size_class_of(size) : num_size_classes;
+  block* ptr;
+  if (cls == num_size_classes) {
+    ptr = static_cast<block*>(::operator new(sizeof(block) + size));
+    ptr->pool = nullptr;
+  } else if (pool->free_lists_[cls] != nullptr) {
+    ptr = pool->free_lists_[cls];
+    pool->free_lists_[cls] = ptr->next;
+    --pool->free_list_sizes_[cls];
+  } else {
+    ptr = static_cast<block*>(::operator new(sizeof(block)
+                                             + (min_block_size << cls)));
+    ptr->pool = pool;
+  }
+  ptr->size_class = cls;
+  ptr->next = nullptr;
+  return ptr + 1;
+}
+
+void coroutine_frame_pool::deallocate(void* ptr) {
+  auto bptr = static_cast<block*>(ptr) - 1;
+  auto pool = bptr->pool;
+  auto cls = bptr->size_class;
+  if (pool == nullptr || pool->free_list_sizes_[cls] == max_cached_blocks) {
+    ::operator delete(bptr);
+    return;
+  }
+  bptr->next = pool->free_lists_[cls];
+  pool->free_lists_[cls] = bptr;
+  ++pool->free_list_sizes_[cls];
+}
+
+size_t coroutine_frame_pool::cached() const {
+  size_t result = 0;
+  for (size_t i = 0; i < num_size_classes; ++i)
+    result += free_list_sizes_[i];
+  return result;
+}
+
+#ifdef CAF_NO_THREAD_LOCAL
+
+namespace {
+
+pthread_key_t s_owner_key;
+pthread_once_t s_owner_key_once = PTHREAD_ONCE_INIT;
+
+void make_owner_key() {
+  pthread_key_create(&s_owner_key, nullptr);
+}
+
+} // namespace <anonymous>
+
+scheduled_actor* current_coroutine_owner() {
+  pthread_once(&s_owner_key_once, make_owner_key);
+  return reinterpret_cast<scheduled_actor*>(pthread_getspecific(s_owner_key));
+}
+
+void current_coroutine_owner(scheduled_actor* x) {
+  pthread_once(&s_owner_key_once, make_owner_key);
+  pthread_setspecific(s_owner_key, x);
+}
+
+#endif // CAF_NO_THREAD_LOCAL
+
+} // namespace detail
+} // namespace caf
@@ -0,0 +1,72 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/file_writer.hpp"
+
+#include "caf/sec.hpp"
+#include "caf/logger.hpp"
+
+namespace caf {
+namespace detail {
+
+file_writer::file_writer() : file_(nullptr), buffer_size_(0), written_(0) {
+  // nop
+}
+
+file_writer::~file_writer() {
+  close();
+}
+
+error file_writer::open(const std::string& path, size_t buffer_size) {
+  CAF_LOG_TRACE(CAF_ARG(path) << CAF_ARG(buffer_size));
+  close();
+  file_ = std::fopen(path.c_str(), "ab");
+  if (file_ == nullptr)
+    return make_error(sec::runtime_error, "cannot open file", path);
+  // we do our own buffering
+  std::setvbuf(file_, nullptr, _IONBF, 0);
+  buffer_size_ = buffer_size;
+  buf_.reserve(buffer_size);
+  return none;
+}
+
+error file_writer::flush() {
+  if (buf_.empty())
+    return none;
+  if (std::fwrite(buf_.data(), 1, buf_.size(), file_) != buf_.size()) {
+    // discard the data instead of retrying with an ever growing buffer
+    buf_.clear();
+    return make_error(sec::runtime_error, "cannot write to file");
+  }
+  written_ += buf_.size();
+  buf_.clear();
+  return none;
+}
+
+error file_writer::close() {
+  if (file_ == nullptr)
+    return none;
+  auto err = flush();
+  std::fclose(file_);
+  file_ = nullptr;
+  return err;
+}
+
+} // namespace detail
+} // namespace caf
@@ -29,6 +29,7 @@
 #include "caf/exit_reason.hpp"
 #include "caf/local_actor.hpp"
 #include "caf/actor_system.hpp"
+#include "caf/actor_system_config.hpp"
 #include "caf/actor_ostream.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/default_attachable.hpp"
@@ -97,40 +98,19 @@ message_id local_actor::new_request_id(message_priority mp) {
 mailbox_element_ptr local_actor::next_message() {
   if (!getf(is_priority_aware_flag))
     return mailbox_element_ptr{mailbox().try_pop()};
-  // we partition the mailbox into four segments in this case:
-  // <-------- ! was_skipped --------> | <--------  was_skipped  -------->
-  // <-- high prio --><-- low prio --> | <-- high prio --><-- low prio -->
-  auto& cache = mailbox().cache();
-  auto i = cache.begin();
-  auto e = cache.separator();
-  // read elements from mailbox if we don't have a high
-  // priority message or if cache is empty
-  if (i == e || !i->is_high_priority()) {
-    // insert points for high priority
-    auto hp_pos = i;
-    // read whole mailbox at once
-    auto tmp = mailbox().try_pop();
-    while (tmp != nullptr) {
-      cache.insert(tmp->is_high_priority() ? hp_pos : e, tmp);
-      // adjust high priority insert point on first low prio element insert
-      if (hp_pos == e && !tmp->is_high_priority())
-        --hp_pos;
-      tmp = mailbox().try_pop();
-    }
-  }
-  mailbox_element_ptr result;
-  i = cache.begin();
-  if (i != e)
-    result.reset(cache.take(i));
-  return result;
+  if (!lanes_)
+    lanes_.reset(new detail::mailbox_lanes(
+      home_system().config().scheduler_lane_fairness));
+  // sort all new elements into their lanes before picking the next one
+  for (auto x = mailbox().try_pop(); x != nullptr; x = mailbox().try_pop())
+    lanes_->push(x);
+  return mailbox_element_ptr{lanes_->take()};
 }
 
 bool local_actor::has_next_message() {
-  if (!getf(is_priority_aware_flag))
-    return mailbox_.can_fetch_more();
-  auto& mbox = mailbox();
-  auto& cache = mbox.cache();
-  return cache.begin() != cache.separator() || mbox.can_fetch_more();
+  if (lanes_ && !lanes_->empty())
+    return true;
+  return mailbox_.can_fetch_more();
 }
 
 void local_actor::push_to_cache(mailbox_element_ptr ptr) {
@@ -182,6 +162,8 @@ bool local_actor::cleanup(error&& fail_state, execution_unit* host) {
   if (!mailbox_.closed()) {
     detail::sync_request_bouncer f{fail_state};
     mailbox_.close(f);
+    if (lanes_)
+      lanes_->clear(f);
   }
   // tell registry we're done
   unregister_from_system();
@@ -0,0 +1,525 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/log_record.hpp"
+
+#include <istream>
+#include <ostream>
+#include <algorithm>
+#include <unordered_map>
+
+#include "caf/binary_serializer.hpp"
+#include "caf/binary_deserializer.hpp"
+
+namespace caf {
+namespace detail {
+
+namespace {
+
+constexpr char binary_log_magic[8] = {'C', 'A', 'F', 'L', 'O', 'G', 0, 1};
+
+// tags of the entries in binary log files
+constexpr char site_entry = 'S';
+constexpr char thread_entry = 'T';
+constexpr char record_entry = 'R';
+constexpr char full_entry = 'E';
+
+template <class T>
+bool read_pod(const char*& first, const char* last, T& x) {
+  if (static_cast<size_t>(last - first) < sizeof(T))
+    return false;
+  memcpy(&x, first, sizeof(T));
+  first += sizeof(T);
+  return true;
+}
+
+template <class T>
+void write_pod(std::ostream& out, const T& x) {
+  out.write(reinterpret_cast<const char*>(&x), sizeof(T));
+}
+
+void write_str(std::ostream& out, const char* str, size_t len) {
+  auto n = static_cast<uint32_t>(len);
+  write_pod(out, n);
+  out.write(str, n);
+}
+
+void write_str(std::ostream& out, const std::string& x) {
+  write_str(out, x.data(), x.size());
+}
+
+template <class T>
+bool read_pod(std::istream& in, T& x) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&x), sizeof(T)));
+}
+
+bool read_str(std::istream& in, std::string& x) {
+  uint32_t n;
+  if (!read_pod(in, n))
+    return false;
+  x.resize(n);
+  return n == 0 || static_cast<bool>(in.read(&x[0], n));
+}
+
+} // namespace <anonymous>
+
+// -- log_record_writer --------------------------------------------------------
+
+log_record_writer::log_record_writer(std::vector<char>& buf) : buf_(buf) {
+  // nop
+}
+
+void log_record_writer::begin(const log_site& site, timestamp tstamp,
+                              actor_id aid) {
+  buf_.clear();
+  uint32_t size = 0;
+  auto site_id = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&site));
+  int64_t ts = tstamp.time_since_epoch().count();
+  uint64_t id = aid;
+  append(&size, sizeof(size));
+  append(&site_id, sizeof(site_id));
+  append(&ts, sizeof(ts));
+  append(&id, sizeof(id));
+}
+
+void log_record_writer::end() {
+  auto size = static_cast<uint32_t>(buf_.size());
+  memcpy(buf_.data(), &size, sizeof(size));
+}
+
+void log_record_writer::text(const char* str, size_t len) {
+  tag(log_text_arg, nullptr);
+  auto n = static_cast<uint32_t>(len);
+  append(&n, sizeof(n));
+  append(str, len);
+}
+
+void log_record_writer::tag(log_arg_tag x, const char* name) {
+  uint8_t y = x;
+  if (name == nullptr) {
+    append(&y, 1);
+    return;
+  }
+  y |= log_named_arg;
+  append(&y, 1);
+  auto len = static_cast<uint16_t>(strlen(name));
+  append(&len, sizeof(len));
+  append(name, len);
+}
+
+void log_record_writer::str(const std::string& x) {
+  auto n = static_cast<uint32_t>(x.size());
+  append(&n, sizeof(n));
+  append(x.data(), x.size());
+}
+
+// -- deferred arguments -------------------------------------------------------
+
+error save_log_arg(std::vector<char>& buf,
+                   const std::function<error (serializer&)>& f) {
+  binary_serializer sink{nullptr, buf};
+  return f(sink);
+}
+
+error load_log_arg(const char* buf, size_t size,
+                   const std::function<error (deserializer&)>& f) {
+  binary_deserializer source{nullptr, const_cast<char*>(buf), size};
+  return f(source);
+}
+
+// -- decoding of records ------------------------------------------------------
+
+bool read_log_record_header(const char* buf, size_t size,
+                            log_record_header& hdr) {
+  auto first = buf;
+  auto last = buf + size;
+  return read_pod(first, last, hdr.size) && read_pod(first, last, hdr.site)
+         && read_pod(first, last, hdr.tstamp) && read_pod(first, last, hdr.aid);
+}
+
+namespace {
+
+// a single argument of a binary log record
+struct log_arg_view {
+  uint8_t tag;
+  const char* name;
+  uint16_t name_len;
+  const char* payload;
+  uint32_t payload_len;
+};
+
+// decodes the argument at `first` into `x` and advances `first`
+bool next_log_arg(const char*& first, const char* last, log_arg_view& x) {
+  if (!read_pod(first, last, x.tag))
+    return false;
+  x.name = nullptr;
+  x.name_len = 0;
+  if ((x.tag & log_named_arg) != 0) {
+    if (!read_pod(first, last, x.name_len)
+        || static_cast<size_t>(last - first) < x.name_len)
+      return false;
+    x.name = first;
+    first += x.name_len;
+  }
+  x.payload = first;
+  switch (x.tag & ~log_named_arg) {
+    case log_text_arg:
+    case log_string_arg:
+      if (!read_pod(first, last, x.payload_len))
+        return false;
+      x.payload = first;
+      break;
+    case log_int_arg:
+    case log_uint_arg:
+    case log_double_arg:
+      x.payload_len = 8;
+      break;
+    case log_bool_arg:
+      x.payload_len = 1;
+      break;
+    case log_deferred_arg: {
+      // the payload includes the renderer and the size prefix
+      uint64_t fun;
+      uint32_t n;
+      if (!read_pod(first, last, fun) || !read_pod(first, last, n))
+        return false;
+      x.payload_len = static_cast<uint32_t>(first - x.payload) + n;
+      first = x.payload;
+      break;
+    }
+    default:
+      return false;
+  }
+  if (static_cast<size_t>(last - first) < x.payload_len)
+    return false;
+  first += x.payload_len;
+  return true;
+}
+
+// calls the renderer of a deferred argument
+bool render_deferred(const log_arg_view& x, std::string& out) {
+  uint64_t fun;
+  memcpy(&fun, x.payload, sizeof(fun));
+  auto f = reinterpret_cast<log_arg_renderer>(static_cast<uintptr_t>(fun));
+  auto offset = sizeof(fun) + sizeof(uint32_t);
+  return f(x.payload + offset, x.payload_len - offset, out);
+}
+
+} // namespace <anonymous>
+
+bool render_log_args(const char* buf, size_t size, std::string& out) {
+  if (size < log_record_header_size)
+    return false;
+  auto first = buf + log_record_header_size;
+  auto last = buf + size;
+  // mirrors the separator logic of logger::line_builder
+  bool behind_arg = false;
+  std::string value;
+  log_arg_view x;
+  while (first != last) {
+    if (!next_log_arg(first, last, x))
+      return false;
+    value.clear();
+    switch (x.tag & ~log_named_arg) {
+      case log_text_arg:
+      case log_string_arg:
+        value.assign(x.payload, x.payload_len);
+        break;
+      case log_int_arg: {
+        int64_t y;
+        memcpy(&y, x.payload, sizeof(y));
+        value = std::to_string(y);
+        break;
+      }
+      case log_uint_arg: {
+        uint64_t y;
+        memcpy(&y, x.payload, sizeof(y));
+        value = std::to_string(y);
+        break;
+      }
+      case log_double_arg: {
+        double y;
+        memcpy(&y, x.payload, sizeof(y));
+        value = std::to_string(y);
+        break;
+      }
+      case log_bool_arg:
+        value = *x.payload != 0 ? "true" : "false";
+        break;
+      default: // log_deferred_arg
+        if (!render_deferred(x, value))
+          return false;
+    }
+    if (x.name != nullptr) {
+      if (behind_arg)
+        out += ", ";
+      else if (!out.empty())
+        out += " ";
+      out.append(x.name, x.name_len);
+      out += " = ";
+      out += value;
+      behind_arg = true;
+    } else {
+      if (!out.empty())
+        out += " ";
+      out += value;
+      behind_arg = false;
+    }
+  }
+  return true;
+}
+
+bool resolve_log_args(const char* buf, size_t size, std::vector<char>& out) {
+  out.clear();
+  if (size < log_record_header_size)
+    return false;
+  auto first = buf + log_record_header_size;
+  auto last = buf + size;
+  out.insert(out.end(), buf, first);
+  std::string value;
+  log_arg_view x;
+  while (first != last) {
+    auto arg_begin = first;
+    if (!next_log_arg(first, last, x))
+      return false;
+    if ((x.tag & ~log_named_arg) != log_deferred_arg) {
+      out.insert(out.end(), arg_begin, first);
+      continue;
+    }
+    value.clear();
+    if (!render_deferred(x, value))
+      return false;
+    // keep tag flags and name, but store the rendered string
+    out.push_back(static_cast<char>(log_string_arg | (x.tag & log_named_arg)));
+    out.insert(out.end(), arg_begin + 1, x.payload);
+    auto n = static_cast<uint32_t>(value.size());
+    auto np = reinterpret_cast<const char*>(&n);
+    out.insert(out.end(), np, np + sizeof(n));
+    out.insert(out.end(), value.begin(), value.end());
+  }
+  // update the size of the record
+  auto n = static_cast<uint32_t>(out.size());
+  memcpy(out.data(), &n, sizeof(n));
+  return true;
+}
+
+// -- log_ring -----------------------------------------------------------------
+
+log_ring::log_ring(size_t capacity, std::thread::id tid)
+    : capacity_(std::max(capacity, size_t{1024})),
+      tid_(tid),
+      buf_(new char[capacity_]),
+      wr_pos_(0),
+      rd_pos_(0),
+      retired_(false) {
+  // nop
+}
+
+bool log_ring::try_push(const char* buf, size_t size) {
+  auto wr = wr_pos_.load(std::memory_order_relaxed);
+  auto rd = rd_pos_.load(std::memory_order_acquire);
+  if (capacity_ - (wr - rd) < size)
+    return false;
+  // copy in at most two chunks, since the record may wrap around
+  auto first = wr % capacity_;
+  auto chunk = std::min(size, capacity_ - first);
+  memcpy(buf_.get() + first, buf, chunk);
+  if (chunk < size)
+    memcpy(buf_.get(), buf + chunk, size - chunk);
+  wr_pos_.store(wr + size, std::memory_order_release);
+  return true;
+}
+
+void log_ring::copy_out(size_t pos, char* dst, size_t len) const {
+  auto first = pos % capacity_;
+  auto chunk = std::min(len, capacity_ - first);
+  memcpy(dst, buf_.get() + first, chunk);
+  if (chunk < len)
+    memcpy(dst + chunk, buf_.get(), len - chunk);
+}
+
+size_t log_ring::drain(const std::function<void (const char*, size_t)>& f) {
+  auto rd = rd_pos_.load(std::memory_order_relaxed);
+  auto wr = wr_pos_.load(std::memory_order_acquire);
+  size_t result = 0;
+  while (rd != wr) {
+    uint32_t size;
+    copy_out(rd, reinterpret_cast<char*>(&size), sizeof(size));
+    CAF_ASSERT(size >= log_record_header_size && size <= wr - rd);
+    auto first = rd % capacity_;
+    if (first + size <= capacity_) {
+      f(buf_.get() + first, size);
+    } else {
+      scratch_.resize(size);
+      copy_out(rd, scratch_.data(), size);
+      f(scratch_.data(), size);
+    }
+    rd += size;
+    ++result;
+  }
+  rd_pos_.store(rd, std::memory_order_release);
+  return result;
+}
+
+// -- binary log files ---------------------------------------------------------
+
+void write_binary_log_header(std::ostream& out, timestamp t0) {
+  out.write(binary_log_magic, sizeof(binary_log_magic));
+  write_pod(out, static_cast<int64_t>(t0.time_since_epoch().count()));
+}
+
+void write_binary_log_site(std::ostream& out, uint64_t id,
+                           const log_site& x) {
+  out.put(site_entry);
+  write_pod(out, id);
+  write_pod(out, static_cast<int32_t>(x.level));
+  write_str(out, x.category_name, strlen(x.category_name));
+  write_str(out, x.pretty_fun, strlen(x.pretty_fun));
+  write_str(out, x.file_name, strlen(x.file_name));
+  write_pod(out, static_cast<int32_t>(x.line_number));
+}
+
+void write_binary_log_thread(std::ostream& out, uint32_t idx,
+                             const std::string& tid) {
+  out.put(thread_entry);
+  write_pod(out, idx);
+  write_str(out, tid);
+}
+
+void write_binary_log_record(std::ostream& out, uint32_t idx, const char* buf,
+                             size_t size) {
+  out.put(record_entry);
+  write_pod(out, idx);
+  out.write(buf, static_cast<std::streamsize>(size));
+}
+
+void write_binary_log_entry(std::ostream& out, const log_entry& x) {
+  out.put(full_entry);
+  write_pod(out, static_cast<int32_t>(x.level));
+  write_str(out, x.category_name);
+  write_str(out, x.pretty_fun);
+  write_str(out, x.file_name);
+  write_pod(out, static_cast<int32_t>(x.line_number));
+  write_str(out, x.message);
+  write_str(out, x.tid);
+  write_pod(out, static_cast<uint64_t>(x.aid));
+  write_pod(out, static_cast<int64_t>(x.tstamp.time_since_epoch().count()));
+}
+
+bool read_binary_log(std::istream& in, timestamp& t0,
+                     const std::function<void (const log_entry&)>& f) {
+  char magic[sizeof(binary_log_magic)];
+  int64_t t0_ns;
+  if (!in.read(magic, sizeof(magic))
+      || memcmp(magic, binary_log_magic, sizeof(magic)) != 0
+      || !read_pod(in, t0_ns))
+    return false;
+  t0 = timestamp{timestamp::duration{t0_ns}};
+  struct site_info {
+    int level;
+    std::string category_name;
+    std::string pretty_fun;
+    std::string file_name;
+    int line_number;
+  };
+  std::unordered_map<uint64_t, site_info> sites;
+  std::unordered_map<uint32_t, std::string> threads;
+  std::vector<char> buf;
+  log_entry x;
+  char kind;
+  while (in.get(kind)) {
+    switch (kind) {
+      case site_entry: {
+        uint64_t id;
+        int32_t level;
+        int32_t line;
+        site_info si;
+        if (!read_pod(in, id) || !read_pod(in, level)
+            || !read_str(in, si.category_name) || !read_str(in, si.pretty_fun)
+            || !read_str(in, si.file_name) || !read_pod(in, line))
+          return false;
+        si.level = level;
+        si.line_number = line;
+        sites[id] = std::move(si);
+        break;
+      }
+      case thread_entry: {
+        uint32_t idx;
+        std::string tid;
+        if (!read_pod(in, idx) || !read_str(in, tid))
+          return false;
+        threads[idx] = std::move(tid);
+        break;
+      }
+      case record_entry: {
+        uint32_t idx;
+        uint32_t size;
+        if (!read_pod(in, idx) || !read_pod(in, size)
+            || size < log_record_header_size)
+          return false;
+        buf.resize(size);
+        memcpy(buf.data(), &size, sizeof(size));
+        if (!in.read(buf.data() + sizeof(size), size - sizeof(size)))
+          return false;
+        log_record_header hdr;
+        read_log_record_header(buf.data(), buf.size(), hdr);
+        auto i = sites.find(hdr.site);
+        if (i == sites.end())
+          return false;
+        auto& si = i->second;
+        x.level = si.level;
+        x.category_name = si.category_name;
+        x.pretty_fun = si.pretty_fun;
+        x.file_name = si.file_name;
+        x.line_number = si.line_number;
+        x.message.clear();
+        if (!render_log_args(buf.data(), buf.size(), x.message))
+          return false;
+        x.tid = threads[idx];
+        x.aid = hdr.aid;
+        x.tstamp = timestamp{timestamp::duration{hdr.tstamp}};
+        f(x);
+        break;
+      }
+      case full_entry: {
+        int32_t level;
+        int32_t line;
+        uint64_t aid;
+        int64_t ts;
+        if (!read_pod(in, level) || !read_str(in, x.category_name)
+            || !read_str(in, x.pretty_fun) || !read_str(in, x.file_name)
+            || !read_pod(in, line) || !read_str(in, x.message)
+            || !read_str(in, x.tid) || !read_pod(in, aid) || !read_pod(in, ts))
+          return false;
+        x.level = level;
+        x.line_number = line;
+        x.aid = aid;
+        x.tstamp = timestamp{timestamp::duration{ts}};
+        f(x);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+} // namespace detail
+} // namespace caf
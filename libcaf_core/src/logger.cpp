@@ -20,10 +20,12 @@
 #include "caf/logger.hpp"
 
 #include <ctime>
+#include <chrono>
 #include <thread>
 #include <cstring>
 #include <iomanip>
 #include <fstream>
+#include <sstream>
 #include <algorithm>
 #include <condition_variable>
 
@@ -111,6 +113,42 @@ inline logger* get_current_logger() {
 }
 #endif // CAF_LOG_LEVEL
 
+// distinguishes loggers of different actor systems in the same process
+std::atomic<uint64_t> s_logger_serial;
+
+// interval for draining the ring buffers of all threads in binary mode
+constexpr auto ring_drain_interval = std::chrono::milliseconds(5);
+
+struct binary_log_state {
+  uint64_t owner = 0;
+  std::shared_ptr<detail::log_ring> ring;
+  std::vector<char> buf;
+
+  ~binary_log_state() {
+    // the logger keeps draining the ring until it sees the retired flag
+    if (ring)
+      ring->retire();
+  }
+};
+
+#if defined(CAF_LOG_LEVEL) && !defined(CAF_NO_THREAD_LOCAL)
+
+thread_local binary_log_state s_binary_log_state;
+
+inline binary_log_state& get_binary_log_state() {
+  return s_binary_log_state;
+}
+
+#else // CAF_LOG_LEVEL && !CAF_NO_THREAD_LOCAL
+
+// binary output is never enabled in this configuration
+inline binary_log_state& get_binary_log_state() {
+  static binary_log_state dummy;
+  return dummy;
+}
+
+#endif // CAF_LOG_LEVEL && !CAF_NO_THREAD_LOCAL
+
 } // namespace <anonymous>
 
 logger::line_builder::line_builder() : behind_arg_(false) {
@@ -137,6 +175,29 @@ std::string logger::line_builder::get() const {
   return std::move(str_);
 }
 
+logger::record_builder::record_builder(logger& owner,
+                                       const detail::log_site& site)
+    : owner_(owner),
+      writer_(get_binary_log_state().buf) {
+  writer_.begin(site, make_timestamp(), owner.thread_local_aid());
+}
+
+logger::record_builder& logger::record_builder::
+operator<<(const std::string& str) {
+  writer_.text(str.data(), str.size());
+  return *this;
+}
+
+logger::record_builder& logger::record_builder::operator<<(const char* str) {
+  writer_.text(str, strlen(str));
+  return *this;
+}
+
+void logger::record_builder::commit() {
+  writer_.end();
+  owner_.log_record(get_binary_log_state().buf);
+}
+
 // returns the actor ID for the current thread
 actor_id logger::thread_local_aid() {
   shared_lock<detail::shared_spinlock> guard{aids_lock_};
@@ -173,6 +234,34 @@ void logger::log(event* x) {
   }
 }
 
+void logger::log_record(const std::vector<char>& buf) {
+  auto& st = get_binary_log_state();
+  if (st.owner != serial_) {
+    if (st.ring)
+      st.ring->retire();
+    auto cap = system_.config().logger_ring_size;
+    st.ring = std::make_shared<detail::log_ring>(cap,
+                                                 std::this_thread::get_id());
+    st.owner = serial_;
+    std::lock_guard<std::mutex> guard{rings_mtx_};
+    // reuse the slot of a terminated thread if possible
+    auto i = std::find(rings_.begin(), rings_.end(), nullptr);
+    if (i != rings_.end())
+      *i = st.ring;
+    else
+      rings_.push_back(st.ring);
+  }
+  auto& r = *st.ring;
+  if (buf.size() > r.capacity())
+    return;
+  // apply backpressure instead of dropping records while the writer runs
+  while (!r.try_push(buf.data(), buf.size())) {
+    if (!rings_active_)
+      return;
+    std::this_thread::yield();
+  }
+}
+
 void logger::set_current_actor_system(actor_system* x) {
   if (x != nullptr)
     set_current_logger(&x->logger());
@@ -206,7 +295,12 @@ logger::~logger() {
   system_.logger_dtor_cv_.notify_one();
 }
 
-logger::logger(actor_system& sys) : system_(sys), inline_output_(false) {
+logger::logger(actor_system& sys)
+    : system_(sys),
+      inline_output_(false),
+      binary_output_(false),
+      serial_(++s_logger_serial),
+      rings_active_(false) {
   // nop
 }
 
@@ -214,6 +308,10 @@ void logger::init(actor_system_config& cfg) {
   CAF_IGNORE_UNUSED(cfg);
 #if defined(CAF_LOG_LEVEL)
   inline_output_ = cfg.logger_inline_output;
+# ifndef CAF_NO_THREAD_LOCAL
+  // binary records require the writer thread
+  binary_output_ = cfg.logger_binary_output && !inline_output_;
+# endif
   // Parse the configured log level.
   switch (static_cast<uint64_t>(cfg.logger_verbosity)) {
     case atom_uint("quiet"):
@@ -383,6 +481,28 @@ void logger::run() {
   log_first_line();
   // receive log entries from other threads and actors
   std::unique_ptr<event> ptr;
+  if (binary_output_) {
+    // poll the ring buffers of all threads periodically
+    bool done = false;
+    while (!done) {
+      auto timeout = std::chrono::steady_clock::now() + ring_drain_interval;
+      if (queue_.synchronized_await(queue_mtx_, queue_cv_, timeout)) {
+        for (ptr.reset(queue_.try_pop()); ptr != nullptr;
+             ptr.reset(queue_.try_pop())) {
+          // empty message means: shut down
+          if (ptr->message.empty())
+            done = true;
+          else
+            handle_event(*ptr);
+        }
+      }
+      drain_rings();
+    }
+    rings_active_ = false;
+    drain_rings();
+    log_last_line();
+    return;
+  }
   for (;;) {
     // make sure we have data to read
     queue_.synchronized_await(queue_mtx_, queue_cv_);
@@ -398,9 +518,112 @@ void logger::run() {
 #endif
 }
 
+void logger::drain_rings() {
+  struct pending_record {
+    int64_t tstamp;
+    uint32_t thread_idx;
+    std::thread::id tid;
+    std::vector<char> buf;
+  };
+  std::vector<pending_record> xs;
+  { // lifetime scope of guard
+    std::lock_guard<std::mutex> guard{rings_mtx_};
+    for (size_t i = 0; i < rings_.size(); ++i) {
+      auto& ring = rings_[i];
+      if (!ring)
+        continue;
+      // read the flag before draining, since the producer may still push
+      // records until it retires the ring
+      auto retired = ring->retired();
+      auto idx = static_cast<uint32_t>(i);
+      auto tid = ring->tid();
+      ring->drain([&](const char* buf, size_t size) {
+        detail::log_record_header hdr;
+        detail::read_log_record_header(buf, size, hdr);
+        xs.push_back(pending_record{hdr.tstamp, idx, tid,
+                                    std::vector<char>(buf, buf + size)});
+      });
+      // release the memory of terminated threads; keep the slot to preserve
+      // the thread index of all other rings
+      if (retired)
+        ring.reset();
+    }
+  }
+  // restore the global order of events across threads, e.g., to make sure a
+  // SEND event always precedes its RECEIVE event
+  std::stable_sort(xs.begin(), xs.end(),
+                   [](const pending_record& x, const pending_record& y) {
+                     return x.tstamp < y.tstamp;
+                   });
+  for (auto& x : xs)
+    handle_record(x.thread_idx, x.tid, x.buf.data(), x.buf.size());
+}
+
+void logger::handle_record(uint32_t thread_idx, std::thread::id tid,
+                           const char* buf, size_t size) {
+  // format deferred arguments once for both file and console output
+  if (!detail::resolve_log_args(buf, size, resolved_))
+    return;
+  buf = resolved_.data();
+  size = resolved_.size();
+  detail::log_record_header hdr;
+  detail::read_log_record_header(buf, size, hdr);
+  auto site = reinterpret_cast<const detail::log_site*>(hdr.site);
+  if (file_) {
+    if (sites_written_.insert(hdr.site).second)
+      detail::write_binary_log_site(file_, hdr.site, *site);
+    // thread indexes get reused after a thread terminates
+    if (threads_written_.size() <= thread_idx)
+      threads_written_.resize(thread_idx + 1);
+    if (threads_written_[thread_idx] != tid) {
+      std::ostringstream oss;
+      oss << tid;
+      detail::write_binary_log_thread(file_, thread_idx, oss.str());
+      threads_written_[thread_idx] = tid;
+    }
+    detail::write_binary_log_record(file_, thread_idx, buf, size);
+  }
+  auto console = system_.config().logger_console;
+  if (console == atom("UNCOLORED") || console == atom("COLORED")) {
+    event x{nullptr,
+            nullptr,
+            site->level,
+            site->category_name,
+            site->pretty_fun,
+            site->file_name,
+            site->line_number,
+            std::string{},
+            tid,
+            static_cast<actor_id>(hdr.aid),
+            timestamp{timestamp::duration{hdr.tstamp}}};
+    detail::render_log_args(buf, size, x.message);
+    render_console(x);
+  }
+}
+
 void logger::handle_event(event& x) {
-  if (file_)
-    render(file_, file_format_, x);
+  if (file_) {
+    if (binary_output_) {
+      std::ostringstream tid;
+      tid << x.tid;
+      detail::write_binary_log_entry(file_,
+                                     detail::log_entry{x.level,
+                                                       x.category_name,
+                                                       x.pretty_fun,
+                                                       x.file_name,
+                                                       x.line_number,
+                                                       x.message,
+                                                       tid.str(),
+                                                       x.aid,
+                                                       x.tstamp});
+    } else {
+      render(file_, file_format_, x);
+    }
+  }
+  render_console(x);
+}
+
+void logger::render_console(event& x) {
   if (system_.config().logger_console == atom("UNCOLORED")) {
     render(std::clog, console_format_, x);
   } else if  (system_.config().logger_console == atom("COLORED")) {
@@ -496,16 +719,23 @@ void logger::start() {
       auto nid = to_string(system_.node());
       f.replace(i, i + sizeof(node) - 1, nid);
     }
-    file_.open(f, std::ios::out | std::ios::app);
+    if (binary_output_)
+      file_.open(f, std::ios::out | std::ios::trunc | std::ios::binary);
+    else
+      file_.open(f, std::ios::out | std::ios::app);
     if (!file_) {
       std::cerr << "unable to open log file " << f << std::endl;
       return;
     }
+    if (binary_output_)
+      detail::write_binary_log_header(file_, t0_);
   }
-  if (inline_output_)
+  if (inline_output_) {
     log_first_line();
-  else
+  } else {
+    rings_active_ = binary_output_;
     thread_ = std::thread{[this] { this->run(); }};
+  }
 #endif
 }
 
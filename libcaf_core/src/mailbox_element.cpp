@@ -58,7 +58,8 @@ private:
 mailbox_element::mailbox_element()
     : next(nullptr),
       prev(nullptr),
-      marked(false) {
+      marked(false),
+      trace{0, 0, 0} {
   // nop
 }
 
@@ -69,7 +70,8 @@ mailbox_element::mailbox_element(strong_actor_ptr&& x, message_id y,
       marked(false),
       sender(std::move(x)),
       mid(y),
-      stages(std::move(z)) {
+      stages(std::move(z)),
+      trace(detail::propagated_trace_context()) {
   // nop
 }
 
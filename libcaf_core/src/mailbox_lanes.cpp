@@ -0,0 +1,147 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/mailbox_lanes.hpp"
+
+#include "caf/type_nr.hpp"
+#include "caf/stream_msg.hpp"
+#include "caf/system_messages.hpp"
+
+namespace caf {
+namespace detail {
+
+namespace {
+
+constexpr uint32_t bit(size_t x) {
+  return 1u << x;
+}
+
+// maps a bitmask of non-empty lanes to its highest-priority lane
+constexpr mailbox_lanes::lane_id first_lane[] = {
+  mailbox_lanes::num_lanes,   // 000
+  mailbox_lanes::urgent_lane, // 001
+  mailbox_lanes::system_lane, // 010
+  mailbox_lanes::urgent_lane, // 011
+  mailbox_lanes::normal_lane, // 100
+  mailbox_lanes::urgent_lane, // 101
+  mailbox_lanes::system_lane, // 110
+  mailbox_lanes::urgent_lane  // 111
+};
+
+static_assert(sizeof(first_lane) / sizeof(first_lane[0])
+              == bit(mailbox_lanes::num_lanes),
+              "first_lane must cover all combinations of lanes");
+
+} // namespace <anonymous>
+
+mailbox_lanes::mailbox_lanes(size_t fairness)
+    : mask_(0),
+      fairness_(fairness),
+      streak_(0),
+      last_bumped_(num_lanes) {
+  // nop
+}
+
+mailbox_lanes::~mailbox_lanes() {
+  auto f = [](mailbox_element&) {
+    // nop
+  };
+  clear(f);
+}
+
+mailbox_lanes::lane_id mailbox_lanes::classify(const mailbox_element& x) {
+  if (x.mid.is_high_priority())
+    return urgent_lane;
+  switch (x.content().type_token()) {
+    case make_type_token<exit_msg>():
+    case make_type_token<down_msg>():
+      return system_lane;
+    case make_type_token<stream_msg>(): {
+      // only promote messages without ordering dependency on batches, e.g., a
+      // `close` must never overtake the batches sent ahead of it
+      auto& sm = x.content().get_as<stream_msg>(0);
+      return holds_alternative<stream_msg::open>(sm.content)
+             || holds_alternative<stream_msg::ack_open>(sm.content)
+             || holds_alternative<stream_msg::ack_batch>(sm.content)
+             ? system_lane
+             : normal_lane;
+    }
+    default:
+      return normal_lane;
+  }
+}
+
+void mailbox_lanes::push(mailbox_element* x) {
+  CAF_ASSERT(x != nullptr);
+  auto& l = lanes_[classify(*x)];
+  x->next = nullptr;
+  if (l.tail != nullptr)
+    l.tail->next = x;
+  else
+    l.head = x;
+  l.tail = x;
+  ++l.size;
+  mask_ |= bit(static_cast<size_t>(&l - lanes_.data()));
+}
+
+mailbox_element* mailbox_lanes::take() {
+  auto hi = first_lane[mask_];
+  if (hi == num_lanes)
+    return nullptr;
+  auto lower = mask_ & ~bit(hi);
+  if (lower == 0) {
+    streak_ = 0;
+    return take(hi);
+  }
+  if (fairness_ == 0 || streak_ < fairness_) {
+    ++streak_;
+    return take(hi);
+  }
+  // serve the waiting lower lanes in turns
+  streak_ = 0;
+  auto after_last = last_bumped_ < num_lanes
+                    ? lower & ~(bit(last_bumped_ + 1) - 1)
+                    : lower;
+  last_bumped_ = first_lane[after_last != 0 ? after_last : lower];
+  return take(last_bumped_);
+}
+
+size_t mailbox_lanes::size() const {
+  size_t result = 0;
+  for (auto& x : lanes_)
+    result += x.size;
+  return result;
+}
+
+mailbox_element* mailbox_lanes::take(lane_id x) {
+  auto& l = lanes_[x];
+  CAF_ASSERT(l.head != nullptr);
+  auto result = l.head;
+  l.head = result->next;
+  if (l.head == nullptr) {
+    l.tail = nullptr;
+    mask_ &= ~bit(x);
+  }
+  --l.size;
+  result->next = nullptr;
+  return result;
+}
+
+} // namespace detail
+} // namespace caf
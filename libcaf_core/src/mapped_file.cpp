@@ -0,0 +1,128 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/mapped_file.hpp"
+
+#include <algorithm>
+
+#include "caf/sec.hpp"
+#include "caf/logger.hpp"
+
+#ifdef CAF_WINDOWS
+# include <fstream>
+# include <iterator>
+#else
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/types.h>
+#endif
+
+namespace caf {
+namespace detail {
+
+mapped_file::mapped_file() : open_(false), data_(nullptr), size_(0) {
+  // nop
+}
+
+mapped_file::~mapped_file() {
+  close();
+}
+
+#ifdef CAF_WINDOWS
+
+error mapped_file::open(const std::string& path) {
+  CAF_LOG_TRACE(CAF_ARG(path));
+  close();
+  std::ifstream in{path, std::ios::binary};
+  if (!in)
+    return make_error(sec::runtime_error, "cannot open file", path);
+  storage_.assign(std::istreambuf_iterator<char>{in},
+                  std::istreambuf_iterator<char>{});
+  data_ = storage_.data();
+  size_ = storage_.size();
+  open_ = true;
+  return none;
+}
+
+void mapped_file::release(size_t) {
+  // nop
+}
+
+void mapped_file::close() {
+  storage_.clear();
+  storage_.shrink_to_fit();
+  data_ = nullptr;
+  size_ = 0;
+  open_ = false;
+}
+
+#else // CAF_WINDOWS
+
+error mapped_file::open(const std::string& path) {
+  CAF_LOG_TRACE(CAF_ARG(path));
+  close();
+  auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return make_error(sec::runtime_error, "cannot open file", path);
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    return make_error(sec::runtime_error, "cannot stat file", path);
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  // mmap rejects empty mappings
+  if (size_ > 0) {
+    auto ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED) {
+      ::close(fd);
+      size_ = 0;
+      return make_error(sec::runtime_error, "cannot map file", path);
+    }
+    data_ = reinterpret_cast<const char*>(ptr);
+    madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+  }
+  // the mapping stays valid after closing the file descriptor
+  ::close(fd);
+  open_ = true;
+  return none;
+}
+
+void mapped_file::release(size_t num_bytes) {
+  // round down to page boundaries
+  auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  auto n = std::min(num_bytes, size_) / page_size * page_size;
+  if (n > 0)
+    madvise(const_cast<char*>(data_), n, MADV_DONTNEED);
+}
+
+void mapped_file::close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+  }
+  size_ = 0;
+  open_ = false;
+}
+
+#endif // CAF_WINDOWS
+
+} // namespace detail
+} // namespace caf
@@ -0,0 +1,89 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/metrics/histogram.hpp"
+
+#include <limits>
+#include <thread>
+#include <functional>
+
+namespace caf {
+namespace metrics {
+
+size_t next_shard() {
+  static std::atomic<size_t> next{0};
+  return next.fetch_add(1, std::memory_order_relaxed) & (num_shards - 1);
+}
+
+#ifdef CAF_NO_THREAD_LOCAL
+size_t this_shard() {
+  std::hash<std::thread::id> f;
+  return f(std::this_thread::get_id()) & (num_shards - 1);
+}
+#endif // CAF_NO_THREAD_LOCAL
+
+constexpr size_t histogram::sub_bucket_bits;
+
+constexpr size_t histogram::sub_buckets;
+
+constexpr size_t histogram::num_buckets;
+
+histogram::shard::shard() : sum(0) {
+  for (auto& x : buckets)
+    x.store(0, std::memory_order_relaxed);
+}
+
+histogram::histogram() : shards_(new shard[num_shards]) {
+  // nop
+}
+
+histogram::~histogram() {
+  delete[] shards_;
+}
+
+uint64_t histogram::upper_bound(size_t index) {
+  if (index < sub_buckets)
+    return index;
+  if (index >= num_buckets - 1)
+    return std::numeric_limits<uint64_t>::max();
+  auto msb = index / sub_buckets + sub_bucket_bits - 1;
+  auto sub = static_cast<uint64_t>(index % sub_buckets);
+  auto width = uint64_t{1} << (msb - sub_bucket_bits);
+  return ((sub_buckets + sub) << (msb - sub_bucket_bits)) + width - 1;
+}
+
+histogram::data histogram::collect() const {
+  data result;
+  result.buckets.resize(num_buckets);
+  result.count = 0;
+  result.sum = 0;
+  for (size_t i = 0; i < num_shards; ++i) {
+    auto& s = shards_[i];
+    for (size_t j = 0; j < num_buckets; ++j) {
+      auto n = s.buckets[j].load(std::memory_order_relaxed);
+      result.buckets[j] += n;
+      result.count += n;
+    }
+    result.sum += s.sum.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+} // namespace metrics
+} // namespace caf
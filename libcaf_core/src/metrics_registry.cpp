@@ -0,0 +1,222 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/metrics/registry.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+#include "caf/actor_system_config.hpp"
+#include "caf/string_algorithms.hpp"
+
+namespace caf {
+namespace metrics {
+
+std::string to_string(metric_type x) {
+  switch (x) {
+    case metric_type::counter:
+      return "counter";
+    case metric_type::gauge:
+      return "gauge";
+    default:
+      return "histogram";
+  }
+}
+
+registry::registry() : runtime_enabled_(false) {
+  memset(&runtime_, 0, sizeof(runtime_metrics));
+}
+
+registry::~registry() {
+  // nop
+}
+
+counter& registry::get_counter(const std::string& name,
+                               const std::string& labels,
+                               const std::string& help) {
+  return *get(metric_type::counter, name, labels, help).ctr;
+}
+
+gauge& registry::get_gauge(const std::string& name, const std::string& labels,
+                           const std::string& help) {
+  return *get(metric_type::gauge, name, labels, help).gge;
+}
+
+histogram& registry::get_histogram(const std::string& name,
+                                   const std::string& labels,
+                                   const std::string& help) {
+  return *get(metric_type::histogram, name, labels, help).hst;
+}
+
+void registry::add_callback(const std::string& name, const std::string& labels,
+                            const std::string& help, callback f) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  auto& e = entries_[key_type{name, labels}];
+  e.type = metric_type::gauge;
+  e.help = help;
+  e.fun = std::move(f);
+}
+
+void registry::remove_callback(const std::string& name,
+                               const std::string& labels) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  auto i = entries_.find(key_type{name, labels});
+  if (i != entries_.end() && i->second.fun)
+    entries_.erase(i);
+}
+
+histogram* registry::mailbox_latency(const char* name) {
+  auto& xs = mailbox_latency_actors_;
+  if (xs.empty())
+    return nullptr;
+  auto matches = [&](const std::string& x) {
+    return x == "*" || x == name;
+  };
+  if (std::none_of(xs.begin(), xs.end(), matches))
+    return nullptr;
+  std::string labels = "actor=\"";
+  labels += name;
+  labels += '"';
+  return &get_histogram("caf_actor_mailbox_latency_ns", labels,
+                        "Nanoseconds messages spend in a mailbox.");
+}
+
+histogram* registry::processing_time(const char* name) {
+  if (!runtime_enabled_)
+    return nullptr;
+  std::string labels = "actor=\"";
+  labels += name;
+  labels += '"';
+  return &get_histogram("caf_actor_processing_time_ns", labels,
+                        "Nanoseconds spent per resume of a scheduled actor.");
+}
+
+std::vector<snapshot> registry::collect() const {
+  std::vector<snapshot> result;
+  std::unique_lock<std::mutex> guard{mtx_};
+  result.reserve(entries_.size());
+  for (auto& kvp : entries_) {
+    auto& e = kvp.second;
+    snapshot x;
+    x.name = kvp.first.first;
+    x.labels = kvp.first.second;
+    x.help = e.help;
+    x.type = e.type;
+    x.value = 0;
+    x.sum = 0;
+    if (e.fun) {
+      x.value = e.fun();
+    } else {
+      switch (e.type) {
+        case metric_type::counter:
+          x.value = static_cast<int64_t>(e.ctr->value());
+          break;
+        case metric_type::gauge:
+          x.value = e.gge->value();
+          break;
+        case metric_type::histogram: {
+          auto d = e.hst->collect();
+          x.value = static_cast<int64_t>(d.count);
+          x.sum = d.sum;
+          x.buckets = std::move(d.buckets);
+        }
+      }
+    }
+    result.emplace_back(std::move(x));
+  }
+  return result;
+}
+
+void registry::init(actor_system_config& cfg) {
+  split(mailbox_latency_actors_, cfg.metrics_mailbox_latency_actors,
+        is_any_of(" ,"), token_compress_on);
+  if (!cfg.metrics_enable_runtime)
+    return;
+  runtime_.messages_enqueued =
+    &get_counter("caf_mailbox_enqueued_total", "",
+                 "Messages enqueued to mailboxes of scheduled actors.");
+  runtime_.messages_processed =
+    &get_counter("caf_actor_messages_processed_total", "",
+                 "Messages processed by scheduled actors.");
+  runtime_.resume_budget_exhausted =
+    &get_counter("caf_actor_resume_budget_exhausted_total", "",
+                 "Resumes that ended because the actor exhausted its time "
+                 "budget.");
+  runtime_.mailbox_size =
+    &get_histogram("caf_actor_mailbox_size", "",
+                   "Mailbox size of scheduled actors when resuming them.");
+  runtime_.queued_jobs =
+    &get_gauge("caf_scheduler_queued_jobs", "",
+               "Jobs in the queues of the scheduler.");
+  runtime_.steal_attempts =
+    &get_counter("caf_scheduler_steal_attempts_total", "",
+                 "Attempts of workers to steal jobs from other workers.");
+  runtime_.steals =
+    &get_counter("caf_scheduler_steals_total", "",
+                 "Jobs stolen from other workers.");
+  runtime_.detached_threads_started =
+    &get_counter("caf_detached_threads_started_total", "",
+                 "Threads started by the pool for detached actors.");
+  runtime_.detached_threads_stopped =
+    &get_counter("caf_detached_threads_stopped_total", "",
+                 "Threads stopped by the pool for detached actors.");
+  runtime_.detached_queue_wait =
+    &get_histogram("caf_detached_queue_wait_ns", "",
+                   "Nanoseconds detached actors waited for a thread.");
+  runtime_.proxies =
+    &get_gauge("caf_proxies", "", "Proxies for remote actors.");
+  runtime_.stream_batches =
+    &get_counter("caf_stream_batches_total", "",
+                 "Batches emitted on outbound stream paths.");
+  runtime_.stream_elements =
+    &get_counter("caf_stream_elements_total", "",
+                 "Elements emitted on outbound stream paths.");
+  runtime_enabled_ = true;
+}
+
+registry::entry& registry::get(metric_type type, const std::string& name,
+                               const std::string& labels,
+                               const std::string& help) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  auto i = entries_.find(key_type{name, labels});
+  if (i != entries_.end()) {
+    auto& e = i->second;
+    // a type mismatch always is a programming error
+    if (e.type != type || e.fun)
+      CAF_RAISE_ERROR("metric registered with a different type");
+    return e;
+  }
+  auto& e = entries_[key_type{name, labels}];
+  e.type = type;
+  e.help = help;
+  switch (type) {
+    case metric_type::counter:
+      e.ctr.reset(new counter);
+      break;
+    case metric_type::gauge:
+      e.gge.reset(new gauge);
+      break;
+    case metric_type::histogram:
+      e.hst.reset(new histogram);
+  }
+  return e;
+}
+
+} // namespace metrics
+} // namespace caf
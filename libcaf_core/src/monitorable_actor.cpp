@@ -56,7 +56,7 @@ void monitorable_actor::attach(attachable_ptr ptr) {
 
 size_t monitorable_actor::detach(const attachable::token& what) {
   CAF_LOG_TRACE("");
-  std::unique_lock<std::mutex> guard{mtx_};
+  std::unique_lock<detail::shared_spinlock> guard{mtx_};
   return detach_impl(what, attachables_head_);
 }
 
@@ -23,6 +23,7 @@
 #include "caf/logger.hpp"
 #include "caf/no_stages.hpp"
 #include "caf/local_actor.hpp"
+#include "caf/actor_system.hpp"
 
 namespace caf {
 
@@ -78,6 +79,11 @@ void outbound_path::emit_open(strong_actor_ptr origin,
 void outbound_path::emit_batch(long xs_size, message xs) {
   CAF_LOG_TRACE(CAF_ARG(xs_size) << CAF_ARG(xs));
   open_credit -= xs_size;
+  auto rt = self->system().metrics().runtime();
+  if (rt != nullptr) {
+    rt->stream_batches->inc();
+    rt->stream_elements->inc(static_cast<uint64_t>(xs_size));
+  }
   auto bid = next_batch_id++;
   stream_msg::batch batch{static_cast<int32_t>(xs_size), std::move(xs), bid};
   if (redeployable)
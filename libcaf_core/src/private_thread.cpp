@@ -26,6 +26,7 @@ namespace detail {
 
 private_thread::private_thread(scheduled_actor* self)
     : self_destroyed_(false),
+      job_done_(false),
       self_(self),
       state_(active),
       system_(self->system()) {
@@ -87,28 +88,38 @@ void private_thread::shutdown() {
 void private_thread::exec(private_thread* this_ptr) {
   this_ptr->run();
   // make sure to not destroy the private thread object before the
-  // detached actor is destroyed and this object is unreachable
-  this_ptr->await_self_destroyed();
-  // signalize destruction of detached thread to registry
-  this_ptr->system_.dec_detached_threads();
-  // done
-  delete this_ptr;
+  // detached actor is destroyed and this object is unreachable, but
+  // return the pooled thread immediately instead of blocking it
+  bool self_destroyed;
+  { // lifetime scope of guard
+    std::unique_lock<std::mutex> guard(this_ptr->mtx_);
+    this_ptr->job_done_ = true;
+    self_destroyed = this_ptr->self_destroyed_;
+  }
+  if (self_destroyed)
+    this_ptr->finalize();
 }
 
 void private_thread::notify_self_destroyed() {
-  std::unique_lock<std::mutex> guard(mtx_);
-  self_destroyed_ = true;
-  cv_.notify_one();
+  bool job_done;
+  { // lifetime scope of guard
+    std::unique_lock<std::mutex> guard(mtx_);
+    self_destroyed_ = true;
+    job_done = job_done_;
+  }
+  if (job_done)
+    finalize();
 }
 
-void private_thread::await_self_destroyed() {
-  std::unique_lock<std::mutex> guard(mtx_);
-  while (!self_destroyed_)
-    cv_.wait(guard);
+void private_thread::start() {
+  system_.private_threads().run([=] { exec(this); });
 }
 
-void private_thread::start() {
-  std::thread{exec, this}.detach();
+void private_thread::finalize() {
+  auto& sys = system_;
+  delete this;
+  // signalize destruction of detached thread to registry
+  sys.dec_detached_threads();
 }
 
 } // namespace detail
@@ -0,0 +1,152 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/private_thread_pool.hpp"
+
+#include <thread>
+#include <algorithm>
+
+#include "caf/logger.hpp"
+#include "caf/actor_system.hpp"
+#include "caf/actor_system_config.hpp"
+
+#include "caf/metrics/registry.hpp"
+
+namespace caf {
+namespace detail {
+
+private_thread_pool::private_thread_pool()
+    : min_threads_(0),
+      max_threads_(0),
+      idle_timeout_(0),
+      stopping_(false),
+      threads_(0),
+      idle_threads_(0),
+      threads_started_(0),
+      threads_stopped_(0),
+      jobs_(0),
+      total_wait_ns_(0),
+      max_wait_ns_(0),
+      rt_(nullptr) {
+  // nop
+}
+
+private_thread_pool::~private_thread_pool() {
+  stop();
+}
+
+void private_thread_pool::run(job f) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  CAF_ASSERT(!stopping_);
+  ++jobs_;
+  queue_.push_back(queued_job{std::move(f), clock_type::now()});
+  // idle threads only leave the idle state by taking a job or by stopping
+  // while the queue is empty, i.e., each queued job has an idle thread
+  // as long as the queue is not longer than the number of idle threads
+  if (queue_.size() <= idle_threads_)
+    jobs_cv_.notify_one();
+  else if (max_threads_ == 0 || threads_ < max_threads_)
+    launch_thread();
+}
+
+private_thread_pool::stats private_thread_pool::collect_stats() const {
+  std::unique_lock<std::mutex> guard{mtx_};
+  return {threads_started_, threads_stopped_, threads_, idle_threads_,
+          jobs_, queue_.size(), total_wait_ns_, max_wait_ns_};
+}
+
+void private_thread_pool::init(actor_system& sys) {
+  auto& cfg = sys.config();
+  std::unique_lock<std::mutex> guard{mtx_};
+  min_threads_ = cfg.scheduler_detached_min_threads;
+  max_threads_ = cfg.scheduler_detached_max_threads;
+  if (max_threads_ != 0)
+    min_threads_ = std::min(min_threads_, max_threads_);
+  idle_timeout_ =
+    std::chrono::milliseconds(cfg.scheduler_detached_idle_timeout);
+  rt_ = sys.metrics().runtime();
+  while (threads_ < min_threads_)
+    launch_thread();
+}
+
+void private_thread_pool::stop() {
+  std::unique_lock<std::mutex> guard{mtx_};
+  stopping_ = true;
+  jobs_cv_.notify_all();
+  while (threads_ > 0)
+    stopped_cv_.wait(guard);
+}
+
+void private_thread_pool::launch_thread() {
+  // new threads count as idle until they take their first job
+  ++threads_;
+  ++idle_threads_;
+  ++threads_started_;
+  if (rt_ != nullptr)
+    rt_->detached_threads_started->inc();
+  std::thread{[this] { worker_loop(); }}.detach();
+}
+
+bool private_thread_pool::await_job(std::unique_lock<std::mutex>& guard) {
+  while (queue_.empty()) {
+    if (stopping_)
+      return false;
+    auto timed_out = false;
+    if (threads_ > min_threads_)
+      timed_out = jobs_cv_.wait_for(guard, idle_timeout_)
+                  == std::cv_status::timeout;
+    else
+      jobs_cv_.wait(guard);
+    if (timed_out && queue_.empty() && threads_ > min_threads_)
+      return false;
+  }
+  return true;
+}
+
+void private_thread_pool::worker_loop() {
+  std::unique_lock<std::mutex> guard{mtx_};
+  while (await_job(guard)) {
+    auto x = std::move(queue_.front());
+    queue_.pop_front();
+    --idle_threads_;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      clock_type::now() - x.enqueued);
+    auto wait_ns = static_cast<uint64_t>(ns.count());
+    total_wait_ns_ += wait_ns;
+    max_wait_ns_ = std::max(max_wait_ns_, wait_ns);
+    if (rt_ != nullptr)
+      rt_->detached_queue_wait->observe(wait_ns);
+    guard.unlock();
+    x.f();
+    // destroy captured state, e.g., the last reference to an actor, before
+    // locking the pool again
+    x.f = nullptr;
+    guard.lock();
+    ++idle_threads_;
+  }
+  --threads_;
+  --idle_threads_;
+  ++threads_stopped_;
+  if (rt_ != nullptr)
+    rt_->detached_threads_stopped->inc();
+  stopped_cv_.notify_all();
+}
+
+} // namespace detail
+} // namespace caf
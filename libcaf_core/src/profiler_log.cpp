@@ -0,0 +1,96 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/profiler_log.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <istream>
+
+namespace caf {
+namespace detail {
+
+namespace {
+
+constexpr char profiler_log_magic[8] = {'C', 'A', 'F', 'P', 'R', 'O', 'F', 1};
+
+} // namespace <anonymous>
+
+void init_profiler_log_header(profiler_log_header& x) {
+  memset(&x, 0, sizeof(profiler_log_header));
+  memcpy(x.magic, profiler_log_magic, sizeof(profiler_log_magic));
+  x.event_size = static_cast<uint32_t>(sizeof(profiler_event));
+}
+
+bool valid_profiler_log_header(const profiler_log_header& x) {
+  return memcmp(x.magic, profiler_log_magic, sizeof(profiler_log_magic)) == 0
+         && x.event_size == sizeof(profiler_event);
+}
+
+bool read_profiler_log(std::istream& in, profiler_log_header& hdr,
+                       std::vector<profiler_event>& out) {
+  if (!in.read(reinterpret_cast<char*>(&hdr), sizeof(hdr))
+      || !valid_profiler_log_header(hdr))
+    return false;
+  profiler_event x;
+  while (in.read(reinterpret_cast<char*>(&x), sizeof(x)))
+    out.push_back(x);
+  // a truncated trailing event is not an error, since the writer may have
+  // been killed while flushing
+  return true;
+}
+
+profiler_ring::profiler_ring(size_t min_capacity)
+    : wr_pos_(0),
+      dropped_(0),
+      rd_pos_(0) {
+  size_t cap = 1;
+  while (cap < min_capacity)
+    cap <<= 1;
+  mask_ = cap - 1;
+  buf_.reset(new profiler_event[cap]);
+}
+
+size_t profiler_ring::drain(std::FILE* f) {
+  auto rd = rd_pos_.load(std::memory_order_relaxed);
+  auto wr = wr_pos_.load(std::memory_order_acquire);
+  auto n = wr - rd;
+  // write in at most two chunks, since the range may wrap around
+  auto first = rd & mask_;
+  auto chunk = std::min(n, capacity() - first);
+  if (f != nullptr) {
+    fwrite(buf_.get() + first, sizeof(profiler_event), chunk, f);
+    if (chunk < n)
+      fwrite(buf_.get(), sizeof(profiler_event), n - chunk, f);
+  }
+  rd_pos_.store(wr, std::memory_order_release);
+  return n;
+}
+
+size_t profiler_ring::drain(std::vector<profiler_event>& out) {
+  auto rd = rd_pos_.load(std::memory_order_relaxed);
+  auto wr = wr_pos_.load(std::memory_order_acquire);
+  for (auto i = rd; i != wr; ++i)
+    out.push_back(buf_[i & mask_]);
+  rd_pos_.store(wr, std::memory_order_release);
+  return wr - rd;
+}
+
+} // namespace detail
+} // namespace caf
@@ -62,8 +62,12 @@ strong_actor_ptr proxy_registry::get(const node_id& node, actor_id aid) {
 strong_actor_ptr proxy_registry::get_or_put(const node_id& nid, actor_id aid) {
   CAF_LOG_TRACE(CAF_ARG(nid) << CAF_ARG(aid));
   auto& result = proxies_[nid][aid];
-  if (!result)
+  if (!result) {
     result = backend_.make_proxy(nid, aid);
+    auto rt = system_.metrics().runtime();
+    if (result && rt != nullptr)
+      rt->proxies->inc();
+  }
   return result;
 }
 
@@ -115,6 +119,9 @@ void proxy_registry::clear() {
 void proxy_registry::kill_proxy(strong_actor_ptr& ptr, error rsn) {
   if (!ptr)
     return;
+  auto rt = system_.metrics().runtime();
+  if (rt != nullptr)
+    rt->proxies->dec();
   auto pptr = static_cast<actor_proxy*>(actor_cast<abstract_actor*>(ptr));
   pptr->kill_proxy(backend_.registry_context(), std::move(rsn));
 }
@@ -49,9 +49,12 @@ invoke_message_result raw_event_based_actor::consume(mailbox_element& x) {
   }
   // handle multiplexed responses
   if (x.mid.is_response()) {
-    auto mrh = multiplexed_responses_.find(x.mid);
     // neither awaited nor multiplexed, probably an expired timeout
-    if (mrh == multiplexed_responses_.end())
+    if (ext_ == nullptr)
+      return im_dropped;
+    auto& responses = ext_->multiplexed_responses;
+    auto mrh = responses.find(x.mid);
+    if (mrh == responses.end())
       return im_dropped;
     if (!mrh->second(x.content())) {
       // try again with error if first attempt failed
@@ -59,7 +62,7 @@ invoke_message_result raw_event_based_actor::consume(mailbox_element& x) {
                                          x.move_content_to_message()));
       mrh->second(msg);
     }
-    multiplexed_responses_.erase(mrh);
+    responses.erase(mrh);
     return im_success;
   }
   auto& content = x.content();
@@ -90,7 +93,8 @@ invoke_message_result raw_event_based_actor::consume(mailbox_element& x) {
       setf(has_timeout_flag);
   });
   auto call_default_handler = [&] {
-    auto sres = call_handler(default_handler_, this, x);
+    auto sres = call_handler(&extended_state::default_hdl, print_and_drop,
+                             this, x);
     switch (sres.flag) {
       default:
         break;
@@ -27,7 +27,9 @@
 
 namespace caf {
 
-response_promise::response_promise() : self_(nullptr) {
+response_promise::response_promise()
+    : self_(nullptr),
+      trace_{0, 0, 0} {
   // nop
 }
 
@@ -37,7 +39,8 @@ response_promise::response_promise(none_t) : response_promise() {
 
 response_promise::response_promise(strong_actor_ptr self, mailbox_element& src)
     : self_(std::move(self)),
-      id_(src.mid) {
+      id_(src.mid),
+      trace_(detail::propagated_trace_context()) {
   // form an invalid request promise when initialized from a
   // response ID, since CAF always drops messages in this case
   if (!src.mid.is_response()) {
@@ -64,6 +67,9 @@ execution_unit* response_promise::context() {
 }
 
 response_promise response_promise::deliver_impl(message msg) {
+  // responses belong to the span that created this promise, even if delivered
+  // later from another message handler
+  detail::trace_scope scope{&trace_};
   if (!stages_.empty()) {
     auto next = std::move(stages_.back());
     stages_.pop_back();
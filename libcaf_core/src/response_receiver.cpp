@@ -0,0 +1,225 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/response_receiver.hpp"
+
+#include <thread>
+
+#ifdef CAF_LINUX
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif // CAF_LINUX
+
+#include "caf/logger.hpp"
+
+namespace caf {
+namespace detail {
+
+namespace {
+
+// tells the CPU that we are busy waiting to save power and to avoid
+// memory order violations when leaving the loop
+inline void cpu_relax() {
+#if (defined(CAF_GCC) || defined(CAF_CLANG))                                   \
+    && (defined(__i386__) || defined(__x86_64__))
+  __builtin_ia32_pause();
+#elif (defined(CAF_GCC) || defined(CAF_CLANG)) && defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+} // namespace <anonymous>
+
+constexpr size_t response_receiver::spin_iterations;
+
+response_receiver::response_receiver(actor_config& cfg)
+    : monitorable_actor(cfg),
+      state_(idle),
+      expected_(0) {
+  // nop
+}
+
+response_receiver::~response_receiver() {
+  // nop
+}
+
+void response_receiver::enqueue(mailbox_element_ptr what, execution_unit*) {
+  CAF_ASSERT(what != nullptr);
+  CAF_LOG_TRACE(CAF_ARG(*what));
+  // drop anything but the response we are waiting for
+  auto rid = what->mid.request_id().integer_value();
+  if (!what->mid.is_response() || rid != expected_.load()) {
+    CAF_LOG_DEBUG("drop unexpected message:" << CAF_ARG(what->mid));
+    return;
+  }
+  auto s = state_.load();
+  for (;;) {
+    if (s != pending && s != sleeping)
+      return;
+    if (state_.compare_exchange_weak(s, writing))
+      break;
+  }
+  // the request may have timed out and a new one may have started in
+  // between, restoring the previous state hands the slot back
+  if (rid != expected_.load()) {
+    state_.store(s);
+    return;
+  }
+  result_ = std::move(what);
+  state_.store(ready);
+  if (s == sleeping)
+    wake();
+}
+
+const char* response_receiver::name() const {
+  return "response_receiver";
+}
+
+message_id response_receiver::new_request_id(message_priority mp) {
+  CAF_ASSERT(state_.load() == idle);
+  auto result = ++last_request_id_;
+  expected_.store(result.request_id().integer_value());
+  state_.store(pending);
+  return mp == message_priority::normal ? result : result.with_high_priority();
+}
+
+mailbox_element_ptr
+response_receiver::await_response(const clock_type::time_point* deadline) {
+  // spinning only delays the sender on a single core
+  static const size_t spins = std::thread::hardware_concurrency() > 1
+                              ? spin_iterations
+                              : 0;
+  for (size_t i = 0; i < spins; ++i) {
+    if (state_.load(std::memory_order_acquire) == ready)
+      return take();
+    cpu_relax();
+  }
+  auto s = state_.load();
+  for (;;) {
+    switch (s) {
+      case ready:
+        return take();
+      case writing:
+        std::this_thread::yield();
+        s = state_.load();
+        break;
+      case pending:
+        // `sleeping` tells `enqueue` to wake us up
+        state_.compare_exchange_weak(s, sleeping);
+        break;
+      default:
+        CAF_ASSERT(s == sleeping);
+        if (deadline != nullptr && clock_type::now() >= *deadline) {
+          cancel();
+          return nullptr;
+        }
+        sleep(deadline);
+        s = state_.load();
+    }
+  }
+}
+
+void response_receiver::cancel() {
+  expected_.store(0);
+  auto s = state_.load();
+  for (;;) {
+    switch (s) {
+      case idle:
+        return;
+      case pending:
+      case sleeping:
+        if (state_.compare_exchange_weak(s, idle))
+          return;
+        break;
+      case writing:
+        std::this_thread::yield();
+        s = state_.load();
+        break;
+      default:
+        CAF_ASSERT(s == ready);
+        result_.reset();
+        state_.store(idle);
+        return;
+    }
+  }
+}
+
+mailbox_element_ptr response_receiver::take() {
+  auto result = std::move(result_);
+  expected_.store(0);
+  state_.store(idle);
+  return result;
+}
+
+#ifdef CAF_LINUX
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "std::atomic<uint32_t> cannot serve as futex word");
+
+void response_receiver::sleep(const clock_type::time_point* deadline) {
+  timespec ts;
+  timespec* tsp = nullptr;
+  if (deadline != nullptr) {
+    auto now = clock_type::now();
+    if (*deadline <= now)
+      return;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(*deadline
+                                                                   - now);
+    ts.tv_sec = static_cast<time_t>(ns.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns.count() % 1000000000);
+    tsp = &ts;
+  }
+  // returns immediately if `state_` no longer equals `sleeping`
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state_), FUTEX_WAIT_PRIVATE,
+          static_cast<uint32_t>(sleeping), tsp, nullptr, 0);
+}
+
+void response_receiver::wake() {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state_), FUTEX_WAKE_PRIVATE,
+          1, nullptr, nullptr, 0);
+}
+
+#else // CAF_LINUX
+
+void response_receiver::sleep(const clock_type::time_point* deadline) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  auto pred = [&] {
+    return state_.load() != sleeping;
+  };
+  if (deadline != nullptr)
+    cv_.wait_until(guard, *deadline, pred);
+  else
+    cv_.wait(guard, pred);
+}
+
+void response_receiver::wake() {
+  // acquiring the lock prevents lost wakeups between checking the state and
+  // blocking on the condition variable in `sleep`
+  { // lifetime scope of guard
+    std::unique_lock<std::mutex> guard{mtx_};
+  }
+  cv_.notify_all();
+}
+
+#endif // CAF_LINUX
+
+} // namespace detail
+} // namespace caf
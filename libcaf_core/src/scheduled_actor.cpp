@@ -19,12 +19,17 @@
 
 #include "caf/scheduled_actor.hpp"
 
+#include <chrono>
+#include <limits>
+
 #include "caf/config.hpp"
 #include "caf/to_string.hpp"
 #include "caf/actor_ostream.hpp"
 #include "caf/stream_msg_visitor.hpp"
 
+#include "caf/detail/coarse_clock.hpp"
 #include "caf/detail/private_thread.hpp"
+#include "caf/detail/coroutine_response_slot.hpp"
 #include "caf/detail/sync_request_bouncer.hpp"
 #include "caf/detail/default_invoke_result_visitor.hpp"
 
@@ -55,6 +60,52 @@ result<message> drop(scheduled_actor*, message_view&) {
   return sec::unexpected_message;
 }
 
+namespace {
+
+// returns whether `f` is the `skip` handler, i.e., never consumes a message
+bool is_skip_handler(const scheduled_actor::default_handler& f) {
+  using fun_ptr = result<message> (*)(scheduled_actor*, message_view&);
+  static const fun_ptr skip_ptr = *skip.operator skip_t::fun()
+                                       .target<fun_ptr>();
+  auto ptr = f.target<fun_ptr>();
+  return ptr != nullptr && *ptr == skip_ptr;
+}
+
+// Records the runtime metrics for a single call to `resume` when going out of
+// scope, since `resume` has many exit points.
+class resume_metrics_recorder {
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  resume_metrics_recorder(metrics::runtime_metrics* rt,
+                          metrics::histogram* processing_time,
+                          const size_t& handled_msgs)
+      : rt_(rt),
+        processing_time_(processing_time),
+        handled_msgs_(handled_msgs) {
+    if (rt_ != nullptr)
+      start_ = clock_type::now();
+  }
+
+  ~resume_metrics_recorder() {
+    if (rt_ == nullptr)
+      return;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      clock_type::now() - start_);
+    processing_time_->observe(static_cast<uint64_t>(ns.count()));
+    if (handled_msgs_ > 0)
+      rt_->messages_processed->inc(handled_msgs_);
+  }
+
+private:
+  metrics::runtime_metrics* rt_;
+  metrics::histogram* processing_time_;
+  const size_t& handled_msgs_;
+  clock_type::time_point start_;
+};
+
+} // namespace <anonymous>
+
 // -- static helper functions --------------------------------------------------
 
 void scheduled_actor::default_error_handler(scheduled_actor* ptr, error& x) {
@@ -98,14 +149,10 @@ error scheduled_actor::default_exception_handler(pointer ptr,
 scheduled_actor::scheduled_actor(actor_config& cfg)
     : local_actor(cfg),
       timeout_id_(0),
-      default_handler_(print_and_drop),
-      error_handler_(default_error_handler),
-      down_handler_(default_down_handler),
-      exit_handler_(default_exit_handler),
       private_thread_(nullptr)
-# ifndef CAF_NO_EXCEPTIONS
-      , exception_handler_(default_exception_handler)
-# endif // CAF_NO_EXCEPTIONS
+# ifdef CAF_ENABLE_MAILBOX_LATENCY
+      , mailbox_latency_(nullptr)
+# endif // CAF_ENABLE_MAILBOX_LATENCY
       {
   // nop
 }
@@ -126,20 +173,17 @@ void scheduled_actor::enqueue(mailbox_element_ptr ptr, execution_unit* eu) {
   CAF_LOG_SEND_EVENT(ptr);
   auto mid = ptr->mid;
   auto sender = ptr->sender;
+  auto rt = home_system().metrics().runtime();
+  if (rt != nullptr)
+    rt->messages_enqueued->inc();
+# ifdef CAF_ENABLE_MAILBOX_LATENCY
+  if (mailbox_latency_ != nullptr)
+    ptr->enqueue_time = std::chrono::steady_clock::now();
+# endif // CAF_ENABLE_MAILBOX_LATENCY
   switch (mailbox().enqueue(ptr.release())) {
     case detail::enqueue_result::unblocked_reader: {
       CAF_LOG_ACCEPT_EVENT(true);
-      // add a reference count to this actor and re-schedule it
-      intrusive_ptr_add_ref(ctrl());
-      if (getf(is_detached_flag)) {
-        CAF_ASSERT(private_thread_ != nullptr);
-        private_thread_->resume();
-      } else {
-        if (eu != nullptr)
-          eu->exec_later(this);
-        else
-          home_system().scheduler().enqueue(this);
-      }
+      schedule_unblocked(eu);
       break;
     }
     case detail::enqueue_result::queue_closed: {
@@ -157,6 +201,56 @@ void scheduled_actor::enqueue(mailbox_element_ptr ptr, execution_unit* eu) {
   }
 }
 
+void scheduled_actor::enqueue_batch(std::vector<mailbox_element_ptr> xs,
+                                    execution_unit* eu) {
+  CAF_ASSERT(!getf(is_blocking_flag));
+  CAF_LOG_TRACE(CAF_ARG2("size", xs.size()));
+  if (xs.empty())
+    return;
+  auto rt = home_system().metrics().runtime();
+  if (rt != nullptr)
+    rt->messages_enqueued->inc(xs.size());
+# ifdef CAF_ENABLE_MAILBOX_LATENCY
+  auto t0 = mailbox_latency_ != nullptr ? std::chrono::steady_clock::now()
+                                        : std::chrono::steady_clock::time_point{};
+# endif // CAF_ENABLE_MAILBOX_LATENCY
+  // link all elements in order before publishing them with a single CAS
+  mailbox_element* first = nullptr;
+  mailbox_element* last = nullptr;
+  for (auto& x : xs) {
+    CAF_ASSERT(x != nullptr);
+    CAF_LOG_SEND_EVENT(x);
+#   ifdef CAF_ENABLE_MAILBOX_LATENCY
+    x->enqueue_time = t0;
+#   endif // CAF_ENABLE_MAILBOX_LATENCY
+    auto ptr = x.release();
+    ptr->next = nullptr;
+    if (last != nullptr)
+      last->next = ptr;
+    else
+      first = ptr;
+    last = ptr;
+  }
+  auto bounce = [&](mailbox_element& x) {
+    if (x.mid.is_request()) {
+      detail::sync_request_bouncer f{exit_reason()};
+      f(x.sender, x.mid);
+    }
+  };
+  switch (mailbox().enqueue_list(first, bounce)) {
+    case detail::enqueue_result::unblocked_reader:
+      CAF_LOG_ACCEPT_EVENT(true);
+      schedule_unblocked(eu);
+      break;
+    case detail::enqueue_result::queue_closed:
+      CAF_LOG_REJECT_EVENT();
+      break;
+    case detail::enqueue_result::success:
+      CAF_LOG_ACCEPT_EVENT(false);
+      break;
+  }
+}
+
 // -- overridden functions of local_actor --------------------------------------
 
 const char* scheduled_actor::name() const {
@@ -166,6 +260,9 @@ const char* scheduled_actor::name() const {
 void scheduled_actor::launch(execution_unit* eu, bool lazy, bool hide) {
   CAF_LOG_TRACE(CAF_ARG(lazy) << CAF_ARG(hide));
   CAF_ASSERT(!getf(is_blocking_flag));
+# ifdef CAF_ENABLE_MAILBOX_LATENCY
+  mailbox_latency_ = home_system().metrics().mailbox_latency(name());
+# endif // CAF_ENABLE_MAILBOX_LATENCY
   if (!hide)
     register_at_system();
   if (getf(is_detached_flag)) {
@@ -192,14 +289,23 @@ bool scheduled_actor::cleanup(error&& fail_state, execution_unit* host) {
   }
   // Clear all state.
   awaited_responses_.clear();
-  multiplexed_responses_.clear();
-  if (fail_state != none)
-    for (auto& kvp : streams_)
-      kvp.second->abort(fail_state);
-  else
-    for (auto& kvp : streams_)
-      kvp.second->close();
-  streams_.clear();
+  if (ext_ != nullptr) {
+    ext_->multiplexed_responses.clear();
+    // destroying a coroutine may not touch the list while we iterate it
+    auto suspended = std::move(ext_->coroutine_responses);
+    ext_->coroutine_responses.clear();
+    for (auto& kvp : suspended)
+      kvp.second->discard();
+    ext_->stash_index.clear();
+    ext_->stashed_responses = 0;
+    if (fail_state != none)
+      for (auto& kvp : ext_->streams)
+        kvp.second->abort(fail_state);
+    else
+      for (auto& kvp : ext_->streams)
+        kvp.second->close();
+    ext_->streams.clear();
+  }
   // Dispatch to parent's `cleanup` function.
   return local_actor::cleanup(std::move(fail_state), host);
 }
@@ -221,15 +327,46 @@ void scheduled_actor::intrusive_ptr_release_impl() {
 resumable::resume_result
 scheduled_actor::resume(execution_unit* ctx, size_t max_throughput) {
   CAF_PUSH_AID(id());
+  detail::coroutine_owner_scope owner_scope{this};
   if (!activate(ctx))
     return resume_result::done;
   size_t handled_msgs = 0;
+  auto rt = home_system().metrics().runtime();
+  metrics::histogram* processing_time = nullptr;
+  if (rt != nullptr) {
+    // resolve the histogram for our name only once per actor
+    auto& st = ext();
+    if (st.processing_time == nullptr)
+      st.processing_time = home_system().metrics().processing_time(name());
+    processing_time = st.processing_time;
+    // counting the mailbox is linear, hence sample only every n-th resume
+    if (st.resumes++ % metrics::mailbox_size_sample_interval == 0)
+      rt->mailbox_size->observe(
+        mailbox().count(metrics::max_sampled_mailbox_size));
+  }
+  resume_metrics_recorder recorder{rt, processing_time, handled_msgs};
   auto reset_timeout_if_needed = [&] {
     if (handled_msgs > 0 && !bhvr_stack_.empty())
       request_timeout(bhvr_stack_.back().timeout());
   };
+  // read the clock only every `budget_interval` messages
+  auto budget = resume_budget();
+  auto budget_interval = home_system().scheduler().resume_budget_interval();
+  auto next_budget_check = budget.count() > 0
+                           ? budget_interval
+                           : std::numeric_limits<size_t>::max();
+  auto t0 = budget.count() > 0 ? detail::coarse_clock::now()
+                               : detail::coarse_clock::time_point{};
   mailbox_element_ptr ptr;
   while (handled_msgs < max_throughput) {
+    if (handled_msgs >= next_budget_check) {
+      if (detail::coarse_clock::now() - t0 >= budget) {
+        if (rt != nullptr)
+          rt->resume_budget_exhausted->inc();
+        break;
+      }
+      next_budget_check = handled_msgs + budget_interval;
+    }
     do {
       ptr = next_message();
       if (!ptr) {
@@ -238,6 +375,15 @@ scheduled_actor::resume(execution_unit* ctx, size_t max_throughput) {
           return resumable::awaiting_message;
       }
     } while (!ptr);
+#   ifdef CAF_ENABLE_MAILBOX_LATENCY
+    // elements enqueued before launching the actor have no timestamp
+    if (mailbox_latency_ != nullptr
+        && ptr->enqueue_time != std::chrono::steady_clock::time_point{}) {
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - ptr->enqueue_time);
+      mailbox_latency_->observe(static_cast<uint64_t>(ns.count()));
+    }
+#   endif // CAF_ENABLE_MAILBOX_LATENCY
     switch (reactivate(*ptr)) {
       case activation_result::terminated:
         return resume_result::done;
@@ -255,7 +401,7 @@ scheduled_actor::resume(execution_unit* ctx, size_t max_throughput) {
         }
         break;
       case activation_result::skipped:
-        push_to_cache(std::move(ptr));
+        stash(std::move(ptr));
         break;
       default:
         break;
@@ -276,6 +422,12 @@ proxy_registry* scheduled_actor::proxy_registry_ptr() {
 
 // -- state modifiers ----------------------------------------------------------
 
+std::chrono::nanoseconds scheduled_actor::resume_budget() {
+  if (ext_ != nullptr && ext_->resume_budget.count() > 0)
+    return ext_->resume_budget;
+  return home_system().scheduler().resume_budget();
+}
+
 void scheduled_actor::quit(error x) {
   CAF_LOG_TRACE(CAF_ARG(x));
   fail_state_ = std::move(x);
@@ -285,7 +437,9 @@ void scheduled_actor::quit(error x) {
 // -- stream management --------------------------------------------------------
 
 void scheduled_actor::trigger_downstreams() {
-  for (auto& s : streams_)
+  if (ext_ == nullptr)
+    return;
+  for (auto& s : ext_->streams)
     s.second->push();
 }
 
@@ -331,9 +485,22 @@ void scheduled_actor::add_multiplexed_response_handler(message_id response_id,
                                                        behavior bhvr) {
   if (bhvr.timeout().valid())
     request_response_timeout(bhvr.timeout(), response_id);
-  multiplexed_responses_.emplace(response_id, std::move(bhvr));
+  ext().multiplexed_responses.emplace(response_id, std::move(bhvr));
 }
 
+void scheduled_actor::add_coroutine_response_handler(
+  message_id response_id, detail::coroutine_response_slot* ptr) {
+  ext().coroutine_responses.emplace(response_id, ptr);
+}
+
+#ifndef CAF_NO_EXCEPTIONS
+void scheduled_actor::handle_coroutine_exception(std::exception_ptr eptr) {
+  CAF_LOG_INFO("actor died because of an exception in a coroutine");
+  quit(call_handler(&extended_state::exception_hdl, default_exception_handler,
+                    this, eptr));
+}
+#endif // CAF_NO_EXCEPTIONS
+
 scheduled_actor::message_category
 scheduled_actor::categorize(mailbox_element& x) {
   auto& content = x.content();
@@ -374,18 +541,21 @@ scheduled_actor::categorize(mailbox_element& x) {
         fail_state_ = std::move(em.reason);
         setf(is_terminated_flag);
       } else {
-        call_handler(exit_handler_, this, em);
+        call_handler(&extended_state::exit_hdl, default_exit_handler, this,
+                     em);
       }
       return message_category::internal;
     }
     case make_type_token<down_msg>(): {
       auto dm = content.move_if_unshared<down_msg>(0);
-      call_handler(down_handler_, this, dm);
+      call_handler(&extended_state::down_hdl, default_down_handler, this,
+                   dm);
       return message_category::internal;
     }
     case make_type_token<error>(): {
       auto err = content.move_if_unshared<error>(0);
-      call_handler(error_handler_, this, err);
+      call_handler(&extended_state::error_hdl, default_error_handler, this,
+                   err);
       return message_category::internal;
     }
     case make_type_token<stream_msg>(): {
@@ -440,9 +610,22 @@ invoke_message_result scheduled_actor::consume(mailbox_element& x) {
   // Handle multiplexed responses.
   if (x.mid.is_response()) {
     auto invoke = select_invoke_fun();
-    auto mrh = multiplexed_responses_.find(x.mid);
     // neither awaited nor multiplexed, probably an expired timeout
-    if (mrh == multiplexed_responses_.end())
+    if (ext_ == nullptr)
+      return im_dropped;
+    // resume a suspended coroutine
+    auto& slots = ext_->coroutine_responses;
+    auto slot = slots.find(x.mid);
+    if (slot != slots.end()) {
+      auto ptr = slot->second;
+      slots.erase(slot);
+      auto msg = x.move_content_to_message();
+      ptr->resume(msg);
+      return im_success;
+    }
+    auto& responses = ext_->multiplexed_responses;
+    auto mrh = responses.find(x.mid);
+    if (mrh == responses.end())
       return im_dropped;
     if (!invoke(this, mrh->second, x)) {
       // try again with error if first attempt failed
@@ -450,7 +633,7 @@ invoke_message_result scheduled_actor::consume(mailbox_element& x) {
                                          x.move_content_to_message()));
       mrh->second(msg);
     }
-    multiplexed_responses_.erase(mrh);
+    responses.erase(mrh);
     return im_success;
   }
   // Dispatch on the content of x.
@@ -480,7 +663,8 @@ invoke_message_result scheduled_actor::consume(mailbox_element& x) {
           setf(has_timeout_flag);
       });
       auto call_default_handler = [&] {
-        auto sres = call_handler(default_handler_, this, x);
+        auto sres = call_handler(&extended_state::default_hdl, print_and_drop,
+                                 this, x);
         switch (sres.flag) {
           default:
             break;
@@ -513,36 +697,122 @@ invoke_message_result scheduled_actor::consume(mailbox_element& x) {
   CAF_CRITICAL("invalid message type");
 }
 
+invoke_message_result scheduled_actor::traced_consume(mailbox_element& x) {
+  // Unsampled messages install an empty context without root flag, i.e.,
+  // messages sent from this handler never start a new trace.
+  static const trace_context unsampled{0, 0, 0};
+  auto& tr = home_system().tracer();
+  if (!tr.enabled() || !(x.trace.sampled() || (x.trace.root() && tr.sample()))) {
+    detail::trace_scope scope{x.trace.sampled() ? &x.trace : &unsampled};
+    return consume(x);
+  }
+  // Start a new span as child of the sender's span (or as root of a new
+  // trace) and make it the parent of all messages sent from this handler.
+  auto root = x.trace.root();
+  auto parent = root ? 0 : x.trace.span_id;
+  trace_context ctx{root ? detail::tracer::make_id() : x.trace.trace_id,
+                    detail::tracer::make_id(), trace_context::sampled_flag};
+  auto now = [] {
+    using namespace std::chrono;
+    auto t = system_clock::now().time_since_epoch();
+    return static_cast<int64_t>(duration_cast<nanoseconds>(t).count());
+  };
+  auto start = now();
+  invoke_message_result result;
+  { // lifetime scope of trace_scope
+    detail::trace_scope scope{&ctx};
+    result = consume(x);
+  }
+  if (result != im_skipped)
+    tr.record(detail::span_record{ctx.trace_id, ctx.span_id,
+                                  parent, id(), name(),
+                                  start, now()});
+  return result;
+}
+
 /// Tries to consume `x`.
 void scheduled_actor::consume(mailbox_element_ptr x) {
-  switch (consume(*x)) {
+  switch (traced_consume(*x)) {
     default:
       break;
     case im_skipped:
-      push_to_cache(std::move(x));
+      stash(std::move(x));
   }
 }
 
 bool scheduled_actor::consume_from_cache() {
   CAF_LOG_TRACE("");
   auto& cache = mailbox().cache();
+  // avoids allocating the sentinels of the cache on the hot path
+  if (cache.empty() || ext_ == nullptr)
+    return false;
+  auto& st = *ext_;
+  // skip scanning the cache if no stashed type can match
+  if (st.stashed_responses == 0) {
+    auto pred = [&](const std::pair<const uint32_t, size_t>& kvp) {
+      return may_consume_stashed(kvp.first);
+    };
+    if (std::none_of(st.stash_index.begin(), st.stash_index.end(), pred))
+      return false;
+  }
+  // removes an element from the index, must be called before consuming the
+  // element since consuming may move its content
+  auto unstash = [&](bool is_response, uint32_t tt) {
+    if (is_response) {
+      --st.stashed_responses;
+      return;
+    }
+    auto j = st.stash_index.find(tt);
+    if (j != st.stash_index.end() && --j->second == 0)
+      st.stash_index.erase(j);
+  };
   auto i = cache.continuation();
   auto e = cache.end();
-  while (i != e)
-    switch (consume(*i)) {
+  while (i != e) {
+    auto is_response = i->mid.is_response();
+    auto tt = i->content().type_token();
+    if (!is_response && !may_consume_stashed(tt)) {
+      ++i;
+      continue;
+    }
+    switch (traced_consume(*i)) {
       case im_success:
+        unstash(is_response, tt);
         cache.erase(i);
         return true;
       case im_skipped:
         ++i;
         break;
       case im_dropped:
+        unstash(is_response, tt);
         i = cache.erase(i);
         break;
     }
+  }
   return false;
 }
 
+void scheduled_actor::stash(mailbox_element_ptr x) {
+  auto& st = ext();
+  if (x->mid.is_response())
+    ++st.stashed_responses;
+  else
+    ++st.stash_index[x->content().type_token()];
+  push_to_cache(std::move(x));
+}
+
+bool scheduled_actor::may_consume_stashed(uint32_t tt) {
+  // ordinary messages remain skipped while awaiting a response
+  if (!awaited_responses_.empty())
+    return false;
+  // any default handler except `skip` consumes messages the behavior
+  // cannot match
+  if (ext_ == nullptr || !ext_->default_hdl
+      || !is_skip_handler(ext_->default_hdl))
+    return true;
+  return !bhvr_stack_.empty() && bhvr_stack_.back().may_match(tt);
+}
+
 bool scheduled_actor::activate(execution_unit* ctx) {
   CAF_LOG_TRACE("");
   CAF_ASSERT(ctx != nullptr);
@@ -572,7 +842,8 @@ bool scheduled_actor::activate(execution_unit* ctx) {
   catch (...) {
     CAF_LOG_ERROR("actor died during initialization");
     auto eptr = std::current_exception();
-    quit(call_handler(exception_handler_, this, eptr));
+    quit(call_handler(&extended_state::exception_hdl,
+                      default_exception_handler, this, eptr));
     finalize();
     return false;
   }
@@ -596,7 +867,7 @@ auto scheduled_actor::reactivate(mailbox_element& x) -> activation_result {
 # ifndef CAF_NO_EXCEPTIONS
   try {
 # endif // CAF_NO_EXCEPTIONS
-    switch (consume(x)) {
+    switch (traced_consume(x)) {
       case im_dropped:
         return activation_result::dropped;
       case im_success:
@@ -615,12 +886,14 @@ auto scheduled_actor::reactivate(mailbox_element& x) -> activation_result {
     CAF_LOG_INFO("actor died because of an exception, what: " << e.what());
     static_cast<void>(e); // keep compiler happy when not logging
     auto eptr = std::current_exception();
-    quit(call_handler(exception_handler_, this, eptr));
+    quit(call_handler(&extended_state::exception_hdl,
+                      default_exception_handler, this, eptr));
   }
   catch (...) {
     CAF_LOG_INFO("actor died because of an unknown exception");
     auto eptr = std::current_exception();
-    quit(call_handler(exception_handler_, this, eptr));
+    quit(call_handler(&extended_state::exception_hdl,
+                      default_exception_handler, this, eptr));
   }
   finalize();
   return activation_result::terminated;
@@ -648,6 +921,20 @@ bool scheduled_actor::finalize() {
   return true;
 }
 
+void scheduled_actor::schedule_unblocked(execution_unit* eu) {
+  // add a reference count to this actor and re-schedule it
+  intrusive_ptr_add_ref(ctrl());
+  if (getf(is_detached_flag)) {
+    CAF_ASSERT(private_thread_ != nullptr);
+    private_thread_->resume();
+  } else {
+    if (eu != nullptr)
+      eu->exec_later(this);
+    else
+      home_system().scheduler().enqueue(this);
+  }
+}
+
 bool scheduled_actor::handle_stream_msg(mailbox_element& x,
                                         behavior* active_behavior) {
   CAF_LOG_TRACE(CAF_ARG(x));
@@ -659,7 +946,7 @@ bool scheduled_actor::handle_stream_msg(mailbox_element& x,
   }
   stream_msg_visitor f{this, sm, active_behavior};
   auto result = visit(f, sm.content);
-  if (streams_.empty() && !has_behavior())
+  if ((ext_ == nullptr || ext_->streams.empty()) && !has_behavior())
     quit(exit_reason::normal);
   return result;
 }
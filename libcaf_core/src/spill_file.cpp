@@ -0,0 +1,176 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/spill_file.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#include "caf/sec.hpp"
+#include "caf/logger.hpp"
+
+#ifndef CAF_WINDOWS
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/types.h>
+#endif
+
+namespace caf {
+namespace detail {
+
+namespace {
+
+// initial size of a segment
+constexpr size_t min_segment_size = 1024 * 1024;
+
+} // namespace <anonymous>
+
+spill_file::spill_file()
+    : data_(nullptr),
+      capacity_(0),
+      rd_pos_(0),
+      wr_pos_(0) {
+#ifndef CAF_WINDOWS
+  fd_ = -1;
+#endif
+}
+
+spill_file::~spill_file() {
+  close();
+}
+
+#ifdef CAF_WINDOWS
+
+error spill_file::open(const std::string&) {
+  storage_.resize(min_segment_size);
+  data_ = storage_.data();
+  capacity_ = storage_.size();
+  return none;
+}
+
+error spill_file::reserve(size_t num_bytes) {
+  storage_.resize(std::max(storage_.size() * 2, wr_pos_ + num_bytes));
+  data_ = storage_.data();
+  capacity_ = storage_.size();
+  return none;
+}
+
+void spill_file::close() {
+  storage_.clear();
+  storage_.shrink_to_fit();
+  data_ = nullptr;
+}
+
+#else // CAF_WINDOWS
+
+error spill_file::open(const std::string& dir) {
+  CAF_LOG_TRACE(CAF_ARG(dir));
+  if (is_open())
+    return none;
+  std::string path = dir;
+  if (path.empty()) {
+    auto tmp = getenv("TMPDIR");
+    path = tmp != nullptr ? tmp : "/tmp";
+  }
+  path += "/caf-spill-XXXXXX";
+  std::vector<char> tmpl{path.begin(), path.end()};
+  tmpl.push_back('\0');
+  fd_ = mkstemp(tmpl.data());
+  if (fd_ < 0)
+    return make_error(sec::runtime_error, "cannot create spill file", path);
+  // the file disappears as soon as we close it or the process dies
+  unlink(tmpl.data());
+  if (ftruncate(fd_, static_cast<off_t>(min_segment_size)) != 0) {
+    close();
+    return make_error(sec::runtime_error, "cannot resize spill file");
+  }
+  auto ptr = mmap(nullptr, min_segment_size, PROT_READ | PROT_WRITE,
+                  MAP_SHARED, fd_, 0);
+  if (ptr == MAP_FAILED) {
+    close();
+    return make_error(sec::runtime_error, "cannot map spill file");
+  }
+  data_ = reinterpret_cast<char*>(ptr);
+  capacity_ = min_segment_size;
+  madvise(data_, capacity_, MADV_SEQUENTIAL);
+  return none;
+}
+
+error spill_file::reserve(size_t num_bytes) {
+  CAF_LOG_TRACE(CAF_ARG(num_bytes) << CAF_ARG(capacity_));
+  auto new_capacity = std::max(capacity_ * 2, wr_pos_ + num_bytes);
+  if (ftruncate(fd_, static_cast<off_t>(new_capacity)) != 0)
+    return make_error(sec::runtime_error, "cannot resize spill file");
+  auto ptr = mmap(nullptr, new_capacity, PROT_READ | PROT_WRITE, MAP_SHARED,
+                  fd_, 0);
+  if (ptr == MAP_FAILED)
+    return make_error(sec::runtime_error, "cannot map spill file");
+  munmap(data_, capacity_);
+  data_ = reinterpret_cast<char*>(ptr);
+  capacity_ = new_capacity;
+  madvise(data_, capacity_, MADV_SEQUENTIAL);
+  return none;
+}
+
+void spill_file::close() {
+  if (data_ != nullptr) {
+    munmap(data_, capacity_);
+    data_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+#endif // CAF_WINDOWS
+
+error spill_file::append(const void* buf, size_t num_bytes) {
+  CAF_ASSERT(is_open());
+  if (wr_pos_ + num_bytes > capacity_) {
+    // reclaim consumed space at the front before growing the segment
+    if (rd_pos_ > 0) {
+      memmove(data_, data_ + rd_pos_, available());
+      wr_pos_ -= rd_pos_;
+      rd_pos_ = 0;
+    }
+    if (wr_pos_ + num_bytes > capacity_) {
+      auto err = reserve(num_bytes);
+      if (err)
+        return err;
+    }
+  }
+  memcpy(data_ + wr_pos_, buf, num_bytes);
+  wr_pos_ += num_bytes;
+  return none;
+}
+
+void spill_file::consume(size_t num_bytes) {
+  CAF_ASSERT(num_bytes <= available());
+  rd_pos_ += num_bytes;
+  if (rd_pos_ == wr_pos_)
+    rd_pos_ = wr_pos_ = 0;
+}
+
+} // namespace detail
+} // namespace caf
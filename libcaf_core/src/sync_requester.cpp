@@ -0,0 +1,44 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/sync_requester.hpp"
+
+#include "caf/actor_system.hpp"
+#include "caf/make_actor.hpp"
+#include "caf/exit_reason.hpp"
+
+namespace caf {
+
+sync_requester::sync_requester(actor_system& sys) {
+  // the receiver does not register at the system, since it neither has a
+  // behavior nor keeps the system alive
+  actor_config cfg;
+  self_ = make_actor<detail::response_receiver, strong_actor_ptr>(
+    sys.next_actor_id(), sys.node(), &sys, cfg);
+}
+
+sync_requester::~sync_requester() {
+  receiver()->cleanup(exit_reason::normal, nullptr);
+}
+
+actor_addr sync_requester::address() const {
+  return self_->address();
+}
+
+} // namespace caf
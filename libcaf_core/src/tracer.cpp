@@ -0,0 +1,285 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/tracer.hpp"
+
+#include <thread>
+#include <random>
+#include <limits>
+#include <fstream>
+#include <algorithm>
+#include <iostream>
+#include <functional>
+
+#include "caf/logger.hpp"
+#include "caf/node_id.hpp"
+#include "caf/actor_system.hpp"
+#include "caf/actor_system_config.hpp"
+
+#ifdef CAF_NO_THREAD_LOCAL
+#include <pthread.h>
+#endif // CAF_NO_THREAD_LOCAL
+
+namespace caf {
+
+constexpr uint8_t trace_context::sampled_flag;
+
+constexpr uint8_t trace_context::root_flag;
+
+namespace detail {
+
+namespace {
+
+std::atomic<size_t> s_next_tracer_id{1};
+
+// per-thread state for generating IDs and for finding the buffer of a tracer
+struct tracer_thread_state {
+  tracer_thread_state()
+      : engine(std::random_device{}()
+               ^ std::hash<std::thread::id>{}(std::this_thread::get_id())),
+        tracer_id(0),
+        buf(nullptr) {
+    // nop
+  }
+
+  std::mt19937_64 engine;
+  size_t tracer_id;
+  void* buf;
+};
+
+#ifdef CAF_NO_THREAD_LOCAL
+
+pthread_key_t s_key;
+pthread_once_t s_key_once = PTHREAD_ONCE_INIT;
+
+pthread_key_t s_ctx_key;
+pthread_once_t s_ctx_key_once = PTHREAD_ONCE_INIT;
+
+void destroy_thread_state(void* ptr) {
+  delete reinterpret_cast<tracer_thread_state*>(ptr);
+}
+
+void make_thread_state_key() {
+  pthread_key_create(&s_key, destroy_thread_state);
+}
+
+void make_ctx_key() {
+  pthread_key_create(&s_ctx_key, nullptr);
+}
+
+tracer_thread_state& thread_state() {
+  pthread_once(&s_key_once, make_thread_state_key);
+  auto ptr = reinterpret_cast<tracer_thread_state*>(pthread_getspecific(s_key));
+  if (ptr == nullptr) {
+    ptr = new tracer_thread_state;
+    pthread_setspecific(s_key, ptr);
+  }
+  return *ptr;
+}
+
+#else // CAF_NO_THREAD_LOCAL
+
+tracer_thread_state& thread_state() {
+  static thread_local tracer_thread_state result;
+  return result;
+}
+
+#endif // CAF_NO_THREAD_LOCAL
+
+void append_hex(std::ostream& out, uint64_t x, size_t digits) {
+  static constexpr char hex[] = "0123456789abcdef";
+  char buf[16];
+  for (size_t i = 0; i < 16; ++i) {
+    buf[15 - i] = hex[x & 0x0F];
+    x >>= 4;
+  }
+  for (size_t i = 16; i < digits; ++i)
+    out << '0';
+  out.write(buf, 16);
+}
+
+void append_json_string(std::ostream& out, const std::string& str) {
+  out << '"';
+  for (auto c : str) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          out << "\\u00";
+          static constexpr char hex[] = "0123456789abcdef";
+          out << hex[(c >> 4) & 0x0F] << hex[c & 0x0F];
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+} // namespace <anonymous>
+
+#ifdef CAF_NO_THREAD_LOCAL
+
+const trace_context* current_trace_context() {
+  pthread_once(&s_ctx_key_once, make_ctx_key);
+  return reinterpret_cast<const trace_context*>(pthread_getspecific(s_ctx_key));
+}
+
+void current_trace_context(const trace_context* x) {
+  pthread_once(&s_ctx_key_once, make_ctx_key);
+  pthread_setspecific(s_ctx_key, x);
+}
+
+#endif // CAF_NO_THREAD_LOCAL
+
+tracer::tracer()
+    : system_(nullptr),
+      id_(s_next_tracer_id++),
+      sample_threshold_(0),
+      buffer_size_(0),
+      dropped_(0) {
+  // nop
+}
+
+tracer::~tracer() {
+  // nop
+}
+
+bool tracer::sample() {
+  if (sample_threshold_ == std::numeric_limits<uint64_t>::max())
+    return true;
+  return thread_state().engine() < sample_threshold_;
+}
+
+uint64_t tracer::make_id() {
+  auto& engine = thread_state().engine;
+  uint64_t result;
+  do {
+    result = engine();
+  } while (result == 0);
+  return result;
+}
+
+void tracer::record(span_record x) {
+  auto& buf = local_buffer();
+  std::unique_lock<std::mutex> guard{buf.mtx};
+  if (buf.spans.size() >= buffer_size_) {
+    ++dropped_;
+    return;
+  }
+  buf.spans.emplace_back(std::move(x));
+}
+
+std::vector<span_record> tracer::collect() {
+  std::vector<span_record> result;
+  std::unique_lock<std::mutex> guard{buffers_mtx_};
+  for (auto& buf : buffers_) {
+    std::unique_lock<std::mutex> buf_guard{buf->mtx};
+    result.insert(result.end(), std::make_move_iterator(buf->spans.begin()),
+                  std::make_move_iterator(buf->spans.end()));
+    buf->spans.clear();
+  }
+  return result;
+}
+
+void tracer::write_json(std::ostream& out, const std::vector<span_record>& xs,
+                        const std::string& service_name,
+                        const std::string& node) {
+  out << R"({"resourceSpans":[{"resource":{"attributes":[)"
+      << R"({"key":"service.name","value":{"stringValue":)";
+  append_json_string(out, service_name);
+  out << R"(}},{"key":"caf.node","value":{"stringValue":)";
+  append_json_string(out, node);
+  out << R"(}}]},"scopeSpans":[{"scope":{"name":"caf"},"spans":[)";
+  for (size_t i = 0; i < xs.size(); ++i) {
+    auto& x = xs[i];
+    if (i > 0)
+      out << ',';
+    out << "\n" << R"({"traceId":")";
+    append_hex(out, x.trace_id, 32);
+    out << R"(","spanId":")";
+    append_hex(out, x.span_id, 16);
+    out << R"(","parentSpanId":")";
+    if (x.parent_span_id != 0)
+      append_hex(out, x.parent_span_id, 16);
+    // kind 5 denotes SPAN_KIND_CONSUMER, i.e., processing a message
+    out << R"(","name":)";
+    append_json_string(out, x.name);
+    out << R"(,"kind":5,"startTimeUnixNano":")" << x.start
+        << R"(","endTimeUnixNano":")" << x.end
+        << R"(","attributes":[{"key":"caf.actor_id","value":{"intValue":")"
+        << x.aid << R"("}}]})";
+  }
+  out << "\n]}]}]}\n";
+}
+
+void tracer::init(actor_system& sys) {
+  system_ = &sys;
+  auto& cfg = sys.config();
+  auto rate = cfg.tracing_sample_rate;
+  if (rate <= 0.)
+    sample_threshold_ = 0;
+  else if (rate >= 1.)
+    sample_threshold_ = std::numeric_limits<uint64_t>::max();
+  else
+    sample_threshold_ = static_cast<uint64_t>(
+      rate * static_cast<double>(std::numeric_limits<uint64_t>::max()));
+  buffer_size_ = cfg.tracing_buffer_size;
+  output_file_ = cfg.tracing_output_file;
+}
+
+void tracer::stop() {
+  if (!enabled() || output_file_.empty())
+    return;
+  auto xs = collect();
+  std::ofstream out{output_file_};
+  if (!out) {
+    std::cerr << "[WARNING] unable to open trace output file: "
+              << output_file_ << std::endl;
+    return;
+  }
+  auto& cfg = system_->config();
+  auto service_name = cfg.middleman_app_identifier.empty()
+                      ? std::string{"caf"}
+                      : cfg.middleman_app_identifier;
+  write_json(out, xs, service_name, to_string(system_->node()));
+  if (dropped() > 0)
+    CAF_LOG_WARNING("dropped spans due to full buffers:" << CAF_ARG(dropped()));
+}
+
+tracer::buffer& tracer::local_buffer() {
+  auto& st = thread_state();
+  if (st.tracer_id != id_) {
+    std::unique_ptr<buffer> ptr{new buffer};
+    ptr->spans.reserve(std::min(buffer_size_, size_t{1024}));
+    st.tracer_id = id_;
+    st.buf = ptr.get();
+    std::unique_lock<std::mutex> guard{buffers_mtx_};
+    buffers_.emplace_back(std::move(ptr));
+  }
+  return *reinterpret_cast<buffer*>(st.buf);
+}
+
+} // namespace detail
+} // namespace caf
@@ -0,0 +1,121 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/weighted_gatherer.hpp"
+
+#include <algorithm>
+
+#include "caf/logger.hpp"
+#include "caf/inbound_path.hpp"
+
+namespace caf {
+
+weighted_gatherer::weighted_gatherer(local_actor* selfptr)
+    : super(selfptr),
+      weights_{{16, 8, 4, 2, 1}},
+      offset_(0) {
+  // nop
+}
+
+weighted_gatherer::~weighted_gatherer() {
+  // nop
+}
+
+void weighted_gatherer::assign_credit(long available) {
+  CAF_LOG_TRACE(CAF_ARG(available));
+  for (auto& kvp : assignment_vec_)
+    kvp.second = 0;
+  auto n = assignment_vec_.size();
+  if (n == 0 || available <= 0)
+    return;
+  // Guarantee a minimum share for each path first, starting at a rotating
+  // offset in case we cannot satisfy all paths.
+  offset_ = (offset_ + 1) % n;
+  for (size_t i = 0; i < n && available > 0; ++i) {
+    auto& kvp = assignment_vec_[(offset_ + i) % n];
+    auto x = std::min({available, min_credit_assignment(),
+                       headroom(kvp.first)});
+    kvp.second = x;
+    available -= x;
+  }
+  // Distribute remaining credit in proportion to the weights of all paths
+  // with free capacity. Each iteration either distributes all credit or
+  // saturates at least one path.
+  while (available > 0) {
+    long total_weight = 0;
+    for (auto& kvp : assignment_vec_)
+      if (headroom(kvp.first) > kvp.second)
+        total_weight += weight(kvp.first->prio);
+    if (total_weight == 0)
+      break;
+    auto remaining = available;
+    path_type* heaviest = nullptr;
+    for (auto& kvp : assignment_vec_) {
+      auto free = headroom(kvp.first) - kvp.second;
+      if (free <= 0)
+        continue;
+      auto w = weight(kvp.first->prio);
+      auto x = std::min(free, remaining * w / total_weight);
+      kvp.second += x;
+      available -= x;
+      if (heaviest == nullptr || w > weight(heaviest->prio))
+        heaviest = kvp.first;
+    }
+    // hand out rounding leftovers to the heaviest path with free capacity
+    if (available == remaining) {
+      for (auto& kvp : assignment_vec_)
+        if (kvp.first == heaviest) {
+          auto x = std::min(available, headroom(heaviest) - kvp.second);
+          kvp.second += x;
+          available -= x;
+        }
+    }
+  }
+  emit_credits();
+}
+
+long weighted_gatherer::initial_credit(long available, path_type* x) {
+  if (available <= 0)
+    return 0;
+  long total_weight = 0;
+  for (auto& kvp : assignment_vec_)
+    total_weight += weight(kvp.first->prio);
+  auto share = total_weight > 0
+               ? available * weight(x->prio) / total_weight
+               : available;
+  // the guaranteed minimum never exceeds what the downstream can handle
+  if (min_credit_assignment() <= available)
+    share = std::max(share, min_credit_assignment());
+  return std::min({share, available, max_credit()});
+}
+
+long weighted_gatherer::weight(stream_priority x) const {
+  return weights_[static_cast<size_t>(x)];
+}
+
+void weighted_gatherer::weight(stream_priority x, long y) {
+  CAF_ASSERT(y > 0);
+  weights_[static_cast<size_t>(x)] = y;
+}
+
+long weighted_gatherer::headroom(const path_type* x) const {
+  return std::max(max_credit() - x->assigned_credit, 0l);
+}
+
+} // namespace caf
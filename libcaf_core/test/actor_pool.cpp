@@ -42,7 +42,7 @@ public:
   }
 
   behavior make_behavior() override {
-    auto nested = exit_handler_;
+    auto nested = current_exit_handler();
     set_exit_handler([=](scheduled_actor* self, exit_msg& em) {
       nested(self, em);
     });
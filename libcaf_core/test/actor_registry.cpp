@@ -0,0 +1,166 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE actor_registry
+#include "caf/test/dsl.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/detail/concurrent_actor_map.hpp"
+
+using namespace caf;
+
+namespace {
+
+behavior dummy() {
+  return {
+    [](int x) {
+      return x;
+    }
+  };
+}
+
+struct fixture : test_coordinator_fixture<> {
+  actor_registry& reg() {
+    return sys.registry();
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(actor_registry_tests, fixture)
+
+CAF_TEST(lookup_by_id) {
+  auto x = sys.spawn(dummy);
+  auto y = sys.spawn(dummy);
+  sched.run();
+  CAF_CHECK_EQUAL(reg().get(x.id()), nullptr);
+  reg().put(x.id(), actor_cast<strong_actor_ptr>(x));
+  reg().put(y.id(), actor_cast<strong_actor_ptr>(y));
+  CAF_CHECK_EQUAL(reg().get(x.id()), actor_cast<strong_actor_ptr>(x));
+  CAF_CHECK_EQUAL(reg().get(y.id()), actor_cast<strong_actor_ptr>(y));
+  // existing entries remain unchanged
+  reg().put(x.id(), actor_cast<strong_actor_ptr>(y));
+  CAF_CHECK_EQUAL(reg().get(x.id()), actor_cast<strong_actor_ptr>(x));
+  reg().erase(x.id());
+  CAF_CHECK_EQUAL(reg().get(x.id()), nullptr);
+  CAF_CHECK_EQUAL(reg().get(y.id()), actor_cast<strong_actor_ptr>(y));
+  CAF_CHECK_EQUAL(reg().get(actor_id{0}), nullptr);
+  // registered actors keep the system alive
+  reg().erase(y.id());
+}
+
+CAF_TEST(terminated_actors_leave_the_registry) {
+  auto x = sys.spawn(dummy);
+  auto id = x.id();
+  reg().put(id, actor_cast<strong_actor_ptr>(x));
+  anon_send_exit(x, exit_reason::user_shutdown);
+  sched.run();
+  CAF_CHECK_EQUAL(reg().get(id), nullptr);
+}
+
+CAF_TEST(lookup_by_name) {
+  auto x = sys.spawn(dummy);
+  sched.run();
+  auto key = atom("foo");
+  CAF_CHECK_EQUAL(reg().get(key), nullptr);
+  reg().put(key, actor_cast<strong_actor_ptr>(x));
+  CAF_CHECK_EQUAL(reg().get(key), actor_cast<strong_actor_ptr>(x));
+  auto named = reg().named_actors();
+  CAF_REQUIRE_EQUAL(named.count(key), 1u);
+  CAF_CHECK_EQUAL(named[key], actor_cast<strong_actor_ptr>(x));
+  reg().erase(key);
+  CAF_CHECK_EQUAL(reg().get(key), nullptr);
+  CAF_CHECK_EQUAL(reg().named_actors().count(key), 0u);
+}
+
+CAF_TEST(all_keys_are_valid) {
+  auto x = sys.spawn(dummy);
+  sched.run();
+  // encodes to 0xFFFFFFFFFFFFFFFF
+  auto key = atom("zzzzzzzzzz");
+  reg().put(key, actor_cast<strong_actor_ptr>(x));
+  CAF_CHECK_EQUAL(reg().get(key), actor_cast<strong_actor_ptr>(x));
+  CAF_CHECK_EQUAL(reg().named_actors().count(key), 1u);
+  reg().erase(key);
+  CAF_CHECK_EQUAL(reg().get(key), nullptr);
+  detail::concurrent_actor_map m;
+  auto ptr = actor_cast<strong_actor_ptr>(x);
+  for (auto k : {uint64_t{0}, ~uint64_t{0}}) {
+    CAF_CHECK(m.put(k, ptr));
+    CAF_CHECK_EQUAL(m.get(k), ptr);
+    CAF_CHECK(m.erase(k));
+    CAF_CHECK_EQUAL(m.get(k), nullptr);
+    CAF_CHECK(!m.erase(k));
+  }
+}
+
+CAF_TEST(many_entries) {
+  // fills shards beyond their initial capacity and leaves tombstones
+  auto x = actor_cast<strong_actor_ptr>(sys.spawn(dummy));
+  sched.run();
+  detail::concurrent_actor_map m;
+  for (uint64_t i = 1; i <= 10000; ++i)
+    CAF_REQUIRE(m.put(i, x));
+  for (uint64_t i = 1; i <= 10000; i += 2)
+    CAF_REQUIRE(m.erase(i));
+  CAF_CHECK_EQUAL(m.entries().size(), 5000u);
+  for (uint64_t i = 1; i <= 10000; ++i)
+    CAF_REQUIRE_EQUAL(m.get(i) != nullptr, i % 2 == 0);
+  for (uint64_t i = 1; i <= 10000; i += 2)
+    CAF_REQUIRE(m.put(i, x));
+  CAF_CHECK_EQUAL(m.entries().size(), 10000u);
+}
+
+CAF_TEST(concurrent_readers_and_writers) {
+  auto x = actor_cast<strong_actor_ptr>(sys.spawn(dummy));
+  sched.run();
+  detail::concurrent_actor_map m;
+  for (uint64_t i = 1; i <= 100; ++i)
+    m.put(i, x);
+  std::atomic<bool> done{false};
+  std::atomic<int> errors{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 2; ++t)
+    readers.emplace_back([&] {
+      while (!done)
+        for (uint64_t i = 1; i <= 100; ++i)
+          if (m.get(i) != x)
+            ++errors;
+    });
+  // churn on keys the readers do not look up
+  for (int round = 0; round < 20; ++round) {
+    for (uint64_t i = 1000; i < 2000; ++i)
+      m.put(i, x);
+    for (uint64_t i = 1000; i < 2000; ++i)
+      m.erase(i);
+  }
+  done = true;
+  for (auto& t : readers)
+    t.join();
+  CAF_CHECK_EQUAL(errors.load(), 0);
+  CAF_CHECK_EQUAL(m.entries().size(), 100u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
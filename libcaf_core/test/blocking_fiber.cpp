@@ -0,0 +1,206 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE blocking_fiber
+#include "caf/test/unit_test.hpp"
+
+#include <chrono>
+#include <vector>
+
+#include "caf/all.hpp"
+
+#include "caf/detail/blocking_fiber.hpp"
+
+using namespace caf;
+
+namespace {
+
+using ping_atom = atom_constant<atom("ping")>;
+using pong_atom = atom_constant<atom("pong")>;
+
+class config : public actor_system_config {
+public:
+  config() {
+    scheduler_max_threads = 2;
+    scheduler_blocking_fibers = true;
+  }
+};
+
+void adder(blocking_actor* self) {
+  self->receive(
+    [](int x) {
+      return x + 1;
+    }
+  );
+}
+
+void pong(blocking_actor* self) {
+  bool running = true;
+  self->receive_while(running)(
+    [](ping_atom, int x) {
+      return std::make_tuple(pong_atom::value, x);
+    },
+    [&](const std::string&) {
+      running = false;
+    }
+  );
+}
+
+void ping(blocking_actor* self, actor buddy, int rounds, actor reporter) {
+  int received = 0;
+  for (int i = 0; i < rounds; ++i) {
+    self->send(buddy, ping_atom::value, i);
+    self->receive(
+      [&](pong_atom, int x) {
+        if (x == i)
+          ++received;
+      }
+    );
+  }
+  self->send(buddy, "done");
+  self->send(reporter, received);
+}
+
+void timeout_tester(blocking_actor* self, actor buddy) {
+  // no message arrives, i.e., the fiber resumes from the timeout
+  bool timed_out = false;
+  self->receive(
+    [](int) {
+      // nop
+    },
+    after(std::chrono::milliseconds(10)) >> [&] {
+      timed_out = true;
+    }
+  );
+  self->send(buddy, timed_out);
+  // a message arriving before the timeout wins
+  self->receive(
+    [&](int x) {
+      self->send(buddy, x);
+    },
+    after(std::chrono::seconds(10)) >> [&] {
+      self->send(buddy, -1);
+    }
+  );
+  // the pending timer of the previous receive must not end this one early
+  timed_out = false;
+  auto t0 = std::chrono::steady_clock::now();
+  self->receive(
+    [](int) {
+      // nop
+    },
+    after(std::chrono::milliseconds(20)) >> [&] {
+      timed_out = std::chrono::steady_clock::now() - t0
+                  >= std::chrono::milliseconds(20);
+    }
+  );
+  self->send(buddy, timed_out);
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(blocking_actors_run_as_fibers_without_threads) {
+  if (!detail::blocking_fiber::available()) {
+    CAF_MESSAGE("platform does not support fibers");
+    return;
+  }
+  config cfg;
+  actor_system sys{cfg};
+  auto before = sys.private_threads().collect_stats();
+  std::vector<actor> workers;
+  for (int i = 0; i < 500; ++i)
+    workers.emplace_back(sys.spawn(adder));
+  scoped_actor self{sys};
+  for (auto& worker : workers)
+    self->send(worker, 1);
+  int sum = 0;
+  for (size_t i = 0; i < workers.size(); ++i)
+    self->receive(
+      [&](int x) {
+        sum += x;
+      }
+    );
+  CAF_CHECK_EQUAL(sum, 1000);
+  auto after = sys.private_threads().collect_stats();
+  CAF_CHECK_EQUAL(after.jobs, before.jobs);
+  CAF_CHECK_EQUAL(after.threads_started, before.threads_started);
+}
+
+CAF_TEST(fibers_exchange_messages) {
+  if (!detail::blocking_fiber::available())
+    return;
+  config cfg;
+  actor_system sys{cfg};
+  scoped_actor self{sys};
+  auto buddy = sys.spawn(pong);
+  sys.spawn(ping, buddy, 1000, actor{self});
+  self->receive(
+    [](int received) {
+      CAF_CHECK_EQUAL(received, 1000);
+    }
+  );
+}
+
+CAF_TEST(fibers_receive_with_timeouts) {
+  if (!detail::blocking_fiber::available())
+    return;
+  config cfg;
+  actor_system sys{cfg};
+  scoped_actor self{sys};
+  auto tester = sys.spawn(timeout_tester, actor{self});
+  self->receive(
+    [](bool timed_out) {
+      CAF_CHECK(timed_out);
+    }
+  );
+  self->send(tester, 42);
+  self->receive(
+    [](int x) {
+      CAF_CHECK_EQUAL(x, 42);
+    }
+  );
+  self->receive(
+    [](bool timed_out) {
+      CAF_CHECK(timed_out);
+    }
+  );
+}
+
+CAF_TEST(fiber_stacks_return_to_the_pool) {
+  if (!detail::blocking_fiber::available())
+    return;
+  config cfg;
+  actor_system sys{cfg};
+  scoped_actor self{sys};
+  for (int i = 0; i < 10; ++i) {
+    auto worker = sys.spawn(adder);
+    self->request(worker, infinite, i).receive(
+      [&](int x) {
+        CAF_CHECK_EQUAL(x, i + 1);
+      },
+      [&](error& err) {
+        CAF_FAIL("unexpected error: " << sys.render(err));
+      }
+    );
+    self->wait_for(worker);
+  }
+  CAF_CHECK_GREATER(detail::blocking_fiber::pooled_stacks(), 0u);
+}
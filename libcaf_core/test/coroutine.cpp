@@ -0,0 +1,220 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE coroutine
+#include "caf/test/dsl.hpp"
+
+#include <tuple>
+
+#include "caf/all.hpp"
+
+#include "caf/detail/coroutine_frame_pool.hpp"
+
+using namespace caf;
+
+using detail::coroutine_frame_pool;
+
+namespace {
+
+#ifdef CAF_HAS_COROUTINES
+
+using add_atom = atom_constant<atom("add")>;
+using div_atom = atom_constant<atom("div")>;
+
+using calculator = typed_actor<replies_to<div_atom, int, int>
+                               ::with<int, int>>;
+
+behavior adder() {
+  return {
+    [](add_atom, int x, int y) {
+      return x + y;
+    }
+  };
+}
+
+calculator::behavior_type divider() {
+  return {
+    [](div_atom, int x, int y) -> result<int, int> {
+      if (y == 0)
+        return sec::invalid_argument;
+      return {x / y, x % y};
+    }
+  };
+}
+
+// increments `count` on destruction to detect destroyed coroutine frames
+struct frame_guard {
+  int* count;
+
+  ~frame_guard() {
+    ++*count;
+  }
+};
+
+// adds 1 to its input `depth` times via `worker`, one request at a time
+behavior chain(event_based_actor* self, actor worker, int depth) {
+  return {
+    [=](int x) -> actor_task {
+      auto rp = self->make_response_promise();
+      for (int i = 0; i < depth; ++i) {
+        auto y = co_await self->request(worker, infinite, add_atom::value, x,
+                                        1);
+        if (!y) {
+          rp.deliver(y.error());
+          co_return;
+        }
+        x = y->get_as<int>(0);
+      }
+      rp.deliver(x);
+    }
+  };
+}
+
+struct fixture : test_coordinator_fixture<> {
+  // nop
+};
+
+#endif // CAF_HAS_COROUTINES
+
+} // namespace <anonymous>
+
+CAF_TEST(frame_pools_recycle_blocks_per_size_class) {
+  coroutine_frame_pool pool;
+  auto x = coroutine_frame_pool::allocate(&pool, 100);
+  auto y = coroutine_frame_pool::allocate(&pool, 200);
+  coroutine_frame_pool::deallocate(x);
+  coroutine_frame_pool::deallocate(y);
+  CAF_CHECK_EQUAL(pool.cached(), 2u);
+  CAF_CHECK_EQUAL(coroutine_frame_pool::allocate(&pool, 64), x);
+  CAF_CHECK_EQUAL(coroutine_frame_pool::allocate(&pool, 256), y);
+  CAF_CHECK_EQUAL(pool.cached(), 0u);
+  coroutine_frame_pool::deallocate(x);
+  coroutine_frame_pool::deallocate(y);
+  // frames beyond the largest size class bypass the pool
+  auto z = coroutine_frame_pool::allocate(&pool, 4096);
+  coroutine_frame_pool::deallocate(z);
+  auto w = coroutine_frame_pool::allocate(nullptr, 100);
+  coroutine_frame_pool::deallocate(w);
+  CAF_CHECK_EQUAL(pool.cached(), 2u);
+}
+
+#ifdef CAF_HAS_COROUTINES
+
+CAF_TEST_FIXTURE_SCOPE(coroutine_tests, fixture)
+
+CAF_TEST(coroutines_resume_on_responses) {
+  auto worker = sys.spawn(adder);
+  auto aut = sys.spawn(chain, worker, 5);
+  sched.run();
+  auto res = self->request(aut, infinite, 10);
+  sched.run();
+  res.receive(
+    [](int x) {
+      CAF_CHECK_EQUAL(x, 15);
+    },
+    [&](error& err) {
+      CAF_FAIL("unexpected error: " << sys.render(err));
+    }
+  );
+  // the frame went back to the pool of the actor
+  auto& ref = deref<scheduled_actor>(aut);
+  CAF_CHECK_EQUAL(ref.frame_pool().cached(), 1u);
+}
+
+CAF_TEST(coroutines_receive_typed_results_and_errors) {
+  auto calc = sys.spawn(divider);
+  int results = 0;
+  auto aut = sys.spawn([=, &results](event_based_actor* self) -> behavior {
+    return {
+      [=, &results](int x, int y) -> actor_task {
+        auto res = co_await self->request(calc, infinite, div_atom::value, x,
+                                          y);
+        if (y == 0) {
+          CAF_REQUIRE(!res);
+          CAF_CHECK_EQUAL(res.error(), sec::invalid_argument);
+        } else {
+          CAF_REQUIRE(res);
+          CAF_CHECK_EQUAL(*res, std::make_tuple(x / y, x % y));
+        }
+        ++results;
+      }
+    };
+  });
+  sched.run();
+  anon_send(aut, 7, 2);
+  anon_send(aut, 7, 0);
+  sched.run();
+  CAF_CHECK_EQUAL(results, 2);
+}
+
+CAF_TEST(terminating_actors_destroy_suspended_coroutines) {
+  int destroyed = 0;
+  bool resumed = false;
+  // never answers, i.e., the coroutine stays suspended
+  auto sink = sys.spawn([]() -> behavior {
+    return {
+      [](add_atom, int, int) -> result<int> {
+        return delegated<int>{};
+      }
+    };
+  });
+  auto aut = sys.spawn([=, &destroyed, &resumed](event_based_actor* self) {
+    return behavior{
+      [=, &destroyed, &resumed](int) -> actor_task {
+        frame_guard guard{&destroyed};
+        co_await self->request(sink, infinite, add_atom::value, 1, 2);
+        resumed = true;
+      }
+    };
+  });
+  sched.run();
+  anon_send(aut, 1);
+  sched.run();
+  CAF_CHECK_EQUAL(destroyed, 0);
+  CAF_CHECK(deref<scheduled_actor>(aut).has_behavior());
+  anon_send_exit(aut, exit_reason::user_shutdown);
+  sched.run();
+  CAF_CHECK_EQUAL(destroyed, 1);
+  CAF_CHECK(!resumed);
+  anon_send_exit(sink, exit_reason::user_shutdown);
+  sched.run();
+}
+
+CAF_TEST(requests_to_dead_actors_resume_with_an_error) {
+  auto worker = sys.spawn(adder);
+  anon_send_exit(worker, exit_reason::user_shutdown);
+  sched.run();
+  auto aut = sys.spawn(chain, worker, 3);
+  auto res = self->request(aut, infinite, 1);
+  sched.run();
+  res.receive(
+    [](int) {
+      CAF_FAIL("expected an error");
+    },
+    [](error& err) {
+      CAF_CHECK_EQUAL(err, sec::request_receiver_down);
+    }
+  );
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+#endif // CAF_HAS_COROUTINES
@@ -0,0 +1,163 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+
+#define CAF_SUITE file_stream
+#include "caf/test/dsl.hpp"
+
+#include "caf/file_stream.hpp"
+
+#include "caf/detail/get_process_id.hpp"
+
+using namespace caf;
+
+namespace {
+
+std::string tmp_path(const std::string& name) {
+  auto dir = getenv("TMPDIR");
+  std::string result = dir != nullptr ? dir : "/tmp";
+  result += "/caf-file-stream-";
+  result += std::to_string(detail::get_process_id());
+  result += '-';
+  result += name;
+  return result;
+}
+
+std::string read_file(const std::string& path) {
+  std::ifstream in{path, std::ios::binary};
+  return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+void write_file(const std::string& path, const std::vector<char>& buf) {
+  std::ofstream out{path, std::ios::binary};
+  out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+}
+
+template <class Format>
+behavior reader(event_based_actor* self) {
+  return {
+    [=](const std::string& path) -> stream<typename Format::value_type> {
+      return make_file_source<Format>(self, path);
+    }
+  };
+}
+
+template <class Format>
+behavior writer(event_based_actor* self, std::string path,
+                size_t buffer_size) {
+  return {
+    [=](const stream<typename Format::value_type>& in) {
+      return make_file_sink<Format>(self, in, path, buffer_size);
+    }
+  };
+}
+
+struct fixture : test_coordinator_fixture<> {
+  std::vector<std::string> files;
+
+  ~fixture() {
+    for (auto& file : files)
+      remove(file.c_str());
+  }
+
+  std::string make_path(const std::string& name) {
+    files.emplace_back(tmp_path(name));
+    return files.back();
+  }
+
+  // streams `input` from one file to another and returns the written bytes
+  template <class Format>
+  expected<uint64_t> copy(const std::string& input, const std::string& output,
+                          size_t buffer_size) {
+    auto src = sys.spawn(reader<Format>);
+    auto snk = sys.spawn(writer<Format>, output, buffer_size);
+    sched.run();
+    self->send(snk * src, input);
+    sched.run();
+    return fetch_result<uint64_t>();
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(file_stream_tests, fixture)
+
+CAF_TEST(fixed_size_records) {
+  auto input = make_path("fixed-in");
+  auto output = make_path("fixed-out");
+  std::vector<char> buf;
+  fixed_size_records<int> fmt;
+  for (int i = 0; i < 1000; ++i)
+    fmt.write(buf, i);
+  write_file(input, buf);
+  CAF_MESSAGE("use a write-behind buffer smaller than a single batch");
+  auto res = copy<fixed_size_records<int>>(input, output, 64);
+  CAF_REQUIRE(res);
+  CAF_CHECK_EQUAL(*res, buf.size());
+  CAF_CHECK(read_file(output) == read_file(input));
+}
+
+CAF_TEST(length_prefixed_records) {
+  auto input = make_path("prefixed-in");
+  auto output = make_path("prefixed-out");
+  std::vector<char> buf;
+  length_prefixed_records fmt;
+  for (int i = 0; i < 500; ++i)
+    fmt.write(buf, std::string(static_cast<size_t>(i % 17), 'x'));
+  auto expected_size = buf.size();
+  CAF_MESSAGE("trailing bytes of an incomplete record get ignored");
+  buf.push_back(0);
+  buf.push_back(0);
+  write_file(input, buf);
+  auto res = copy<length_prefixed_records>(input, output, 1024 * 1024);
+  CAF_REQUIRE(res);
+  CAF_CHECK_EQUAL(*res, expected_size);
+  auto out = read_file(output);
+  CAF_CHECK(std::equal(out.begin(), out.end(), buf.begin()));
+}
+
+CAF_TEST(write_errors) {
+  auto input = make_path("full-in");
+  std::vector<char> buf;
+  fixed_size_records<int> fmt;
+  for (int i = 0; i < 1000; ++i)
+    fmt.write(buf, i);
+  write_file(input, buf);
+  CAF_MESSAGE("writing to /dev/full fails with ENOSPC");
+  auto res = copy<fixed_size_records<int>>(input, "/dev/full", 64);
+  CAF_REQUIRE(!res);
+  CAF_CHECK_EQUAL(res.error().code(), static_cast<uint8_t>(sec::runtime_error));
+}
+
+CAF_TEST(missing_input_file) {
+  auto src = sys.spawn(reader<fixed_size_records<int>>);
+  sched.run();
+  self->send(src, tmp_path("no-such-file"));
+  sched.run();
+  auto res = fetch_result<uint64_t>();
+  CAF_REQUIRE(!res);
+  CAF_CHECK_EQUAL(res.error().code(), static_cast<uint8_t>(sec::runtime_error));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -134,4 +134,103 @@ CAF_TEST(rendering) {
                   "unit.test WARN actor0 ns.foo bar foo.cpp:42 hello world");
 }
 
+CAF_TEST(binary_records) {
+  // Binary records render to the same message as line_builder.
+  static const detail::log_site site{CAF_LOG_LEVEL_DEBUG, "unit.test",
+                                     "void ns::foo::bar()", "foo.cpp", 42};
+  int x = -7;
+  unsigned y = 42;
+  double z = 1.5;
+  bool b = true;
+  string str = "abc";
+  std::vector<int> xs{1, 2, 3};
+  // messages fail to serialize without context and get rendered right away
+  auto msg = make_message(1, "two");
+  auto expected = (logger::line_builder{} << "ENTRY" << CAF_ARG(x)
+                   << CAF_ARG(y) << CAF_ARG(z) << CAF_ARG(b) << CAF_ARG(str)
+                   << "then" << xs << CAF_ARG(xs) << CAF_ARG(msg)).get();
+  vector<char> buf;
+  detail::log_record_writer w{buf};
+  timestamp t0{timestamp::duration{123}};
+  w.begin(site, t0, 11);
+  w.text("ENTRY", 5);
+  w.value("x", x);
+  w.value("y", y);
+  w.value("z", z);
+  w.value("b", b);
+  w.value("str", str);
+  w.text("then", 4);
+  w.value(xs);
+  w.value("xs", xs);
+  w.value("msg", msg);
+  w.end();
+  detail::log_record_header hdr;
+  CAF_REQUIRE(detail::read_log_record_header(buf.data(), buf.size(), hdr));
+  CAF_CHECK_EQUAL(hdr.size, buf.size());
+  CAF_CHECK_EQUAL(hdr.site, reinterpret_cast<uintptr_t>(&site));
+  CAF_CHECK_EQUAL(hdr.tstamp, 123);
+  CAF_CHECK_EQUAL(hdr.aid, 11u);
+  string rendered;
+  CAF_REQUIRE(detail::render_log_args(buf.data(), buf.size(), rendered));
+  CAF_CHECK_EQUAL(rendered, expected);
+  // Resolving formats deferred arguments without changing the output.
+  vector<char> resolved;
+  CAF_REQUIRE(detail::resolve_log_args(buf.data(), buf.size(), resolved));
+  CAF_REQUIRE(detail::read_log_record_header(resolved.data(), resolved.size(),
+                                             hdr));
+  CAF_CHECK_EQUAL(hdr.size, resolved.size());
+  rendered.clear();
+  CAF_REQUIRE(detail::render_log_args(resolved.data(), resolved.size(),
+                                      rendered));
+  CAF_CHECK_EQUAL(rendered, expected);
+  // Records survive wrapping around the end of a ring buffer.
+  detail::log_ring ring{1024, this_thread::get_id()};
+  size_t pushed = 0;
+  size_t drained = 0;
+  for (int i = 0; i < 100; ++i) {
+    CAF_REQUIRE(ring.try_push(buf.data(), buf.size()));
+    ++pushed;
+    if (i % 3 == 0)
+      drained += ring.drain([&](const char* ptr, size_t size) {
+        CAF_CHECK_EQUAL(size, buf.size());
+        string str;
+        CAF_CHECK(detail::render_log_args(ptr, size, str));
+        CAF_CHECK_EQUAL(str, expected);
+      });
+  }
+  drained += ring.drain([](const char*, size_t) {});
+  CAF_CHECK_EQUAL(pushed, drained);
+  // Terminating threads retire their ring but records remain readable.
+  CAF_CHECK(!ring.retired());
+  CAF_REQUIRE(ring.try_push(buf.data(), buf.size()));
+  ring.retire();
+  CAF_CHECK(ring.retired());
+  CAF_CHECK_EQUAL(ring.drain([](const char*, size_t) {}), 1u);
+  // Binary log files contain everything for rendering records offline.
+  ostringstream out;
+  detail::write_binary_log_header(out, t0);
+  detail::write_binary_log_site(out, hdr.site, site);
+  detail::write_binary_log_thread(out, 0, "thread-0");
+  detail::write_binary_log_record(out, 0, resolved.data(), resolved.size());
+  detail::write_binary_log_entry(out, detail::log_entry{
+    CAF_LOG_LEVEL_INFO, "caf", "void caf::logger::run()", "logger.cpp", 1,
+    "EOF", "thread-1", 0, t0});
+  istringstream in{out.str()};
+  vector<detail::log_entry> entries;
+  timestamp t0_in;
+  auto add_entry = [&](const detail::log_entry& e) {
+    entries.push_back(e);
+  };
+  CAF_REQUIRE(detail::read_binary_log(in, t0_in, add_entry));
+  CAF_CHECK(t0_in == t0);
+  CAF_REQUIRE_EQUAL(entries.size(), 2u);
+  CAF_CHECK_EQUAL(entries[0].category_name, "unit.test");
+  CAF_CHECK_EQUAL(entries[0].line_number, 42);
+  CAF_CHECK_EQUAL(entries[0].message, expected);
+  CAF_CHECK_EQUAL(entries[0].tid, "thread-0");
+  CAF_CHECK_EQUAL(entries[0].aid, 11u);
+  CAF_CHECK_EQUAL(entries[1].message, "EOF");
+  CAF_CHECK_EQUAL(entries[1].tid, "thread-1");
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,216 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE mailbox_lanes
+#include "caf/test/dsl.hpp"
+
+#include <string>
+#include <vector>
+
+#include "caf/all.hpp"
+
+#include "caf/detail/mailbox_lanes.hpp"
+
+using namespace caf;
+
+using detail::mailbox_lanes;
+
+namespace {
+
+using log_type = std::vector<std::string>;
+
+behavior recorder(event_based_actor* self, log_type* log) {
+  self->set_down_handler([=](down_msg&) {
+    log->emplace_back("down");
+  });
+  return {
+    [=](int x) {
+      log->emplace_back(std::to_string(x));
+    }
+  };
+}
+
+behavior int_sink(event_based_actor* self, log_type* log) {
+  return {
+    [=](stream<int>& in, std::string&) {
+      return self->make_sink(
+        in,
+        [](unit_t&) {
+          // nop
+        },
+        [=](unit_t&, int x) {
+          log->emplace_back(std::to_string(x));
+        },
+        [](unit_t&) {
+          // nop
+        }
+      );
+    }
+  };
+}
+
+struct fixture : test_coordinator_fixture<> {
+  template <message_priority P = message_priority::normal, class... Ts>
+  mailbox_element* make(Ts&&... xs) {
+    return make_mailbox_element(nullptr, message_id::make(P), {},
+                                std::forward<Ts>(xs)...).release();
+  }
+
+  // drains `xs` and renders integers as-is and system messages as "sys"
+  log_type drain(mailbox_lanes& xs) {
+    log_type result;
+    for (auto x = xs.take(); x != nullptr; x = xs.take()) {
+      mailbox_element_ptr guard{x};
+      auto& content = x->content();
+      if (content.match_elements<int>())
+        result.emplace_back(std::to_string(content.get_as<int>(0)));
+      else
+        result.emplace_back("sys");
+    }
+    return result;
+  }
+
+  down_msg dm() {
+    return down_msg{actor_addr{}, exit_reason::user_shutdown};
+  }
+
+  log_type log;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(mailbox_lanes_tests, fixture)
+
+CAF_TEST(classification) {
+  mailbox_element_ptr x{make(1)};
+  CAF_CHECK_EQUAL(mailbox_lanes::classify(*x), mailbox_lanes::normal_lane);
+  x.reset(make<message_priority::high>(1));
+  CAF_CHECK_EQUAL(mailbox_lanes::classify(*x), mailbox_lanes::urgent_lane);
+  x.reset(make(dm()));
+  CAF_CHECK_EQUAL(mailbox_lanes::classify(*x), mailbox_lanes::system_lane);
+  x.reset(make(exit_msg{actor_addr{}, exit_reason::kill}));
+  CAF_CHECK_EQUAL(mailbox_lanes::classify(*x), mailbox_lanes::system_lane);
+}
+
+CAF_TEST(stream_classification) {
+  stream_id sid;
+  actor_addr addr;
+  mailbox_element_ptr x{make(caf::make<stream_msg::ack_batch>(sid, addr, 10,
+                                                             int64_t{0}))};
+  CAF_CHECK_EQUAL(mailbox_lanes::classify(*x), mailbox_lanes::system_lane);
+  CAF_MESSAGE("batches and all messages that must follow them stay in order");
+  x.reset(make(caf::make<stream_msg::batch>(sid, addr, 1, make_message(1),
+                                            int64_t{0})));
+  CAF_CHECK_EQUAL(mailbox_lanes::classify(*x), mailbox_lanes::normal_lane);
+  x.reset(make(caf::make<stream_msg::close>(sid, addr)));
+  CAF_CHECK_EQUAL(mailbox_lanes::classify(*x), mailbox_lanes::normal_lane);
+  auto err = make_error(sec::runtime_error);
+  x.reset(make(caf::make<stream_msg::forced_close>(sid, addr, err)));
+  CAF_CHECK_EQUAL(mailbox_lanes::classify(*x), mailbox_lanes::normal_lane);
+}
+
+CAF_TEST(stream_close_follows_batches) {
+  auto aut = sys.spawn<priority_aware>(int_sink, &log);
+  sched.run();
+  scoped_actor src{sys};
+  auto src_ptr = actor_cast<strong_actor_ptr>(src);
+  stream_id sid{src.address(), 1};
+  auto send = [&](stream_msg x) {
+    aut->enqueue(make_mailbox_element(src_ptr, message_id::make(), {},
+                                      std::move(x)),
+                 nullptr);
+  };
+  send(caf::make<stream_msg::open>(sid, src.address(),
+                                   make_message(stream<int>{sid},
+                                                std::string{"ints"}),
+                                   src_ptr, src_ptr, stream_priority::normal,
+                                   false));
+  sched.run();
+  CAF_MESSAGE("upstream sends batch, batch, close before the sink runs");
+  send(caf::make<stream_msg::batch>(sid, src.address(), 2,
+                                    make_message(std::vector<int>{1, 2}),
+                                    int64_t{0}));
+  send(caf::make<stream_msg::batch>(sid, src.address(), 2,
+                                    make_message(std::vector<int>{3, 4}),
+                                    int64_t{1}));
+  send(caf::make<stream_msg::close>(sid, src.address()));
+  sched.run();
+  CAF_CHECK_EQUAL(log, log_type({"1", "2", "3", "4"}));
+}
+
+CAF_TEST(strict_priority) {
+  mailbox_lanes xs{0};
+  CAF_CHECK(xs.empty());
+  CAF_CHECK(xs.take() == nullptr);
+  xs.push(make(1));
+  xs.push(make(2));
+  xs.push(make(dm()));
+  xs.push(make<message_priority::high>(3));
+  CAF_CHECK_EQUAL(xs.size(), 4u);
+  CAF_CHECK_EQUAL(xs.size(mailbox_lanes::normal_lane), 2u);
+  CAF_CHECK_EQUAL(drain(xs), log_type({"3", "sys", "1", "2"}));
+  CAF_CHECK(xs.empty());
+  CAF_CHECK_EQUAL(xs.size(), 0u);
+}
+
+CAF_TEST(fairness) {
+  mailbox_lanes xs{2};
+  for (int i = 0; i < 5; ++i)
+    xs.push(make<message_priority::high>(i));
+  xs.push(make(10));
+  xs.push(make(11));
+  CAF_CHECK_EQUAL(drain(xs), log_type({"0", "1", "10", "2", "3", "11", "4"}));
+}
+
+CAF_TEST(fairness_rotates_between_lower_lanes) {
+  mailbox_lanes xs{1};
+  for (int i = 0; i < 4; ++i)
+    xs.push(make<message_priority::high>(i));
+  xs.push(make(10));
+  xs.push(make(11));
+  xs.push(make(dm()));
+  xs.push(make(dm()));
+  CAF_CHECK_EQUAL(drain(xs), log_type({"0", "sys", "1", "10", "2", "sys", "3",
+                                       "11"}));
+}
+
+CAF_TEST(priority_aware_actors) {
+  auto aut = sys.spawn<priority_aware>(recorder, &log);
+  sched.run();
+  anon_send(aut, 1);
+  anon_send(aut, 2);
+  anon_send(aut, dm());
+  anon_send<message_priority::high>(aut, 3);
+  sched.run();
+  CAF_CHECK_EQUAL(log, log_type({"3", "down", "1", "2"}));
+}
+
+CAF_TEST(other_actors_keep_fifo_order) {
+  auto aut = sys.spawn(recorder, &log);
+  sched.run();
+  anon_send(aut, 1);
+  anon_send(aut, dm());
+  anon_send<message_priority::high>(aut, 2);
+  sched.run();
+  CAF_CHECK_EQUAL(log, log_type({"1", "down", "2"}));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
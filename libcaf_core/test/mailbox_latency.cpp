@@ -0,0 +1,121 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE mailbox_latency
+#include "caf/test/unit_test.hpp"
+
+#include <thread>
+#include <chrono>
+
+#include "caf/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+class testee : public event_based_actor {
+public:
+  testee(actor_config& cfg, const char* name)
+      : event_based_actor(cfg),
+        name_(name) {
+    // nop
+  }
+
+  const char* name() const override {
+    return name_;
+  }
+
+  behavior make_behavior() override {
+    return {
+      [](int x) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return x;
+      }
+    };
+  }
+
+private:
+  const char* name_;
+};
+
+struct fixture {
+  fixture() {
+    cfg.metrics_mailbox_latency_actors = "foo, bar";
+  }
+
+  actor_system_config cfg;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(mailbox_latency_tests, fixture)
+
+CAF_TEST(selection_by_name) {
+  actor_system sys{cfg};
+  auto& reg = sys.metrics();
+  auto foo = reg.mailbox_latency("foo");
+  CAF_REQUIRE(foo != nullptr);
+  CAF_CHECK_EQUAL(reg.mailbox_latency("foo"), foo);
+  CAF_CHECK(reg.mailbox_latency("bar") != nullptr);
+  CAF_CHECK_NOT_EQUAL(reg.mailbox_latency("bar"), foo);
+  CAF_CHECK(reg.mailbox_latency("baz") == nullptr);
+  cfg.metrics_mailbox_latency_actors = "*";
+  actor_system sys2{cfg};
+  CAF_CHECK(sys2.metrics().mailbox_latency("baz") != nullptr);
+}
+
+#ifdef CAF_ENABLE_MAILBOX_LATENCY
+
+CAF_TEST(latency_per_actor_name) {
+  actor_system sys{cfg};
+  { // lifetime scope of self
+    scoped_actor self{sys};
+    auto foo1 = sys.spawn<testee>("foo");
+    auto foo2 = sys.spawn<testee>("foo");
+    auto baz = sys.spawn<testee>("baz");
+    // queue up messages to make sure they have to wait in the mailbox
+    for (int i = 0; i < 5; ++i) {
+      self->send(foo1, i);
+      self->send(foo2, i);
+      self->send(baz, i);
+    }
+    for (int i = 0; i < 15; ++i)
+      self->receive([](int) {});
+    for (auto& x : {foo1, foo2, baz})
+      anon_send_exit(x, exit_reason::user_shutdown);
+  }
+  auto xs = sys.metrics().collect();
+  auto i = std::find_if(xs.begin(), xs.end(), [](const metrics::snapshot& x) {
+    return x.name == "caf_actor_mailbox_latency_ns";
+  });
+  CAF_REQUIRE(i != xs.end());
+  CAF_CHECK_EQUAL(i->labels, "actor=\"foo\"");
+  // both foo actors share one histogram
+  CAF_CHECK_EQUAL(i->value, 10);
+  // the last message waits at least 4ms for its predecessors
+  CAF_CHECK(i->sum >= 4000000u);
+  ++i;
+  CAF_CHECK(i == xs.end() || i->name != "caf_actor_mailbox_latency_ns");
+}
+
+#endif // CAF_ENABLE_MAILBOX_LATENCY
+
+CAF_TEST_FIXTURE_SCOPE_END()
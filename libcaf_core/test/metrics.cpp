@@ -0,0 +1,208 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <thread>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#define CAF_SUITE metrics
+#include "caf/test/unit_test.hpp"
+
+#include "caf/all.hpp"
+
+#include "caf/metrics/registry.hpp"
+
+using namespace caf;
+
+using metrics::histogram;
+
+namespace {
+
+behavior adder() {
+  return {
+    [](int x, int y) {
+      return x + y;
+    }
+  };
+}
+
+const metrics::snapshot* find(const std::vector<metrics::snapshot>& xs,
+                              const std::string& name,
+                              const std::string& labels = "") {
+  auto i = std::find_if(xs.begin(), xs.end(),
+                        [&](const metrics::snapshot& x) {
+    return x.name == name && x.labels == labels;
+  });
+  return i != xs.end() ? &*i : nullptr;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(counters_and_gauges) {
+  metrics::counter c;
+  metrics::gauge g;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back([&] {
+      for (int j = 0; j < 1000; ++j) {
+        c.inc();
+        g.inc(2);
+        g.dec();
+      }
+    });
+  for (auto& t : threads)
+    t.join();
+  CAF_CHECK_EQUAL(c.value(), 4000u);
+  CAF_CHECK_EQUAL(g.value(), 4000);
+  // a gauge may go down in a thread other than the incrementing thread
+  std::thread{[&] { g.dec(5000); }}.join();
+  CAF_CHECK_EQUAL(g.value(), -1000);
+}
+
+CAF_TEST(histogram_buckets) {
+  for (uint64_t x = 0; x < 4; ++x) {
+    CAF_CHECK_EQUAL(histogram::bucket_of(x), x);
+    CAF_CHECK_EQUAL(histogram::upper_bound(x), x);
+  }
+  CAF_CHECK_EQUAL(histogram::bucket_of(4), 4u);
+  CAF_CHECK_EQUAL(histogram::bucket_of(7), 7u);
+  CAF_CHECK_EQUAL(histogram::bucket_of(8), 8u);
+  CAF_CHECK_EQUAL(histogram::bucket_of(9), 8u);
+  CAF_CHECK_EQUAL(histogram::bucket_of(10), 9u);
+  CAF_CHECK_EQUAL(histogram::upper_bound(8), 9u);
+  CAF_CHECK_EQUAL(histogram::upper_bound(9), 11u);
+  auto max = std::numeric_limits<uint64_t>::max();
+  CAF_CHECK_EQUAL(histogram::bucket_of(max), histogram::num_buckets - 1);
+  CAF_CHECK_EQUAL(histogram::upper_bound(histogram::num_buckets - 1), max);
+  // each value is in the bucket with the smallest upper bound >= value
+  for (size_t i = 4; i < histogram::num_buckets - 1; ++i) {
+    auto ub = histogram::upper_bound(i);
+    CAF_CHECK_EQUAL(histogram::bucket_of(ub), i);
+    CAF_CHECK_EQUAL(histogram::bucket_of(ub + 1), i + 1);
+  }
+}
+
+CAF_TEST(histogram_collect) {
+  histogram h;
+  std::thread{[&] {
+    for (uint64_t x = 0; x < 100; ++x)
+      h.observe(x);
+  }}.join();
+  h.observe(1000);
+  auto d = h.collect();
+  CAF_CHECK_EQUAL(d.count, 101u);
+  CAF_CHECK_EQUAL(d.sum, 5950u);
+  CAF_REQUIRE_EQUAL(d.buckets.size(), histogram::num_buckets);
+  CAF_CHECK_EQUAL(d.buckets[histogram::bucket_of(1000)], 1u);
+  uint64_t total = 0;
+  for (auto n : d.buckets)
+    total += n;
+  CAF_CHECK_EQUAL(total, d.count);
+}
+
+CAF_TEST(registry) {
+  metrics::registry reg;
+  CAF_CHECK(reg.runtime() == nullptr);
+  auto& c1 = reg.get_counter("requests_total", "path=\"/\"", "Requests.");
+  auto& c2 = reg.get_counter("requests_total", "path=\"/\"");
+  auto& c3 = reg.get_counter("requests_total", "path=\"/x\"");
+  CAF_CHECK_EQUAL(&c1, &c2);
+  CAF_CHECK_NOT_EQUAL(&c1, &c3);
+  c1.inc(3);
+  c3.inc();
+  reg.get_gauge("connections").inc(2);
+  reg.get_histogram("latency").observe(42);
+  int64_t x = 7;
+  reg.add_callback("answer", "", "Computed value.", [&] { return x; });
+  x = 42;
+  auto xs = reg.collect();
+  CAF_REQUIRE_EQUAL(xs.size(), 5u);
+  auto ptr = find(xs, "requests_total", "path=\"/\"");
+  CAF_REQUIRE(ptr != nullptr);
+  CAF_CHECK_EQUAL(ptr->type, metrics::metric_type::counter);
+  CAF_CHECK_EQUAL(ptr->value, 3);
+  CAF_CHECK_EQUAL(ptr->help, "Requests.");
+  ptr = find(xs, "requests_total", "path=\"/x\"");
+  CAF_REQUIRE(ptr != nullptr);
+  CAF_CHECK_EQUAL(ptr->value, 1);
+  ptr = find(xs, "connections");
+  CAF_REQUIRE(ptr != nullptr);
+  CAF_CHECK_EQUAL(ptr->type, metrics::metric_type::gauge);
+  CAF_CHECK_EQUAL(ptr->value, 2);
+  ptr = find(xs, "latency");
+  CAF_REQUIRE(ptr != nullptr);
+  CAF_CHECK_EQUAL(ptr->type, metrics::metric_type::histogram);
+  CAF_CHECK_EQUAL(ptr->value, 1);
+  CAF_CHECK_EQUAL(ptr->sum, 42u);
+  ptr = find(xs, "answer");
+  CAF_REQUIRE(ptr != nullptr);
+  CAF_CHECK_EQUAL(ptr->value, 42);
+  reg.remove_callback("answer", "");
+  CAF_CHECK_EQUAL(reg.collect().size(), 4u);
+}
+
+CAF_TEST(runtime_metrics) {
+  actor_system_config cfg;
+  cfg.metrics_enable_runtime = true;
+  cfg.scheduler_max_threads = 2;
+  actor_system sys{cfg};
+  CAF_REQUIRE(sys.metrics().runtime() != nullptr);
+  scoped_actor self{sys};
+  auto x = sys.spawn(adder);
+  for (int i = 0; i < 10; ++i)
+    self->request(x, infinite, i, i).receive(
+      [&](int y) {
+        CAF_CHECK_EQUAL(y, i + i);
+      },
+      [&](error& err) {
+        CAF_FAIL(sys.render(err));
+      }
+    );
+  // the snapshot is available to any actor, e.g., via a request
+  auto reader = sys.spawn([&](event_based_actor*) -> behavior {
+    return {
+      [&](get_atom) {
+        return sys.metrics().collect();
+      }
+    };
+  });
+  self->request(reader, infinite, get_atom::value).receive(
+    [&](const std::vector<metrics::snapshot>& xs) {
+      auto ptr = find(xs, "caf_actor_messages_processed_total");
+      CAF_REQUIRE(ptr != nullptr);
+      CAF_CHECK(ptr->value >= 10);
+      ptr = find(xs, "caf_mailbox_enqueued_total");
+      CAF_REQUIRE(ptr != nullptr);
+      CAF_CHECK(ptr->value >= 10);
+      // processing time is recorded per actor name
+      ptr = find(xs, "caf_actor_processing_time_ns",
+                 "actor=\"scheduled_actor\"");
+      CAF_REQUIRE(ptr != nullptr);
+      CAF_CHECK(ptr->value > 0);
+      CAF_CHECK(find(xs, "caf_scheduler_queued_jobs") != nullptr);
+      CAF_CHECK(find(xs, "caf_scheduler_steals_total") != nullptr);
+    },
+    [&](error& err) {
+      CAF_FAIL(sys.render(err));
+    }
+  );
+  anon_send_exit(x, exit_reason::user_shutdown);
+  anon_send_exit(reader, exit_reason::user_shutdown);
+}
@@ -0,0 +1,138 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE private_thread_pool
+#include "caf/test/unit_test.hpp"
+
+#include <chrono>
+#include <thread>
+
+#include "caf/all.hpp"
+
+using namespace caf;
+
+using stats = detail::private_thread_pool::stats;
+
+namespace {
+
+behavior short_lived(event_based_actor* self) {
+  self->quit();
+  return {};
+}
+
+void waiting(blocking_actor* self) {
+  self->receive(
+    [](int) {
+      // nop
+    }
+  );
+}
+
+// blocks until `pred` holds for the stats of `sys` or one second passed
+template <class Predicate>
+bool await_stats(actor_system& sys, Predicate pred) {
+  for (int i = 0; i < 1000; ++i) {
+    if (pred(sys.private_threads().collect_stats()))
+      return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(detached_actors_reuse_idle_threads) {
+  actor_system_config cfg;
+  actor_system sys{cfg};
+  auto& pool = sys.private_threads();
+  auto before = pool.collect_stats();
+  for (int i = 0; i < 10; ++i) {
+    scoped_actor self{sys};
+    self->wait_for(sys.spawn<detached>(short_lived));
+    // wait until the thread is back in the pool
+    CAF_REQUIRE(await_stats(sys, [](const stats& x) {
+      return x.idle_threads > 0;
+    }));
+  }
+  auto after = pool.collect_stats();
+  CAF_CHECK_EQUAL(after.jobs - before.jobs, 10u);
+  CAF_CHECK_EQUAL(after.threads_started - before.threads_started, 1u);
+  CAF_CHECK_EQUAL(after.threads_stopped, before.threads_stopped);
+}
+
+CAF_TEST(jobs_wait_for_a_thread_at_max_capacity) {
+  actor_system_config cfg;
+  // the timer and the printer of the scheduler occupy two threads
+  cfg.scheduler_detached_max_threads = 3;
+  actor_system sys{cfg};
+  auto& pool = sys.private_threads();
+  auto first = sys.spawn(waiting);
+  auto second = sys.spawn(waiting);
+  // the second actor waits for the first one to finish
+  CAF_CHECK(await_stats(sys, [](const stats& y) {
+    return y.queued_jobs == 1 && y.idle_threads == 0;
+  }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  auto x = pool.collect_stats();
+  CAF_CHECK_EQUAL(x.threads, 3u);
+  CAF_CHECK_EQUAL(x.queued_jobs, 1u);
+  anon_send(first, 1);
+  CAF_CHECK(await_stats(sys, [](const stats& y) {
+    return y.queued_jobs == 0;
+  }));
+  anon_send(second, 1);
+  x = pool.collect_stats();
+  CAF_CHECK_EQUAL(x.threads, 3u);
+  CAF_CHECK_GREATER_OR_EQUAL(x.max_wait_ns, 5000000u);
+  CAF_CHECK_GREATER_OR_EQUAL(x.total_wait_ns, x.max_wait_ns);
+}
+
+CAF_TEST(idle_threads_stop_after_the_timeout) {
+  actor_system_config cfg;
+  cfg.scheduler_detached_idle_timeout = 10;
+  actor_system sys{cfg};
+  auto before = sys.private_threads().collect_stats();
+  {
+    scoped_actor self{sys};
+    self->wait_for(sys.spawn<detached>(short_lived));
+  }
+  CAF_CHECK(await_stats(sys, [&](const stats& x) {
+    return x.threads_stopped > before.threads_stopped
+           && x.threads == before.threads;
+  }));
+}
+
+CAF_TEST(min_threads_stay_alive) {
+  actor_system_config cfg;
+  cfg.scheduler_detached_min_threads = 4;
+  cfg.scheduler_detached_idle_timeout = 0;
+  actor_system sys{cfg};
+  auto x = sys.private_threads().collect_stats();
+  CAF_CHECK_EQUAL(x.threads_started, 4u);
+  CAF_CHECK_EQUAL(x.threads, 4u);
+  {
+    scoped_actor self{sys};
+    self->wait_for(sys.spawn<detached>(short_lived));
+  }
+  x = sys.private_threads().collect_stats();
+  CAF_CHECK_EQUAL(x.threads_started, 4u);
+  CAF_CHECK_EQUAL(x.threads_stopped, 0u);
+}
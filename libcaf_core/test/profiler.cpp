@@ -0,0 +1,179 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <fstream>
+
+#define CAF_SUITE profiler
+#include "caf/test/unit_test.hpp"
+
+#include "caf/all.hpp"
+
+#include "caf/detail/profiler_log.hpp"
+#include "caf/detail/get_process_id.hpp"
+
+using namespace caf;
+
+using detail::profiler_event;
+using detail::profiler_ring;
+using detail::profiler_log_header;
+
+namespace {
+
+std::string tmp_path(const std::string& name) {
+  auto dir = getenv("TMPDIR");
+  std::string result = dir != nullptr ? dir : "/tmp";
+  result += "/caf-profiler-";
+  result += std::to_string(detail::get_process_id());
+  result += '-';
+  result += name;
+  return result;
+}
+
+profiler_event make_event(uint64_t id) {
+  profiler_event x;
+  memset(&x, 0, sizeof(x));
+  x.kind = profiler_event::resume;
+  x.id = id;
+  x.timestamp = id * 10;
+  return x;
+}
+
+behavior adder() {
+  return {
+    [](int x, int y) {
+      return x + y;
+    }
+  };
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(ring_capacity) {
+  profiler_ring r{5};
+  CAF_CHECK_EQUAL(r.capacity(), 8u);
+  for (uint64_t i = 0; i < 8; ++i)
+    CAF_CHECK(r.push(make_event(i)));
+  CAF_CHECK(!r.push(make_event(8)));
+  CAF_CHECK(!r.try_push(make_event(9)));
+  CAF_CHECK_EQUAL(r.dropped(), 1u);
+  std::vector<profiler_event> xs;
+  CAF_CHECK_EQUAL(r.drain(xs), 8u);
+  CAF_REQUIRE_EQUAL(xs.size(), 8u);
+  for (uint64_t i = 0; i < 8; ++i)
+    CAF_CHECK_EQUAL(xs[i].id, i);
+}
+
+CAF_TEST(ring_wraparound) {
+  profiler_ring r{4};
+  std::vector<profiler_event> xs;
+  uint64_t next = 0;
+  for (int round = 0; round < 5; ++round) {
+    for (int i = 0; i < 3; ++i)
+      CAF_CHECK(r.push(make_event(next++)));
+    r.drain(xs);
+  }
+  CAF_REQUIRE_EQUAL(xs.size(), 15u);
+  for (uint64_t i = 0; i < 15; ++i)
+    CAF_CHECK_EQUAL(xs[i].id, i);
+}
+
+CAF_TEST(log_roundtrip) {
+  auto path = tmp_path("roundtrip");
+  auto f = fopen(path.c_str(), "wb");
+  CAF_REQUIRE(f != nullptr);
+  profiler_log_header hdr;
+  detail::init_profiler_log_header(hdr);
+  hdr.num_workers = 2;
+  fwrite(&hdr, sizeof(hdr), 1, f);
+  profiler_ring r{4};
+  for (uint64_t i = 0; i < 3; ++i)
+    r.push(make_event(i));
+  r.drain(f);
+  for (uint64_t i = 3; i < 6; ++i)
+    r.push(make_event(i));
+  r.drain(f);
+  fclose(f);
+  std::ifstream in{path, std::ios::binary};
+  profiler_log_header hdr2;
+  std::vector<profiler_event> xs;
+  CAF_REQUIRE(detail::read_profiler_log(in, hdr2, xs));
+  CAF_CHECK_EQUAL(hdr2.num_workers, 2u);
+  CAF_REQUIRE_EQUAL(xs.size(), 6u);
+  for (uint64_t i = 0; i < 6; ++i)
+    CAF_CHECK_EQUAL(xs[i].timestamp, i * 10);
+  std::istringstream garbage{"not a profiler log, not at all"};
+  xs.clear();
+  CAF_CHECK(!detail::read_profiler_log(garbage, hdr2, xs));
+  remove(path.c_str());
+}
+
+CAF_TEST(profiled_coordinator) {
+  auto path = tmp_path("coordinator");
+  actor_id aid;
+  { // lifetime scope of system
+    actor_system_config cfg;
+    cfg.scheduler_enable_profiling = true;
+    cfg.scheduler_profiling_output_file = path;
+    cfg.scheduler_profiling_rusage_interval = 1;
+    cfg.scheduler_max_threads = 2;
+    actor_system sys{cfg};
+    scoped_actor self{sys};
+    auto x = sys.spawn(adder);
+    aid = x.id();
+    for (int i = 0; i < 10; ++i)
+      self->request(x, infinite, i, i).receive(
+        [&](int y) {
+          CAF_CHECK_EQUAL(y, i + i);
+        },
+        [&](error& err) {
+          CAF_FAIL(sys.render(err));
+        }
+      );
+    anon_send_exit(x, exit_reason::user_shutdown);
+  }
+  std::ifstream in{path, std::ios::binary};
+  profiler_log_header hdr;
+  std::vector<profiler_event> xs;
+  CAF_REQUIRE(detail::read_profiler_log(in, hdr, xs));
+  CAF_CHECK_EQUAL(hdr.num_workers, 2u);
+  CAF_CHECK_EQUAL(hdr.resolution, 100u);
+  size_t resumes = 0;
+  size_t samples = 0;
+  size_t done = 0;
+  for (auto& x : xs) {
+    CAF_CHECK(x.worker < 2);
+    if (x.kind == profiler_event::resume && x.id == aid)
+      ++resumes;
+    else if (x.kind == profiler_event::rusage)
+      ++samples;
+    else if (x.kind == profiler_event::done && x.id == aid)
+      ++done;
+  }
+  // the adder may consume several requests per resume
+  CAF_CHECK(resumes > 0);
+  CAF_CHECK(samples >= resumes);
+  CAF_CHECK_EQUAL(done, 1u);
+  remove(path.c_str());
+}
@@ -0,0 +1,117 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE resume_budget
+#include "caf/test/dsl.hpp"
+
+#include <chrono>
+#include <thread>
+
+#include "caf/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+struct config : actor_system_config {
+  config() {
+    metrics_enable_runtime = true;
+    scheduler_resume_budget_interval = 1;
+  }
+};
+
+// sleeps for the given number of milliseconds per message
+behavior sleeper(event_based_actor*, size_t* count) {
+  return {
+    [=](int ms) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+      ++*count;
+    }
+  };
+}
+
+struct fixture : test_coordinator_fixture<config> {
+  size_t count = 0;
+
+  // resumes the next job once with a custom message limit
+  resumable::resume_result resume_once(size_t max_throughput) {
+    auto job = sched.jobs.front();
+    sched.jobs.pop_front();
+    scoped_execution_unit ctx{&sys};
+    auto result = job->resume(&ctx, max_throughput);
+    if (result == resumable::resume_later)
+      sched.jobs.push_front(job);
+    else
+      intrusive_ptr_release(job);
+    return result;
+  }
+
+  uint64_t exhausted() {
+    return sys.metrics().runtime()->resume_budget_exhausted->value();
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(resume_budget_tests, fixture)
+
+CAF_TEST(no_budget_by_default) {
+  auto aut = sys.spawn(sleeper, &count);
+  sched.run();
+  CAF_CHECK_EQUAL(deref<scheduled_actor>(aut).resume_budget().count(), 0);
+  for (int i = 0; i < 10; ++i)
+    anon_send(aut, 0);
+  CAF_CHECK_EQUAL(resume_once(100), resumable::awaiting_message);
+  CAF_CHECK_EQUAL(count, 10u);
+  CAF_CHECK_EQUAL(exhausted(), 0u);
+}
+
+CAF_TEST(actors_yield_after_exhausting_their_budget) {
+  auto aut = sys.spawn(sleeper, &count);
+  sched.run();
+  auto& self = deref<scheduled_actor>(aut);
+  self.set_resume_budget(std::chrono::microseconds(100));
+  CAF_CHECK(self.resume_budget() == std::chrono::microseconds(100));
+  // the coarse clock advances at least every 10ms, i.e., the actor must
+  // yield after at most three messages
+  for (int i = 0; i < 10; ++i)
+    anon_send(aut, 5);
+  CAF_CHECK_EQUAL(resume_once(100), resumable::resume_later);
+  CAF_CHECK_LESS(count, 4u);
+  CAF_CHECK_EQUAL(exhausted(), 1u);
+  sched.run();
+  CAF_CHECK_EQUAL(count, 10u);
+}
+
+CAF_TEST(message_limit_applies_with_budget) {
+  auto aut = sys.spawn(sleeper, &count);
+  sched.run();
+  deref<scheduled_actor>(aut).set_resume_budget(std::chrono::seconds(10));
+  for (int i = 0; i < 10; ++i)
+    anon_send(aut, 0);
+  CAF_CHECK_EQUAL(resume_once(4), resumable::resume_later);
+  CAF_CHECK_EQUAL(count, 4u);
+  CAF_CHECK_EQUAL(exhausted(), 0u);
+  sched.run();
+  CAF_CHECK_EQUAL(count, 10u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
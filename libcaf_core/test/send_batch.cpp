@@ -0,0 +1,133 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE send_batch
+#include "caf/test/dsl.hpp"
+
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/actor_companion.hpp"
+#include "caf/scoped_execution_unit.hpp"
+
+using namespace caf;
+
+namespace {
+
+using log_type = std::vector<int>;
+
+behavior recorder(event_based_actor*, log_type* log) {
+  return {
+    [=](int x) {
+      log->push_back(x);
+    }
+  };
+}
+
+behavior forwarder(event_based_actor* self, actor dest) {
+  return {
+    [=](int n) {
+      std::vector<message> xs;
+      for (int i = 0; i < n; ++i)
+        xs.emplace_back(make_message(i));
+      self->send_batch(dest, xs);
+    }
+  };
+}
+
+struct fixture : test_coordinator_fixture<> {
+  log_type log;
+
+  std::vector<message> make_batch(int n) {
+    std::vector<message> result;
+    for (int i = 1; i <= n; ++i)
+      result.emplace_back(make_message(i));
+    return result;
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(send_batch_tests, fixture)
+
+CAF_TEST(batches_schedule_the_receiver_once) {
+  auto aut = sys.spawn(recorder, &log);
+  sched.run();
+  auto xs = make_batch(5);
+  anon_send_batch(aut, xs);
+  CAF_CHECK_EQUAL(sched.jobs.size(), 1u);
+  anon_send_batch(aut, xs.begin(), xs.begin() + 2);
+  CAF_CHECK_EQUAL(sched.jobs.size(), 1u);
+  sched.run();
+  CAF_CHECK_EQUAL(log, log_type({1, 2, 3, 4, 5, 1, 2}));
+}
+
+CAF_TEST(empty_batches_are_noops) {
+  auto aut = sys.spawn(recorder, &log);
+  sched.run();
+  anon_send_batch(aut, std::vector<message>{});
+  CAF_CHECK(!sched.has_job());
+}
+
+CAF_TEST(actors_send_batches_with_their_own_address) {
+  auto dest = sys.spawn(recorder, &log);
+  auto src = sys.spawn(forwarder, dest);
+  sched.run();
+  anon_send(src, 3);
+  sched.run();
+  CAF_CHECK_EQUAL(log, log_type({0, 1, 2}));
+}
+
+CAF_TEST(blocking_actors_receive_batches_in_order) {
+  self->send_batch(self, make_batch(3));
+  for (int i = 1; i <= 3; ++i)
+    self->receive(
+      [&](int x) {
+        CAF_CHECK_EQUAL(x, i);
+      }
+    );
+}
+
+CAF_TEST(batches_to_terminated_actors_get_dropped) {
+  auto aut = sys.spawn(recorder, &log);
+  sched.run();
+  anon_send_exit(aut, exit_reason::user_shutdown);
+  sched.run();
+  anon_send_batch(aut, make_batch(3));
+  CAF_CHECK(!sched.has_job());
+  CAF_CHECK(log.empty());
+}
+
+CAF_TEST(companions_receive_batches_via_their_handler) {
+  auto companion = sys.spawn<actor_companion>();
+  auto ptr = static_cast<actor_companion*>(
+    actor_cast<abstract_actor*>(companion));
+  ptr->on_enqueue([&](mailbox_element_ptr x) {
+    log.push_back(x->content().get_as<int>(0));
+  });
+  anon_send_batch(companion, make_batch(3));
+  CAF_CHECK(sched.jobs.empty());
+  CAF_CHECK_EQUAL(log, log_type({1, 2, 3}));
+  scoped_execution_unit ctx{&sys};
+  ptr->cleanup(error{}, &ctx);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
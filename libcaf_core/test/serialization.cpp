@@ -29,6 +29,7 @@
 #include <tuple>
 #include <locale>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <limits>
 #include <vector>
@@ -476,6 +477,24 @@ CAF_TEST(long_sequences) {
   CAF_CHECK_EQUAL(n, m);
 }
 
+CAF_TEST(arithmetic_sequence_optimization) {
+  // bulk serialization of vectors must produce the same bytes as the
+  // element-wise serialization of other containers
+  std::vector<int32_t> xs(1000);
+  std::iota(xs.begin(), xs.end(), -500);
+  std::list<int32_t> ys{xs.begin(), xs.end()};
+  CAF_CHECK(serialize(xs) == serialize(ys));
+  CAF_CHECK_EQUAL(roundtrip(xs), xs);
+  std::vector<double> ds{0., -1.5, 3.25, 1e300, -4e-20};
+  std::list<double> es{ds.begin(), ds.end()};
+  CAF_CHECK(serialize(ds) == serialize(es));
+  CAF_CHECK_EQUAL(roundtrip(ds), ds);
+  std::vector<uint16_t> us{1, 2, 0xFFFF, 0x0102};
+  CAF_CHECK_EQUAL(roundtrip(us), us);
+  std::vector<uint64_t> empty;
+  CAF_CHECK_EQUAL(roundtrip(empty), empty);
+}
+
 // -- our vector<bool> serialization packs into an uint64_t. Hence, the
 // critical sizes to test are 0, 1, 63, 64, and 65.
 
@@ -0,0 +1,171 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <deque>
+#include <vector>
+#include <numeric>
+
+#define CAF_SUITE spilling_scatterer
+#include "caf/test/dsl.hpp"
+
+#include "caf/spilling_scatterer.hpp"
+
+#include "caf/detail/spill_file.hpp"
+#include "caf/detail/pull5_gatherer.hpp"
+
+using namespace caf;
+
+namespace {
+
+struct config : actor_system_config {
+  config() {
+    stream_spill_threshold = 3;
+  }
+};
+
+using fixture = test_coordinator_fixture<config>;
+
+std::vector<int> ingest_result;
+
+std::vector<int> iota_vec(int first, int last) {
+  std::vector<int> result(static_cast<size_t>(last - first + 1));
+  std::iota(result.begin(), result.end(), first);
+  return result;
+}
+
+struct ingest_state {
+  static const char* name;
+};
+
+const char* ingest_state::name = "ingest";
+
+// a source that cannot get paused, i.e., ignores credit
+void ingest(stateful_actor<ingest_state>* self, const actor& dest) {
+  using buf = std::deque<int>;
+  self->make_source(
+    dest,
+    std::make_tuple(),
+    [&](buf& xs) {
+      auto ys = iota_vec(1, 20);
+      xs.assign(ys.begin(), ys.end());
+    },
+    [=](buf& xs, downstream<int>& out, size_t) {
+      for (auto x : xs)
+        out.push(x);
+      xs.clear();
+    },
+    [=](const buf& xs) {
+      return xs.empty();
+    },
+    [=](expected<std::vector<int>> res) {
+      if (res)
+        ingest_result = std::move(*res);
+    },
+    policy::arg<spilling_scatterer<int>>::value
+  );
+}
+
+struct collect_state {
+  static const char* name;
+};
+
+const char* collect_state::name = "collect";
+
+behavior collect(stateful_actor<collect_state>* self) {
+  return {
+    [=](stream<int>& in) {
+      return self->make_sink(
+        in,
+        [](std::vector<int>&) {
+          // nop
+        },
+        [](std::vector<int>& xs, int x) {
+          xs.push_back(x);
+        },
+        [](std::vector<int>& xs) {
+          return std::move(xs);
+        },
+        policy::arg<detail::pull5_gatherer, terminal_stream_scatterer>::value
+      );
+    }
+  };
+}
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(spilling_scatterer_tests, fixture)
+
+CAF_TEST(spill_file) {
+  detail::spill_file f;
+  CAF_REQUIRE_EQUAL(f.open(""), none);
+  CAF_CHECK_EQUAL(f.available(), 0u);
+  std::vector<char> xs(3 * f.capacity() / 2, 'a');
+  CAF_REQUIRE_EQUAL(f.append(xs.data(), xs.size()), none);
+  CAF_CHECK_EQUAL(f.available(), xs.size());
+  CAF_CHECK(f.capacity() >= xs.size());
+  CAF_CHECK_EQUAL(*f.read_ptr(), 'a');
+  f.consume(xs.size() - 1);
+  CAF_CHECK_EQUAL(f.available(), 1u);
+  CAF_REQUIRE_EQUAL(f.append("bc", 2), none);
+  CAF_CHECK_EQUAL(std::string(f.read_ptr(), f.available()), "abc");
+  f.consume(3);
+  CAF_CHECK_EQUAL(f.available(), 0u);
+}
+
+CAF_TEST(spill_and_replay) {
+  auto& ref = dynamic_cast<local_actor&>(*actor_cast<abstract_actor*>(self));
+  spilling_scatterer<int> out{&ref};
+  for (auto x : iota_vec(1, 10))
+    out.push(x);
+  CAF_MESSAGE("emit_batches without downstream credit moves 7 ints to disk");
+  out.emit_batches();
+  CAF_CHECK_EQUAL(out.buf(), std::deque<int>({1, 2, 3}));
+  CAF_CHECK_EQUAL(out.spilled(), 7u);
+  CAF_CHECK_EQUAL(out.buffered(), 10);
+  CAF_CHECK(out.bytes_spilled() > 0u);
+  CAF_CHECK_EQUAL(out.bytes_replayed(), 0u);
+  CAF_MESSAGE("new elements queue up behind spilled elements");
+  out.push(11);
+  out.emit_batches();
+  CAF_CHECK_EQUAL(out.buf(), std::deque<int>({1, 2, 3}));
+  CAF_CHECK_EQUAL(out.spilled(), 8u);
+  CAF_CHECK_EQUAL(out.buffered(), 11);
+  CAF_MESSAGE("replay all elements in order");
+  std::vector<int> result;
+  while (out.buffered() > 0) {
+    for (auto x : out.buf())
+      result.push_back(x);
+    out.buf().clear();
+    out.emit_batches();
+  }
+  CAF_CHECK_EQUAL(result, iota_vec(1, 11));
+  CAF_CHECK_EQUAL(out.spilled(), 0u);
+  CAF_CHECK_EQUAL(out.bytes_spilled(), out.bytes_replayed());
+}
+
+CAF_TEST(unpausable_source) {
+  auto sink = sys.spawn(collect);
+  auto source = sys.spawn(ingest, sink);
+  sched.run();
+  CAF_CHECK(deref(source).streams().empty());
+  CAF_CHECK(deref(sink).streams().empty());
+  CAF_CHECK_EQUAL(ingest_result, iota_vec(1, 20));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,140 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE stash
+#include "caf/test/dsl.hpp"
+
+#include <vector>
+
+#include "caf/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+using init_atom = atom_constant<atom("init")>;
+
+using log_type = std::vector<int>;
+
+// stashes all messages except `init` and `ping`, then logs ints and strings
+behavior waiting(event_based_actor* self, log_type* log) {
+  self->set_default_handler(skip);
+  return {
+    [=](init_atom) {
+      self->become(
+        [=](int x) {
+          log->push_back(x);
+        },
+        [=](const std::string&) {
+          log->push_back(-1);
+        }
+      );
+    },
+    [=](ok_atom) {
+      log->push_back(0);
+    }
+  };
+}
+
+// skips ints until receiving `init` without changing its behavior
+behavior gated(event_based_actor* self, log_type* log) {
+  auto ready = std::make_shared<bool>(false);
+  self->set_default_handler(skip);
+  return {
+    [=](int x) -> result<void> {
+      if (!*ready)
+        return skip();
+      log->push_back(x);
+      return unit;
+    },
+    [=](init_atom) {
+      *ready = true;
+    }
+  };
+}
+
+struct fixture : test_coordinator_fixture<> {
+  log_type log;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(stash_tests, fixture)
+
+CAF_TEST(stashed_messages_keep_their_order_after_a_behavior_change) {
+  auto aut = sys.spawn(waiting, &log);
+  sched.run();
+  anon_send(aut, 1);
+  anon_send(aut, "a");
+  anon_send(aut, 2);
+  sched.run();
+  CAF_CHECK(log.empty());
+  anon_send(aut, init_atom::value);
+  sched.run();
+  CAF_CHECK_EQUAL(log, log_type({1, -1, 2}));
+  CAF_CHECK(deref(aut).mailbox().cache().empty());
+}
+
+CAF_TEST(unmatched_types_are_not_retried) {
+  auto aut = sys.spawn(waiting, &log);
+  sched.run();
+  anon_send(aut, 1);
+  sched.run();
+  auto& self = deref(aut);
+  CAF_CHECK(!self.may_consume_stashed(make_type_token<int>()));
+  CAF_CHECK(self.may_consume_stashed(make_type_token<ok_atom>()));
+  anon_send(aut, ok_atom::value);
+  sched.run();
+  CAF_CHECK_EQUAL(log, log_type({0}));
+  CAF_CHECK_EQUAL(self.mailbox().cache().count(), 1u);
+  anon_send(aut, init_atom::value);
+  sched.run();
+  CAF_CHECK_EQUAL(log, log_type({0, 1}));
+  CAF_CHECK(self.mailbox().cache().empty());
+}
+
+CAF_TEST(skipping_handlers_get_retried_without_behavior_change) {
+  auto aut = sys.spawn(gated, &log);
+  sched.run();
+  anon_send(aut, 1);
+  anon_send(aut, 2);
+  sched.run();
+  CAF_CHECK(log.empty());
+  anon_send(aut, init_atom::value);
+  sched.run();
+  CAF_CHECK_EQUAL(log, log_type({1, 2}));
+}
+
+CAF_TEST(replacing_the_skip_handler_consumes_stashed_messages) {
+  auto aut = sys.spawn(waiting, &log);
+  sched.run();
+  anon_send(aut, 1);
+  sched.run();
+  auto& self = deref(aut);
+  self.set_default_handler(drop);
+  CAF_CHECK(self.may_consume_stashed(make_type_token<int>()));
+  anon_send(aut, ok_atom::value);
+  sched.run();
+  CAF_CHECK_EQUAL(log, log_type({0}));
+  CAF_CHECK(self.mailbox().cache().empty());
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,164 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE sync_requester
+#include "caf/test/unit_test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "caf/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+using calculator = typed_actor<replies_to<int, int>::with<int>>;
+
+calculator::behavior_type adder() {
+  return {
+    [](int x, int y) {
+      return x + y;
+    }
+  };
+}
+
+using doubler = typed_actor<replies_to<int>::with<int, int>>;
+
+doubler::behavior_type simple_doubler() {
+  return {
+    [](int x) {
+      return std::make_tuple(x, x);
+    }
+  };
+}
+
+// responds after sleeping for the given number of milliseconds
+behavior sleeper() {
+  return {
+    [](int ms) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+      return ms;
+    }
+  };
+}
+
+struct fixture {
+  fixture() : system(cfg) {
+    // nop
+  }
+
+  actor_system_config cfg;
+  actor_system system;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(sync_requester_tests, fixture)
+
+CAF_TEST(single_result) {
+  sync_requester self{system};
+  auto res = self.request(system.spawn(adder), infinite, 3, 4).get();
+  CAF_CHECK_EQUAL(res, 7);
+}
+
+CAF_TEST(tuple_result) {
+  sync_requester self{system};
+  auto res = self.request(system.spawn(simple_doubler), infinite, 10).get();
+  CAF_CHECK_EQUAL(res, std::make_tuple(10, 10));
+}
+
+CAF_TEST(dynamically_typed_result) {
+  sync_requester self{system};
+  auto res = self.request(system.spawn(sleeper), infinite, 0).get();
+  CAF_REQUIRE(res);
+  CAF_CHECK(res->match_elements<int>());
+  CAF_CHECK_EQUAL(res->get_as<int>(0), 0);
+}
+
+CAF_TEST(many_requests) {
+  sync_requester self{system};
+  auto dest = system.spawn(adder);
+  for (int i = 0; i < 1000; ++i)
+    CAF_REQUIRE_EQUAL(self.request(dest, infinite, i, i).get(), i + i);
+}
+
+CAF_TEST(timeouts) {
+  sync_requester self{system};
+  auto dest = system.spawn(sleeper);
+  auto res = self.request(dest, std::chrono::milliseconds(10), 100).get();
+  CAF_CHECK_EQUAL(res.error(), sec::request_timeout);
+  // the late response to the first request must not satisfy the second one
+  res = self.request(dest, infinite, 1).get();
+  CAF_REQUIRE(res);
+  CAF_CHECK_EQUAL(res->get_as<int>(0), 1);
+}
+
+CAF_TEST(discarded_futures) {
+  sync_requester self{system};
+  auto dest = system.spawn(sleeper);
+  { // lifetime scope of f
+    auto f = self.request(dest, infinite, 10);
+    CAF_CHECK(f.valid());
+  }
+  auto res = self.request(dest, infinite, 2).get();
+  CAF_REQUIRE(res);
+  CAF_CHECK_EQUAL(res->get_as<int>(0), 2);
+}
+
+CAF_TEST(invalid_receivers) {
+  sync_requester self{system};
+  calculator dest;
+  auto res = self.request(dest, infinite, 1, 2).get();
+  CAF_CHECK_EQUAL(res.error(), sec::invalid_argument);
+}
+
+CAF_TEST(terminated_receivers) {
+  sync_requester self{system};
+  auto dest = system.spawn(adder);
+  scoped_actor sender{system};
+  sender->send_exit(dest, exit_reason::kill);
+  sender->wait_for(dest);
+  auto res = self.request(dest, infinite, 1, 2).get();
+  CAF_CHECK_EQUAL(res.error(), sec::request_receiver_down);
+}
+
+CAF_TEST(concurrent_requesters) {
+  auto dest = system.spawn(adder);
+  std::atomic<int> errors{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&, t] {
+      sync_requester self{system};
+      for (int i = 0; i < 500; ++i) {
+        auto res = self.request(dest, infinite, t, i).get();
+        if (!res || *res != t + i)
+          ++errors;
+      }
+    });
+  for (auto& t : threads)
+    t.join();
+  CAF_CHECK_EQUAL(errors.load(), 0);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
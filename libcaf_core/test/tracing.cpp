@@ -0,0 +1,177 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE tracing
+#include "caf/test/unit_test.hpp"
+
+#include <map>
+#include <sstream>
+
+#include "caf/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+struct leaf_state {
+  static const char* name;
+};
+
+const char* leaf_state::name = "leaf";
+
+behavior leaf(stateful_actor<leaf_state>* self) {
+  return {
+    [=](int x) {
+      self->quit();
+      return x * 2;
+    }
+  };
+}
+
+struct relay_state {
+  static const char* name;
+};
+
+const char* relay_state::name = "relay";
+
+behavior relay(stateful_actor<relay_state>* self, actor next) {
+  return {
+    [=](int x) {
+      auto rp = self->make_response_promise<int>();
+      self->request(next, infinite, x).then([=](int y) mutable {
+        rp.deliver(y + 1);
+        self->quit();
+      });
+      return rp;
+    }
+  };
+}
+
+struct fixture {
+  fixture() {
+    cfg.tracing_sample_rate = 1.;
+    cfg.tracing_output_file = "";
+  }
+
+  // runs a request chain from a scoped actor via relay to leaf
+  void run_chain(actor_system& sys) {
+    {
+      scoped_actor self{sys};
+      auto hdl = sys.spawn(relay, sys.spawn(leaf));
+      self->request(hdl, infinite, 20).receive(
+        [&](int y) {
+          CAF_CHECK_EQUAL(y, 41);
+        },
+        [&](error& err) {
+          CAF_FAIL("unexpected error: " << sys.render(err));
+        }
+      );
+    }
+    sys.await_all_actors_done();
+  }
+
+  actor_system_config cfg;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(tracing_tests, fixture)
+
+CAF_TEST(disabled_tracing) {
+  cfg.tracing_sample_rate = 0.;
+  actor_system sys{cfg};
+  CAF_CHECK(!sys.tracer().enabled());
+  run_chain(sys);
+  CAF_CHECK(sys.tracer().collect().empty());
+}
+
+CAF_TEST(request_chains_form_a_single_trace) {
+  actor_system sys{cfg};
+  CAF_REQUIRE(sys.tracer().enabled());
+  run_chain(sys);
+  auto spans = sys.tracer().collect();
+  // relay receives the request, leaf receives the forwarded request, and
+  // relay receives the response from leaf
+  CAF_REQUIRE_EQUAL(spans.size(), 3u);
+  std::map<uint64_t, detail::span_record*> by_id;
+  for (auto& x : spans) {
+    CAF_CHECK_EQUAL(x.trace_id, spans.front().trace_id);
+    CAF_CHECK_LESS_OR_EQUAL(x.start, x.end);
+    by_id.emplace(x.span_id, &x);
+  }
+  CAF_REQUIRE_EQUAL(by_id.size(), 3u);
+  std::vector<detail::span_record*> roots;
+  for (auto& x : spans)
+    if (x.parent_span_id == 0)
+      roots.push_back(&x);
+  CAF_REQUIRE_EQUAL(roots.size(), 1u);
+  CAF_CHECK_EQUAL(roots.front()->name, "relay");
+  // walk from the root along the parent relation
+  std::vector<std::string> names;
+  for (auto current = roots.front(); current != nullptr;) {
+    names.emplace_back(current->name);
+    auto parent = current->span_id;
+    current = nullptr;
+    for (auto& x : spans)
+      if (x.parent_span_id == parent)
+        current = &x;
+  }
+  CAF_CHECK_EQUAL(names, std::vector<std::string>({"relay", "leaf", "relay"}));
+}
+
+CAF_TEST(propagation_context) {
+  // no context outside of message handlers
+  CAF_CHECK(detail::current_trace_context() == nullptr);
+  CAF_CHECK(detail::propagated_trace_context().root());
+  trace_context ctx{1, 2, trace_context::sampled_flag};
+  {
+    detail::trace_scope scope{&ctx};
+    auto x = detail::propagated_trace_context();
+    CAF_CHECK_EQUAL(x.trace_id, 1u);
+    CAF_CHECK_EQUAL(x.span_id, 2u);
+    CAF_CHECK(x.sampled());
+    CAF_CHECK(!x.root());
+  }
+  CAF_CHECK(detail::current_trace_context() == nullptr);
+}
+
+CAF_TEST(opentelemetry_json) {
+  std::vector<detail::span_record> xs;
+  xs.push_back(detail::span_record{0xABCD, 0x42, 0, 7, "foo", 10, 20});
+  xs.push_back(detail::span_record{0xABCD, 0x43, 0x42, 8, "\"bar\"", 15, 18});
+  std::ostringstream out;
+  detail::tracer::write_json(out, xs, "my-app", "node-1");
+  auto str = out.str();
+  auto contains = [&](const char* x) {
+    return str.find(x) != std::string::npos;
+  };
+  CAF_CHECK(contains(R"("key":"service.name","value":{"stringValue":"my-app"})"));
+  CAF_CHECK(contains(R"("key":"caf.node","value":{"stringValue":"node-1"})"));
+  CAF_CHECK(contains(R"("traceId":"0000000000000000000000000000abcd")"));
+  CAF_CHECK(contains(R"("spanId":"0000000000000042","parentSpanId":"")"));
+  CAF_CHECK(contains(R"("spanId":"0000000000000043",)"
+                     R"("parentSpanId":"0000000000000042")"));
+  CAF_CHECK(contains(R"("name":"\"bar\"")"));
+  CAF_CHECK(contains(R"("startTimeUnixNano":"10","endTimeUnixNano":"20")"));
+  CAF_CHECK(contains(R"("key":"caf.actor_id","value":{"intValue":"8"})"));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,151 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE weighted_gatherer
+#include "caf/test/dsl.hpp"
+
+#include "caf/random_gatherer.hpp"
+#include "caf/weighted_gatherer.hpp"
+
+using namespace caf;
+
+namespace {
+
+behavior dummy() {
+  return {
+    [](int) {
+      // nop
+    }
+  };
+}
+
+struct fixture : test_coordinator_fixture<> {
+  actor hi;
+  actor lo;
+  int64_t batch_id = 0;
+
+  fixture() : hi(sys.spawn(dummy)), lo(sys.spawn(dummy)) {
+    // nop
+  }
+
+  ~fixture() {
+    anon_send_exit(hi, exit_reason::kill);
+    anon_send_exit(lo, exit_reason::kill);
+    sched.run();
+  }
+
+  local_actor* parent() {
+    return dynamic_cast<local_actor*>(actor_cast<abstract_actor*>(self));
+  }
+
+  inbound_path* add(stream_gatherer& g, const actor& hdl,
+                    stream_priority prio) {
+    stream_id sid{actor_cast<strong_actor_ptr>(hdl), 1};
+    return g.add_path(sid, actor_cast<strong_actor_ptr>(hdl), nullptr, prio, 0,
+                      false, response_promise{});
+  }
+
+  // Lets all sources consume their credit and then grants `available` new
+  // credit, adding the consumed credit to `hi_total` and `lo_total`.
+  void round(stream_gatherer& g, inbound_path* hi_path, inbound_path* lo_path,
+             long available, long& hi_total, long& lo_total) {
+    hi_total += hi_path->assigned_credit;
+    lo_total += lo_path->assigned_credit;
+    hi_path->handle_batch(hi_path->assigned_credit, ++batch_id);
+    lo_path->handle_batch(lo_path->assigned_credit, ++batch_id);
+    g.assign_credit(available);
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(weighted_gatherer_tests, fixture)
+
+CAF_TEST(random_gatherer_starves_late_paths) {
+  random_gatherer g{parent()};
+  auto lo_path = add(g, lo, stream_priority::very_low);
+  auto hi_path = add(g, hi, stream_priority::very_high);
+  long hi_total = 0;
+  long lo_total = 0;
+  for (int i = 0; i < 100; ++i)
+    round(g, hi_path, lo_path, 20, hi_total, lo_total);
+  CAF_CHECK_EQUAL(hi_total, 0);
+  CAF_CHECK(lo_total > 0);
+}
+
+CAF_TEST(high_priority_keeps_its_share) {
+  weighted_gatherer g{parent()};
+  auto lo_path = add(g, lo, stream_priority::very_low);
+  auto hi_path = add(g, hi, stream_priority::very_high);
+  long hi_total = 0;
+  long lo_total = 0;
+  for (int i = 0; i < 100; ++i)
+    round(g, hi_path, lo_path, 20, hi_total, lo_total);
+  CAF_MESSAGE("hi: " << hi_total << ", lo: " << lo_total);
+  CAF_CHECK(hi_total >= 8 * lo_total);
+  CAF_CHECK(hi_total + lo_total <= 100 * 20 + 2);
+  CAF_MESSAGE("each path receives its guaranteed minimum per round");
+  CAF_CHECK(lo_total >= 99 * g.min_credit_assignment());
+}
+
+CAF_TEST(credit_follows_weights) {
+  weighted_gatherer g{parent()};
+  g.weight(stream_priority::very_low, 1);
+  g.weight(stream_priority::very_high, 3);
+  g.min_credit_assignment(0);
+  auto lo_path = add(g, lo, stream_priority::very_low);
+  auto hi_path = add(g, hi, stream_priority::very_high);
+  long hi_total = 0;
+  long lo_total = 0;
+  for (int i = 0; i < 100; ++i)
+    round(g, hi_path, lo_path, 40, hi_total, lo_total);
+  CAF_CHECK_EQUAL(hi_total, 3 * lo_total);
+}
+
+CAF_TEST(unused_credit_goes_to_low_priority_paths) {
+  weighted_gatherer g{parent()};
+  g.max_credit(10);
+  auto lo_path = add(g, lo, stream_priority::very_low);
+  auto hi_path = add(g, hi, stream_priority::very_high);
+  long hi_total = 0;
+  long lo_total = 0;
+  for (int i = 0; i < 100; ++i)
+    round(g, hi_path, lo_path, 20, hi_total, lo_total);
+  CAF_CHECK_EQUAL(hi_path->assigned_credit, 10);
+  CAF_CHECK_EQUAL(lo_path->assigned_credit, 10);
+}
+
+CAF_TEST(initial_credit_never_exceeds_available) {
+  weighted_gatherer g{parent()};
+  g.min_credit_assignment(5);
+  auto lo_path = add(g, lo, stream_priority::very_low);
+  auto hi_path = add(g, hi, stream_priority::very_high);
+  CAF_CHECK_EQUAL(g.initial_credit(0, lo_path), 0);
+  CAF_CHECK_EQUAL(g.initial_credit(-1, lo_path), 0);
+  CAF_CHECK_EQUAL(g.initial_credit(3, hi_path), 2);
+  CAF_CHECK(g.initial_credit(3, lo_path) <= 3);
+  CAF_MESSAGE("paths receive the guaranteed minimum if it fits");
+  CAF_CHECK_EQUAL(g.initial_credit(20, lo_path), 5);
+  for (long available = 0; available < 50; ++available) {
+    CAF_CHECK(g.initial_credit(available, lo_path) <= available);
+    CAF_CHECK(g.initial_credit(available, hi_path) <= available);
+  }
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
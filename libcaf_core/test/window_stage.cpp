@@ -0,0 +1,252 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <deque>
+#include <tuple>
+#include <vector>
+#include <algorithm>
+
+#define CAF_SUITE window_stage
+#include "caf/test/dsl.hpp"
+
+#include "caf/stream_window.hpp"
+#include "caf/stream_window_stage_impl.hpp"
+
+#include "caf/detail/window_table.hpp"
+
+using namespace caf;
+
+namespace {
+
+using std::chrono::milliseconds;
+
+// (window begin in ms, key, sum)
+using window_sum = std::tuple<int64_t, int, int>;
+
+using window_sums = std::vector<window_sum>;
+
+window_sums collected;
+
+timestamp at(int x) {
+  return timestamp{milliseconds(x)};
+}
+
+// computes the expected output for `xs` with keys `x % 3` and times `x` ms
+window_sums reference(const std::vector<int>& xs, int size, int slide) {
+  window_sums result;
+  auto first = std::min_element(xs.begin(), xs.end());
+  auto last = std::max_element(xs.begin(), xs.end());
+  for (auto begin = (*first / slide) * slide - size + slide; begin <= *last;
+       begin += slide)
+    for (int key = 0; key < 3; ++key) {
+      int sum = 0;
+      bool any = false;
+      for (auto x : xs)
+        if (x % 3 == key && x >= begin && x < begin + size) {
+          sum += x;
+          any = true;
+        }
+      if (any)
+        result.emplace_back(begin, key, sum);
+    }
+  return result;
+}
+
+struct sum_aggregator {
+  using input_type = int;
+  using accumulator_type = int;
+  using output_type = window_sum;
+
+  void add(int& acc, int x) {
+    acc += x;
+  }
+
+  void merge(int& acc, int x) {
+    acc += x;
+  }
+
+  window_sum emit(int key, int acc, timestamp begin) {
+    auto ms = std::chrono::duration_cast<milliseconds>(begin.time_since_epoch());
+    return window_sum{ms.count(), key, acc};
+  }
+};
+
+struct source_state {
+  static const char* name;
+};
+
+const char* source_state::name = "source";
+
+behavior source(stateful_actor<source_state>* self) {
+  using buf = std::deque<int>;
+  return {
+    [=](std::vector<int>& xs) -> stream<int> {
+      return self->make_source(
+        std::make_tuple(),
+        [&](buf& ys) {
+          ys.assign(xs.begin(), xs.end());
+        },
+        [=](buf& ys, downstream<int>& out, size_t num) {
+          auto n = std::min(num, ys.size());
+          for (size_t i = 0; i < n; ++i)
+            out.push(ys[i]);
+          ys.erase(ys.begin(), ys.begin() + static_cast<ptrdiff_t>(n));
+        },
+        [=](const buf& ys) {
+          return ys.empty();
+        }
+      );
+    }
+  };
+}
+
+struct window_state {
+  static const char* name;
+};
+
+const char* window_state::name = "window";
+
+behavior window(stateful_actor<window_state>* self, stream_window win) {
+  return {
+    [=](stream<int>& in) {
+      return self->make_window_stage(
+        in,
+        win,
+        [](int x) {
+          return x % 3;
+        },
+        [](int x) {
+          return at(x);
+        },
+        sum_aggregator{}
+      );
+    }
+  };
+}
+
+struct collect_state {
+  static const char* name;
+};
+
+const char* collect_state::name = "collect";
+
+behavior collect(stateful_actor<collect_state>* self) {
+  return {
+    [=](stream<window_sum>& in) {
+      return self->make_sink(
+        in,
+        [](window_sums&) {
+          // nop
+        },
+        [](window_sums& xs, window_sum x) {
+          xs.push_back(x);
+        },
+        [](window_sums& xs) {
+          std::sort(xs.begin(), xs.end());
+          collected = xs;
+          return xs.size();
+        }
+      );
+    }
+  };
+}
+
+struct fixture : test_coordinator_fixture<> {
+  void run_pipeline(stream_window win, std::vector<int> xs) {
+    collected.clear();
+    auto src = sys.spawn(source);
+    auto stage = sys.spawn(window, win);
+    auto snk = sys.spawn(collect);
+    auto pipeline = snk * stage * src;
+    sched.run();
+    self->send(pipeline, std::move(xs));
+    sched.run();
+    CAF_CHECK(deref(src).streams().empty());
+    CAF_CHECK(deref(stage).streams().empty());
+    CAF_CHECK(deref(snk).streams().empty());
+  }
+};
+
+std::vector<int> iota_vec(int first, int last) {
+  std::vector<int> result;
+  for (auto i = first; i <= last; ++i)
+    result.push_back(i);
+  return result;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(window_table) {
+  detail::window_table<int, int> tbl;
+  CAF_CHECK(tbl.empty());
+  CAF_CHECK_EQUAL(tbl.find(1), nullptr);
+  for (int i = 0; i < 1000; ++i)
+    tbl[i] += i;
+  for (int i = 0; i < 1000; ++i)
+    tbl[i] += i;
+  CAF_CHECK_EQUAL(tbl.size(), 1000u);
+  auto ptr = tbl.find(42);
+  CAF_REQUIRE(ptr != nullptr);
+  CAF_CHECK_EQUAL(*ptr, 84);
+  CAF_CHECK_EQUAL(tbl.find(1000), nullptr);
+  int sum = 0;
+  tbl.for_each([&](int, int x) { sum += x; });
+  CAF_CHECK_EQUAL(sum, 999 * 1000);
+  auto capacity = tbl.capacity();
+  tbl.clear();
+  CAF_CHECK(tbl.empty());
+  CAF_CHECK_EQUAL(tbl.capacity(), capacity);
+  CAF_CHECK_EQUAL(tbl[42], 0);
+}
+
+CAF_TEST_FIXTURE_SCOPE(window_stage_tests, fixture)
+
+CAF_TEST(tumbling_windows) {
+  auto xs = iota_vec(0, 49);
+  run_pipeline(tumbling_window(milliseconds(10)), xs);
+  CAF_CHECK_EQUAL(collected, reference(xs, 10, 10));
+}
+
+CAF_TEST(sliding_windows) {
+  auto xs = iota_vec(0, 49);
+  run_pipeline(sliding_window(milliseconds(20), milliseconds(5)), xs);
+  CAF_CHECK_EQUAL(collected, reference(xs, 20, 5));
+}
+
+CAF_TEST(late_elements) {
+  CAF_MESSAGE("drop 3 after 25 closed the first window");
+  std::vector<int> xs{0, 1, 2, 4, 25, 3, 21, 9};
+  run_pipeline(tumbling_window(milliseconds(10)), xs);
+  CAF_CHECK_EQUAL(collected, reference({0, 1, 2, 4, 25, 21}, 10, 10));
+  CAF_MESSAGE("allowed lateness keeps the first window open");
+  run_pipeline(tumbling_window(milliseconds(10), milliseconds(20)), xs);
+  CAF_CHECK_EQUAL(collected, reference(xs, 10, 10));
+}
+
+CAF_TEST(event_time_gaps) {
+  CAF_MESSAGE("a gap of one day with 1ms panes closes only windows with data");
+  auto day = 24 * 60 * 60 * 1000;
+  std::vector<int> xs{0, 1, day};
+  run_pipeline(tumbling_window(milliseconds(1), milliseconds(5)), xs);
+  CAF_CHECK_EQUAL(collected, (window_sums{window_sum{0, 0, 0},
+                                          window_sum{1, 1, 1},
+                                          window_sum{day, day % 3, day}}));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
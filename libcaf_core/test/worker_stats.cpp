@@ -0,0 +1,117 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE worker_stats
+#include "caf/test/unit_test.hpp"
+
+#include "caf/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+behavior counter(event_based_actor* self, int remaining) {
+  return {
+    [=](int x) mutable {
+      if (--remaining == 0)
+        self->quit();
+      return x;
+    }
+  };
+}
+
+// sends `n` messages to each of `m` actors and waits for all of them
+void run_workload(actor_system& sys, int n, int m) {
+  {
+    scoped_actor self{sys};
+    std::vector<actor> xs;
+    for (int i = 0; i < m; ++i)
+      xs.push_back(sys.spawn(counter, n));
+    for (int i = 0; i < n; ++i)
+      for (auto& x : xs)
+        self->send(x, i);
+  }
+  sys.await_all_actors_done();
+}
+
+struct fixture {
+  fixture() {
+    cfg.scheduler_max_threads = 2;
+  }
+
+  actor_system_config cfg;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(worker_stats_tests, fixture)
+
+CAF_TEST(work_stealing) {
+  cfg.scheduler_policy = atom("stealing");
+  actor_system sys{cfg};
+  run_workload(sys, 100, 10);
+  auto xs = sys.scheduler().collect_worker_stats();
+  CAF_REQUIRE_EQUAL(xs.size(), 2u);
+  uint64_t resumed = 0;
+  for (size_t i = 0; i < xs.size(); ++i) {
+    CAF_CHECK_EQUAL(xs[i].worker_id, i);
+    resumed += xs[i].jobs_resumed;
+  }
+  CAF_CHECK_GREATER(resumed, 0u);
+  // all workers become idle eventually and start polling
+  for (auto i = 0; i < 100; ++i) {
+    xs = sys.scheduler().collect_worker_stats();
+    auto idle = [](const scheduler::worker_stats& x) {
+      return x.queue_length == 0 && x.aggressive_poll_ns > 0;
+    };
+    if (std::all_of(xs.begin(), xs.end(), idle))
+      break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  for (auto& x : xs) {
+    CAF_CHECK_EQUAL(x.queue_length, 0u);
+    CAF_CHECK_GREATER(x.aggressive_poll_ns, 0u);
+    // workers with idle time try to steal from each other
+    CAF_CHECK_GREATER(x.steals + x.failed_steals, 0u);
+  }
+}
+
+CAF_TEST(work_sharing) {
+  cfg.scheduler_policy = atom("sharing");
+  actor_system sys{cfg};
+  run_workload(sys, 100, 10);
+  auto xs = sys.scheduler().collect_worker_stats();
+  CAF_REQUIRE_EQUAL(xs.size(), 2u);
+  uint64_t resumed = 0;
+  for (auto& x : xs) {
+    resumed += x.jobs_resumed;
+    CAF_CHECK_EQUAL(x.steals + x.failed_steals, 0u);
+  }
+  CAF_CHECK_GREATER(resumed, 0u);
+}
+
+CAF_TEST(to_string) {
+  scheduler::worker_stats x{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  CAF_CHECK_EQUAL(deep_to_string(x),
+                  "worker_stats(1, 2, 3, 4, 5, 6, 7, 8, 9)");
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -89,6 +89,9 @@ public:
 
   void enqueue(strong_actor_ptr, message_id, message, execution_unit*) override;
 
+  void enqueue_batch(std::vector<mailbox_element_ptr>,
+                     execution_unit*) override;
+
   // -- overridden modifiers of local_actor ------------------------------------
 
   void launch(execution_unit* eu, bool lazy, bool hide) override;
@@ -23,6 +23,7 @@
 #include "caf/io/publish.hpp"
 #include "caf/io/broker.hpp"
 #include "caf/io/middleman.hpp"
+#include "caf/io/metrics_broker.hpp"
 #include "caf/io/unpublish.hpp"
 #include "caf/io/basp_broker.hpp"
 #include "caf/io/remote_actor.hpp"
@@ -73,6 +73,12 @@ struct header {
   /// Identifies a receiver by name rather than ID.
   static const uint8_t named_receiver_flag = 0x01;
 
+  /// Prefixes the payload of a `dispatch_message` with a `trace_context`. In
+  /// handshakes, announces that the sender accepts such messages. Nodes only
+  /// send trace contexts to peers that announced support, because BASP nodes
+  /// without tracing ignore this flag and would fail to parse the payload.
+  static const uint8_t trace_context_flag = 0x02;
+
   /// Queries whether this header has the given flag.
   inline bool has(uint8_t flag) const {
     return (flags & flag) != 0;
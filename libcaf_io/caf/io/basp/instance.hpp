@@ -20,7 +20,10 @@
 #ifndef CAF_IO_BASP_INSTANCE_HPP
 #define CAF_IO_BASP_INSTANCE_HPP
 
+#include <unordered_set>
+
 #include "caf/error.hpp"
+#include "caf/stream_msg.hpp"
 
 #include "caf/io/hook.hpp"
 #include "caf/io/middleman.hpp"
@@ -100,6 +103,24 @@ public:
     proxy_registry namespace_;
   };
 
+  /// Accumulates the time spent in the hot paths of the protocol. Profiling
+  /// is disabled by default and costs a single branch per call while off.
+  struct cpu_profile {
+    bool enabled = false;
+    /// Number of `handle` calls, i.e., one per header plus one per payload.
+    uint64_t handle_calls = 0;
+    /// Time spent in `handle`, including deserialization and delivery.
+    uint64_t handle_ns = 0;
+    /// Number of messages written via `write`.
+    uint64_t serialize_calls = 0;
+    /// Time spent serializing headers and payloads in `write`.
+    uint64_t serialize_ns = 0;
+    /// Number of received `dispatch_message` payloads.
+    uint64_t deserialize_calls = 0;
+    /// Time spent deserializing forwarding stack and content of messages.
+    uint64_t deserialize_ns = 0;
+  };
+
   /// Describes a function object responsible for writing
   /// the payload for a BASP message.
   using payload_writer = callback<serializer&>;
@@ -152,6 +173,15 @@ public:
                 const strong_actor_ptr& receiver,
                 message_id mid, const message& msg);
 
+  /// Writes all buffered `stream_msg::ack_batch` messages and flushes the
+  /// affected connections. Acknowledgements are held back by `dispatch`
+  /// in order to coalesce them and to piggyback them on other traffic to the
+  /// same node; the broker calls this function once it ran out of messages.
+  void flush_stream_acks(execution_unit* ctx);
+
+  /// Returns whether `msg` is a `stream_msg` carrying an `ack_batch`.
+  static bool is_stream_ack(const message& msg);
+
   /// Returns the actor namespace associated to this BASP protocol instance.
   proxy_registry& proxies() {
     return callee_.proxies();
@@ -207,6 +237,12 @@ public:
     return this_node_;
   }
 
+  /// Returns the CPU profile of this instance. Set `enabled` to start
+  /// collecting and reset the profile to start over.
+  inline cpu_profile& profile() {
+    return profile_;
+  }
+
   /// Invokes the callback(s) associated with given event.
   template <hook::event_type Event, typename... Ts>
   void notify(Ts&&... xs) {
@@ -218,10 +254,40 @@ public:
   }
 
 private:
+  /// An acknowledgement that awaits transmission.
+  struct pending_ack {
+    strong_actor_ptr sender;
+    strong_actor_ptr receiver;
+    message_id mid;
+    stream_msg content;
+  };
+
+  using pending_ack_list = std::vector<pending_ack>;
+
+  /// Traffic metrics for a single peer.
+  struct peer_metrics {
+    metrics::counter* bytes_received;
+    metrics::counter* bytes_sent;
+    metrics::counter* messages_received;
+    metrics::counter* messages_sent;
+  };
+
+  // returns the traffic metrics for `nid` or `nullptr` if disabled
+  peer_metrics* metrics_for(const node_id& nid);
+
+  // writes all pending acks for `nid` to `buf` without flushing
+  void write_stream_acks(execution_unit* ctx, buffer_type& buf,
+                         const node_id& nid, const node_id& next_hop);
+
   routing_table tbl_;
+  std::unordered_map<node_id, pending_ack_list> pending_acks_;
+  std::unordered_map<node_id, peer_metrics> peer_metrics_;
+  // direct peers that accept trace contexts in `dispatch_message`
+  std::unordered_set<node_id> trace_peers_;
   published_actor_map published_actors_;
   node_id this_node_;
   callee& callee_;
+  cpu_profile profile_;
 };
 
 /// @}
@@ -77,6 +77,15 @@ struct basp_broker_state : proxy_registry::backend, basp::instance::callee {
                strong_actor_ptr dest, message_id mid,
                std::vector<strong_actor_ptr>& stages, message& msg);
 
+  // holds back `ack_batch` messages from remote sinks while the connection
+  // to their node has more than `stream_buffer_limit` bytes of pending output
+  bool defer_stream_ack(const node_id& src_nid, strong_actor_ptr& src,
+                        strong_actor_ptr& dest, message_id mid,
+                        std::vector<strong_actor_ptr>& stages, message& msg);
+
+  // delivers all deferred acks for `hdl`
+  void release_stream_acks(connection_handle hdl);
+
   // performs bookkeeping such as managing `spawn_servers`
   void learned_new_node(const node_id& nid);
 
@@ -133,6 +142,15 @@ struct basp_broker_state : proxy_registry::backend, basp::instance::callee {
   // routing paths by forming a mesh between all nodes
   bool enable_automatic_connections = false;
 
+  // maximum number of pending bytes on a connection before we stop granting
+  // credit to local stream sources sending to that node, 0 disables throttling
+  size_t stream_buffer_limit;
+
+  using deferred_ack = std::pair<strong_actor_ptr, mailbox_element_ptr>;
+
+  // stores acks from remote sinks held back by `defer_stream_ack`
+  std::unordered_map<connection_handle, std::vector<deferred_ack>> deferred_acks;
+
   // returns the node identifier of the underlying BASP instance
   const node_id& this_node() const {
     return instance.this_node();
@@ -40,7 +40,9 @@ public:
       : hdl_(x),
         value_(strong_actor_ptr{}, message_id::make(),
                mailbox_element::forwarding_stack{}, SysMsgType{x, {}}) {
-    // nop
+    // I/O events never start a new trace, e.g., BASP messages carry the trace
+    // context of their sender in the payload
+    value_.trace = trace_context{0, 0, 0};
   }
 
   handle_type hdl() const {
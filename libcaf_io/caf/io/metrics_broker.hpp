@@ -0,0 +1,64 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_METRICS_BROKER_HPP
+#define CAF_IO_METRICS_BROKER_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "caf/behavior.hpp"
+#include "caf/stateful_actor.hpp"
+
+#include "caf/metrics/registry.hpp"
+
+#include "caf/io/broker.hpp"
+#include "caf/io/connection_handle.hpp"
+
+namespace caf {
+namespace io {
+
+/// Appends `xs` to `out` in the Prometheus text exposition format (version
+/// 0.0.4). Histograms only list non-empty buckets plus the `+Inf` bucket.
+void append_prometheus(std::string& out,
+                       const std::vector<metrics::snapshot>& xs);
+
+/// State of a `metrics_broker`.
+struct metrics_broker_state {
+  /// Maximum size of an HTTP request header in bytes.
+  static constexpr size_t max_request_size = 8192;
+
+  /// Stores incomplete requests per connection.
+  std::unordered_map<connection_handle, std::string> requests;
+
+  static const char* name;
+};
+
+/// A broker serving `GET /metrics` requests with the content of the metrics
+/// registry. Each response renders a fresh snapshot of the registry, i.e.,
+/// scraping never blocks actors or workers. Responds to any other request
+/// with an error and closes each connection after sending the response.
+/// @ingroup Broker
+behavior metrics_broker(stateful_actor<metrics_broker_state, broker>* self);
+
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_METRICS_BROKER_HPP
@@ -46,6 +46,12 @@ void abstract_broker::enqueue(mailbox_element_ptr ptr, execution_unit*) {
   scheduled_actor::enqueue(std::move(ptr), &backend());
 }
 
+void abstract_broker::enqueue_batch(std::vector<mailbox_element_ptr> xs,
+                                    execution_unit*) {
+  CAF_PUSH_AID(id());
+  scheduled_actor::enqueue_batch(std::move(xs), &backend());
+}
+
 void abstract_broker::launch(execution_unit* eu, bool lazy, bool hide) {
   CAF_ASSERT(eu != nullptr);
   CAF_ASSERT(eu == &backend());
@@ -51,7 +51,9 @@ basp_broker_state::basp_broker_state(broker* selfptr)
     : basp::instance::callee(selfptr->system(),
                              static_cast<proxy_registry::backend&>(*this)),
       self(selfptr),
-      instance(selfptr, *this) {
+      instance(selfptr, *this),
+      stream_buffer_limit(
+        selfptr->system().config().middleman_stream_buffer_limit) {
   CAF_ASSERT(this_node() != none);
 }
 
@@ -284,11 +286,53 @@ void basp_broker_state::deliver(const node_id& src_nid, actor_id src_aid,
     return;
   }
   self->parent().notify<hook::message_received>(src_nid, src, dest, mid, msg);
+  if (defer_stream_ack(src_nid, src, dest, mid, stages, msg))
+    return;
   dest->enqueue(make_mailbox_element(std::move(src), mid, std::move(stages),
                                       std::move(msg)),
                 nullptr);
 }
 
+bool basp_broker_state::defer_stream_ack(const node_id& src_nid,
+                                         strong_actor_ptr& src,
+                                         strong_actor_ptr& dest,
+                                         message_id mid,
+                                         std::vector<strong_actor_ptr>& stages,
+                                         message& msg) {
+  if (stream_buffer_limit == 0 || src_nid == this_node()
+      || !basp::instance::is_stream_ack(msg))
+    return false;
+  auto path = instance.tbl().lookup(src_nid);
+  if (!path)
+    return false;
+  // once we defer acks on a connection we keep doing so until the output
+  // drained in order to not reorder acks of the same stream
+  auto i = deferred_acks.find(path->hdl);
+  if (i == deferred_acks.end()) {
+    if (path->wr_buf.size() <= stream_buffer_limit)
+      return false;
+    CAF_LOG_DEBUG("throttle remote stream:" << CAF_ARG(src_nid)
+                  << CAF_ARG(path->wr_buf.size()));
+    self->ack_writes(path->hdl, true);
+    i = deferred_acks.emplace(path->hdl, std::vector<deferred_ack>{}).first;
+  }
+  i->second.emplace_back(dest, make_mailbox_element(std::move(src), mid,
+                                                    std::move(stages),
+                                                    std::move(msg)));
+  return true;
+}
+
+void basp_broker_state::release_stream_acks(connection_handle hdl) {
+  auto i = deferred_acks.find(hdl);
+  if (i == deferred_acks.end())
+    return;
+  CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG(i->second.size()));
+  for (auto& x : i->second)
+    x.first->enqueue(std::move(x.second), nullptr);
+  deferred_acks.erase(i);
+  self->ack_writes(hdl, false);
+}
+
 void basp_broker_state::learned_new_node(const node_id& nid) {
   CAF_LOG_TRACE(CAF_ARG(nid));
   if (spawn_servers.count(nid) > 0) {
@@ -588,8 +632,15 @@ behavior basp_broker::make_behavior() {
       configure_read(msg.handle, receive_policy::exactly(basp::header_size));
     },
     // received from underlying broker implementation
+    [=](const data_transferred_msg& msg) {
+      CAF_LOG_TRACE(CAF_ARG(msg.handle) << CAF_ARG(msg.remaining));
+      if (msg.remaining <= state.stream_buffer_limit)
+        state.release_stream_acks(msg.handle);
+    },
+    // received from underlying broker implementation
     [=](const connection_closed_msg& msg) {
       CAF_LOG_TRACE(CAF_ARG(msg.handle));
+      state.deferred_acks.erase(msg.handle);
       // TODO: currently we assume a node has gone offline once we lose
       //       a connection, we also could try to reach this node via other
       //       hops to be resilient to (rare) network failures or if a
@@ -696,7 +747,11 @@ resumable::resume_result basp_broker::resume(execution_unit* ctx, size_t mt) {
   auto guard = detail::make_scope_guard([=] {
     ctx->proxy_registry_ptr(nullptr);
   });
-  return super::resume(ctx, mt);
+  auto result = super::resume(ctx, mt);
+  // our state gets destroyed on termination
+  if (result != resumable::done)
+    state.instance.flush_stream_acks(ctx);
+  return result;
 }
 
 proxy_registry* basp_broker::proxy_registry_ptr() {
@@ -19,17 +19,56 @@
 
 #include "caf/io/basp/instance.hpp"
 
+#include <chrono>
+#include <algorithm>
+
 #include "caf/streambuf.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/binary_deserializer.hpp"
 #include "caf/actor_system_config.hpp"
 
+#include "caf/detail/tracer.hpp"
+
 #include "caf/io/basp/version.hpp"
 
 namespace caf {
 namespace io {
 namespace basp {
 
+namespace {
+
+// adds the time between construction and destruction to `ns` and increments
+// `calls` if `enabled` is set, reads no clock otherwise
+class profile_scope {
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  profile_scope(bool enabled, uint64_t& calls, uint64_t& ns)
+      : enabled_(enabled),
+        calls_(calls),
+        ns_(ns) {
+    if (enabled_)
+      t0_ = clock_type::now();
+  }
+
+  ~profile_scope() {
+    if (!enabled_)
+      return;
+    auto t1 = clock_type::now();
+    ++calls_;
+    ns_ += static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0_).count());
+  }
+
+private:
+  bool enabled_;
+  uint64_t& calls_;
+  uint64_t& ns_;
+  clock_type::time_point t0_;
+};
+
+} // namespace <anonymous>
+
 instance::callee::callee(actor_system& sys, proxy_registry::backend& backend)
     : namespace_(sys, backend) {
   // nop
@@ -50,9 +89,12 @@ connection_state instance::handle(execution_unit* ctx,
                                   new_data_msg& dm, header& hdr,
                                   bool is_payload) {
   CAF_LOG_TRACE(CAF_ARG(dm) << CAF_ARG(is_payload));
+  profile_scope prof{profile_.enabled, profile_.handle_calls,
+                     profile_.handle_ns};
   // function object providing cleanup code on errors
   auto err = [&]() -> connection_state {
     auto cb = make_callback([&](const node_id& nid) -> error {
+      pending_acks_.erase(nid);
       callee_.purge_state(nid);
       return none;
     });
@@ -79,6 +121,11 @@ connection_state instance::handle(execution_unit* ctx,
     }
   }
   CAF_LOG_DEBUG(CAF_ARG(hdr));
+  auto pm = metrics_for(hdr.source_node);
+  if (pm != nullptr) {
+    pm->bytes_received->inc(basp::header_size + hdr.payload_len);
+    pm->messages_received->inc();
+  }
   // needs forwarding?
   if (!is_handshake(hdr) && !is_heartbeat(hdr) && hdr.dest_node != this_node_) {
     CAF_LOG_DEBUG("forward message");
@@ -151,6 +198,8 @@ connection_state instance::handle(execution_unit* ctx,
       // add direct route to this node and remove any indirect entry
       CAF_LOG_INFO("new direct connection:" << CAF_ARG(hdr.source_node));
       tbl_.add_direct(dm.handle, hdr.source_node);
+      if (hdr.has(header::trace_context_flag))
+        trace_peers_.emplace(hdr.source_node);
       auto was_indirect = tbl_.erase_indirect(hdr.source_node);
       // write handshake as client in response
       auto path = tbl_.lookup(hdr.source_node);
@@ -187,6 +236,8 @@ connection_state instance::handle(execution_unit* ctx,
       // add direct route to this node and remove any indirect entry
       CAF_LOG_INFO("new direct connection:" << CAF_ARG(hdr.source_node));
       tbl_.add_direct(dm.handle, hdr.source_node);
+      if (hdr.has(header::trace_context_flag))
+        trace_peers_.emplace(hdr.source_node);
       auto was_indirect = tbl_.erase_indirect(hdr.source_node);
       callee_.learned_new_node_directly(hdr.source_node, was_indirect);
       break;
@@ -207,15 +258,29 @@ connection_state instance::handle(execution_unit* ctx,
       auto receiver_name = static_cast<atom_value>(0);
       std::vector<strong_actor_ptr> forwarding_stack;
       message msg;
+      // messages without trace context never start a new trace, because the
+      // sending node already decided against sampling them
+      trace_context trace{0, 0, 0};
+      if (hdr.has(header::trace_context_flag)) {
+        auto e = bd(trace);
+        if (e)
+          return err();
+      }
       if (hdr.has(header::named_receiver_flag)) {
         auto e = bd(receiver_name);
         if (e)
           return err();
       }
-      auto e = bd(forwarding_stack, msg);
+      error e;
+      {
+        profile_scope dprof{profile_.enabled, profile_.deserialize_calls,
+                            profile_.deserialize_ns};
+        e = bd(forwarding_stack, msg);
+      }
       if (e)
         return err();
       CAF_LOG_DEBUG(CAF_ARG(forwarding_stack) << CAF_ARG(msg));
+      detail::trace_scope scope{&trace};
       if (hdr.has(header::named_receiver_flag))
         callee_.deliver(hdr.source_node, hdr.source_actor, receiver_name,
                         message_id::from_integer_value(hdr.operation_data),
@@ -268,6 +333,8 @@ void instance::handle_node_shutdown(const node_id& affected_node) {
     return;
   CAF_LOG_INFO("lost direct connection:" << CAF_ARG(affected_node));
   auto cb = make_callback([&](const node_id& nid) -> error {
+    pending_acks_.erase(nid);
+    trace_peers_.erase(nid);
     callee_.purge_state(nid);
     return none;
   });
@@ -355,11 +422,45 @@ bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
     notify<hook::message_sending_failed>(sender, receiver, mid, msg);
     return false;
   }
+  if (sender && forwarding_stack.empty() && is_stream_ack(msg)) {
+    // hold back acks until we run out of messages or until we have other
+    // traffic for the same node, merging all acks for the same path
+    auto& sm = msg.get_as<stream_msg>(0);
+    auto& x = get<stream_msg::ack_batch>(sm.content);
+    auto& acks = pending_acks_[receiver->node()];
+    auto pred = [&](const pending_ack& y) {
+      return y.sender == sender && y.receiver == receiver
+             && y.mid == mid && y.content.sid == sm.sid;
+    };
+    auto i = std::find_if(acks.begin(), acks.end(), pred);
+    if (i == acks.end()) {
+      acks.push_back(pending_ack{sender, receiver, mid, sm});
+    } else {
+      auto& y = get<stream_msg::ack_batch>(i->content.content);
+      y.new_capacity += x.new_capacity;
+      y.acknowledged_id = std::max(y.acknowledged_id, x.acknowledged_id);
+    }
+    return true;
+  }
+  // pending acks for this node precede this message to preserve ordering
+  write_stream_acks(ctx, path->wr_buf, receiver->node(), path->next_hop);
+  // only sampled messages carry their trace context over the network and only
+  // to direct peers that announced support for it during the handshake
+  auto trace = detail::current_trace_context();
+  uint8_t flags = 0;
+  if (trace != nullptr && trace->sampled()
+      && trace_peers_.count(receiver->node()) > 0)
+    flags = header::trace_context_flag;
   auto writer = make_callback([&](serializer& sink) -> error {
+    if (flags != 0) {
+      auto e = sink(const_cast<trace_context&>(*trace));
+      if (e)
+        return e;
+    }
     return sink(const_cast<std::vector<strong_actor_ptr>&>(forwarding_stack),
                 const_cast<message&>(msg));
   });
-  header hdr{message_type::dispatch_message, 0, 0, mid.integer_value(),
+  header hdr{message_type::dispatch_message, flags, 0, mid.integer_value(),
              sender ? sender->node() : this_node(), receiver->node(),
              sender ? sender->id() : invalid_actor_id, receiver->id()};
   write(ctx, path->wr_buf, hdr, &writer);
@@ -368,12 +469,58 @@ bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
   return true;
 }
 
+void instance::flush_stream_acks(execution_unit* ctx) {
+  CAF_LOG_TRACE(CAF_ARG(pending_acks_.size()));
+  while (!pending_acks_.empty()) {
+    auto i = pending_acks_.begin();
+    auto nid = i->first;
+    auto path = lookup(nid);
+    if (!path) {
+      for (auto& x : i->second)
+        notify<hook::message_sending_failed>(x.sender, x.receiver, x.mid,
+                                             make_message(x.content));
+      pending_acks_.erase(i);
+      continue;
+    }
+    write_stream_acks(ctx, path->wr_buf, nid, path->next_hop);
+    flush(*path);
+  }
+}
+
+bool instance::is_stream_ack(const message& msg) {
+  return msg.match_elements<stream_msg>()
+         && holds_alternative<stream_msg::ack_batch>(
+              msg.get_as<stream_msg>(0).content);
+}
+
+void instance::write_stream_acks(execution_unit* ctx, buffer_type& buf,
+                                 const node_id& nid, const node_id& next_hop) {
+  auto i = pending_acks_.find(nid);
+  if (i == pending_acks_.end())
+    return;
+  CAF_LOG_TRACE(CAF_ARG(nid) << CAF_ARG(i->second.size()));
+  std::vector<strong_actor_ptr> stages;
+  for (auto& x : i->second) {
+    auto msg = make_message(std::move(x.content));
+    auto writer = make_callback([&](serializer& sink) -> error {
+      return sink(stages, msg);
+    });
+    header hdr{message_type::dispatch_message, 0, 0, x.mid.integer_value(),
+               x.sender->node(), nid, x.sender->id(), x.receiver->id()};
+    write(ctx, buf, hdr, &writer);
+    notify<hook::message_sent>(x.sender, next_hop, x.receiver, x.mid, msg);
+  }
+  pending_acks_.erase(i);
+}
+
 void instance::write(execution_unit* ctx, buffer_type& buf,
                      header& hdr, payload_writer* pw) {
   CAF_LOG_TRACE(CAF_ARG(hdr));
+  profile_scope prof{profile_.enabled, profile_.serialize_calls,
+                     profile_.serialize_ns};
   error err;
+  auto pos = buf.size();
   if (pw != nullptr) {
-    auto pos = buf.size();
     // write payload first (skip first 72 bytes and write header later)
     char placeholder[basp::header_size];
     buf.insert(buf.end(), std::begin(placeholder), std::end(placeholder));
@@ -388,8 +535,36 @@ void instance::write(execution_unit* ctx, buffer_type& buf,
     binary_serializer bs{ctx, buf};
     err = bs(hdr);
   }
-  if (err)
+  if (err) {
     CAF_LOG_ERROR(CAF_ARG(err));
+    return;
+  }
+  auto pm = metrics_for(hdr.dest_node);
+  if (pm != nullptr) {
+    pm->bytes_sent->inc(buf.size() - pos);
+    pm->messages_sent->inc();
+  }
+}
+
+instance::peer_metrics* instance::metrics_for(const node_id& nid) {
+  if (system().metrics().runtime() == nullptr)
+    return nullptr;
+  auto i = peer_metrics_.find(nid);
+  if (i != peer_metrics_.end())
+    return &i->second;
+  auto& reg = system().metrics();
+  auto labels = "peer=\"" + to_string(nid) + "\"";
+  peer_metrics pm{
+    &reg.get_counter("caf_basp_bytes_received_total", labels,
+                     "Bytes received from a BASP peer."),
+    &reg.get_counter("caf_basp_bytes_sent_total", labels,
+                     "Bytes sent to a BASP peer."),
+    &reg.get_counter("caf_basp_messages_received_total", labels,
+                     "BASP messages received from a peer."),
+    &reg.get_counter("caf_basp_messages_sent_total", labels,
+                     "BASP messages sent to a peer.")
+  };
+  return &peer_metrics_.emplace(nid, pm).first->second;
 }
 
 void instance::write_server_handshake(execution_unit* ctx,
@@ -417,8 +592,8 @@ void instance::write_server_handshake(execution_unit* ctx,
     std::set<std::string> tmp;
     return sink(aid, tmp);
   });
-  header hdr{message_type::server_handshake, 0, 0, version,
-             this_node_, none,
+  header hdr{message_type::server_handshake, header::trace_context_flag, 0,
+             version, this_node_, none,
              (pa != nullptr) && pa->first ? pa->first->id() : invalid_actor_id,
              invalid_actor_id};
   write(ctx, out_buf, hdr, &writer);
@@ -432,7 +607,7 @@ void instance::write_client_handshake(execution_unit* ctx,
     auto& str = callee_.system().config().middleman_app_identifier;
     return sink(const_cast<std::string&>(str));
   });
-  header hdr{message_type::client_handshake, 0, 0, 0,
+  header hdr{message_type::client_handshake, header::trace_context_flag, 0, 0,
              this_node_, remote_side, invalid_actor_id, invalid_actor_id};
   write(ctx, buf, hdr, &writer);
 }
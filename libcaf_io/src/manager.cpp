@@ -60,7 +60,7 @@ void manager::detach(execution_unit*, bool invoke_disconnect_message) {
           raw_ptr->finalize();
           break;
         case im_skipped:
-          raw_ptr->push_to_cache(std::move(mptr));
+          raw_ptr->stash(std::move(mptr));
           break;
         case im_dropped:
           CAF_LOG_INFO("broker dropped disconnect message");
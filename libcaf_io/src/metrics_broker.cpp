@@ -0,0 +1,193 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/metrics_broker.hpp"
+
+#include <cstring>
+
+#include "caf/logger.hpp"
+#include "caf/actor_system.hpp"
+
+#include "caf/io/system_messages.hpp"
+
+namespace caf {
+namespace io {
+
+namespace {
+
+constexpr char request_end[] = "\r\n\r\n";
+
+constexpr char metrics_path[] = "/metrics";
+
+void append_labels(std::string& out, const std::string& labels,
+                   const char* extra_key = nullptr,
+                   const std::string& extra_value = "") {
+  if (labels.empty() && extra_key == nullptr)
+    return;
+  out += '{';
+  out += labels;
+  if (extra_key != nullptr) {
+    if (!labels.empty())
+      out += ',';
+    out += extra_key;
+    out += "=\"";
+    out += extra_value;
+    out += '"';
+  }
+  out += '}';
+}
+
+void append_help(std::string& out, const std::string& help) {
+  for (auto c : help) {
+    switch (c) {
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      default:
+        out += c;
+    }
+  }
+}
+
+void append_sample(std::string& out, const std::string& name,
+                   const char* suffix, const std::string& labels,
+                   const std::string& value, const char* extra_key = nullptr,
+                   const std::string& extra_value = "") {
+  out += name;
+  out += suffix;
+  append_labels(out, labels, extra_key, extra_value);
+  out += ' ';
+  out += value;
+  out += '\n';
+}
+
+void respond(stateful_actor<metrics_broker_state, broker>* self,
+             connection_handle hdl, const char* status,
+             const std::string& body) {
+  auto& out = self->wr_buf(hdl);
+  std::string header = "HTTP/1.1 ";
+  header += status;
+  header += "\r\nContent-Type: text/plain; version=0.0.4\r\n"
+            "Content-Length: ";
+  header += std::to_string(body.size());
+  header += "\r\nConnection: close\r\n\r\n";
+  out.insert(out.end(), header.begin(), header.end());
+  out.insert(out.end(), body.begin(), body.end());
+  self->flush(hdl);
+  self->close(hdl);
+  self->state.requests.erase(hdl);
+}
+
+} // namespace <anonymous>
+
+void append_prometheus(std::string& out,
+                       const std::vector<metrics::snapshot>& xs) {
+  using std::to_string;
+  const std::string* prev_name = nullptr;
+  for (auto& x : xs) {
+    // snapshots are sorted by name, i.e., all labeled variants of a metric
+    // share a single HELP and TYPE line
+    if (prev_name == nullptr || *prev_name != x.name) {
+      prev_name = &x.name;
+      if (!x.help.empty()) {
+        out += "# HELP ";
+        out += x.name;
+        out += ' ';
+        append_help(out, x.help);
+        out += '\n';
+      }
+      out += "# TYPE ";
+      out += x.name;
+      out += ' ';
+      out += to_string(x.type);
+      out += '\n';
+    }
+    if (x.type != metrics::metric_type::histogram) {
+      append_sample(out, x.name, "", x.labels, to_string(x.value));
+      continue;
+    }
+    uint64_t total = 0;
+    for (size_t i = 0; i < x.buckets.size(); ++i) {
+      if (x.buckets[i] == 0)
+        continue;
+      total += x.buckets[i];
+      append_sample(out, x.name, "_bucket", x.labels, to_string(total), "le",
+                    to_string(metrics::histogram::upper_bound(i)));
+    }
+    auto count = to_string(x.value);
+    append_sample(out, x.name, "_bucket", x.labels, count, "le", "+Inf");
+    append_sample(out, x.name, "_sum", x.labels, to_string(x.sum));
+    append_sample(out, x.name, "_count", x.labels, count);
+  }
+}
+
+const char* metrics_broker_state::name = "metrics_broker";
+
+constexpr size_t metrics_broker_state::max_request_size;
+
+behavior metrics_broker(stateful_actor<metrics_broker_state, broker>* self) {
+  return {
+    [=](const new_connection_msg& msg) {
+      CAF_LOG_TRACE(CAF_ARG(msg));
+      self->configure_read(msg.handle, receive_policy::at_most(1024));
+    },
+    [=](const new_data_msg& msg) {
+      auto& req = self->state.requests[msg.handle];
+      req.insert(req.end(), msg.buf.begin(), msg.buf.end());
+      auto eoh = req.find(request_end);
+      if (eoh == std::string::npos) {
+        if (req.size() > metrics_broker_state::max_request_size)
+          respond(self, msg.handle, "431 Request Header Fields Too Large", "");
+        return;
+      }
+      // we only look at the request line, e.g., "GET /metrics HTTP/1.1"
+      auto line = req.substr(0, req.find("\r\n"));
+      auto sp1 = line.find(' ');
+      auto sp2 = line.find(' ', sp1 == std::string::npos ? sp1 : sp1 + 1);
+      if (sp1 == std::string::npos || sp2 == std::string::npos) {
+        respond(self, msg.handle, "400 Bad Request", "");
+        return;
+      }
+      if (line.compare(0, sp1, "GET") != 0) {
+        respond(self, msg.handle, "405 Method Not Allowed", "");
+        return;
+      }
+      auto path = line.substr(sp1 + 1, sp2 - sp1 - 1);
+      if (path != metrics_path) {
+        respond(self, msg.handle, "404 Not Found", "");
+        return;
+      }
+      std::string body;
+      append_prometheus(body, self->system().metrics().collect());
+      respond(self, msg.handle, "200 OK", body);
+    },
+    [=](const connection_closed_msg& msg) {
+      self->state.requests.erase(msg.handle);
+    },
+    [=](const acceptor_closed_msg&) {
+      self->quit();
+    }
+  };
+}
+
+} // namespace io
+} // namespace caf
@@ -24,6 +24,7 @@
 #include <memory>
 #include <cstring>
 #include <sstream>
+#include <iostream>
 #include <stdexcept>
 
 #include "caf/sec.hpp"
@@ -44,6 +45,7 @@
 #include "caf/typed_event_based_actor.hpp"
 
 #include "caf/io/basp_broker.hpp"
+#include "caf/io/metrics_broker.hpp"
 #include "caf/io/system_messages.hpp"
 
 #include "caf/io/network/interfaces.hpp"
@@ -275,6 +277,17 @@ void middleman::start() {
   auto basp = named_broker<basp_broker>(atom("BASP"));
   manager_ = make_middleman_actor(system(), basp);
   auto hdl = actor_cast<actor>(basp);
+  // Serve metrics if configured. The broker shuts down with all other named
+  // brokers of the middleman.
+  auto metrics_port = system().config().middleman_metrics_port;
+  if (metrics_port != 0) {
+    auto res = spawn_server<hidden>(metrics_broker, metrics_port);
+    if (res)
+      named_brokers_.emplace(atom("MetricsSrv"), std::move(*res));
+    else
+      std::cerr << "[WARNING] cannot serve metrics on port " << metrics_port
+                << ": " << system().render(res.error()) << std::endl;
+  }
 }
 
 void middleman::stop() {
@@ -35,6 +35,8 @@
 
 #include "caf/deep_to_string.hpp"
 
+#include "caf/detail/tracer.hpp"
+
 #include "caf/io/network/interfaces.hpp"
 #include "caf/io/network/test_multiplexer.hpp"
 
@@ -278,7 +280,8 @@ public:
   void connect_node(node& n,
                     optional<accept_handle> ax = none,
                     actor_id published_actor_id = invalid_actor_id,
-                    const set<string>& published_actor_ifs = std::set<std::string>{}) {
+                    const set<string>& published_actor_ifs = std::set<std::string>{},
+                    uint8_t handshake_flags = 0) {
     auto src = ax ? *ax : ahdl_;
     CAF_MESSAGE("connect remote node " << n.name
                 << ", connection ID = " << n.connection.id()
@@ -289,11 +292,12 @@ public:
     // technically, the server handshake arrives
     // before we send the client handshake
     mock(hdl,
-         {basp::message_type::client_handshake, 0, 0, 0,
+         {basp::message_type::client_handshake, handshake_flags, 0, 0,
           n.id, this_node(),
           invalid_actor_id, invalid_actor_id}, std::string{})
     .receive(hdl,
-            basp::message_type::server_handshake, no_flags,
+            basp::message_type::server_handshake,
+            basp::header::trace_context_flag,
             any_vals, basp::version, this_node(), node_id{none},
             published_actor_id, invalid_actor_id, std::string{},
             published_actor_id,
@@ -488,7 +492,8 @@ CAF_TEST(empty_server_handshake) {
   basp::header hdr;
   buffer payload;
   std::tie(hdr, payload) = from_buf(buf);
-  basp::header expected{basp::message_type::server_handshake, 0,
+  basp::header expected{basp::message_type::server_handshake,
+                        basp::header::trace_context_flag,
                         static_cast<uint32_t>(payload.size()),
                         basp::version,
                         this_node(), none,
@@ -506,7 +511,8 @@ CAF_TEST(non_empty_server_handshake) {
                                  {"caf::replies_to<@u16>::with<@u16>"});
   instance().write_server_handshake(mpx(), buf, uint16_t{4242});
   buffer expected_buf;
-  basp::header expected{basp::message_type::server_handshake, 0, 0,
+  basp::header expected{basp::message_type::server_handshake,
+                        basp::header::trace_context_flag, 0,
                         basp::version, this_node(), none,
                         self()->id(), invalid_actor_id};
   to_buf(expected_buf, expected, nullptr, std::string{},
@@ -621,7 +627,8 @@ CAF_TEST(remote_actor_and_send) {
        jupiter().dummy_actor->id(),
        uint32_t{0})
   .receive(jupiter().connection,
-          basp::message_type::client_handshake, no_flags, 1u,
+          basp::message_type::client_handshake,
+          basp::header::trace_context_flag, 1u,
           no_operation_data, this_node(), jupiter().id,
           invalid_actor_id, invalid_actor_id, std::string{})
   .receive(jupiter().connection,
@@ -724,6 +731,86 @@ CAF_TEST(actor_serialize_and_deserialize) {
           std::vector<actor_id>{}, msg);
 }
 
+CAF_TEST(stream_ack_coalescing) {
+  connect_node(jupiter());
+  auto prx = proxies().get_or_put(jupiter().id, jupiter().dummy_actor->id());
+  mock()
+  .receive(jupiter().connection,
+          basp::message_type::announce_proxy, no_flags, no_payload,
+          no_operation_data, this_node(), prx->node(),
+          invalid_actor_id, prx->id());
+  stream_id sid{self()->address(), 1};
+  auto src = actor_cast<strong_actor_ptr>(self());
+  std::vector<strong_actor_ptr> stages;
+  auto& buf = mpx()->output_buffer(jupiter().connection);
+  auto ack = [&](int32_t capacity, int64_t id) {
+    return make_message(make<stream_msg::ack_batch>(sid, self()->address(),
+                                                    capacity, id));
+  };
+  CAF_MESSAGE("BASP holds back acks until flushing them explicitly");
+  instance().dispatch(mpx(), src, stages, prx, message_id::make(), ack(1, 0));
+  CAF_CHECK(buf.empty());
+  instance().flush_stream_acks(mpx());
+  mock()
+  .receive(jupiter().connection,
+          basp::message_type::dispatch_message, no_flags, any_vals,
+          no_operation_data, this_node(), prx->node(),
+          self()->id(), prx->id(),
+          std::vector<actor_id>{}, ack(1, 0));
+  CAF_CHECK(buf.empty());
+  CAF_MESSAGE("BASP merges acks and puts them in front of other messages");
+  instance().dispatch(mpx(), src, stages, prx, message_id::make(), ack(3, 1));
+  instance().dispatch(mpx(), src, stages, prx, message_id::make(), ack(4, 2));
+  CAF_CHECK(buf.empty());
+  instance().dispatch(mpx(), src, stages, prx, message_id::make(),
+                      make_message(42));
+  mock()
+  .receive(jupiter().connection,
+          basp::message_type::dispatch_message, no_flags, any_vals,
+          no_operation_data, this_node(), prx->node(),
+          self()->id(), prx->id(),
+          std::vector<actor_id>{}, ack(7, 2))
+  .receive(jupiter().connection,
+          basp::message_type::dispatch_message, no_flags, any_vals,
+          no_operation_data, this_node(), prx->node(),
+          self()->id(), prx->id(),
+          std::vector<actor_id>{}, make_message(42));
+  CAF_CHECK(buf.empty());
+}
+
+CAF_TEST(stream_ack_throttling) {
+  connect_node(jupiter());
+  auto prx = proxies().get_or_put(jupiter().id, jupiter().dummy_actor->id());
+  auto& buf = mpx()->output_buffer(jupiter().connection);
+  aut()->state.stream_buffer_limit = 1000;
+  CAF_MESSAGE("simulate a backlog of 2000 bytes towards Jupiter");
+  buf.resize(2000);
+  stream_id sid{self()->address(), 1};
+  auto ack = make<stream_msg::ack_batch>(sid, prx->address(), 10, int64_t{1});
+  mock(jupiter().connection,
+       {basp::message_type::dispatch_message, 0, 0, 0,
+        prx->node(), this_node(), prx->id(), self()->id()},
+       std::vector<actor_id>{},
+       make_message(ack));
+  CAF_MESSAGE("BASP holds back the ack while the backlog exceeds the limit");
+  CAF_CHECK_EQUAL(aut()->state.deferred_acks.size(), 1u);
+  CAF_CHECK(mpx()->ack_writes(jupiter().connection));
+  CAF_MESSAGE("BASP releases the ack after the backlog drained");
+  buf.clear();
+  anon_send(actor_cast<actor>(aut()),
+            data_transferred_msg{jupiter().connection, 2000u, 0u});
+  mpx()->flush_runnables();
+  CAF_CHECK(aut()->state.deferred_acks.empty());
+  CAF_CHECK(!mpx()->ack_writes(jupiter().connection));
+  self()->receive(
+    [&](const stream_msg& x) {
+      CAF_REQUIRE(is<stream_msg::ack_batch>(x));
+      CAF_CHECK_EQUAL(get<stream_msg::ack_batch>(x).new_capacity, 10);
+      CAF_CHECK_EQUAL(x.sid, sid);
+    }
+  );
+}
+
 CAF_TEST(indirect_connections) {
   // this node receives a message from jupiter via mars and responds via mars
   // and any ad-hoc automatic connection requests are ignored
@@ -774,6 +861,53 @@ CAF_TEST(indirect_connections) {
           make_message("hello from earth!"));
 }
 
+CAF_TEST(trace_context_negotiation) {
+  // Jupiter runs a BASP version without tracing and ignores the flag in our
+  // handshake, while Mars announces support for trace contexts
+  connect_node(jupiter());
+  auto jprx = proxies().get_or_put(jupiter().id, jupiter().dummy_actor->id());
+  mock()
+  .receive(jupiter().connection,
+          basp::message_type::announce_proxy, no_flags, no_payload,
+          no_operation_data, this_node(), jupiter().id,
+          invalid_actor_id, jupiter().dummy_actor->id());
+  connect_node(mars(), none, invalid_actor_id, std::set<std::string>{},
+               basp::header::trace_context_flag);
+  auto mprx = proxies().get_or_put(mars().id, mars().dummy_actor->id());
+  mock()
+  .receive(mars().connection,
+          basp::message_type::announce_proxy, no_flags, no_payload,
+          no_operation_data, this_node(), mars().id,
+          invalid_actor_id, mars().dummy_actor->id());
+  CAF_MESSAGE("send a sampled message to both nodes");
+  trace_context trace{1, 2, trace_context::sampled_flag};
+  { // lifetime scope of guard
+    detail::trace_scope guard{&trace};
+    instance().dispatch(mpx(), nullptr, {}, jprx, message_id::make(),
+                        make_message(42));
+    instance().dispatch(mpx(), nullptr, {}, mprx, message_id::make(),
+                        make_message(42));
+  }
+  CAF_MESSAGE("Jupiter receives the message without trace context");
+  mock()
+  .receive(jupiter().connection,
+          basp::message_type::dispatch_message, no_flags, any_vals,
+          no_operation_data, this_node(), jupiter().id,
+          invalid_actor_id, jupiter().dummy_actor->id(),
+          std::vector<actor_id>{},
+          make_message(42));
+  CAF_MESSAGE("Mars receives the message with trace context");
+  mock()
+  .receive(mars().connection,
+          basp::message_type::dispatch_message,
+          basp::header::trace_context_flag, any_vals,
+          no_operation_data, this_node(), mars().id,
+          invalid_actor_id, mars().dummy_actor->id(),
+          trace,
+          std::vector<actor_id>{},
+          make_message(42));
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
 
 CAF_TEST_FIXTURE_SCOPE(basp_tests_with_autoconn, autoconn_enabled_fixture)
@@ -856,7 +990,8 @@ CAF_TEST(automatic_connection) {
        jupiter().dummy_actor->id(),
        uint32_t{0})
   .receive(jupiter().connection,
-          basp::message_type::client_handshake, no_flags, 1u,
+          basp::message_type::client_handshake,
+          basp::header::trace_context_flag, 1u,
           no_operation_data, this_node(), jupiter().id,
           invalid_actor_id, invalid_actor_id, std::string{});
   CAF_CHECK_EQUAL(tbl().lookup_indirect(jupiter().id), none);
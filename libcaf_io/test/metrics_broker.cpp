@@ -0,0 +1,183 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2017                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE io_metrics_broker
+#include "caf/test/unit_test.hpp"
+
+#include <string>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+constexpr char http_get_metrics[] = "GET /metrics HTTP/1.1\r\n"
+                                    "Host: localhost\r\n"
+                                    "Accept: text/plain\r\n"
+                                    "\r\n";
+
+class config : public actor_system_config {
+public:
+  config() {
+    metrics_enable_runtime = true;
+    load<io::middleman, network::test_multiplexer>();
+  }
+};
+
+class fixture {
+public:
+  fixture() : system(cfg) {
+    mpx_ = dynamic_cast<network::test_multiplexer*>(&system.middleman().backend());
+    CAF_REQUIRE(mpx_ != nullptr);
+    aut_ = system.middleman().spawn_broker(metrics_broker);
+    auto ptr = static_cast<abstract_broker*>(actor_cast<abstract_actor*>(aut_));
+    ptr->add_doorman(mpx_->new_doorman(acceptor_, 1u));
+    mpx_->add_pending_connect(acceptor_, connection_);
+    mpx_->accept_connection(acceptor_);
+  }
+
+  ~fixture() {
+    anon_send_exit(aut_, exit_reason::kill);
+    mpx_->flush_runnables();
+  }
+
+  void send(const std::string& str) {
+    mpx_->virtual_send(connection_, std::vector<char>{str.begin(), str.end()});
+  }
+
+  std::string output() {
+    auto& buf = mpx_->output_buffer(connection_);
+    std::string result{buf.begin(), buf.end()};
+    buf.clear();
+    return result;
+  }
+
+  bool closed() {
+    return mpx_->stopped_reading(connection_);
+  }
+
+  config cfg;
+  actor_system system;
+  actor aut_;
+  network::test_multiplexer* mpx_;
+  accept_handle acceptor_ = accept_handle::from_int(1);
+  connection_handle connection_ = connection_handle::from_int(1);
+};
+
+bool starts_with(const std::string& str, const std::string& prefix) {
+  return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool contains(const std::string& str, const std::string& x) {
+  return str.find(x) != std::string::npos;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(prometheus_format) {
+  metrics::registry reg;
+  reg.get_counter("requests_total", "path=\"/a\"", "Requests per path.").inc(2);
+  reg.get_counter("requests_total", "path=\"/b\"").inc(3);
+  reg.get_gauge("connections").inc(4);
+  auto& h = reg.get_histogram("latency", "", "Latency.");
+  h.observe(1);
+  h.observe(1);
+  h.observe(5);
+  std::string out;
+  append_prometheus(out, reg.collect());
+  CAF_CHECK_EQUAL(out, "# TYPE connections gauge\n"
+                       "connections 4\n"
+                       "# HELP latency Latency.\n"
+                       "# TYPE latency histogram\n"
+                       "latency_bucket{le=\"1\"} 2\n"
+                       "latency_bucket{le=\"5\"} 3\n"
+                       "latency_bucket{le=\"+Inf\"} 3\n"
+                       "latency_sum 7\n"
+                       "latency_count 3\n"
+                       "# HELP requests_total Requests per path.\n"
+                       "# TYPE requests_total counter\n"
+                       "requests_total{path=\"/a\"} 2\n"
+                       "requests_total{path=\"/b\"} 3\n");
+}
+
+CAF_TEST_FIXTURE_SCOPE(metrics_broker_tests, fixture)
+
+CAF_TEST(scrape) {
+  // actors register their processing time histogram when resuming
+  auto worker = system.spawn([]() -> behavior {
+    return {
+      [](int x) {
+        return x;
+      }
+    };
+  });
+  scoped_actor self{system};
+  self->request(worker, infinite, 42).receive(
+    [](int) {
+      // nop
+    },
+    [&](error& err) {
+      CAF_FAIL(system.render(err));
+    }
+  );
+  send(http_get_metrics);
+  auto response = output();
+  CAF_CHECK(starts_with(response, "HTTP/1.1 200 OK\r\n"));
+  CAF_CHECK(contains(response, "Content-Type: text/plain; version=0.0.4\r\n"));
+  CAF_CHECK(contains(response, "# TYPE caf_mailbox_enqueued_total counter\n"));
+  CAF_CHECK(contains(response, "# TYPE caf_scheduler_queued_jobs gauge\n"));
+  CAF_CHECK(contains(response, "# TYPE caf_stream_batches_total counter\n"));
+  CAF_CHECK(contains(response, "caf_actor_processing_time_ns_count"
+                               "{actor=\"scheduled_actor\"} "));
+  auto body_start = response.find("\r\n\r\n") + 4;
+  auto expected_length = "Content-Length: "
+                         + std::to_string(response.size() - body_start);
+  CAF_CHECK(contains(response, expected_length));
+  CAF_CHECK(closed());
+  anon_send_exit(worker, exit_reason::user_shutdown);
+}
+
+CAF_TEST(split_request) {
+  std::string req = http_get_metrics;
+  send(req.substr(0, 10));
+  CAF_CHECK(output().empty());
+  send(req.substr(10));
+  CAF_CHECK(starts_with(output(), "HTTP/1.1 200 OK\r\n"));
+  CAF_CHECK(closed());
+}
+
+CAF_TEST(invalid_requests) {
+  send("GET / HTTP/1.1\r\n\r\n");
+  CAF_CHECK(starts_with(output(), "HTTP/1.1 404 Not Found\r\n"));
+  CAF_CHECK(closed());
+}
+
+CAF_TEST(unsupported_method) {
+  send("POST /metrics HTTP/1.1\r\n\r\n");
+  CAF_CHECK(starts_with(output(), "HTTP/1.1 405 Method Not Allowed\r\n"));
+  CAF_CHECK(closed());
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
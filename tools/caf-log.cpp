@@ -0,0 +1,123 @@
+#include <string>
+#include <fstream>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+#include "caf/detail/log_record.hpp"
+
+using std::string;
+
+using namespace caf;
+
+namespace {
+
+constexpr const char* log_level_name[] = {
+  "ERROR",
+  "WARN",
+  "INFO",
+  "DEBUG",
+  "TRACE"
+};
+
+// renders `x` like the logger renders events to its log file
+void render(std::ostream& out, const logger::line_format& lf, timestamp t0,
+            const detail::log_entry& x) {
+  for (auto& f : lf)
+    switch (f.kind) {
+      case logger::category_field:
+        out << x.category_name;
+        break;
+      case logger::class_name_field:
+        logger::render_fun_prefix(out, x.pretty_fun.c_str());
+        break;
+      case logger::date_field:
+        logger::render_date(out, x.tstamp);
+        break;
+      case logger::file_field:
+        out << x.file_name;
+        break;
+      case logger::line_field:
+        out << x.line_number;
+        break;
+      case logger::message_field:
+        out << x.message;
+        break;
+      case logger::method_field:
+        logger::render_fun_name(out, x.pretty_fun.c_str());
+        break;
+      case logger::newline_field:
+        out << '\n';
+        break;
+      case logger::priority_field:
+        if (x.level >= 0 && x.level <= 4)
+          out << log_level_name[x.level];
+        break;
+      case logger::runtime_field:
+        logger::render_time_diff(out, t0, x.tstamp);
+        break;
+      case logger::thread_field:
+        out << x.tid;
+        break;
+      case logger::actor_field:
+        out << "actor" << x.aid;
+        break;
+      case logger::percent_sign_field:
+        out << '%';
+        break;
+      case logger::plain_text_field:
+        out.write(f.first, f.last - f.first);
+        break;
+      default:
+        break;
+    }
+}
+
+struct config : public actor_system_config {
+  string output_file;
+  string line_format = "%r %c %p %a %t %C %M %F:%L %m%n";
+  config() {
+    opt_group{custom_options_, "global"}
+    .add(output_file, "output-file,o", "Path for the output file")
+    .add(line_format, "line-format,f", "Format for rendering log entries");
+    // shutdown logging per default
+    logger_verbosity = atom("quiet");
+  }
+};
+
+// converts binary log files into the text format of the logger, e.g., for
+// further processing with caf-vec
+void caf_main(actor_system& sys, const config& cfg) {
+  using namespace std;
+  auto& args = sys.config().args_remainder;
+  if (args.size() != 1 || !args.match_element<string>(0)) {
+    cerr << "*** expected exactly one input file" << endl;
+    return;
+  }
+  auto& input_file = args.get_as<string>(0);
+  ifstream in{input_file, ios::binary};
+  if (!in) {
+    cerr << "*** unable to open input file: " << input_file << endl;
+    return;
+  }
+  ofstream fout;
+  if (!cfg.output_file.empty()) {
+    fout.open(cfg.output_file);
+    if (!fout) {
+      cerr << "*** unable to open output file: " << cfg.output_file << endl;
+      return;
+    }
+  }
+  ostream& out = cfg.output_file.empty() ? cout : fout;
+  auto lf = logger::parse_format(cfg.line_format.c_str());
+  timestamp t0;
+  auto f = [&](const detail::log_entry& x) {
+    render(out, lf, t0, x);
+  };
+  if (!detail::read_binary_log(in, t0, f))
+    cerr << "*** not a valid binary log: " << input_file << endl;
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
@@ -0,0 +1,244 @@
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <iomanip>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+
+#include "caf/all.hpp"
+
+#include "caf/detail/profiler_log.hpp"
+
+using std::string;
+
+using namespace caf;
+
+using detail::profiler_event;
+using detail::profiler_log_header;
+
+namespace {
+
+using event_vector = std::vector<profiler_event>;
+
+// -- legacy text format of the profiled coordinator ---------------------------
+
+struct text_row {
+  int64_t time = 0;
+  int64_t usr = 0;
+  int64_t sys = 0;
+  int64_t mem = 0;
+};
+
+class text_writer {
+public:
+  text_writer(std::ostream& out, const profiler_log_header& hdr)
+      : out_(out),
+        hdr_(hdr),
+        last_flush_(0),
+        workers_(hdr.num_workers),
+        last_sample_(hdr.num_workers) {
+    out_.flags(std::ios::left);
+    out_ << std::setw(21) << "clock"
+         << std::setw(10) << "type"
+         << std::setw(10) << "id"
+         << std::setw(15) << "time"
+         << std::setw(15) << "usr"
+         << std::setw(15) << "sys"
+         << "mem"
+         << '\n';
+  }
+
+  void operator()(const profiler_event& x) {
+    auto resolution = static_cast<uint64_t>(hdr_.resolution) * 1000000u;
+    switch (x.kind) {
+      case profiler_event::resume:
+        actors_[x.id].time += static_cast<int64_t>(x.duration);
+        if (x.worker < workers_.size())
+          workers_[x.worker].time += static_cast<int64_t>(x.duration);
+        break;
+      case profiler_event::rusage:
+        if (x.worker < workers_.size()) {
+          auto& w = workers_[x.worker];
+          auto& prev = last_sample_[x.worker];
+          w.usr = x.usr - prev.usr;
+          w.sys = x.sys - prev.sys;
+          w.mem = x.mem;
+          prev.usr = x.usr;
+          prev.sys = x.sys;
+          record(x.timestamp, "worker", x.worker, w);
+          w = text_row{};
+        }
+        break;
+      case profiler_event::done: {
+        auto i = actors_.find(x.id);
+        if (i != actors_.end()) {
+          record(x.timestamp, "actor", x.id, i->second);
+          actors_.erase(i);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    if (x.timestamp - last_flush_ >= resolution) {
+      last_flush_ = x.timestamp;
+      for (auto& kvp : actors_) {
+        if (kvp.first != 0 && kvp.second.time > 0) {
+          record(x.timestamp, "actor", kvp.first, kvp.second);
+          kvp.second = text_row{};
+        }
+      }
+    }
+  }
+
+private:
+  void record(uint64_t t, const char* label, uint64_t id, const text_row& x) {
+    using std::setw;
+    // the legacy format uses UNIX timestamps and durations in microseconds
+    out_ << setw(21) << (hdr_.system_start + static_cast<int64_t>(t / 1000))
+         << setw(10) << label
+         << setw(10) << id
+         << setw(15) << (x.time / 1000)
+         << setw(15) << x.usr
+         << setw(15) << x.sys
+         << x.mem
+         << '\n';
+  }
+
+  std::ostream& out_;
+  const profiler_log_header& hdr_;
+  uint64_t last_flush_;
+  std::vector<text_row> workers_;
+  std::vector<text_row> last_sample_;
+  std::map<uint64_t, text_row> actors_;
+};
+
+// -- Chrome trace-event format ------------------------------------------------
+
+// prints `ns` as fractional microseconds
+string to_us(uint64_t ns) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%llu.%03llu",
+           static_cast<unsigned long long>(ns / 1000),
+           static_cast<unsigned long long>(ns % 1000));
+  return buf;
+}
+
+void write_chrome_trace(std::ostream& out, const profiler_log_header& hdr,
+                        const event_vector& xs) {
+  out << "{\"traceEvents\":[\n";
+  bool first = true;
+  auto sep = [&] {
+    if (!first)
+      out << ",\n";
+    first = false;
+  };
+  for (uint32_t i = 0; i < hdr.num_workers; ++i) {
+    sep();
+    out << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << i
+        << R"(,"args":{"name":"worker )" << i << "\"}}";
+  }
+  for (auto& x : xs) {
+    switch (x.kind) {
+      case profiler_event::resume:
+        sep();
+        out << R"({"name":")";
+        if (x.id == 0)
+          out << "job";
+        else
+          out << "actor " << x.id;
+        out << R"(","cat":"resume","ph":"X","pid":1,"tid":)" << x.worker
+            << R"(,"ts":)" << to_us(x.timestamp)
+            << R"(,"dur":)" << to_us(x.duration) << "}";
+        break;
+      case profiler_event::rusage:
+        sep();
+        out << R"({"name":"worker )" << x.worker
+            << R"( cpu","ph":"C","pid":1,"tid":)" << x.worker
+            << R"(,"ts":)" << to_us(x.timestamp)
+            << R"(,"args":{"usr":)" << x.usr << R"(,"sys":)" << x.sys
+            << R"(,"mem":)" << x.mem << "}}";
+        break;
+      case profiler_event::done:
+        sep();
+        out << R"({"name":"actor )" << x.id
+            << R"( done","ph":"i","s":"t","pid":1,"tid":)" << x.worker
+            << R"(,"ts":)" << to_us(x.timestamp) << "}";
+        break;
+      case profiler_event::dropped:
+        sep();
+        out << R"({"name":"dropped )" << x.id
+            << R"( events","ph":"i","s":"t","pid":1,"tid":)" << x.worker
+            << R"(,"ts":)" << to_us(x.timestamp) << "}";
+        break;
+      default:
+        break;
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+// -- program entry point ------------------------------------------------------
+
+struct config : public actor_system_config {
+  string output_file;
+  string format = "text";
+  config() {
+    opt_group{custom_options_, "global"}
+    .add(output_file, "output-file,o", "Path for the output file")
+    .add(format, "format,f", "Output format: 'text' or 'chrome'");
+    // shutdown logging per default
+    logger_verbosity = atom("quiet");
+  }
+};
+
+// converts binary output of the profiled coordinator into the legacy text
+// format or into Chrome's trace-event format
+void caf_main(actor_system& sys, const config& cfg) {
+  using namespace std;
+  auto& args = sys.config().args_remainder;
+  if (args.size() != 1 || !args.match_element<string>(0)) {
+    cerr << "*** expected exactly one input file" << endl;
+    return;
+  }
+  if (cfg.format != "text" && cfg.format != "chrome") {
+    cerr << "*** invalid format: " << cfg.format << endl;
+    return;
+  }
+  auto& input_file = args.get_as<string>(0);
+  ifstream in{input_file, ios::binary};
+  profiler_log_header hdr;
+  event_vector xs;
+  if (!in || !detail::read_profiler_log(in, hdr, xs)) {
+    cerr << "*** not a valid profiler log: " << input_file << endl;
+    return;
+  }
+  // workers flush their buffers independently, i.e., events from different
+  // workers interleave only chunk-wise
+  stable_sort(xs.begin(), xs.end(),
+              [](const profiler_event& x, const profiler_event& y) {
+                return x.timestamp < y.timestamp;
+              });
+  ofstream fout;
+  if (!cfg.output_file.empty()) {
+    fout.open(cfg.output_file);
+    if (!fout) {
+      cerr << "*** unable to open output file: " << cfg.output_file << endl;
+      return;
+    }
+  }
+  ostream& out = cfg.output_file.empty() ? cout : fout;
+  if (cfg.format == "chrome") {
+    write_chrome_trace(out, hdr, xs);
+  } else {
+    text_writer f{out, hdr};
+    for_each(xs.begin(), xs.end(), ref(f));
+  }
+}
+
+} // namespace <anonymous>
+
+CAF_MAIN()
@@ -1,13 +1,22 @@
+#include <map>
+#include <set>
+#include <deque>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <cctype>
+#include <cstring>
 #include <utility>
 #include <cassert>
 #include <fstream>
+#include <sstream>
 #include <iostream>
+#include <unordered_map>
 
 #include "caf/all.hpp"
 
+#include "caf/detail/mapped_file.hpp"
+
 using std::string;
 
 using namespace caf;
@@ -92,11 +101,10 @@ istream_char_consumer consume(const char (&what)[S]) {
 
 // -- convenience functions for vector timestamps
 
-vector_timestamp& merge(vector_timestamp& x, const vector_timestamp& y) {
-  assert(x.size() == y.size());
-  for (size_t i = 0; i < x.size(); ++i)
+// merges `y` into the clock starting at `x` with `y.size()` elements
+void merge(size_t* x, const vector_timestamp& y) {
+  for (size_t i = 0; i < y.size(); ++i)
     x[i] = std::max(x[i], y[i]);
-  return x;
 }
 
 constexpr const char* log_level_name[] = {"ERROR", "WARN", "INFO",
@@ -367,18 +375,359 @@ struct log_entry {
   string message;
 };
 
-/// Stores a log event along with context information.
-struct enhanced_log_entry {
-  /// The original log entry without context information.
-  const log_entry& data;
-  /// The actual ID of the logging entity.
-  const entity& id;
-  /// Current vector time as seen by `id`.
-  vector_timestamp& vstamp;
-  /// JSON representation of `vstamp`.
-  string json_vstamp;
+std::istream& operator>>(std::istream& in, log_entry& x) {
+  in >> x.timestamp >> x.component >> x.level
+     >> consume("actor") >> x.id.aid >> x.id.tid
+     >> x.class_name >> x.function_name
+     >> skip_whitespaces >> rd_line(x.file_name, ':')
+     >> x.line_number >> skip_whitespaces >> rd_line(x.message);
+  if (x.level == log_level::invalid)
+    in.setstate(std::ios::failbit);
+  return in;
+}
+
+// -- views to memory-mapped log files
+
+/// A non-owning view to a range of characters in a mapped log file.
+struct slice {
+  const char* data;
+  size_t size;
+
+  const char* begin() const {
+    return data;
+  }
+
+  const char* end() const {
+    return data + size;
+  }
+
+  string str() const {
+    return string{data, size};
+  }
+
+  template <size_t S>
+  bool starts_with(const char (&x)[S]) const {
+    return size >= S - 1 && memcmp(data, x, S - 1) == 0;
+  }
+
+  template <size_t S>
+  bool ends_with(const char (&x)[S]) const {
+    return size >= S - 1 && memcmp(end() - (S - 1), x, S - 1) == 0;
+  }
 };
 
+slice make_slice(const char* first, const char* last) {
+  return {first, static_cast<size_t>(last - first)};
+}
+
+std::ostream& operator<<(std::ostream& out, const slice& x) {
+  return out.write(x.data, static_cast<std::streamsize>(x.size));
+}
+
+bool is_blank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+// parses a non-empty sequence of decimal digits
+template <class T>
+bool parse_uint(slice x, T& res) {
+  if (x.size == 0)
+    return false;
+  res = 0;
+  for (auto c : x) {
+    if (c < '0' || c > '9')
+      return false;
+    res = res * 10 + static_cast<T>(c - '0');
+  }
+  return true;
+}
+
+/// Reads space-separated words from a single line.
+struct line_cursor {
+  const char* pos;
+  const char* end;
+
+  void skip_whitespaces() {
+    while (pos != end && is_blank(*pos))
+      ++pos;
+  }
+
+  slice next_word() {
+    skip_whitespaces();
+    auto first = pos;
+    while (pos != end && !is_blank(*pos))
+      ++pos;
+    return make_slice(first, pos);
+  }
+
+  // reads all characters until `delim` and skips `delim`
+  bool read_until(char delim, slice& x) {
+    auto i = std::find(pos, end, delim);
+    if (i == end)
+      return false;
+    x = make_slice(pos, i);
+    pos = i + 1;
+    return true;
+  }
+
+  // returns all remaining characters without surrounding whitespaces
+  slice remainder() {
+    skip_whitespaces();
+    auto last = end;
+    while (last != pos && is_blank(*(last - 1)))
+      --last;
+    return make_slice(pos, last);
+  }
+};
+
+/// A single entry in a logfile in compact form, i.e., all fields point into
+/// the mapped file.
+struct log_line {
+  /// Index of the logging entity in `chunk_result::ids`.
+  uint32_t id;
+  /// Timestamp, component, and log level.
+  slice prefix;
+  /// Class name, function name, file name, and line number.
+  slice context;
+  /// Description of the log entry.
+  slice message;
+};
+
+// parses the line `[first, last)` in the same format as `log_entry`
+bool parse_line(const char* first, const char* last, log_line& x,
+                logger_id& id) {
+  line_cursor in{first, last};
+  int64_t timestamp;
+  auto ts = in.next_word();
+  if (!parse_uint(ts, timestamp))
+    return false;
+  in.next_word(); // component
+  auto lvl = in.next_word();
+  auto lvl_pred = [&](const char* cstr) {
+    return strlen(cstr) == lvl.size && memcmp(cstr, lvl.data, lvl.size) == 0;
+  };
+  if (std::none_of(std::begin(log_level_name), std::end(log_level_name) - 1,
+                   lvl_pred))
+    return false;
+  x.prefix = make_slice(ts.data, lvl.end());
+  auto aid = in.next_word();
+  if (!aid.starts_with("actor")
+      || !parse_uint(slice{aid.data + 5, aid.size - 5}, id.aid))
+    return false;
+  auto tid = in.next_word();
+  id.tid.assign(tid.data, tid.size);
+  auto class_name = in.next_word();
+  in.next_word(); // function name
+  in.skip_whitespaces();
+  slice file_name;
+  int32_t line_number;
+  if (class_name.size == 0 || !in.read_until(':', file_name))
+    return false;
+  auto line_number_str = in.next_word();
+  if (!parse_uint(line_number_str, line_number))
+    return false;
+  x.context = make_slice(class_name.data, line_number_str.end());
+  x.message = in.remainder();
+  return true;
+}
+
+/// Stores meta data of a logging entity as found in its INIT event.
+struct logger_id_meta_data {
+  bool hidden;
+  string pretty_name;
+};
+
+/// Result of parsing a chunk of a mapped log file.
+struct chunk_result {
+  /// Maps chunk-local entity indexes to logger IDs.
+  std::vector<logger_id> ids;
+  /// Stores meta data for each entity in `ids`.
+  std::vector<logger_id_meta_data> meta;
+  /// Stores all parsed lines in order of appearance.
+  std::vector<log_line> lines;
+  /// Counts lines that failed to parse.
+  size_t malformed = 0;
+};
+
+void parse_chunk(const char* first, const char* last, chunk_result& res) {
+  std::map<logger_id, uint32_t> index;
+  logger_id id;
+  log_line x;
+  while (first != last) {
+    auto eol = static_cast<const char*>(memchr(first, '\n',
+                                               static_cast<size_t>(last - first)));
+    if (eol == nullptr)
+      eol = last;
+    if (parse_line(first, eol, x, id)) {
+      auto i = index.find(id);
+      if (i == index.end()) {
+        i = index.emplace(id, static_cast<uint32_t>(res.ids.size())).first;
+        res.ids.push_back(id);
+        res.meta.push_back(logger_id_meta_data{false, "actor"});
+      }
+      x.id = i->second;
+      if (x.message.starts_with("INIT ; NAME = ")) {
+        auto& meta = res.meta[x.id];
+        line_cursor in{x.message.data + 14, x.message.end()};
+        slice name;
+        if (!in.read_until(';', name))
+          name = make_slice(in.pos, in.end);
+        line_cursor name_in{name.data, name.end()};
+        meta.pretty_name = name_in.remainder().str();
+        if (x.message.ends_with("HIDDEN = true"))
+          meta.hidden = true;
+      }
+      res.lines.push_back(x);
+    } else if (first != eol) {
+      ++res.malformed;
+    }
+    first = eol == last ? last : eol + 1;
+  }
+}
+
+/// A chunk of a mapped file for parsing in a worker of the actor pool.
+struct parse_job {
+  const char* first;
+  const char* last;
+  chunk_result* res;
+};
+
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(parse_job)
+
+behavior parser(event_based_actor*) {
+  return {
+    [](const parse_job& x) {
+      parse_chunk(x.first, x.last, *x.res);
+    }
+  };
+}
+
+/// A memory-mapped log file along with all parsed entries.
+struct input_file {
+  /// Path to the log file.
+  string fname;
+  /// Content of the log file.
+  detail::mapped_file content;
+  /// Node ID used in the log file.
+  node_id this_node;
+  /// Parsed lines, split into chunks at line boundaries.
+  std::vector<chunk_result> chunks;
+  /// All entities of the log file with their meta data.
+  std::map<logger_id, logger_id_meta_data> entities;
+};
+
+using input_file_ptr = std::unique_ptr<input_file>;
+
+enum verbosity_level {
+  silent,
+  informative,
+  noisy
+};
+
+// reads the node ID from the first line of a log file
+bool parse_first_line(input_file& x) {
+  auto first = x.content.data();
+  auto last = first + x.content.size();
+  // _ caf INFO actor0 _ caf.logger start _:_ level = _, node = NODE
+  std::istringstream in{string{first, std::find(first, last, '\n')}};
+  return static_cast<bool>(in >> skip_word >> consume("caf")
+                           >> consume("INFO") >> consume("actor0")
+                           >> skip_word >> consume("caf.logger")
+                           >> consume("start") >> skip_word
+                           >> consume("level =") >> skip_word
+                           >> consume("node = ") >> x.this_node);
+}
+
+// maps all files and parses them in chunks of roughly `chunk_size` bytes,
+// using an actor pool with one parser per scheduler thread; drops all files
+// that are not readable or do not start with a valid logger line
+void parse_files(actor_system& sys, std::vector<input_file_ptr>& xs,
+                 size_t chunk_size, verbosity_level vl) {
+  std::vector<input_file_ptr> readable;
+  for (auto& x : xs) {
+    auto err = x->content.open(x->fname);
+    if (err) {
+      std::cerr << "could not open file: " << x->fname << std::endl;
+      continue;
+    }
+    if (!parse_first_line(*x)) {
+      std::cerr << "*** malformed log file " << x->fname << ", expect the "
+                << "first line to contain an INFO entry of the logger"
+                << std::endl;
+      continue;
+    }
+    if (vl >= verbosity_level::informative)
+      std::cout << "found node " << to_string(x->this_node) << std::endl;
+    readable.emplace_back(std::move(x));
+  }
+  xs.swap(readable);
+  // split each file at line boundaries
+  std::vector<parse_job> jobs;
+  for (auto& x : xs) {
+    std::vector<std::pair<const char*, const char*>> ranges;
+    auto first = x->content.data();
+    auto last = first + x->content.size();
+    while (first != last) {
+      auto remaining = static_cast<size_t>(last - first);
+      auto n = std::min(std::max(chunk_size, size_t{1}), remaining);
+      auto eol = static_cast<const char*>(memchr(first + n - 1, '\n',
+                                                 remaining - (n - 1)));
+      auto chunk_end = eol == nullptr ? last : eol + 1;
+      ranges.emplace_back(first, chunk_end);
+      first = chunk_end;
+    }
+    x->chunks.resize(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i)
+      jobs.push_back(parse_job{ranges[i].first, ranges[i].second,
+                               &x->chunks[i]});
+  }
+  if (jobs.empty())
+    return;
+  // parse all chunks in parallel
+  scoped_execution_unit context{&sys};
+  auto num_workers = std::max(sys.config().scheduler_max_threads, size_t{1});
+  auto pool = actor_pool::make(&context, num_workers,
+                               [&] { return sys.spawn(parser); },
+                               actor_pool::round_robin());
+  {
+    scoped_actor self{sys};
+    using handle_type = decltype(self->request(pool, infinite, jobs.front()));
+    std::vector<handle_type> hdls;
+    for (auto& job : jobs)
+      hdls.emplace_back(self->request(pool, infinite, job));
+    for (auto& hdl : hdls)
+      hdl.receive(
+        [] {
+          // nop
+        },
+        [&](error& err) {
+          std::cerr << "*** parser failed: " << sys.render(err) << std::endl;
+        }
+      );
+  }
+  anon_send_exit(pool, exit_reason::user_shutdown);
+  // collect entities and their meta data from all chunks
+  for (auto& x : xs) {
+    size_t malformed = 0;
+    for (auto& chunk : x->chunks) {
+      malformed += chunk.malformed;
+      for (size_t i = 0; i < chunk.ids.size(); ++i) {
+        auto& meta = chunk.meta[i];
+        auto res = x->entities.emplace(chunk.ids[i], meta);
+        // only the chunk with the INIT event knows name and visibility
+        if (!res.second && (meta.hidden || meta.pretty_name != "actor"))
+          res.first->second = meta;
+      }
+    }
+    if (malformed > 0)
+      std::cerr << "*** skipped " << malformed << " malformed lines in "
+                << x->fname << std::endl;
+    if (vl >= verbosity_level::informative)
+      std::cout << "found " << x->entities.size() << " entities for node "
+                << to_string(x->this_node) << std::endl;
+  }
+}
+
 /// CAF events according to SE-0001.
 enum class se_type {
   spawn,
@@ -450,9 +799,15 @@ bool field_key_compare(const std::pair<const std::string, std::string>& x,
   if (!y.fields.empty())                                                       \
     return sec::invalid_argument;
 
-expected<se_event> parse_event(const enhanced_log_entry& x) {
-  se_event y{&x.id, x.vstamp, se_type::none, string_map{}};
-  std::istringstream in{x.data.message};
+
+expected<se_event> parse_event(const entity& id, slice message) {
+  // all SE-0001 events start with an upper-case keyword, which allows us to
+  // skip the expensive parsing below for all other messages
+  if (message.size == 0
+      || isupper(static_cast<unsigned char>(message.data[0])) == 0)
+    return sec::invalid_argument;
+  se_event y{&id, vector_timestamp{}, se_type::none, string_map{}};
+  std::istringstream in{message.str()};
   string type;
   if (!(in >> type))
     return sec::invalid_argument;
@@ -479,7 +834,7 @@ expected<se_event> parse_event(const enhanced_log_entry& x) {
     ATM_CASE("RECEIVE", receive);
       CHECK_FIELDS("FROM", "STAGES", "CONTENT");
       // insert TO field to allow comparing SEND and RECEIVE events easily
-      y.fields.emplace("TO", to_string(to_mailbox_id(x.id)));
+      y.fields.emplace("TO", to_string(to_mailbox_id(id)));
       break;
     ATM_CASE("DROP", drop);
       CHECK_NO_FIELDS();
@@ -497,79 +852,30 @@ expected<se_event> parse_event(const enhanced_log_entry& x) {
   return {std::move(y)};
 }
 
-std::ostream& operator<<(std::ostream& out, const enhanced_log_entry& x) {
-  return out << x.json_vstamp << ' ' << x.data.timestamp << ' '
-             << x.data.component << ' ' << x.data.level << ' '
-             << x.id.pretty_name << ' ' << x.data.class_name << ' '
-             << x.data.function_name << ' '
-             << x.data.file_name << ':' << x.data.line_number << ' '
-             << x.data.message;
+// concatenates all fields of an event for looking up matching SEND events
+string fields_key(const string_map& xs) {
+  string res;
+  for (auto& kvp : xs) {
+    res += kvp.first;
+    res += '\0';
+    res += kvp.second;
+    res += '\0';
+  }
+  return res;
 }
 
-std::istream& operator>>(std::istream& in, log_entry& x) {
-  in >> x.timestamp >> x.component >> x.level
-     >> consume("actor") >> x.id.aid >> x.id.tid
-     >> x.class_name >> x.function_name
-     >> skip_whitespaces >> rd_line(x.file_name, ':')
-     >> x.line_number >> skip_whitespaces >> rd_line(x.message);
-  if (x.level == log_level::invalid)
-    in.setstate(std::ios::failbit);
-  return in;
+void append_uint(string& out, size_t x) {
+  char buf[24];
+  auto i = std::end(buf);
+  do {
+    *--i = static_cast<char>('0' + x % 10);
+    x /= 10;
+  } while (x > 0);
+  out.append(i, std::end(buf));
 }
 
-struct logger_id_meta_data {
-  bool hidden;
-  string pretty_name;
-};
-
-/// Stores all log entities and their node ID.
-struct first_pass_result {
-  /// Node ID used in the parsed file.
-  node_id this_node;
-  /// Entities of the parsed file. The value is `true` if an entity is
-  /// hidden, otherwise `false`.
-  std::map<logger_id, logger_id_meta_data> entities;
-};
-
-enum verbosity_level {
-  silent,
-  informative,
-  noisy
-};
-
-expected<first_pass_result> first_pass(blocking_actor* self, std::istream& in,
-                                       verbosity_level vl) {
-  first_pass_result res;
-  // read first line to extract the node ID of local actors
-  // _ caf INFO actor0 _ caf.logger start _:_ level = _, node = NODE
-  if (!(in >> skip_word >> consume("caf") >> consume("INFO")
-           >> consume("actor0") >> skip_word >> consume("caf.logger")
-           >> consume("start") >> skip_word
-           >> consume("level =") >> skip_word >> consume("node = ")
-           >> res.this_node >> skip_to_next_line)) {
-    std::cerr << "*** malformed log file, expect the first line to contain "
-              << "an INFO entry of the logger" << std::endl;
-    return sec::invalid_argument;
-  }
-  if (vl >= verbosity_level::informative)
-    aout(self) << "found node " << res.this_node << std::endl;
-  logger_id id;
-  string message;
-  while (in >> skip_word >> skip_word >> skip_word >> id
-            >> skip_word >> skip_word >> skip_word >> rd_line(message)) {
-    // store in map
-    auto i = res.entities.emplace(id, logger_id_meta_data{false, "actor"}).first;
-    if (starts_with(message, "INIT ; NAME = ")) {
-      std::istringstream iss{message};
-      iss >> consume("INIT ; NAME = ") >> rd_line(i->second.pretty_name, ';');
-      if (ends_with(message, "HIDDEN = true"))
-        i->second.hidden = true;
-    }
-  }
-  if (vl >= verbosity_level::informative)
-    aout(self) << "found " << res.entities.size() << " entities for node "
-               << res.this_node << std::endl;
-  return res;
+void append(string& out, const slice& x) {
+  out.append(x.data, x.size);
 }
 
 const string& get(const std::map<string, string>& xs, const string& x) {
@@ -580,40 +886,39 @@ const string& get(const std::map<string, string>& xs, const string& x) {
 }
 
 void second_pass(blocking_actor* self, const group& grp,
-                 const entity_set& entities, const node_id& nid,
-                 const std::vector<string>& json_names, std::istream& in,
-                 std::ostream& out, std::mutex& out_mtx,
-                 bool drop_hidden_actors, verbosity_level vl) {
+                 const entity_set& entities, const input_file& input,
+                 const std::vector<string>& json_names, std::ostream& out,
+                 std::mutex& out_mtx, bool drop_hidden_actors,
+                 verbosity_level vl) {
   assert(entities.size() == json_names.size());
+  auto& nid = input.this_node;
   node_range local_entities{entities, nid};
   if (local_entities.begin() == local_entities.end())
     return;
-  // state for each local entity
-  struct state_t {
-    const entity& eid;
-    vector_timestamp clock;
-  };
-  std::map<logger_id, state_t> local_entities_state;
+  // give each local entity a dense index and store all vector clocks in a
+  // single array with one row of `width` elements per local entity
+  auto width = entities.size();
+  std::vector<const entity*> local;
+  std::map<logger_id, size_t> local_index;
   for (auto& x : local_entities) {
-    vector_timestamp vzero;
-    vzero.resize(entities.size());
-    local_entities_state.emplace(logger_id{x.aid, x.tid},
-                                 state_t{x, std::move(vzero)});
-  }
-  // lambda for accessing state via logger ID
-  auto state = [&](const logger_id& x) -> state_t& {
-    auto i = local_entities_state.find(x);
-    if (i != local_entities_state.end())
+    local_index.emplace(to_logger_id(x), local.size());
+    local.push_back(&x);
+  }
+  std::vector<size_t> clocks(local.size() * width);
+  auto clock_of = [&](size_t idx) {
+    return clocks.data() + idx * width;
+  };
+  auto index_of = [&](const logger_id& x) -> size_t {
+    auto i = local_index.find(x);
+    if (i != local_index.end())
       return i->second;
     CAF_RAISE_ERROR("logger ID not found");
   };
-  // additional state for second pass
-  size_t line = 0;
-  log_entry plain_entry;
-  std::vector<se_event> in_flight_messages;
+  // vector timestamps of all SEND events, indexed by their fields
+  std::unordered_map<string, vector_timestamp> in_flight_messages;
   std::vector<se_event> in_flight_spawns;
-  // maps scoped actor IDs to their parent ID
-  std::map<logger_id, logger_id> scoped_actors;
+  // maps scoped actors to their parent
+  std::map<size_t, size_t> scoped_actors;
   // lambda for broadcasting events that could cross node boundary
   auto bcast = [&](const se_event& x) {
     if (vl >= verbosity_level::noisy)
@@ -624,141 +929,269 @@ void second_pass(blocking_actor* self, const group& grp,
   };
   // fetch message from another node via the group
   auto fetch_message = [&](const std::map<string, string>& fields)
-                       -> se_event& {
+                       -> const vector_timestamp& {
     // TODO: this receive unconditionally waits on a message,
     //       i.e., is a potential deadlock
     if (vl >= verbosity_level::noisy)
       aout(self) << "wait for send from another node matching fields "
                  << deep_to_string(fields) << std::endl;
-    se_event* res = nullptr;
+    const vector_timestamp* res = nullptr;
     self->receive_while([&] { return res == nullptr; })(
       [&](const se_event& x) {
         switch (x.type) {
           default:
             break;
-          case se_type::send:
-            in_flight_messages.emplace_back(x);
+          case se_type::send: {
+            auto i = in_flight_messages.emplace(fields_key(x.fields),
+                                                x.vstamp).first;
             if (x.fields == fields)
-              res = &in_flight_messages.back();
+              res = &i->second;
             break;
+          }
         }
       }
     );
     return *res;
   };
-  // second pass
-  while (in >> plain_entry) {
-    ++line;
-    // increment local time
-    auto& st = state(plain_entry.id);
-    // do not produce log output for internal actors but still track messages
-    // through those actors, because they might be forwarding messages
-    bool internal = drop_hidden_actors && st.eid.hidden;
-    if (!internal)
-      st.clock[st.eid.vid] += 1;
-    // generate enhanced entry (with incomplete JSON timestamp for now)
-    enhanced_log_entry entry{plain_entry, st.eid, st.clock, string{}};
-    // check whether entry contains an SE-0001 event
-    auto tmp = parse_event(entry);
-    if (tmp) {
-      auto& event = *tmp;
-      switch (event.type) {
-        default:
-          break;
-        case se_type::send:
-          bcast(event);
-          in_flight_messages.emplace_back(std::move(event));
-          break;
-        case se_type::receive: {
-          auto pred = [&](const se_event& x) {
-            assert(x.type == se_type::send);
-            return event.fields == x.fields;
-          };
-          auto e = in_flight_messages.end();
-          auto i = std::find_if(in_flight_messages.begin(), e, pred);
-          if (i != e) {
-            merge(st.clock, i->vstamp);
-          } else {
-            merge(st.clock, fetch_message(event.fields).vstamp);
+  // buffer output to reduce contention on `out_mtx`
+  static constexpr size_t flush_threshold = 1024 * 1024;
+  string buf;
+  auto flush = [&] {
+    std::lock_guard<std::mutex> guard{out_mtx};
+    out << buf;
+    buf.clear();
+  };
+  std::vector<size_t> remap;
+  for (auto& chunk : input.chunks) {
+    // translate chunk-local entity indexes to dense indexes
+    remap.clear();
+    for (auto& id : chunk.ids)
+      remap.push_back(index_of(id));
+    for (auto& x : chunk.lines) {
+      auto idx = remap[x.id];
+      auto& eid = *local[idx];
+      auto clock = clock_of(idx);
+      // do not produce log output for internal actors but still track
+      // messages through those actors, because they might be forwarding
+      // messages
+      bool internal = drop_hidden_actors && eid.hidden;
+      if (!internal)
+        clock[eid.vid] += 1;
+      // check whether entry contains an SE-0001 event
+      auto tmp = parse_event(eid, x.message);
+      if (tmp) {
+        auto& event = *tmp;
+        event.vstamp.assign(clock, clock + width);
+        switch (event.type) {
+          default:
+            break;
+          case se_type::send:
+            bcast(event);
+            in_flight_messages.emplace(fields_key(event.fields),
+                                       std::move(event.vstamp));
+            break;
+          case se_type::receive: {
+            auto i = in_flight_messages.find(fields_key(event.fields));
+            if (i != in_flight_messages.end())
+              merge(clock, i->second);
+            else
+              merge(clock, fetch_message(event.fields));
+            break;
           }
-          break;
-        }
-        case se_type::spawn:
-          in_flight_spawns.emplace_back(std::move(event));
-          break;
-        case se_type::init: {
-          auto id_field = std::to_string(st.eid.aid);
-          auto pred = [&](const se_event& x) {
-            assert(x.type == se_type::spawn);
-            return get(x.fields, "ID") == id_field;
-          };
-          auto e = in_flight_spawns.end();
-          auto i = std::find_if(in_flight_spawns.begin(), e, pred);
-          if (i != e) {
-            merge(st.clock, i->vstamp);
-            // keep book on scoped actors since their terminate
-            // event propagates back to the parent
-            if (get(event.fields, "NAME") == "scoped_actor")
-              scoped_actors.emplace(plain_entry.id, to_logger_id(*i->source));
-            in_flight_spawns.erase(i);
-          } else {
-            std::cerr << "*** cannot match init event to a previous spawn"
-                      << std::endl;
+          case se_type::spawn:
+            in_flight_spawns.emplace_back(std::move(event));
+            break;
+          case se_type::init: {
+            auto id_field = std::to_string(eid.aid);
+            auto pred = [&](const se_event& y) {
+              assert(y.type == se_type::spawn);
+              return get(y.fields, "ID") == id_field;
+            };
+            auto e = in_flight_spawns.end();
+            auto i = std::find_if(in_flight_spawns.begin(), e, pred);
+            if (i != e) {
+              merge(clock, i->vstamp);
+              // keep book on scoped actors since their terminate
+              // event propagates back to the parent
+              if (get(event.fields, "NAME") == "scoped_actor")
+                scoped_actors.emplace(idx, index_of(to_logger_id(*i->source)));
+              in_flight_spawns.erase(i);
+            } else {
+              std::cerr << "*** cannot match init event to a previous spawn"
+                        << std::endl;
+            }
+            break;
           }
-          break;
+          case se_type::terminate:
+            auto i = scoped_actors.find(idx);
+            if (i != scoped_actors.end()) {
+              // merge timestamp with parent to capture happens-before
+              // relation
+              merge(clock_of(i->second), event.vstamp);
+              scoped_actors.erase(i);
+            }
+            break;
         }
-        case se_type::terminate:
-          auto i = scoped_actors.find(plain_entry.id);
-          if (i != scoped_actors.end()) {
-            // merge timestamp with parent to capture happens-before relation
-            auto& parent_state = state(i->second);
-            merge(parent_state.clock, st.clock);
-            scoped_actors.erase(i);
-          }
-          break;
       }
-    }
-    // create ShiViz compatible JSON-formatted vector timestamp
-    std::ostringstream oss;
-    oss << '{';
-    bool need_comma = false;
-    for (size_t i = 0; i < st.clock.size(); ++i) {
-      auto x = st.clock[i];
-      if (x > 0) {
-        if (need_comma)
-          oss << ',';
-        else
-          need_comma = true;
-        oss << '"' << json_names[i] << '"' << ':' << x;
+      if (internal)
+        continue;
+      // print entry with ShiViz compatible JSON-formatted vector timestamp
+      buf += '{';
+      bool need_comma = false;
+      for (size_t i = 0; i < width; ++i) {
+        auto t = clock[i];
+        if (t > 0) {
+          if (need_comma)
+            buf += ',';
+          else
+            need_comma = true;
+          buf += '"';
+          buf += json_names[i];
+          buf += "\":";
+          append_uint(buf, t);
+        }
       }
+      buf += "} ";
+      append(buf, x.prefix);
+      buf += ' ';
+      buf += eid.pretty_name;
+      buf += ' ';
+      append(buf, x.context);
+      buf += ' ';
+      append(buf, x.message);
+      buf += '\n';
+      if (buf.size() >= flush_threshold)
+        flush();
     }
-    oss << '}';
-    entry.json_vstamp = oss.str();
-    // print entry to output file
-    if (!internal) {
-      std::lock_guard<std::mutex> guard{out_mtx};
-      out << entry << '\n';
+  }
+  flush();
+}
+
+// -- benchmark for the log parser
+
+// writes `num_lines` log entries of 64 actors and 4 threads
+void generate_log(std::ostream& out, const node_id& nid, size_t num_lines) {
+  static constexpr size_t num_actors = 64;
+  static constexpr size_t num_threads = 4;
+  auto tid = [](size_t x) {
+    return std::to_string(139770541594368ull + x * 8392704ull);
+  };
+  int64_t ts = 1500000000000;
+  out << ts << " caf INFO actor0 " << tid(0)
+      << " caf.logger start libcaf_core/src/logger.cpp:640 level = DEBUG, "
+      << "node = " << to_string(nid) << '\n';
+  for (size_t i = 1; i < num_lines; ++i) {
+    auto aid = i % (num_actors + num_threads);
+    out << ++ts << " caf DEBUG ";
+    if (aid < num_threads) {
+      out << "actor0 " << tid(aid) << " caf.io.network.default_multiplexer "
+          << "run libcaf_io/src/default_multiplexer.cpp:712 "
+          << "poll returned: num_events = " << i % 7;
+    } else if (i < num_actors + num_threads) {
+      out << "actor" << aid << ' ' << tid(i % num_threads)
+          << " caf.scheduled_actor launch libcaf_core/src/scheduled_actor.cpp:"
+          << "312 INIT ; NAME = worker ; HIDDEN = false";
+    } else {
+      out << "actor" << aid << ' ' << tid(i % num_threads)
+          << " caf.scheduled_actor consume libcaf_core/src/scheduled_actor.cpp:"
+          << "465 x = mailbox_element(actor" << (i * 7) % num_actors + 1
+          << ", " << i << ", [], (\"job\", " << i * 31 << "))";
     }
+    out << '\n';
   }
 }
 
+// parses `in` as previous versions of this tool did: one pass for collecting
+// all entities and one pass for reading all entries, both via std::istream
+size_t legacy_parse(std::istream& in) {
+  std::map<logger_id, logger_id_meta_data> entities;
+  logger_id id;
+  string message;
+  in >> skip_to_next_line;
+  while (in >> skip_word >> skip_word >> skip_word >> id
+            >> skip_word >> skip_word >> skip_word >> rd_line(message))
+    entities.emplace(id, logger_id_meta_data{false, "actor"});
+  in.clear();
+  in.seekg(0);
+  size_t result = 0;
+  log_entry entry;
+  while (in >> entry)
+    ++result;
+  return result;
+}
+
 namespace {
 
 struct config : public actor_system_config {
   string output_file;
   bool include_hidden_actors = false;
   size_t verbosity = 0;
+  size_t chunk_size = 16 * 1024 * 1024;
+  size_t benchmark_lines = 0;
   config() {
     opt_group{custom_options_, "global"}
     .add(output_file, "output-file,o", "Path for the output file")
     .add(include_hidden_actors, "include-hidden-actors,i",
          "Include hidden (system-level) actors")
-    .add(verbosity, "verbosity,v", "Debug output (from 0 to 2)");
+    .add(verbosity, "verbosity,v", "Debug output (from 0 to 2)")
+    .add(chunk_size, "chunk-size,c",
+         "Bytes per parallel parsing job (default: 16 MiB)")
+    .add(benchmark_lines, "benchmark,b",
+         "Generate a log with N lines at the output file path and report "
+         "the speedup of the parser");
     // shutdown logging per default
     logger_verbosity = atom("quiet");
   }
 };
 
+// generates a log file and compares the parsing time of the legacy
+// single-threaded parser with the parallel parser
+void run_benchmark(actor_system& sys, const config& cfg) {
+  using namespace std;
+  using clock_type = std::chrono::steady_clock;
+  auto ms_since = [](clock_type::time_point t0) {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(clock_type::now() - t0).count();
+  };
+  {
+    std::ofstream out{cfg.output_file};
+    if (!out) {
+      cerr << "unable to open output file: " << cfg.output_file << endl;
+      return;
+    }
+    generate_log(out, sys.node(), cfg.benchmark_lines);
+  }
+  auto t0 = clock_type::now();
+  size_t legacy_lines;
+  {
+    std::ifstream in{cfg.output_file};
+    legacy_lines = legacy_parse(in);
+  }
+  auto legacy_ms = ms_since(t0);
+  t0 = clock_type::now();
+  std::vector<input_file_ptr> inputs;
+  inputs.emplace_back(new input_file);
+  inputs.back()->fname = cfg.output_file;
+  parse_files(sys, inputs, cfg.chunk_size, silent);
+  auto parallel_ms = ms_since(t0);
+  if (inputs.empty())
+    return;
+  size_t parallel_lines = 0;
+  for (auto& chunk : inputs.front()->chunks)
+    parallel_lines += chunk.lines.size();
+  cout << "generated " << cfg.benchmark_lines << " lines ("
+       << inputs.front()->content.size() / (1024 * 1024) << " MiB) at "
+       << cfg.output_file << endl
+       << "legacy parser (std::istream, 1 thread): " << legacy_ms << " ms, "
+       << legacy_lines << " lines" << endl
+       << "mapped parser (" << sys.config().scheduler_max_threads
+       << " workers, " << inputs.front()->chunks.size() << " chunks): "
+       << parallel_ms << " ms, " << parallel_lines << " lines" << endl
+       << "speedup: "
+       << static_cast<double>(legacy_ms) / max(parallel_ms, decltype(parallel_ms){1})
+       << "x" << endl;
+}
+
 // two pass parser for CAF log files that enhances logs with vector
 // clock timestamps
 void caf_main(actor_system& sys, const config& cfg) {
@@ -767,6 +1200,10 @@ void caf_main(actor_system& sys, const config& cfg) {
     cerr << "*** no output file specified" << std::endl;
     return;
   }
+  if (cfg.benchmark_lines > 0) {
+    run_benchmark(sys, cfg);
+    return;
+  }
   verbosity_level vl;
   switch (cfg.verbosity) {
     case 0:
@@ -784,63 +1221,26 @@ void caf_main(actor_system& sys, const config& cfg) {
     cerr << "unable to open output file: " << cfg.output_file << endl;
     return;
   }
-  using file_path = string;
-  static constexpr size_t irsize = sizeof(file_path) + sizeof(std::ifstream)
-                                   + sizeof(first_pass_result);
-  using ifstream_ptr = std::unique_ptr<std::ifstream>;
-  struct intermediate_res {
-    file_path fname;
-    ifstream_ptr fstream;
-    first_pass_result res;
-    char pad[irsize >= CAF_CACHE_LINE_SIZE ? 1 : CAF_CACHE_LINE_SIZE - irsize];
-    intermediate_res() = default;
-    intermediate_res(intermediate_res&&) = default;
-    intermediate_res& operator=(intermediate_res&&) = default;
-    intermediate_res(file_path fp, ifstream_ptr fs, first_pass_result&& fr)
-        : fname(std::move(fp)),
-          fstream(std::move(fs)),
-          res(std::move(fr)) {
-      // nop
-    }
-  };
-  // do a first pass on all files to extract node IDs and entities
-  vector<intermediate_res> intermediate_results;
-  intermediate_results.resize(cfg.args_remainder.size());
+  // first pass: map all files and parse them in parallel to extract node IDs
+  // and entities
+  std::vector<input_file_ptr> inputs;
   for (size_t i = 0; i < cfg.args_remainder.size(); ++i) {
-    auto& file = cfg.args_remainder.get_as<string>(i);
-    auto ptr = &intermediate_results[i];
-    ptr->fname = file;
-    ptr->fstream.reset(new std::ifstream(file));
-    if (!*ptr->fstream) {
-      cerr << "could not open file: " << file << endl;
-      continue;
-    }
-    sys.spawn([ptr, vl](blocking_actor* self) {
-      auto& f = *ptr->fstream;
-      auto res = first_pass(self, f, vl);
-      if (res) {
-        // rewind stream and push intermediate results
-        f.clear();
-        f.seekg(0);
-        ptr->res = std::move(*res);
-      }
-    });
+    inputs.emplace_back(new input_file);
+    inputs.back()->fname = cfg.args_remainder.get_as<string>(i);
   }
-  sys.await_all_actors_done();
+  parse_files(sys, inputs, cfg.chunk_size, vl);
   // post-process collected entity IDs before second pass
   entity_set entities;
   std::vector<string> entity_names;
-  auto sort_pred = [](const intermediate_res& x, const intermediate_res& y) {
-    return x.res.this_node < y.res.this_node;
+  auto sort_pred = [](const input_file_ptr& x, const input_file_ptr& y) {
+    return x->this_node < y->this_node;
   };
   std::map<string, size_t> pretty_actor_names;
   size_t thread_count = 0;
   // make sure we insert in sorted order into the entities set
-  std::sort(intermediate_results.begin(), intermediate_results.end(),
-            sort_pred);
-  for (auto& ir : intermediate_results) {
-    auto node_as_string = to_string(ir.res.this_node);
-    for (auto& kvp : ir.res.entities) {
+  std::sort(inputs.begin(), inputs.end(), sort_pred);
+  for (auto& input : inputs) {
+    for (auto& kvp : input->entities) {
       string pretty_name;
       // make each (pretty) actor and thread name unique
       auto& pn = kvp.second.pretty_name;
@@ -851,7 +1251,7 @@ void caf_main(actor_system& sys, const config& cfg) {
         pretty_name = "thread" + std::to_string(++thread_count);
       auto vid = entities.size(); // position in the vector timestamp
       entity_names.emplace_back(pretty_name);
-      entities.emplace(entity{kvp.first.aid, kvp.first.tid, ir.res.this_node,
+      entities.emplace(entity{kvp.first.aid, kvp.first.tid, input->this_node,
                               vid, kvp.second.hidden, std::move(pretty_name)});
     }
   }
@@ -874,10 +1274,11 @@ void caf_main(actor_system& sys, const config& cfg) {
   out << endl;
   std::mutex out_mtx;
   auto grp = sys.groups().anonymous();
-  for (auto& fpr : intermediate_results) {
-    sys.spawn_in_group(grp, [&](blocking_actor* self) {
-      second_pass(self, grp, entities, fpr.res.this_node, entity_names,
-                  *fpr.fstream, out, out_mtx, !cfg.include_hidden_actors, vl);
+  for (auto& input : inputs) {
+    auto ptr = input.get();
+    sys.spawn_in_group(grp, [&, ptr](blocking_actor* self) {
+      second_pass(self, grp, entities, *ptr, entity_names, out, out_mtx,
+                  !cfg.include_hidden_actors, vl);
     });
   }
   sys.await_all_actors_done();
@@ -886,4 +1287,3 @@ void caf_main(actor_system& sys, const config& cfg) {
 } // namespace <anonymous>
 
 CAF_MAIN()
-